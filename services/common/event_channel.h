@@ -68,6 +68,13 @@ struct ChannelSetVolumeEventMsg : public ChannelEventMsg {
     float volume;
 };
 
+struct ChannelSetBitrateEventMsg : public ChannelEventMsg {
+    using Ptr = std::shared_ptr<ChannelSetBitrateEventMsg>;
+
+    uint32_t bitrate = 0;
+    uint32_t frameRate = 0;
+};
+
 struct ChannelSetKeyRedirectEventMsg : public ChannelEventMsg {
     using Ptr = std::shared_ptr<ChannelSetKeyRedirectEventMsg>;
 
@@ -74,7 +74,8 @@
 #define EVENT_WFD                                                                             \
     EVENT_WFD_BASE = MAKE_EVENT_TYPE(9, 0), EVENT_WFD_MEDIA_INIT, EVENT_WFD_STATE_MEDIA_INIT, \
     EVENT_WFD_NOTIFY_RTSP_PLAYED, EVENT_WFD_NOTIFY_RTSP_TEARDOWN, EVENT_WFD_REQUEST_IDR,      \
-    EVENT_WFD_NOTIFY_IS_PC_SOURCE, EVENT_WFD_NOTIFY_TCP_SUCCESS
+    EVENT_WFD_NOTIFY_IS_PC_SOURCE, EVENT_WFD_NOTIFY_TCP_SUCCESS, EVENT_WFD_MEDIA_ADD_SINK,    \
+    EVENT_WFD_MEDIA_REMOVE_SINK, EVENT_WFD_MEDIA_JOIN_GROUP
 
 #define EVENT_SCREEN_CAPTURE    \
     EVENT_SCREEN_CAPTURE_BASE = MAKE_EVENT_TYPE(11, 0), EVENT_SCREEN_CAPTURE_INIT
@@ -47,6 +47,9 @@ static constexpr OHOS::HiviewDFX::HiLogLabel SHARING_LABEL = {LOG_CORE, SHARING_
 #define SHARING_LOGE(fmt, ...) SHARING_LOG(OHOS::HiviewDFX::HiLog::Error, fmt, ##__VA_ARGS__)
 #define SHARING_LOGF(fmt, ...) SHARING_LOG(OHOS::HiviewDFX::HiLog::Fatal, fmt, ##__VA_ARGS__)
 
+// guards arguments that cost something to format, e.g. enum names: LOG_DEBUG, LOG_INFO...
+#define SHARING_LOG_ENABLED(level) HiLogIsLoggable(SHARING_LOG_DOMAIN, SHARING_LOG_TAG, level)
+
 #define CHECK_AND_RETURN(cond)                                \
     do {                                                      \
         if (!(cond)) {                                        \
@@ -23,7 +23,12 @@ namespace OHOS {
 namespace Sharing {
 constexpr uint32_t MAX_SHARING_EVENT_NUM = 5000;
 
-EventManager::EventManager()
+static std::string EventName(EventType type)
+{
+    return std::string(magic_enum::enum_name(type));
+}
+
+EventManager::EventManager() : events_(MAX_SHARING_EVENT_NUM)
 {
     SHARING_LOGD("trace.");
 }
@@ -31,6 +36,9 @@ EventManager::EventManager()
 EventManager::~EventManager()
 {
     SHARING_LOGD("trace.");
+    if (eventThread_ != nullptr) {
+        StopEventLoop();
+    }
 }
 
 int32_t EventManager::Init()
@@ -60,6 +68,12 @@ void EventManager::StopEventLoop()
 {
     SHARING_LOGD("trace.");
     Stop();
+    RETURN_IF_NULL(eventThread_);
+    {
+        // isRunning_ is checked under mutex_ before the loop sleeps
+        std::unique_lock<std::mutex> locker(mutex_);
+        hasEvent_.notify_all();
+    }
     eventThread_->join();
     eventThread_.reset();
     eventThread_ = nullptr;
@@ -69,19 +83,21 @@ int32_t EventManager::AddListener(std::shared_ptr<EventListener> listener)
 {
     SHARING_LOGD("trace.");
     RETURN_INVALID_IF_NULL(listener);
-    SHARING_LOGD("classtype %{public}d.", listener->GetListenerClassType());
-    std::unique_lock<std::mutex> locker(mutex_);
-    auto it = listeners_.find(listener->GetListenerClassType());
-    if (it != listeners_.end()) {
-        it->second.emplace_back(listener);
-    } else {
-        auto newClassList = std::pair<ClassType, std::list<std::shared_ptr<EventListener>>>();
-        newClassList.first = listener->GetListenerClassType();
-        newClassList.second.emplace_back(listener);
-        listeners_.emplace(newClassList);
+    ClassType type = listener->GetListenerClassType();
+    SHARING_LOGD("classtype %{public}d.", type);
+    if (static_cast<size_t>(type) >= CLASS_TYPE_NUM) {
+        SHARING_LOGE("invalid classtype %{public}d.", type);
+        return -1;
     }
 
-    SHARING_LOGD("listeners type count %{public}zu.", listeners_.size());
+    std::unique_lock<std::mutex> locker(mutex_);
+    auto &entry = listeners_[type];
+    // readers keep the list they loaded, a new one replaces it
+    auto newList = entry ? std::make_shared<ListenerList>(*entry) : std::make_shared<ListenerList>();
+    newList->emplace_back(listener);
+    std::atomic_store(&entry, std::shared_ptr<const ListenerList>(std::move(newList)));
+
+    SHARING_LOGD("listeners of type %{public}d count %{public}zu.", type, entry->size());
     return 0;
 }
 
@@ -96,47 +112,82 @@ int32_t EventManager::DrainAllListeners()
 {
     SHARING_LOGD("trace.");
     std::unique_lock<std::mutex> locker(mutex_);
-    listeners_.clear();
+    for (auto &entry : listeners_) {
+        std::atomic_store(&entry, std::shared_ptr<const ListenerList>(nullptr));
+    }
     return 0;
 }
 
+std::shared_ptr<const EventManager::ListenerList> EventManager::GetListeners(ClassType type) const
+{
+    if (static_cast<size_t>(type) >= CLASS_TYPE_NUM) {
+        return nullptr;
+    }
+    return std::atomic_load(&listeners_[type]);
+}
+
 int32_t EventManager::PushEvent(const SharingEvent &event)
 {
     SHARING_LOGD("trace.");
     RETURN_INVALID_IF_NULL(event.eventMsg);
-    SHARING_LOGI("push a async event, type: %{public}u %{public}s.", event.eventMsg->type,
-                 std::string(magic_enum::enum_name(event.eventMsg->type)).c_str());
-    std::unique_lock<std::mutex> locker(mutex_);
-    if (events_.size() >= MAX_SHARING_EVENT_NUM) {
+    if (SHARING_LOG_ENABLED(LOG_INFO)) {
+        SHARING_LOGI("push a async event, type: %{public}u %{public}s.", event.eventMsg->type,
+                     EventName(event.eventMsg->type).c_str());
+    }
+
+    if (!events_.try_push(event)) {
         SHARING_LOGE("events size excced the limit");
         return -1;
     }
-    events_.emplace(event);
-    hasEvent_.notify_one();
+    WakeEventLoop();
     return 0;
 }
 
+void EventManager::WakeEventLoop()
+{
+    // pairs with the fence in ProcessEvent: either the loop sees the event or this sees it asleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (loopSleeping_.load(std::memory_order_relaxed)) {
+        std::unique_lock<std::mutex> locker(mutex_);
+        hasEvent_.notify_one();
+    }
+}
+
 int32_t EventManager::PushSyncEvent(const SharingEvent &event)
 {
     SHARING_LOGD("trace.");
     RETURN_INVALID_IF_NULL(event.eventMsg);
-    SHARING_LOGI("push a sync event, type: %{public}u %{public}s.", event.eventMsg->type,
-                 std::string(magic_enum::enum_name(event.eventMsg->type)).c_str());
-
-    auto it = listeners_.find(event.listenerType);
-    if (it != listeners_.end()) {
-        SHARING_LOGD("find Listener type %{public}d %{public}s.", event.eventMsg->type,
-                     std::string(magic_enum::enum_name(event.eventMsg->type)).c_str());
-        auto listener = it->second.front();
-        std::packaged_task<BindedTask> task(std::bind(&EventListener::OnEvent, listener, event));
-        auto future = task.get_future();
-        PushTask(task);
-        if (future.wait_for(timeoutInterval_) == std::future_status::ready) {
-            SHARING_LOGD("task dispatched success %{public}s.",
-                         std::string(magic_enum::enum_name(event.eventMsg->type)).c_str());
-            return future.get();
+    if (SHARING_LOG_ENABLED(LOG_INFO)) {
+        SHARING_LOGI("push a sync event, type: %{public}u %{public}s.", event.eventMsg->type,
+                     EventName(event.eventMsg->type).c_str());
+    }
+
+    auto listeners = GetListeners(event.listenerType);
+    if (listeners != nullptr && !listeners->empty()) {
+        if (SHARING_LOG_ENABLED(LOG_DEBUG)) {
+            SHARING_LOGD("find Listener type %{public}d %{public}s.", event.eventMsg->type,
+                         EventName(event.eventMsg->type).c_str());
+        }
+        // one per call, a task that timed out may still hold the previous one
+        auto call = std::make_shared<SyncCall>();
+        call->listener = listeners->front();
+        call->event = event;
+        PushTask([call]() {
+            int32_t ret = call->listener->OnEvent(call->event);
+            std::unique_lock<std::mutex> lock(call->mutex);
+            call->result = ret;
+            call->finished = true;
+            call->done.notify_one();
+        });
+
+        std::unique_lock<std::mutex> lock(call->mutex);
+        if (call->done.wait_for(lock, timeoutInterval_, [&call]() { return call->finished; })) {
+            if (SHARING_LOG_ENABLED(LOG_DEBUG)) {
+                SHARING_LOGD("task dispatched success %{public}s.", EventName(event.eventMsg->type).c_str());
+            }
+            return call->result;
         } else {
-            SHARING_LOGW("task timeout %{public}s.", std::string(magic_enum::enum_name(event.eventMsg->type)).c_str());
+            SHARING_LOGW("task timeout %{public}s.", EventName(event.eventMsg->type).c_str());
             return -1;
         }
     }
@@ -147,23 +198,27 @@ int32_t EventManager::PushSyncEvent(const SharingEvent &event)
 void EventManager::ProcessEvent()
 {
     SHARING_LOGD("trace.");
-    std::unique_lock<std::mutex> locker(mutex_);
+    SharingEvent event;
     while (isRunning_) {
-        if (events_.empty()) {
-            hasEvent_.wait(locker);
-        } else {
-            auto event = events_.front();
-            events_.pop();
-            auto it = listeners_.find(event.listenerType);
-            if (it == listeners_.end()) {
-                continue;
+        if (!events_.try_pop(event)) {
+            std::unique_lock<std::mutex> locker(mutex_);
+            loopSleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (events_.empty() && isRunning_) {
+                hasEvent_.wait(locker);
             }
-            for (auto &listener : it->second) {
+            loopSleeping_.store(false, std::memory_order_relaxed);
+            continue;
+        }
+
+        auto listeners = GetListeners(event.listenerType);
+        if (listeners != nullptr) {
+            for (auto &listener : *listeners) {
                 SHARING_LOGD("task dispatched success.");
-                std::packaged_task<BindedTask> task(std::bind(&EventListener::OnEvent, listener, event));
-                PushTask(task);
+                PushTask([listener, event]() mutable { listener->OnEvent(event); });
             }
         }
+        event = {};
     }
 }
 
@@ -16,24 +16,31 @@
 #ifndef OHOS_SHARING_MANAGER_H
 #define OHOS_SHARING_MANAGER_H
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <functional>
 #include <future>
-#include <list>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
-#include <unordered_map>
+#include <vector>
 #include "event_base.h"
 #include "nocopyable.h"
 #include "singleton.h"
 #include "taskpool.h"
+#include "utils/mpsc_ring.h"
 
 namespace OHOS {
 namespace Sharing {
 
+/**
+ * Async events are queued in a lock free ring and dispatched by the eventmgr
+ * thread, which only sleeps on hasEvent_ after announcing it. Listeners are
+ * looked up in a table indexed by ClassType whose entries are immutable
+ * lists, replaced as a whole when a listener comes or goes, so neither the
+ * producers nor the dispatcher take mutex_.
+ */
 class EventManager : public Singleton<EventManager>,
                      public TaskPool {
 public:
@@ -52,15 +59,33 @@ public:
     int32_t DelListener(std::shared_ptr<EventListener> listener);
 
 private:
+    using ListenerList = std::vector<std::shared_ptr<EventListener>>;
+    static constexpr size_t CLASS_TYPE_NUM = CLASS_TYPE_PRODUCER + 1;
+
+    // a sync event and its answer, shared with the task so a timeout does not leave it dangling
+    struct SyncCall {
+        std::mutex mutex;
+        std::condition_variable done;
+        bool finished = false;
+        int32_t result = 0;
+        std::shared_ptr<EventListener> listener = nullptr;
+        SharingEvent event;
+    };
+
     void ProcessEvent();
+    void WakeEventLoop();
+    std::shared_ptr<const ListenerList> GetListeners(ClassType type) const;
 
 private:
+    // guards the sleep of the eventmgr thread and the writers of listeners_
     std::mutex mutex_;
-    std::queue<SharingEvent> events_;
+    mpsc_ring<SharingEvent> events_;
+    std::atomic<bool> loopSleeping_ = false;
     std::condition_variable hasEvent_;
     std::unique_ptr<std::thread> eventLoop_ = nullptr;
     std::unique_ptr<std::thread> eventThread_ = nullptr;
-    std::unordered_map<ClassType, std::list<std::shared_ptr<EventListener>>> listeners_;
+    // read with std::atomic_load, an entry is null until a listener of its type is added
+    std::array<std::shared_ptr<const ListenerList>, CLASS_TYPE_NUM> listeners_;
 };
 
 } // namespace Sharing
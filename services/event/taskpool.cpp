@@ -14,9 +14,42 @@
  */
 
 #include "taskpool.h"
+#include <algorithm>
+
 namespace OHOS {
 namespace Sharing {
 constexpr int32_t MAX_THREAD_NUM = 50;
+constexpr size_t MIN_QUEUE_SLOTS = 16;
+constexpr size_t NO_WORKER = static_cast<size_t>(-1);
+
+// the worker running on this thread, a task it pushes stays in its own queue
+static thread_local const TaskPool *g_currentPool = nullptr;
+static thread_local size_t g_currentWorker = NO_WORKER;
+
+void TaskPool::TaskQueue::Push(SmallTask &&task)
+{
+    if (count_ == slots_.size()) {
+        std::vector<SmallTask> slots(std::max(MIN_QUEUE_SLOTS, slots_.size() * 2)); // 2: grow by doubling
+        for (size_t i = 0; i < count_; ++i) {
+            slots[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+        }
+        slots_.swap(slots);
+        head_ = 0;
+    }
+    slots_[(head_ + count_) % slots_.size()] = std::move(task);
+    ++count_;
+}
+
+bool TaskPool::TaskQueue::Pop(SmallTask &task)
+{
+    if (count_ == 0) {
+        return false;
+    }
+    task = std::move(slots_[head_]);
+    head_ = (head_ + 1) % slots_.size();
+    --count_;
+    return true;
+}
 
 TaskPool::TaskPool()
 {
@@ -34,6 +67,7 @@ TaskPool::~TaskPool()
 int32_t TaskPool::Start(int32_t threadsNum)
 {
     SHARING_LOGD("trace.");
+    std::unique_lock<std::mutex> lock(threadMutex_);
     if (!threads_.empty()) {
         SHARING_LOGE("Before start, theads is not empty.");
         return -1;
@@ -45,16 +79,33 @@ int32_t TaskPool::Start(int32_t threadsNum)
     }
 
     isRunning_ = true;
-    threads_.reserve(threadsNum);
-    for (int32_t i = 0; i < threadsNum; ++i) {
-        threads_.push_back(std::thread(&TaskPool::TaskMainWorker, this));
-        std::string name = "taskpool" + std::to_string(i);
-        pthread_setname_np(threads_.back().native_handle(), name.c_str());
+    maxWorkers_ = static_cast<size_t>(threadsNum);
+    // the queues exist up front, pushes only look at the ones of started workers
+    workers_.clear();
+    for (size_t i = 0; i < maxWorkers_; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
     }
-
+    SmallTask task;
+    while (pendingTasks_.Pop(task)) {
+        workers_[0]->queue.Push(std::move(task));
+    }
+    threads_.reserve(maxWorkers_);
+    StartWorker();
     return 0;
 }
 
+void TaskPool::StartWorker()
+{
+    // threadMutex_ held
+    size_t index = threads_.size();
+    // idle until it takes its first task, pushes meanwhile wake it instead of starting more
+    idleWorkers_.fetch_add(1);
+    threads_.push_back(std::thread(&TaskPool::TaskMainWorker, this, index));
+    std::string name = "taskpool" + std::to_string(index);
+    pthread_setname_np(threads_.back().native_handle(), name.c_str());
+    startedWorkers_.store(index + 1, std::memory_order_release);
+}
+
 void TaskPool::Stop()
 {
     SHARING_LOGD("trace.");
@@ -62,51 +113,140 @@ void TaskPool::Stop()
         std::unique_lock<std::mutex> lock(taskMutex_);
         isRunning_ = false;
         hasTask_.notify_all();
+        acceptNewTask_.notify_all();
     }
 
+    std::unique_lock<std::mutex> lock(threadMutex_);
     for (auto &e : threads_) {
-        e.join();
+        if (e.joinable()) {
+            e.join();
+        }
     }
 }
 
 void TaskPool::PushTask(std::packaged_task<BindedTask> &task)
 {
     SHARING_LOGD("trace.");
-    if (threads_.empty()) {
-    } else {
+    PushTask(SmallTask([task = std::move(task)]() mutable { task(); }));
+}
+
+void TaskPool::PushTask(SmallTask &&task)
+{
+    size_t started = startedWorkers_.load(std::memory_order_acquire);
+    if (started == 0) {
+        std::unique_lock<std::mutex> lock(threadMutex_);
+        started = startedWorkers_.load(std::memory_order_acquire);
+        if (started == 0) {
+            // the pool used to drop these, now Start hands them to the first worker; nothing drains them until
+            // then, so past maxTaskNum_ they are still dropped instead of waited on
+            if (maxTaskNum_ > 0 && pendingTasks_.Size() >= maxTaskNum_) {
+                SHARING_LOGE("task pool is not started, drop the task.");
+                return;
+            }
+            SHARING_LOGW("task pool is not started.");
+            pendingTasks_.Push(std::move(task));
+            queuedTasks_.fetch_add(1);
+            return;
+        }
+    }
+
+    if (IsOverload()) {
         std::unique_lock<std::mutex> lock(taskMutex_);
-        while (IsOverload()) {
+        overloadWaiters_.fetch_add(1);
+        while (IsOverload() && isRunning_) {
             SHARING_LOGE("task pool is over load.");
             acceptNewTask_.wait(lock);
         }
-        tasks_.emplace_back(std::move(task));
+        overloadWaiters_.fetch_sub(1);
+    }
+
+    size_t index = (g_currentPool == this && g_currentWorker < started) ?
+        g_currentWorker : nextWorker_.fetch_add(1, std::memory_order_relaxed) % started;
+    // counted before it is queued: a worker can take it as soon as it is in, and its OnTaskTaken must not take the
+    // count below zero; a worker that sees the count early finds the task on its next turn
+    queuedTasks_.fetch_add(1);
+    {
+        std::unique_lock<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->queue.Push(std::move(task));
+    }
+
+    if (idleWorkers_.load() > 0) {
+        std::unique_lock<std::mutex> lock(taskMutex_);
         hasTask_.notify_one();
+        return;
+    }
+
+    // everyone runs a task, possibly blocked in it: one more worker unless at the limit
+    if (started < maxWorkers_ && isRunning_) {
+        std::unique_lock<std::mutex> lock(threadMutex_);
+        if (threads_.size() < maxWorkers_ && isRunning_) {
+            StartWorker();
+            SHARING_LOGD("task pool grows to %{public}zu threads.", threads_.size());
+        }
     }
 }
 
 bool TaskPool::IsOverload() const
 {
-    return (maxTaskNum_ > 0) && (tasks_.size() >= maxTaskNum_);
+    return (maxTaskNum_ > 0) && (queuedTasks_.load(std::memory_order_relaxed) >= maxTaskNum_);
 }
 
-void TaskPool::TaskMainWorker()
+bool TaskPool::TakeTask(size_t index, SmallTask &task)
+{
+    {
+        std::unique_lock<std::mutex> lock(workers_[index]->mutex);
+        if (workers_[index]->queue.Pop(task)) {
+            return true;
+        }
+    }
+
+    // steal the oldest task of another worker, starting after this one so thieves spread out
+    size_t started = startedWorkers_.load(std::memory_order_acquire);
+    for (size_t i = 1; i < started; ++i) {
+        auto &victim = workers_[(index + i) % started];
+        std::unique_lock<std::mutex> lock(victim->mutex);
+        if (victim->queue.Pop(task)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::OnTaskTaken()
+{
+    queuedTasks_.fetch_sub(1);
+    if (overloadWaiters_.load() > 0) {
+        std::unique_lock<std::mutex> lock(taskMutex_);
+        acceptNewTask_.notify_one();
+    }
+}
+
+void TaskPool::TaskMainWorker(size_t index)
 {
     SHARING_LOGD("trace.");
-    std::unique_lock<std::mutex> lock(taskMutex_);
+    g_currentPool = this;
+    g_currentWorker = index;
+    SmallTask task;
     while (isRunning_) {
-        if (tasks_.empty() && isRunning_) {
-            hasTask_.wait(lock);
-        } else {
-            std::packaged_task<BindedTask> task = std::move(tasks_.front());
-            tasks_.pop_front();
-            acceptNewTask_.notify_one();
-            lock.unlock();
-            SHARING_LOGD("task main worker unlocked.");
+        if (TakeTask(index, task)) {
+            idleWorkers_.fetch_sub(1);
+            OnTaskTaken();
             task();
-            lock.lock();
-            SHARING_LOGD("task main worker locked.");
+            // the captures go now, not when the worker runs its next task
+            task.Reset();
+            idleWorkers_.fetch_add(1);
+            continue;
+        }
+
+        // counted as idle before the check: a push either sees this worker idle or is seen here
+        std::unique_lock<std::mutex> lock(taskMutex_);
+        if (queuedTasks_.load() == 0 && isRunning_) {
+            hasTask_.wait(lock);
         }
     }
+    idleWorkers_.fetch_sub(1);
+    g_currentPool = nullptr;
+    g_currentWorker = NO_WORKER;
 }
 
 void TaskPool::SetTimeoutInterval(uint32_t ms)
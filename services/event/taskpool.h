@@ -18,25 +18,161 @@
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
 #include <functional>
 #include <future>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <queue>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 #include "event_base.h"
 #include "nocopyable.h"
 
 namespace OHOS {
 namespace Sharing {
 
+/**
+ * Work stealing executor. Every worker owns a queue: a worker pushes to its
+ * own, other threads spread their tasks over the workers round robin, and a
+ * worker whose queue is empty takes from the others before it sleeps. The
+ * workers are started one by one when a task finds none of them idle, up to
+ * the number given to Start.
+ *
+ * Tasks are SmallTask, a callable of up to SmallTask::INLINE_SIZE bytes is
+ * kept inline, so queuing it does not allocate once the queues have grown.
+ */
 class TaskPool : public NoCopyable {
 public:
     using Task = int32_t(const SharingEvent &);
     using BindedTask = int32_t();
 
+    // move only void() callable, larger ones are moved to the heap
+    class SmallTask {
+    public:
+        static constexpr size_t INLINE_SIZE = 96; // 96: a listener and a SharingEvent
+
+        SmallTask() = default;
+        ~SmallTask()
+        {
+            Reset();
+        }
+
+        template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SmallTask>>>
+        SmallTask(F &&func) // NOLINT: implicit like std::function
+        {
+            using Fn = std::decay_t<F>;
+            if constexpr (IsInline<Fn>()) {
+                new (storage_) Fn(std::forward<F>(func));
+                ops_ = &InlineOps<Fn>::OPS;
+            } else {
+                new (storage_) Fn *(new Fn(std::forward<F>(func)));
+                ops_ = &HeapOps<Fn>::OPS;
+            }
+        }
+
+        SmallTask(SmallTask &&other) noexcept
+        {
+            MoveFrom(other);
+        }
+
+        SmallTask &operator=(SmallTask &&other) noexcept
+        {
+            if (this != &other) {
+                Reset();
+                MoveFrom(other);
+            }
+            return *this;
+        }
+
+        explicit operator bool() const
+        {
+            return ops_ != nullptr;
+        }
+
+        void operator()()
+        {
+            if (ops_ != nullptr) {
+                ops_->invoke(storage_);
+            }
+        }
+
+        void Reset()
+        {
+            if (ops_ != nullptr) {
+                ops_->destroy(storage_);
+                ops_ = nullptr;
+            }
+        }
+
+    private:
+        struct Ops {
+            void (*invoke)(void *storage);
+            void (*move)(void *dst, void *src);
+            void (*destroy)(void *storage);
+        };
+
+        template <typename Fn>
+        static constexpr bool IsInline()
+        {
+            return sizeof(Fn) <= INLINE_SIZE && alignof(Fn) <= alignof(std::max_align_t) &&
+                   std::is_nothrow_move_constructible_v<Fn>;
+        }
+
+        template <typename Fn>
+        struct InlineOps {
+            static void Invoke(void *storage)
+            {
+                (*static_cast<Fn *>(storage))();
+            }
+            static void Move(void *dst, void *src)
+            {
+                new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+                static_cast<Fn *>(src)->~Fn();
+            }
+            static void Destroy(void *storage)
+            {
+                static_cast<Fn *>(storage)->~Fn();
+            }
+            static constexpr Ops OPS = {Invoke, Move, Destroy};
+        };
+
+        template <typename Fn>
+        struct HeapOps {
+            static void Invoke(void *storage)
+            {
+                (**static_cast<Fn **>(storage))();
+            }
+            static void Move(void *dst, void *src)
+            {
+                new (dst) Fn *(*static_cast<Fn **>(src));
+            }
+            static void Destroy(void *storage)
+            {
+                delete *static_cast<Fn **>(storage);
+            }
+            static constexpr Ops OPS = {Invoke, Move, Destroy};
+        };
+
+        void MoveFrom(SmallTask &other) noexcept
+        {
+            if (other.ops_ != nullptr) {
+                other.ops_->move(storage_, other.storage_);
+                ops_ = other.ops_;
+                other.ops_ = nullptr;
+            }
+        }
+
+    private:
+        alignas(std::max_align_t) unsigned char storage_[INLINE_SIZE];
+        const Ops *ops_ = nullptr;
+    };
+
     TaskPool();
     ~TaskPool();
 
@@ -52,31 +188,76 @@ public:
 
     virtual inline size_t GetTaskNum() const
     {
-        return tasks_.size();
+        return queuedTasks_.load(std::memory_order_relaxed);
     };
 
+    // workers started so far
+    size_t GetThreadNum() const
+    {
+        return startedWorkers_.load(std::memory_order_acquire);
+    }
+
 public:
     virtual void Stop();
     virtual void SetTimeoutInterval(uint32_t ms);
     virtual void PushTask(std::packaged_task<BindedTask> &task);
+    virtual void PushTask(SmallTask &&task);
 
+    // threadsNum: the most workers started, the first one is started here
     virtual int32_t Start(int32_t threadsNum);
 
 protected:
-    virtual void TaskMainWorker();
+    virtual void TaskMainWorker(size_t index);
     virtual bool IsOverload() const;
 
+private:
+    // fifo of one worker, a ring that only grows so steady pushes do not allocate
+    class TaskQueue {
+    public:
+        void Push(SmallTask &&task);
+        bool Pop(SmallTask &task);
+        size_t Size() const
+        {
+            return count_;
+        }
+
+    private:
+        std::vector<SmallTask> slots_;
+        size_t head_ = 0;
+        size_t count_ = 0;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        TaskQueue queue;
+    };
+
+    bool TakeTask(size_t index, SmallTask &task);
+    void StartWorker();
+    void OnTaskTaken();
+
 protected:
-    bool isRunning_ = false;
+    std::atomic<bool> isRunning_ = false;
     size_t maxTaskNum_ = 0;
     std::mutex taskMutex_;
     std::condition_variable hasTask_;
     std::condition_variable acceptNewTask_;
     std::chrono::milliseconds timeoutInterval_;
     std::vector<std::thread> threads_;
-    std::deque<std::packaged_task<BindedTask>> tasks_;
+
+private:
+    std::mutex threadMutex_;
+    size_t maxWorkers_ = 0;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    // pushed before Start, handed to the first worker
+    TaskQueue pendingTasks_;
+    std::atomic<size_t> startedWorkers_ = 0;
+    std::atomic<size_t> idleWorkers_ = 0;
+    std::atomic<size_t> queuedTasks_ = 0;
+    std::atomic<size_t> overloadWaiters_ = 0;
+    std::atomic<size_t> nextWorker_ = 0;
 };
 
 } // namespace Sharing
 } // namespace OHOS
-#endif
\ No newline at end of file
+#endif
@@ -632,6 +632,14 @@ void WfdRtspM4Request::SetVideoFormats(const WfdVideoFormatsInfo &wfdVideoFormat
     AddBodyItem(ss.str());
 }
 
+void WfdRtspM4Request::SetRtpDirect(uint8_t videoPt, uint8_t audioPt)
+{
+    std::stringstream ss;
+    ss << WFD_PARAM_RTP_DIRECT << ":" << RTSP_SP << "h264" << RTSP_SP << static_cast<int32_t>(videoPt) << RTSP_SP
+       << "aac" << RTSP_SP << static_cast<int32_t>(audioPt);
+    AddBodyItem(ss.str());
+}
+
 RtspError WfdRtspM4Request::Parse(const std::string &request)
 {
     auto res = RtspRequest::Parse(request);
@@ -669,6 +677,29 @@ std::string WfdRtspM4Request::GetPresentationUrl()
     return "";
 }
 
+bool WfdRtspM4Request::GetRtpDirect(uint8_t &videoPt, uint8_t &audioPt)
+{
+    std::string value = GetParameterValue(WFD_PARAM_RTP_DIRECT);
+    if (value.empty()) {
+        return false;
+    }
+
+    std::string video;
+    std::string audio;
+    int32_t vpt = -1;
+    int32_t apt = -1;
+    std::stringstream ss(value);
+    ss >> video >> vpt >> audio >> apt;
+    // 96, 127: dynamic payload types
+    if (video != "h264" || audio != "aac" || vpt < 96 || vpt > 127 || apt < 96 || apt > 127 || vpt == apt) {
+        SHARING_LOGE("invalid rtp direct param: %{public}s.", value.c_str());
+        return false;
+    }
+    videoPt = static_cast<uint8_t>(vpt);
+    audioPt = static_cast<uint8_t>(apt);
+    return true;
+}
+
 int32_t WfdRtspM4Request::GetRtpPort()
 {
     auto ports = GetParameterValue(WFD_PARAM_RTP_PORTS);
@@ -841,6 +872,43 @@ int32_t WfdRtspM6Response::GetServerPort()
     return 0;
 }
 
+std::string WfdRtspM6Response::GetTransportParam(const std::string &key)
+{
+    auto transport = GetToken(RTSP_TOKEN_TRANSPORT);
+    if (transport.find("multicast") == std::string::npos) {
+        return {};
+    }
+
+    auto tsVec = RtspCommon::Split(transport, ";");
+    for (auto &item : tsVec) {
+        auto pos = item.find('=');
+        if (pos != std::string::npos && RtspCommon::Trim(item.substr(0, pos)) == key) {
+            return RtspCommon::Trim(item.substr(pos + 1));
+        }
+    }
+
+    return {};
+}
+
+std::string WfdRtspM6Response::GetDestination()
+{
+    return GetTransportParam("destination");
+}
+
+int32_t WfdRtspM6Response::GetMulticastPort()
+{
+    // port=<rtp>-<rtcp>
+    auto val = GetTransportParam("port");
+    return val.empty() ? 0 : atoi(val.c_str());
+}
+
+void WfdRtspM6Response::SetMulticast(const std::string &group, int32_t port, int32_t ttl)
+{
+    multicastGroup_ = group;
+    multicastPort_ = port;
+    multicastTtl_ = ttl;
+}
+
 void WfdRtspM6Response::SetClientPort(int port)
 {
     clientPort_ = port;
@@ -860,8 +928,14 @@ std::string WfdRtspM6Response::StringifyEx()
     if (nPos != std::string::npos) {
         message = message.substr(0, message.size() - temp.size());
     }
-    ss << message << "Transport: RTP/AVP/UDP;unicast;client_port=" << clientPort_ << ";server_port=" << serverPort_
-       << RTSP_CRLF;
+    if (multicastGroup_.empty()) {
+        ss << message << "Transport: RTP/AVP/UDP;unicast;client_port=" << clientPort_ << ";server_port=" << serverPort_
+           << RTSP_CRLF;
+    } else {
+        ss << message << "Transport: RTP/AVP/UDP;multicast;destination=" << multicastGroup_
+           << ";port=" << multicastPort_ << "-" << multicastPort_ + 1 << ";ttl=" << multicastTtl_
+           << ";client_port=" << clientPort_ << ";server_port=" << serverPort_ << RTSP_CRLF;
+    }
     ss << RTSP_CRLF;
     return ss.str();
 }
@@ -146,8 +146,11 @@ public:
     void SetAudioCodecs(WfdAudioCodec &codec);
     void SetPresentationUrl(const std::string &ip);
     void SetVideoFormats(const WfdVideoFormatsInfo &wfdVideoFormatsInfo, VideoFormat format = VIDEO_1920X1080_30);
+    void SetRtpDirect(uint8_t videoPt, uint8_t audioPt);
 
     int32_t GetRtpPort();
+    // false when the source keeps the ts stream
+    bool GetRtpDirect(uint8_t &videoPt, uint8_t &audioPt);
 
     std::string GetPresentationUrl();
     std::string GetParameterValue(const std::string &param);
@@ -194,10 +197,21 @@ public:
     int32_t GetServerPort();
     void SetClientPort(int port);
     void SetServerPort(int port);
+    // rfc 2326 multicast transport, the stream goes to group:port instead of the client port
+    void SetMulticast(const std::string &group, int32_t port, int32_t ttl);
+    // empty for unicast
+    std::string GetDestination();
+    int32_t GetMulticastPort();
+
+private:
+    std::string GetTransportParam(const std::string &key);
 
 private:
     int32_t clientPort_ = 0;
     int32_t serverPort_ = 0;
+    int32_t multicastPort_ = 0;
+    int32_t multicastTtl_ = 1;
+    std::string multicastGroup_;
 };
 
 using WfdRtspM7Request = RtspRequestPlay;
@@ -90,6 +90,10 @@ const std::string WFD_PARAM_HWE_AVSYNC_SINK = "wfd_hwe_avsync_sink";
 const std::string WFD_PARAM_CONNECTOR_TYPE = "wfd_connector_type";
 const std::string WFD_PARAM_IDR_REQUEST_CAPABILITY = "wfd_idr_request_capability";
 const std::string WFD_PARAM_RTCP_CAPABILITY = "microsoft_rtcp_capability";
+// h264 and aac in rtp streams of their own instead of one mpeg-ts stream,
+// m3 response: "h264 aac" or "none", m4 request: "h264 <video pt> aac <audio pt>"
+const std::string WFD_PARAM_RTP_DIRECT = "wfd_rtp_direct";
+const std::string WFD_RTP_DIRECT_CAPABILITY = "h264 aac";
 
 struct VideoConfigTable {
     int32_t width;
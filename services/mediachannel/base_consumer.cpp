@@ -59,6 +59,18 @@ bool BaseConsumer::IsPcSource()
     return isPcSource_;
 }
 
+void BaseConsumer::RequestKeyFrame()
+{
+    SHARING_LOGD("trace.");
+}
+
+void BaseConsumer::SetVideoBitrate(uint32_t bitrate, uint32_t frameRate)
+{
+    SHARING_LOGD("trace.");
+    (void)bitrate;
+    (void)frameRate;
+}
+
 uint32_t BaseConsumer::GetSinkAgentId()
 {
     SHARING_LOGD("trace.");
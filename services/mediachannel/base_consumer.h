@@ -61,6 +61,10 @@ public:
     virtual bool IsRunning();
     virtual bool IsCapture();
     virtual bool IsPcSource();
+    // a producer lost the video of its peer, only capturing consumers can act on it
+    virtual void RequestKeyFrame();
+    // the congestion control of a producer asks for another video bitrate, frameRate 0 keeps the current one
+    virtual void SetVideoBitrate(uint32_t bitrate, uint32_t frameRate);
 
     virtual int32_t Release() = 0;
     virtual uint32_t GetSinkAgentId();
@@ -14,9 +14,11 @@
  */
 
 #include "buffer_dispatcher.h"
+#include <algorithm>
 #include <cmath>
 #include <cstdarg>
 #include <cstdint>
+#include <iterator>
 #include "common/common_macro.h"
 #include "media_channel_def.h"
 
@@ -325,16 +327,22 @@ bool DataNotifier::DataAvailable(MediaType type)
         return false;
     }
 
+    // a cursor left behind by head eviction continues from the oldest buffered data
+    uint32_t oldest = dispatcher->GetOldestIndex();
+    uint32_t aIndex = audioIndex;
+    uint32_t vIndex = videoIndex;
+    aIndex = (aIndex != INVALID_INDEX && aIndex < oldest) ? oldest : aIndex;
+    vIndex = (vIndex != INVALID_INDEX && vIndex < oldest) ? oldest : vIndex;
     if (type == MEDIA_TYPE_AUDIO) {
-        return audioIndex != INVALID_INDEX &&
-               (audioIndex < dispatcher->GetLatestAudioIndex() || !dispatcher->IsRead(GetReceiverId(), audioIndex + 1));
+        return aIndex != INVALID_INDEX &&
+               (aIndex < dispatcher->GetLatestAudioIndex() || !dispatcher->IsRead(GetReceiverId(), aIndex + 1));
     } else if (type == MEDIA_TYPE_VIDEO) {
-        return videoIndex != INVALID_INDEX &&
-               (videoIndex < dispatcher->GetLatestVideoIndex() || !dispatcher->IsRead(GetReceiverId(), videoIndex + 1));
+        return vIndex != INVALID_INDEX &&
+               (vIndex < dispatcher->GetLatestVideoIndex() || !dispatcher->IsRead(GetReceiverId(), vIndex + 1));
     } else {
-        return videoIndex != INVALID_INDEX &&
-               ((dispatcher->GetBufferSize() > 0 && videoIndex < dispatcher->GetBufferSize() - 1) ||
-                !dispatcher->IsRead(GetReceiverId(), videoIndex + 1));
+        uint32_t latest = dispatcher->GetLatestIndex();
+        return vIndex != INVALID_INDEX &&
+               ((latest != INVALID_INDEX && vIndex < latest) || !dispatcher->IsRead(GetReceiverId(), vIndex + 1));
     }
 
     return false;
@@ -355,24 +363,26 @@ bool DataNotifier::IsMixedReceiver()
 uint32_t DataNotifier::GetReceiverReadIndex(MediaType type)
 {
     MEDIA_LOGD("trace.");
+    uint32_t aIndex = audioIndex;
+    uint32_t vIndex = videoIndex;
     switch (type) {
         case MEDIA_TYPE_VIDEO:
-            MEDIA_LOGD("Video Recvid:%{public}d index: %{public}d.", GetReceiverId(), videoIndex);
-            return videoIndex;
+            MEDIA_LOGD("Video Recvid:%{public}d index: %{public}d.", GetReceiverId(), vIndex);
+            return vIndex;
             break;
         case MEDIA_TYPE_AUDIO:
-            MEDIA_LOGD("Audio Recvid:%{public}d index: %{public}d.", GetReceiverId(), audioIndex);
-            return audioIndex;
+            MEDIA_LOGD("Audio Recvid:%{public}d index: %{public}d.", GetReceiverId(), aIndex);
+            return aIndex;
             break;
         case MEDIA_TYPE_AV:
-            MEDIA_LOGD("Mixed Recvid:%{public}d vindex: %{public}d  aindex: %{public}d.", GetReceiverId(), videoIndex,
-                       audioIndex);
-            if (audioIndex != INVALID_INDEX && videoIndex != INVALID_INDEX) {
-                return audioIndex <= videoIndex ? audioIndex : videoIndex;
-            } else if (audioIndex == INVALID_INDEX && videoIndex == INVALID_INDEX) {
+            MEDIA_LOGD("Mixed Recvid:%{public}d vindex: %{public}d  aindex: %{public}d.", GetReceiverId(), vIndex,
+                       aIndex);
+            if (aIndex != INVALID_INDEX && vIndex != INVALID_INDEX) {
+                return aIndex <= vIndex ? aIndex : vIndex;
+            } else if (aIndex == INVALID_INDEX && vIndex == INVALID_INDEX) {
                 return INVALID_INDEX;
             } else {
-                return audioIndex == INVALID_INDEX ? videoIndex : audioIndex;
+                return aIndex == INVALID_INDEX ? vIndex : aIndex;
             }
             break;
         default:
@@ -429,6 +439,7 @@ void DataNotifier::SendAccelerationDone()
 }
 
 BufferDispatcher::BufferDispatcher(uint32_t maxCapacity, uint32_t capacityIncrement)
+    : circularBuffer_(std::max<size_t>(maxCapacity, INITIAL_BUFFER_CAPACITY * 2)) // 2: double capacity
 {
     SHARING_LOGD("BufferDispatcher ctor, set capacity: %{public}u.", maxCapacity);
     maxBufferCapacity_ = maxCapacity;
@@ -437,6 +448,7 @@ BufferDispatcher::BufferDispatcher(uint32_t maxCapacity, uint32_t capacityIncrem
         std::lock_guard<std::mutex> lock(idleMutex_);
         idleAudioBuffer_.set_capacity(INITIAL_BUFFER_CAPACITY);
         idleVideoBuffer_.set_capacity(INITIAL_BUFFER_CAPACITY);
+        idleDataSpec_.set_capacity(circularBuffer_.max_capacity());
         for (size_t i = 0; i < INITIAL_BUFFER_CAPACITY; i++) {
             MediaData::Ptr adata = std::make_shared<MediaData>();
             MediaData::Ptr vdata = std::make_shared<MediaData>();
@@ -554,6 +566,9 @@ void BufferDispatcher::FlushBuffer()
     }
 
     circularBuffer_.clear();
+    audioLinkIndex_ = 0;
+    videoLinkIndex_ = 0;
+    keyLinkIndex_ = 0;
     waitingKey_ = true;
     gop_ = 0;
     audioFrameCnt_ = 0;
@@ -608,7 +623,12 @@ void BufferDispatcher::ReturnIdleBuffer(DataSpec::Ptr &data)
     if (data == nullptr || data->mediaData == nullptr) {
         return;
     }
-    if (data->mediaData->mediaType == MEDIA_TYPE_VIDEO) {
+
+    // receivers may keep the frame after reading it (zero-copy hand-off), never recycle a shared one
+    bool shared = data.use_count() != 1 || data->mediaData.use_count() != 1;
+    if (shared) {
+        MEDIA_LOGD("data still referenced by a receiver, drop it.");
+    } else if (data->mediaData->mediaType == MEDIA_TYPE_VIDEO) {
         if (idleVideoBuffer_.size() < INITIAL_BUFFER_CAPACITY) {
             idleVideoBuffer_.push_back(data->mediaData);
             MEDIA_LOGD("data: push_back in idleVideoBuffer_, size: %{public}zu.", idleVideoBuffer_.size());
@@ -620,15 +640,57 @@ void BufferDispatcher::ReturnIdleBuffer(DataSpec::Ptr &data)
         }
     }
 
+    // the ring slot is already cleared, a single owner means no reader still holds this spec
+    if (data.use_count() == 1 && idleDataSpec_.size() < idleDataSpec_.capacity()) {
+        data->mediaData = nullptr;
+        idleDataSpec_.push_back(data);
+    }
+
     data.reset();
 }
 
+BufferDispatcher::DataSpec::Ptr BufferDispatcher::AcquireDataSpec()
+{
+    MEDIA_LOGD("trace.");
+    std::lock_guard<std::mutex> lock(idleMutex_);
+    if (idleDataSpec_.empty()) {
+        return std::make_shared<DataSpec>();
+    }
+
+    DataSpec::Ptr dataSpec = idleDataSpec_.front();
+    idleDataSpec_.pop_front();
+    return dataSpec;
+}
+
 size_t BufferDispatcher::GetBufferSize()
 {
     SHARING_LOGD("trace.");
     return circularBuffer_.size();
 }
 
+uint32_t BufferDispatcher::GetOldestIndex()
+{
+    MEDIA_LOGD("trace.");
+    return circularBuffer_.begin_index();
+}
+
+uint32_t BufferDispatcher::GetLatestIndex()
+{
+    MEDIA_LOGD("trace.");
+    return circularBuffer_.back_index();
+}
+
+uint32_t BufferDispatcher::ClampReadIndex(uint32_t index)
+{
+    MEDIA_LOGD("trace.");
+    uint32_t oldest = circularBuffer_.begin_index();
+    if (index != INVALID_INDEX && index < oldest) {
+        return oldest;
+    }
+
+    return index;
+}
+
 uint32_t BufferDispatcher::FindReceiverIndex(uint32_t receiverId)
 {
     MEDIA_LOGD("trace.");
@@ -692,6 +754,7 @@ int32_t BufferDispatcher::AttachReceiver(BufferReceiver::Ptr receiver)
                  receiver->GetReceiverId(), notifier->GetReadIndex(), usableRef, readRefFlag_);
     receiver->SetSource(shared_from_this());
     notifiers_.emplace(receiver->GetReceiverId(), notifier);
+    PublishNotifiers();
 
     std::lock_guard<std::shared_mutex> bufferLock(bufferMutex_);
     if (circularBuffer_.empty()) {
@@ -706,7 +769,7 @@ int32_t BufferDispatcher::AttachReceiver(BufferReceiver::Ptr receiver)
     }
 
     if (dataMode_ == MEDIA_AUDIO_ONLY) {
-        notifier->audioIndex = circularBuffer_.size() - 1;
+        notifier->audioIndex = circularBuffer_.back_index();
         SetReceiverDataRef(receiver->GetReceiverId(), MEDIA_TYPE_AUDIO, true);
         notifier->videoIndex = INVALID_INDEX;
         SetReceiverDataRef(receiver->GetReceiverId(), MEDIA_TYPE_VIDEO, false);
@@ -768,6 +831,7 @@ int32_t BufferDispatcher::DetachReceiver(BufferReceiver::Ptr receiver)
 
     readRefFlag_ &= ~(RECV_FLAG_BASE << notifier->GetReadIndex());
     notifiers_.erase(receiver->GetReceiverId());
+    PublishNotifiers();
     SHARING_LOGI("now refFlag: %{public}d.", readRefFlag_);
     return 0;
 }
@@ -785,6 +849,7 @@ int32_t BufferDispatcher::DetachReceiver(uint32_t receiverId, DataNotifier::Ptr
 
     readRefFlag_ &= ~(RECV_FLAG_BASE << notifier->GetReadIndex());
     notifiers_.erase(receiverId);
+    PublishNotifiers();
     SHARING_LOGI("now refFlag: %{public}d.", readRefFlag_);
     return 0;
 }
@@ -818,6 +883,7 @@ void BufferDispatcher::ReleaseAllReceiver()
     }
 
     notifiers_.clear();
+    PublishNotifiers();
     SHARING_LOGD("release all receiver out.");
 }
 
@@ -852,12 +918,20 @@ DataNotifier::Ptr BufferDispatcher::GetNotifierByReceiverPtr(BufferReceiver::Ptr
 DataNotifier::Ptr BufferDispatcher::GetNotifierByReceiverId(uint32_t receiverId)
 {
     MEDIA_LOGD("trace.");
-    std::lock_guard<std::mutex> locker(notifyMutex_);
-    if (notifiers_.find(receiverId) != notifiers_.end()) {
-        return notifiers_[receiverId];
+    auto notifiers = std::atomic_load_explicit(&notifierSnapshot_, std::memory_order_acquire);
+    if (notifiers == nullptr) {
+        return nullptr;
     }
 
-    return nullptr;
+    auto iter = notifiers->find(receiverId);
+    return iter != notifiers->end() ? iter->second : nullptr;
+}
+
+void BufferDispatcher::PublishNotifiers()
+{
+    MEDIA_LOGD("trace.");
+    auto notifiers = std::make_shared<const std::unordered_map<uint32_t, DataNotifier::Ptr>>(notifiers_);
+    std::atomic_store_explicit(&notifierSnapshot_, notifiers, std::memory_order_release);
 }
 
 int32_t BufferDispatcher::ReadBufferData(uint32_t receiverId, MediaType type,
@@ -870,43 +944,29 @@ int32_t BufferDispatcher::ReadBufferData(uint32_t receiverId, MediaType type,
         return -1;
     }
 
-    std::shared_lock<std::shared_mutex> locker(bufferMutex_);
-    uint32_t readIndex = notifier->GetReceiverReadIndex(type);
-    if (readIndex >= circularBuffer_.size()) {
+    // readers never take bufferMutex_, ring slots are loaded by sequence and validated against eviction
+    uint32_t readIndex = ClampReadIndex(notifier->GetReceiverReadIndex(type));
+    auto data = circularBuffer_.load(readIndex);
+    if (data == nullptr) {
         SHARING_LOGE("Read wrong index exceed size.");
         return -1;
     }
 
-    if ((keyOnly_ || notifier->IsKeyModeReceiver()) && type == MEDIA_TYPE_VIDEO &&
-        !IsKeyVideoFrame(circularBuffer_.at(readIndex))) {
+    if ((keyOnly_ || notifier->IsKeyModeReceiver()) && type == MEDIA_TYPE_VIDEO && !IsKeyVideoFrame(data)) {
         UpdateReceiverReadIndex(receiverId, readIndex, type);
         SHARING_LOGE("Read Non Key Video in KeyOnly Mode index: %{public}u.", readIndex);
         return -1;
     }
 
-    if (IsDataReaded(receiverId, circularBuffer_.at(readIndex))) {
+    if (IsDataReaded(receiverId, data)) {
         UpdateReceiverReadIndex(receiverId, readIndex, type);
         return -1;
     }
 
-    readIndex = notifier->GetReceiverReadIndex(type);
-    if (readIndex >= circularBuffer_.size()) {
-        return -1;
-    }
-
-    auto data = circularBuffer_.at(readIndex);
-    if (data == nullptr) {
-        SHARING_LOGE("BufferDispatcher Read data nullptr.");
-        return -1;
-    }
-
     if (IsKeyVideoFrame(data)) {
-        int32_t bufferVideoCacheCnt = 0;
-        for (size_t i = (size_t)readIndex + 1; i < circularBuffer_.size(); i++) {
-            if (circularBuffer_[static_cast<int32_t>(i)]->mediaData->mediaType == MEDIA_TYPE_VIDEO)
-                bufferVideoCacheCnt++;
-        }
-        MEDIA_LOGD("TEST STATISTIC:interval: buffer cache %{public}d frames.", bufferVideoCacheCnt);
+        auto latest = circularBuffer_.load(circularBuffer_.back_index());
+        uint32_t bufferVideoCacheCnt = latest != nullptr ? latest->videoOrdinal - data->videoOrdinal : 0;
+        MEDIA_LOGD("TEST STATISTIC:interval: buffer cache %{public}u frames.", bufferVideoCacheCnt);
     }
 
     SetReceiverReadFlag(receiverId, data);
@@ -915,8 +975,8 @@ int32_t BufferDispatcher::ReadBufferData(uint32_t receiverId, MediaType type,
     }
 
     MEDIA_LOGD("Current data readed, Recvid:%{public}d, remain %{public}zu data, readIndex: %{public}u, "
-               "readtype: %{public}d, diff: %{public}zu.",
-               receiverId, circularBuffer_.size(), readIndex, int32_t(type), circularBuffer_.size() - readIndex);
+               "readtype: %{public}d, diff: %{public}u.",
+               receiverId, circularBuffer_.size(), readIndex, int32_t(type), circularBuffer_.end_index() - readIndex);
     UpdateReceiverReadIndex(receiverId, readIndex, type);
     return 0;
 }
@@ -934,7 +994,7 @@ int32_t BufferDispatcher::InputData(const MediaData::Ptr &data)
         writing_.store(true);
     }
 
-    DataSpec::Ptr dataSpec = std::make_shared<DataSpec>();
+    DataSpec::Ptr dataSpec = AcquireDataSpec();
     dataSpec->mediaData = data;
     if (dataMode_ == MEDIA_AUDIO_ONLY) {
         WriteDataIntoBuffer(dataSpec);
@@ -942,11 +1002,10 @@ int32_t BufferDispatcher::InputData(const MediaData::Ptr &data)
         PreProcessDataSpec(dataSpec);
     }
 
-    if (circularBuffer_.size() > 0) {
+    auto lastData = circularBuffer_.load(circularBuffer_.back_index());
+    if (lastData != nullptr && lastData->mediaData != nullptr) {
         MEDIA_LOGD("inputmediatype: %{public}d, keyFrame: %{public}d, pts: %{public}" PRIu64 ".",
-                   circularBuffer_[circularBuffer_.size() - 1]->mediaData->mediaType,
-                   circularBuffer_[circularBuffer_.size() - 1]->mediaData->keyFrame,
-                   circularBuffer_[circularBuffer_.size() - 1]->mediaData->pts);
+                   lastData->mediaData->mediaType, lastData->mediaData->keyFrame, lastData->mediaData->pts);
     }
 
     if (data->keyFrame) {
@@ -1065,17 +1124,23 @@ int32_t BufferDispatcher::WriteDataIntoBuffer(const DataSpec::Ptr &data)
     }
 
     data->reserveFlag = 0;
+    data->seq = circularBuffer_.end_index();
+    data->nextAudio = INVALID_INDEX;
+    data->nextVideo = INVALID_INDEX;
+    data->nextKey = INVALID_INDEX;
+    data->videoOrdinal = IsVideoData(data) ? ++videoOrdinal_ : videoOrdinal_;
     MEDIA_LOGD("WriteDataIntoBuffer data type: %{public}d, keyFrame: %{public}s, pts: %{public}" PRIu64
                ", cur_size: %{public}zu, capacity: %{public}zu dispatcher[%{public}u].",
                int32_t(data->mediaData->mediaType), data->mediaData->keyFrame ? "true" : "false", data->mediaData->pts,
                circularBuffer_.size(), circularBuffer_.capacity(), GetDispatcherId());
     circularBuffer_.push_back(data);
+    LinkDataSpec(data, circularBuffer_.back_index());
     if (IsAudioData(data)) {
-        lastAudioIndex_ = circularBuffer_.size() - 1;
+        lastAudioIndex_ = circularBuffer_.back_index();
         ActiveDataRef(MEDIA_TYPE_AUDIO, false);
         audioFrameCnt_++;
     } else {
-        lastVideoIndex_ = circularBuffer_.size() - 1;
+        lastVideoIndex_ = circularBuffer_.back_index();
         if (!keyOnly_ || IsKeyVideoFrame(data)) {
             ActiveDataRef(MEDIA_TYPE_VIDEO, IsKeyVideoFrame(data));
         }
@@ -1084,11 +1149,11 @@ int32_t BufferDispatcher::WriteDataIntoBuffer(const DataSpec::Ptr &data)
 
     if (audioNeedActivate_ && IsAudioData(data)) {
         MEDIA_LOGD("BufferDispatcher ActivateReceiverIndex By AudioData.");
-        ActivateReceiverIndex(circularBuffer_.size() - 1, MEDIA_TYPE_AUDIO);
+        ActivateReceiverIndex(circularBuffer_.back_index(), MEDIA_TYPE_AUDIO);
     }
 
     if (IsKeyVideoFrame(data)) {
-        uint32_t keyIndex = circularBuffer_.size() - 1;
+        uint32_t keyIndex = circularBuffer_.back_index();
         {
             std::lock_guard<std::mutex> indexLocker(notifyMutex_);
             keyIndexList_.push_back(keyIndex);
@@ -1120,12 +1185,12 @@ void BufferDispatcher::EraseOldGopDatas()
     uint32_t nextKey = 0;
     {
         std::lock_guard<std::mutex> lock(notifyMutex_);
-        if (!keyIndexList_.empty() && keyIndexList_.back() > 0) {
+        uint32_t oldest = circularBuffer_.begin_index();
+        if (!keyIndexList_.empty() && keyIndexList_.back() > oldest) {
             MEDIA_LOGD("find next key listsize %{public}zu, back:%{public}d.", keyIndexList_.size(),
                        keyIndexList_.back());
-            nextKey = keyIndexList_.back();
-            keyIndexList_.clear();
-            keyIndexList_.push_back(nextKey);
+            nextKey = keyIndexList_.back() - oldest;
+            keyIndexList_.erase(keyIndexList_.begin(), std::prev(keyIndexList_.end()));
         }
     }
 
@@ -1190,46 +1255,35 @@ void BufferDispatcher::DeleteHeadDatas(uint32_t size, bool forceDelete)
 void BufferDispatcher::UpdateIndex()
 {
     MEDIA_LOGD("trace.");
+    // indexes are absolute ring sequences, so eviction only has to drop the key indexes that left the ring;
+    // receiver cursors behind the head are clamped lazily by the readers themselves.
     std::lock_guard<std::mutex> locker(notifyMutex_);
-    if (!keyIndexList_.empty() && keyIndexList_.front() == 0) {
+    uint32_t oldest = circularBuffer_.begin_index();
+    while (!keyIndexList_.empty() && keyIndexList_.front() < oldest) {
         keyIndexList_.pop_front();
-        MEDIA_LOGD("BufferDispatcher pop out first  0 keyIndex after listsize %{public}zu.", keyIndexList_.size());
-    }
-
-    for (auto &keyIndex : keyIndexList_) {
-        if (keyIndex > 0) {
-            keyIndex--;
-        }
-    }
-
-    for (auto &[recvId, notifier] : notifiers_) {
-        if (notifier->videoIndex > 0 && notifier->videoIndex != INVALID_INDEX) {
-            notifier->videoIndex--;
-        }
-        if (notifier->audioIndex > 0 && notifier->audioIndex != INVALID_INDEX) {
-            notifier->audioIndex--;
-        }
-    }
-
-    if (lastVideoIndex_ > 0 && lastVideoIndex_ != INVALID_INDEX) {
-        lastVideoIndex_--;
-    }
-
-    if (lastAudioIndex_ > 0 && lastAudioIndex_ != INVALID_INDEX) {
-        lastAudioIndex_--;
+        MEDIA_LOGD("BufferDispatcher pop out evicted keyIndex after listsize %{public}zu.", keyIndexList_.size());
     }
 }
 
 uint32_t BufferDispatcher::FindNextDeleteVideoIndex()
 {
     MEDIA_LOGD("trace.");
-    for (size_t i = 0; i < circularBuffer_.size(); i++) {
-        if (circularBuffer_[i]->mediaData != nullptr && circularBuffer_[i]->mediaData->mediaType == MEDIA_TYPE_VIDEO) {
-            return i;
-        }
+    if (circularBuffer_.empty()) {
+        return 0;
     }
 
-    return 0;
+    uint32_t oldest = circularBuffer_.begin_index();
+    auto head = circularBuffer_.load(oldest);
+    if (head == nullptr || IsVideoData(head)) {
+        return 0;
+    }
+
+    uint32_t nextIndex = head->nextVideo.load(std::memory_order_acquire);
+    if (nextIndex == INVALID_INDEX || !circularBuffer_.contains(nextIndex)) {
+        return 0;
+    }
+
+    return nextIndex - oldest;
 }
 
 uint32_t BufferDispatcher::FindLastIndex(MediaType type)
@@ -1257,7 +1311,7 @@ void BufferDispatcher::UpdateReceiverReadIndex(uint32_t receiverId, const uint32
         return;
     }
 
-    bool readOver = circularBuffer_.size() - readIndex < 3;
+    bool readOver = circularBuffer_.end_index() - readIndex < 3; // 3: frames left to treat as read over
     if (readOver && notifier->NeedAcceleration() && type == MEDIA_TYPE_VIDEO) {
         SHARING_LOGD("BufferDispatcher SendAccelerationDone.");
         notifier->SendAccelerationDone();
@@ -1275,42 +1329,34 @@ void BufferDispatcher::UpdateReceiverReadIndex(uint32_t receiverId, const uint32
     }
 
     MEDIA_LOGD("After UpdateReceiverReadIndex  type %{public}d, aindex %{public}d, vindex %{public}d.", type,
-               notifier->audioIndex, notifier->videoIndex);
+               notifier->audioIndex.load(), notifier->videoIndex.load());
 }
 
 uint32_t BufferDispatcher::FindNextIndex(uint32_t index, MediaType type)
 {
     MEDIA_LOGD("trace.");
-    if ((uint64_t)index + 1 >= circularBuffer_.size() || index == INVALID_INDEX) {
+    uint32_t endIndex = circularBuffer_.end_index();
+    if (index == INVALID_INDEX || (uint64_t)index + 1 >= endIndex) {
         return index;
     }
 
     if (type == MEDIA_TYPE_AV) {
-        return index + 1;
-    }
-
-    for (size_t i = index + 1; i < circularBuffer_.size(); i++) {
-        if (circularBuffer_[i] && circularBuffer_[i]->mediaData && circularBuffer_[i]->mediaData->mediaType == type) {
-            if (keyOnly_ && type == MEDIA_TYPE_VIDEO && !IsKeyVideoFrame(circularBuffer_[i])) {
-                continue;
-            } else {
-                return i;
-            }
-        }
+        return ClampReadIndex(index + 1);
     }
 
-    return index;
+    return FindNextLinkedIndex(index, type, keyOnly_);
 }
 
 uint32_t BufferDispatcher::FindNextIndex(uint32_t index, MediaType type, uint32_t receiverId)
 {
     MEDIA_LOGD("trace.");
-    if (index + 1 >= circularBuffer_.size() || index == INVALID_INDEX) {
+    uint32_t endIndex = circularBuffer_.end_index();
+    if (index == INVALID_INDEX || (uint64_t)index + 1 >= endIndex) {
         return index;
     }
 
     if (type == MEDIA_TYPE_AV) {
-        return index + 1;
+        return ClampReadIndex(index + 1);
     }
 
     auto notifier = GetNotifierByReceiverId(receiverId);
@@ -1319,25 +1365,107 @@ uint32_t BufferDispatcher::FindNextIndex(uint32_t index, MediaType type, uint32_
         return INVALID_INDEX;
     }
 
-    bool keyModeReceiver = notifier->IsKeyModeReceiver();
-    for (size_t i = index + 1; i < circularBuffer_.size(); i++) {
-        if (circularBuffer_[i] && circularBuffer_[i]->mediaData && circularBuffer_[i]->mediaData->mediaType == type) {
-            if ((keyOnly_ || keyModeReceiver) && type == MEDIA_TYPE_VIDEO) {
-                if (!IsKeyVideoFrame(circularBuffer_[i])) {
-                    continue;
-                } else {
-                    for (size_t bIndex = index + 1; bIndex < i; bIndex++) {
-                        SetReceiverReadFlag(receiverId, circularBuffer_[bIndex]);
-                    }
-                    return i;
-                }
-            } else {
-                return i;
-            }
+    bool keyOnly = (keyOnly_ || notifier->IsKeyModeReceiver()) && type == MEDIA_TYPE_VIDEO;
+    uint32_t nextIndex = FindNextLinkedIndex(index, type, keyOnly);
+    if (keyOnly && nextIndex != index) {
+        // skipped non key frames must not hold the head reserved for this receiver
+        for (uint32_t bIndex = ClampReadIndex(index + 1); bIndex < nextIndex; bIndex++) {
+            auto skipped = circularBuffer_.load(bIndex);
+            SetReceiverReadFlag(receiverId, skipped);
         }
     }
 
-    return index;
+    return nextIndex;
+}
+
+uint32_t BufferDispatcher::FindNextLinkedIndex(uint32_t index, MediaType type, bool keyOnly)
+{
+    MEDIA_LOGD("trace.");
+    if (index == INVALID_INDEX || circularBuffer_.empty()) {
+        return index;
+    }
+
+    uint32_t nextIndex = INVALID_INDEX;
+    auto from = circularBuffer_.load(index);
+    if (from != nullptr) {
+        nextIndex = GetLinkedIndex(from, type, keyOnly);
+    } else {
+        // index already evicted: restart from the oldest data
+        uint32_t oldest = circularBuffer_.begin_index();
+        if (index >= oldest) {
+            return index;
+        }
+        auto head = circularBuffer_.load(oldest);
+        if (head == nullptr) {
+            return index;
+        }
+        if (IsLinkedType(head, type, keyOnly)) {
+            return oldest;
+        }
+        nextIndex = GetLinkedIndex(head, type, keyOnly);
+    }
+
+    if (nextIndex == INVALID_INDEX || !circularBuffer_.contains(nextIndex)) {
+        return index;
+    }
+
+    return nextIndex;
+}
+
+uint32_t BufferDispatcher::GetLinkedIndex(const DataSpec::Ptr &dataSpec, MediaType type, bool keyOnly)
+{
+    MEDIA_LOGD("trace.");
+    if (type == MEDIA_TYPE_AUDIO) {
+        return dataSpec->nextAudio.load(std::memory_order_acquire);
+    }
+
+    return keyOnly ? dataSpec->nextKey.load(std::memory_order_acquire)
+                   : dataSpec->nextVideo.load(std::memory_order_acquire);
+}
+
+bool BufferDispatcher::IsLinkedType(const DataSpec::Ptr &dataSpec, MediaType type, bool keyOnly)
+{
+    MEDIA_LOGD("trace.");
+    if (type == MEDIA_TYPE_AUDIO) {
+        return IsAudioData(dataSpec);
+    }
+
+    return keyOnly ? IsKeyVideoFrame(dataSpec) : IsVideoData(dataSpec);
+}
+
+void BufferDispatcher::LinkDataSpec(const DataSpec::Ptr &dataSpec, uint32_t index)
+{
+    MEDIA_LOGD("trace.");
+    if (IsAudioData(dataSpec)) {
+        LinkPendingIndex(audioLinkIndex_, index, MEDIA_TYPE_AUDIO, false);
+    } else if (IsVideoData(dataSpec)) {
+        LinkPendingIndex(videoLinkIndex_, index, MEDIA_TYPE_VIDEO, false);
+        if (IsKeyVideoFrame(dataSpec)) {
+            LinkPendingIndex(keyLinkIndex_, index, MEDIA_TYPE_VIDEO, true);
+        }
+    }
+}
+
+void BufferDispatcher::LinkPendingIndex(uint32_t &pendingIndex, uint32_t index, MediaType type, bool keyOnly)
+{
+    MEDIA_LOGD("trace.");
+    // every data is linked once per chain, so writes stay amortized O(1)
+    uint32_t oldest = circularBuffer_.begin_index();
+    for (uint32_t i = pendingIndex < oldest ? oldest : pendingIndex; i < index; i++) {
+        auto &dataSpec = circularBuffer_.at(i - oldest);
+        if (dataSpec == nullptr) {
+            continue;
+        }
+        if (type == MEDIA_TYPE_AUDIO) {
+            dataSpec->nextAudio.store(index, std::memory_order_release);
+        } else if (keyOnly) {
+            dataSpec->nextKey.store(index, std::memory_order_release);
+        } else {
+            dataSpec->nextVideo.store(index, std::memory_order_release);
+        }
+    }
+
+    pendingIndex = index;
 }
 
 void BufferDispatcher::ResetAllIndex()
@@ -1515,7 +1643,6 @@ void BufferDispatcher::NotifyReadReady(uint32_t receiverId, MediaType type)
         return;
     }
 
-    std::shared_lock<std::shared_mutex> lock(bufferMutex_);
     std::unique_lock<std::mutex> locker(notifyMutex_);
     if (type == MEDIA_TYPE_AV) {
         SetReceiverReadRef(receiverId, MEDIA_TYPE_VIDEO, true);
@@ -1582,7 +1709,7 @@ void BufferDispatcher::ActiveDataRef(MediaType type, bool keyFrame)
         bool keyModeReceiver = false;
         keyModeReceiver = notifier->IsKeyModeReceiver();
         if (keyFrame && keyModeReceiver && keyIndexList_.empty()) {
-            notifier->videoIndex = circularBuffer_.size() - 1;
+            notifier->videoIndex = circularBuffer_.back_index();
         }
         if (!keyModeReceiver || keyFrame) {
             if (index != INVALID_INDEX) {
@@ -1728,10 +1855,11 @@ void BufferDispatcher::ClearDataBit(uint32_t receiverId, MediaType type)
 bool BufferDispatcher::IsRead(uint32_t receiverId, uint32_t index)
 {
     MEDIA_LOGD("trace.");
-    if (index >= circularBuffer_.size()) {
+    auto dataSpec = circularBuffer_.load(index);
+    if (dataSpec == nullptr) {
         return true;
     } else {
-        return IsDataReaded(receiverId, circularBuffer_.at(index));
+        return IsDataReaded(receiverId, dataSpec);
     }
 }
 
@@ -1743,13 +1871,13 @@ void BufferDispatcher::ActivateReceiverIndex(uint32_t index, MediaType type)
         if (type == MEDIA_TYPE_VIDEO) {
             if (notifier->videoIndex == INVALID_INDEX) {
                 notifier->videoIndex = index;
-                SHARING_LOGD("RecvId %{public}d Activate %{public}d.", notifier->GetReceiverId(), notifier->videoIndex);
+                SHARING_LOGD("RecvId %{public}d Activate %{public}d.", notifier->GetReceiverId(), index);
                 videoNeedActivate_ = false;
             }
         } else {
             if (notifier->audioIndex == INVALID_INDEX) {
                 notifier->audioIndex = index;
-                SHARING_LOGD("RecvId %{public}d Activate %{public}d.", notifier->GetReceiverId(), notifier->audioIndex);
+                SHARING_LOGD("RecvId %{public}d Activate %{public}d.", notifier->GetReceiverId(), index);
                 audioNeedActivate_ = false;
             }
         }
@@ -1828,12 +1956,13 @@ void BufferDispatcher::OnKeyRedirect()
 
     for (auto &[recvId, notifier] : notifiers_) {
         if (notifier->IsKeyRedirectReceiver()) {
+            uint32_t curIndex = ClampReadIndex(notifier->videoIndex);
             SHARING_LOGD("receiverId: %{public}u, videoIndex: %{public}d, nextIndex: %{public}d.",
-                         notifier->GetReceiverId(), notifier->videoIndex, nextIndex);
-            auto curIndex = notifier->videoIndex;
+                         notifier->GetReceiverId(), curIndex, nextIndex);
             notifier->videoIndex = nextIndex;
             for (auto i = curIndex; i < nextIndex; i++) {
-                SetReceiverReadFlag(notifier->GetReceiverId(), circularBuffer_[i]);
+                auto skipped = circularBuffer_.load(i);
+                SetReceiverReadFlag(notifier->GetReceiverId(), skipped);
             }
             if (!rapidMode_) {
                 auto receiver = notifier->GetBufferReceiver();
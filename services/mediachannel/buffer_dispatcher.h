@@ -29,6 +29,7 @@
 #include "media_channel_def.h"
 #include "utils/circular_buffer.h"
 #include "utils/data_buffer.h"
+#include "utils/spmc_ring.h"
 #include "utils/timeout_timer.h"
 
 constexpr size_t INITIAL_BUFFER_CAPACITY = 500;
@@ -74,6 +75,8 @@ public:
                                    std::function<void(const MediaData::Ptr &data)> cb) = 0;
 
     virtual size_t GetBufferSize() = 0;
+    virtual uint32_t GetOldestIndex() = 0;
+    virtual uint32_t GetLatestIndex() = 0;
     virtual uint32_t GetDispatcherId() = 0;
     virtual const MediaData::Ptr GetSPS() = 0;
     virtual const MediaData::Ptr GetPPS() = 0;
@@ -205,8 +208,9 @@ public:
         BufferReceiver::Ptr GetBufferReceiver();
 
     public:
-        uint32_t audioIndex = INVALID_INDEX;
-        uint32_t videoIndex = INVALID_INDEX;
+        // absolute sequences into the dispatcher ring, not affected by head eviction
+        std::atomic<uint32_t> audioIndex = INVALID_INDEX;
+        std::atomic<uint32_t> videoIndex = INVALID_INDEX;
         std::atomic<bool> needUpdateAIndex = true;
         std::atomic<bool> needUpdateVIndex = true;
 
@@ -223,6 +227,12 @@ public:
         volatile std::atomic<uint16_t> reserveFlag;
         uint64_t seq;
         MediaData::Ptr mediaData;
+        // linked at write time to the next audio/video/key video sequence, INVALID_INDEX until it arrives
+        std::atomic<uint32_t> nextAudio = INVALID_INDEX;
+        std::atomic<uint32_t> nextVideo = INVALID_INDEX;
+        std::atomic<uint32_t> nextKey = INVALID_INDEX;
+        // video frames written up to and including this one
+        uint32_t videoOrdinal = 0;
     };
 
 public:
@@ -264,6 +274,8 @@ public:
 
     uint32_t GetCurrentGop();
     size_t GetBufferSize() override;
+    uint32_t GetOldestIndex() override;
+    uint32_t GetLatestIndex() override;
     void NotifyReadReady(uint32_t receiverId, MediaType type) override;
     int32_t ReadBufferData(uint32_t receiverId, MediaType type,
                            std::function<void(const MediaData::Ptr &data)> cb) override;
@@ -271,6 +283,7 @@ public:
     const MediaData::Ptr GetPPS() override;
     MediaData::Ptr RequestDataBuffer(MediaType type, uint32_t size);
     DataNotifier::Ptr GetNotifierByReceiverId(uint32_t receiverId);
+    void PublishNotifiers();
     DataNotifier::Ptr GetNotifierByReceiverPtr(BufferReceiver::Ptr receiver);
 
 private:
@@ -280,11 +293,18 @@ private:
     bool IsAudioData(const DataSpec::Ptr &dataSpec);
     bool IsKeyVideoFrame(const DataSpec::Ptr &dataSpec);
     bool IsDataReaded(uint32_t receiverId, DataSpec::Ptr &dataSpec);
+    uint32_t ClampReadIndex(uint32_t index);
+    DataSpec::Ptr AcquireDataSpec();
 
     uint32_t FindNextDeleteVideoIndex();
     uint32_t FindLastIndex(MediaType type);
     uint32_t FindNextIndex(uint32_t index, MediaType type);
     uint32_t FindNextIndex(uint32_t index, MediaType type, uint32_t receiverId);
+    uint32_t FindNextLinkedIndex(uint32_t index, MediaType type, bool keyOnly);
+    uint32_t GetLinkedIndex(const DataSpec::Ptr &dataSpec, MediaType type, bool keyOnly);
+    bool IsLinkedType(const DataSpec::Ptr &dataSpec, MediaType type, bool keyOnly);
+    void LinkDataSpec(const DataSpec::Ptr &dataSpec, uint32_t index);
+    void LinkPendingIndex(uint32_t &pendingIndex, uint32_t index, MediaType type, bool keyOnly);
 
     void EraseOldGopDatas();
     void ReCalculateCapacity(bool keyFrame);
@@ -328,6 +348,10 @@ private:
     uint32_t baseCounter_ = 0;
     uint32_t videoFrameCnt_ = 0;
     uint32_t audioFrameCnt_ = 0;
+    uint32_t videoOrdinal_ = 0;
+    uint32_t audioLinkIndex_ = 0;
+    uint32_t videoLinkIndex_ = 0;
+    uint32_t keyLinkIndex_ = 0;
     uint32_t maxBufferCapacity_ = MAX_BUFFER_CAPACITY;
     uint32_t baseBufferCapacity_ = INITIAL_BUFFER_CAPACITY;
     uint32_t doubleBufferCapacity_ = INITIAL_BUFFER_CAPACITY * 2;
@@ -345,8 +369,11 @@ private:
     std::weak_ptr<BufferDispatcherListener> listener_;
     std::unique_ptr<TimeoutTimer> writingTimer_ = nullptr;
     std::unordered_map<uint32_t, DataNotifier::Ptr> notifiers_;
+    // copy of notifiers_ republished under notifyMutex_, looked up by the readers without the lock
+    std::shared_ptr<const std::unordered_map<uint32_t, DataNotifier::Ptr>> notifierSnapshot_;
 
-    circular_buffer<DataSpec::Ptr> circularBuffer_;
+    spmc_ring<DataSpec> circularBuffer_;
+    circular_buffer<DataSpec::Ptr> idleDataSpec_;
     circular_buffer<MediaData::Ptr> idleVideoBuffer_;
     circular_buffer<MediaData::Ptr> idleAudioBuffer_;
 
@@ -131,6 +131,18 @@ void MediaChannel::OnProducerNotify(ProsumerStatusMsg::Ptr &msg)
             SendEvent(agentEvent);
             return;
         }
+        case PROSUMER_NOTIFY_KEY_FRAME_REQUEST:
+            if (consumer_) {
+                consumer_->RequestKeyFrame();
+            }
+            break;
+        case PROSUMER_NOTIFY_BITRATE_CHANGE: {
+            auto bitrateMsg = std::static_pointer_cast<ChannelSetBitrateEventMsg>(msg->eventMsg);
+            if (consumer_) {
+                consumer_->SetVideoBitrate(bitrateMsg->bitrate, bitrateMsg->frameRate);
+            }
+            break;
+        }
         default:
             break;
     }
@@ -35,6 +35,8 @@ enum ProsumerNotifyStatus {
     PROSUMER_NOTIFY_DESTROY_SUCCESS,
     PROSUMER_NOTIFY_ERROR,
     PROSUMER_NOTIFY_PRIVATE_EVENT,
+    PROSUMER_NOTIFY_KEY_FRAME_REQUEST,
+    PROSUMER_NOTIFY_BITRATE_CHANGE,
 };
 
 enum ProsumerOptRunningStatus {
@@ -60,6 +62,7 @@ struct MediaData {
     bool keyFrame;
     uint32_t ssrc;
     uint64_t pts;
+    int64_t arrivalUs; // GetMonotonicMicrosecond() when the frame came off the network, 0: unknown
     MediaType mediaType;
     CodecId codecId;
     AudioFormat format;
@@ -14,6 +14,9 @@
  */
 
 #include "udp_client.h"
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
 #include <unistd.h>
 #include "common/common_macro.h"
 #include "common/media_log.h"
@@ -115,12 +118,144 @@ bool UdpClient::Send(const char *buf, int32_t nSize)
     }
 }
 
+bool UdpClient::SendBatch(const std::vector<DataBuffer::Ptr> &bufs)
+{
+    MEDIA_LOGD("batch: %{public}zu.", bufs.size());
+    std::unique_lock<std::shared_mutex> lk(mutex_);
+    if (socket_ == nullptr) {
+        return false;
+    }
+
+    int32_t fd = socket_->GetLocalFd();
+    size_t sent = 0;
+    while (sent < bufs.size()) {
+        if (bufs[sent] == nullptr || bufs[sent]->Size() <= 0) {
+            sent++;
+            continue;
+        }
+
+        size_t count = gsoEnabled_ ? SendSegments(fd, bufs, sent) : 0;
+        if (count == 0) {
+            count = SendMessages(fd, bufs, sent);
+        }
+        if (count == 0) {
+            char errmsg[256] = {0};
+            strerror_r(errno, errmsg, sizeof(errmsg));
+            MEDIA_LOGE("send [%{public}s:%{public}d]Failed, %{public}s, drop %{public}zu.",
+                       GetAnonymousIp(socket_->GetPeerIp()).c_str(), (int32_t)socket_->GetPeerPort(), errmsg,
+                       bufs.size() - sent);
+            return false;
+        }
+        sent += count;
+    }
+
+    return true;
+}
+
+size_t UdpClient::SendSegments(int32_t fd, const std::vector<DataBuffer::Ptr> &bufs, size_t from)
+{
+    // one datagram per segment of segSize bytes, only the last one may be shorter
+    constexpr size_t maxGsoBytes = 65000; // 65000: below the udp payload limit
+    size_t segSize = static_cast<size_t>(bufs[from]->Size());
+    struct iovec iovs[MAX_BATCH_MESSAGES];
+    size_t count = 0;
+    size_t total = 0;
+    for (size_t i = from; i < bufs.size() && count < MAX_BATCH_MESSAGES; i++) {
+        size_t size = bufs[i] ? static_cast<size_t>(bufs[i]->Size()) : 0;
+        if (size == 0 || size > segSize || total + size > maxGsoBytes) {
+            break;
+        }
+        iovs[count].iov_base = bufs[i]->Data();
+        iovs[count].iov_len = size;
+        count++;
+        total += size;
+        if (size < segSize) {
+            break;
+        }
+    }
+
+    if (count < 2) { // 2: nothing to gain for a single datagram
+        return 0;
+    }
+
+    char control[CMSG_SPACE(sizeof(uint16_t))] = {0};
+    struct msghdr msg = {};
+    msg.msg_iov = iovs;
+    msg.msg_iovlen = count;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    *reinterpret_cast<uint16_t *>(CMSG_DATA(cmsg)) = static_cast<uint16_t>(segSize);
+
+    if (::sendmsg(fd, &msg, 0) < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            SHARING_LOGW("udp gso unavailable, errno: %{public}d.", errno);
+            gsoEnabled_ = false;
+        }
+        return 0;
+    }
+
+    return count;
+}
+
+size_t UdpClient::SendMessages(int32_t fd, const std::vector<DataBuffer::Ptr> &bufs, size_t from)
+{
+    if (!mmsgEnabled_) {
+        auto &buf = bufs[from];
+        return ::write(fd, buf->Data(), buf->Size()) != -1 ? 1 : 0;
+    }
+
+    struct mmsghdr msgs[MAX_BATCH_MESSAGES] = {};
+    struct iovec iovs[MAX_BATCH_MESSAGES];
+    uint32_t count = 0;
+    for (size_t i = from; i < bufs.size() && count < MAX_BATCH_MESSAGES; i++) {
+        // an empty buffer ends the run, SendBatch skips it
+        if (bufs[i] == nullptr || bufs[i]->Size() <= 0) {
+            break;
+        }
+        iovs[count].iov_base = bufs[i]->Data();
+        iovs[count].iov_len = static_cast<size_t>(bufs[i]->Size());
+        msgs[count].msg_hdr.msg_iov = &iovs[count];
+        msgs[count].msg_hdr.msg_iovlen = 1;
+        count++;
+    }
+
+    int32_t ret = ::sendmmsg(fd, msgs, count, 0);
+    if (ret < 0 && errno == ENOSYS) {
+        SHARING_LOGW("sendmmsg unavailable.");
+        mmsgEnabled_ = false;
+        return SendMessages(fd, bufs, from);
+    }
+
+    return ret > 0 ? static_cast<size_t>(ret) : 0;
+}
+
 bool UdpClient::Send(const std::string &msg)
 {
     SHARING_LOGD("trace.");
     return Send(msg.c_str(), msg.size());
 }
 
+bool UdpClient::SetMulticastOptions(uint8_t ttl, bool loop, const std::string &localIp)
+{
+    SHARING_LOGI("ttl: %{public}u, loop: %{public}d, localIp: %{public}s.", ttl, loop,
+                 GetAnonymousIp(localIp).c_str());
+    std::unique_lock<std::shared_mutex> lk(mutex_);
+    if (socket_ == nullptr || !SocketUtils::IsMulticastIp(socket_->GetPeerIp())) {
+        return false;
+    }
+
+    int32_t fd = socket_->GetLocalFd();
+    // without an interface the group is reached through the default route, which a p2p link usually is not
+    if (!localIp.empty() && !SocketUtils::SetMulticastIf(fd, localIp)) {
+        return false;
+    }
+    return SocketUtils::SetMulticastTtl(fd, ttl) && SocketUtils::SetMulticastLoop(fd, loop);
+}
+
 SocketInfo::Ptr UdpClient::GetSocketInfo()
 {
     SHARING_LOGD("trace.");
@@ -132,7 +267,7 @@ void UdpClient::OnClientReadable(int32_t fd)
     MEDIA_LOGI("fd: %{public}d, thread_id: %{public}llu.", fd, GetThreadId());
     ssize_t retCode = 0;
     do {
-        DataBuffer::Ptr buf = std::make_shared<DataBuffer>(DEFAULT_READ_BUFFER_SIZE);
+        DataBuffer::Ptr buf = DataBuffer::CreatePooled(DEFAULT_READ_BUFFER_SIZE);
         retCode = read(fd, buf->Data(), DEFAULT_READ_BUFFER_SIZE);
         MEDIA_LOGD("recvSocket len: %{public}d.", static_cast<int32_t>(retCode));
         if (retCode > 0) {
@@ -35,16 +35,27 @@ public:
     bool Send(const std::string &msg) override;
     bool Send(const char *buf, int32_t nSize) override;
     bool Send(const DataBuffer::Ptr &buf, int32_t nSize) override;
+    bool SendBatch(const std::vector<DataBuffer::Ptr> &bufs) override;
 
     void Disconnect() override;
     bool Connect(const std::string &peerHost, uint16_t peerPort, const std::string &localIp,
                  uint16_t localPort) override;
 
+    bool SetMulticastOptions(uint8_t ttl, bool loop, const std::string &localIp) override;
     SocketInfo::Ptr GetSocketInfo() override;
 
     void OnClientReadable(int32_t fd) override;
 
 private:
+    size_t SendSegments(int32_t fd, const std::vector<DataBuffer::Ptr> &bufs, size_t from);
+    size_t SendMessages(int32_t fd, const std::vector<DataBuffer::Ptr> &bufs, size_t from);
+
+private:
+    static constexpr size_t MAX_BATCH_MESSAGES = 64; // also the kernel limit of udp gso segments
+
+    // cleared once the kernel rejects UDP_SEGMENT, sendmmsg is used from then on
+    bool gsoEnabled_ = true;
+    bool mmsgEnabled_ = true;
     std::shared_mutex mutex_;
     std::shared_ptr<UdpSocket> socket_ = nullptr;
 };
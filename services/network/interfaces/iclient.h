@@ -17,6 +17,7 @@
 #define OHOS_SHARING_ICLIENT_H
 
 #include <cstdint>
+#include <vector>
 #include "iclient_callback.h"
 #include "network/data/socket_info.h"
 
@@ -37,6 +38,23 @@ public:
     virtual bool Send(const char *buf, int32_t nSize) = 0;
     virtual bool Send(const DataBuffer::Ptr &buf, int32_t nSize) = 0;
 
+    // sends every buffer as one message, in order
+    virtual bool SendBatch(const std::vector<DataBuffer::Ptr> &bufs)
+    {
+        for (auto &buf : bufs) {
+            if (buf == nullptr || !Send(buf, buf->Size())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ttl, loopback and outgoing interface when the peer is a multicast group, false otherwise
+    virtual bool SetMulticastOptions(uint8_t ttl, bool loop, const std::string &localIp)
+    {
+        return false;
+    }
+
     virtual SocketInfo::Ptr GetSocketInfo() = 0;
     virtual void SetRecvOption(int32_t flags) = 0;
     virtual void RegisterCallback(std::weak_ptr<IClientCallback> callback) = 0;
@@ -17,6 +17,7 @@
 #define OHOS_SHARING_ISERVER_H
 
 #include <cstdint>
+#include <functional>
 #include <string>
 #include "iserver_callback.h"
 #include "network/data/socket_info.h"
@@ -38,6 +39,23 @@ public:
 
     virtual std::weak_ptr<IServerCallback> &GetCallback() = 0;
     virtual void RegisterCallback(std::weak_ptr<IServerCallback> callback) = 0;
+
+    // membership of the listening socket, it has to be bound to the any address to see the group's datagrams
+    virtual bool JoinMulticastGroup(const std::string &group, const std::string &localIp)
+    {
+        return false;
+    }
+
+    virtual bool LeaveMulticastGroup(const std::string &group, const std::string &localIp)
+    {
+        return false;
+    }
+
+    // runs task on the thread that serves the socket, false if there is none
+    virtual bool PostTask(const std::function<void()> &task, int64_t delayMs = 0)
+    {
+        return false;
+    }
 };
 } // namespace Sharing
 } // namespace OHOS
@@ -17,6 +17,7 @@
 #define OHOS_SHARING_ISERVER_CALLBACK_H
 
 #include <memory>
+#include <vector>
 #include "inetwork_session.h"
 
 namespace OHOS {
@@ -33,6 +34,15 @@ public:
     virtual void OnServerException(int32_t fd) = 0;
     virtual void OnAccept(std::weak_ptr<INetworkSession> session) = 0;
     virtual void OnServerReadData(int32_t fd, DataBuffer::Ptr buf, INetworkSession::Ptr session = nullptr) = 0;
+
+    // datagrams received in one batch from the same peer, in arrival order
+    virtual void OnServerReadBatch(int32_t fd, std::vector<DataBuffer::Ptr> &bufs,
+                                   INetworkSession::Ptr session = nullptr)
+    {
+        for (auto &buf : bufs) {
+            OnServerReadData(fd, std::move(buf), session);
+        }
+    }
 };
 } // namespace Sharing
 } // namespace OHOS
@@ -35,6 +35,15 @@ void BaseServer::RegisterCallback(std::weak_ptr<IServerCallback> callback)
     callback_ = callback;
 }
 
+bool BaseServer::PostTask(const std::function<void()> &task, int64_t delayMs)
+{
+    if (eventHandler_ == nullptr || task == nullptr) {
+        return false;
+    }
+
+    return eventHandler_->PostTask(task, delayMs);
+}
+
 std::weak_ptr<IServerCallback> &BaseServer::GetCallback()
 {
     MEDIA_LOGD("trace.");
@@ -85,6 +85,7 @@ public:
 
     std::weak_ptr<IServerCallback> &GetCallback() override;
     void RegisterCallback(std::weak_ptr<IServerCallback> callback) override;
+    bool PostTask(const std::function<void()> &task, int64_t delayMs = 0) override;
 
     virtual void OnServerReadable(int32_t fd) {}
 
@@ -68,6 +68,7 @@ void UdpServer::Stop()
 {
     SHARING_LOGD("stop.");
     std::unique_lock<std::shared_mutex> lk(mutex_);
+    sessionGeneration_.fetch_add(1, std::memory_order_release);
 
     for (auto kv : sessionMap_) {
         if (kv.second) {
@@ -96,6 +97,7 @@ void UdpServer::CloseClientSocket(int32_t fd)
 {
     SHARING_LOGD("fd: %{public}d.", fd);
     std::unique_lock<std::shared_mutex> lk(mutex_);
+    sessionGeneration_.fetch_add(1, std::memory_order_release);
     if (fd > 0) {
         auto itemItr = sessionMap_.find(fd);
         if (itemItr != sessionMap_.end()) {
@@ -110,6 +112,29 @@ void UdpServer::CloseClientSocket(int32_t fd)
     }
 }
 
+bool UdpServer::JoinMulticastGroup(const std::string &group, const std::string &localIp)
+{
+    SHARING_LOGI("group: %{public}s, localIp: %{public}s.", GetAnonymousIp(group).c_str(),
+                 GetAnonymousIp(localIp).c_str());
+    std::shared_lock<std::shared_mutex> lk(mutex_);
+    if (socket_ == nullptr) {
+        return false;
+    }
+
+    return SocketUtils::JoinMulticastGroup(socket_->GetLocalFd(), group, localIp);
+}
+
+bool UdpServer::LeaveMulticastGroup(const std::string &group, const std::string &localIp)
+{
+    SHARING_LOGI("group: %{public}s.", GetAnonymousIp(group).c_str());
+    std::shared_lock<std::shared_mutex> lk(mutex_);
+    if (socket_ == nullptr) {
+        return false;
+    }
+
+    return SocketUtils::LeaveMulticastGroup(socket_->GetLocalFd(), group, localIp);
+}
+
 void UdpServer::OnServerReadable(int32_t fd)
 {
     MEDIA_LOGD("fd: %{public}d, thread_id: %{public}llu tid:%{public}d", fd, GetThreadId(), gettid());
@@ -131,57 +156,117 @@ void UdpServer::OnServerReadable(int32_t fd)
         return;
     }
 
-    int32_t retry = 0;
-    int32_t retCode = 0;
-    bool firstRead = true;
-    bool reading = true;
-    while (reading) {
-        DataBuffer::Ptr buf = std::make_shared<DataBuffer>(DEFAULT_READ_BUFFER_SIZE);
-        struct sockaddr_in clientAddr;
-        socklen_t len = sizeof(struct sockaddr_in);
-        retCode = ::recvfrom(fd, buf->Data(), DEFAULT_READ_BUFFER_SIZE, 0, (struct sockaddr *)&clientAddr, &len);
-        MEDIA_LOGD("recvSocket len: %{public}d,address: %{public}s,port: %{public}d,socklen: %{public}d.", retCode,
-                   inet_ntoa(clientAddr.sin_addr), clientAddr.sin_port, len);
-
-        if (retCode < 0) {
-            if (errno != EAGAIN) {
+    while (true) {
+        int32_t count = ReceiveBatch(fd);
+        if (count < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
                 char errmsg[256] = {0};
                 strerror_r(errno, errmsg, sizeof(errmsg));
                 MEDIA_LOGD("on read data error %{public}d : %{public}s!", errno, errmsg);
                 callback->OnServerException(fd);
-                break;
-            }
-
-            if (firstRead && retry < 5) { // 5: retry 5 times
-                char errmsg[256] = {0};
-                strerror_r(errno, errmsg, sizeof(errmsg));
-                SHARING_LOGE("first read error %{public}d : %{public}s retry: %{public}d", errno, errmsg,
-                             retry);
-                usleep(1000 * 5); // 1000 * 5: sleep 1000 * 5 millionseconds
-                retry++;
-                continue;
             }
             break;
         }
-
-        if (retCode > 0) {
-            firstRead = false;
-            buf->UpdateSize(retCode);
-            BaseNetworkSession::Ptr session = FindOrCreateSession(clientAddr);
-            if (session) {
-                callback->OnServerReadData(fd, std::move(buf), session);
-            }
-        } else {
-            char errmsg[256] = {0};
-            strerror_r(errno, errmsg, sizeof(errmsg));
-            SHARING_LOGE("onReadable error: %{public}s!", errmsg);
+        if (count == 0) {
             break;
         }
+
+        MEDIA_LOGD("recvSocket batch: %{public}d.", count);
+        DeliverBatch(fd, count, callback);
     }
 
     MEDIA_LOGE("fd: %{public}d, thread_id: %{public}llu tid:%{public}d exit.", fd, GetThreadId(), gettid());
 }
 
+int32_t UdpServer::ReceiveBatch(int32_t fd)
+{
+    if (readBuffers_.empty()) {
+        readBuffers_.resize(RECV_BATCH_SIZE);
+        readMsgs_.resize(RECV_BATCH_SIZE);
+        readIovs_.resize(RECV_BATCH_SIZE);
+        readAddrs_.resize(RECV_BATCH_SIZE);
+    }
+
+    uint32_t vlen = 0;
+    for (; vlen < RECV_BATCH_SIZE; vlen++) {
+        // slots handed out by the previous batch are refilled, the others are reused
+        auto &buf = readBuffers_[vlen];
+        if (buf == nullptr) {
+            buf = DataBuffer::CreatePooled(DEFAULT_READ_BUFFER_SIZE);
+            if (buf == nullptr || buf->Data() == nullptr) {
+                buf = nullptr;
+                break;
+            }
+        }
+
+        readIovs_[vlen].iov_base = buf->Data();
+        readIovs_[vlen].iov_len = DEFAULT_READ_BUFFER_SIZE;
+        struct msghdr &hdr = readMsgs_[vlen].msg_hdr;
+        (void)memset_s(&hdr, sizeof(hdr), 0, sizeof(hdr));
+        hdr.msg_name = &readAddrs_[vlen];
+        hdr.msg_namelen = sizeof(struct sockaddr_in);
+        hdr.msg_iov = &readIovs_[vlen];
+        hdr.msg_iovlen = 1;
+        readMsgs_[vlen].msg_len = 0;
+    }
+
+    if (vlen == 0) {
+        SHARING_LOGE("no read buffer!");
+        errno = ENOMEM;
+        return -1;
+    }
+
+    return ::recvmmsg(fd, readMsgs_.data(), vlen, 0, nullptr);
+}
+
+void UdpServer::DeliverBatch(int32_t fd, int32_t count, const std::shared_ptr<IServerCallback> &callback)
+{
+    std::vector<DataBuffer::Ptr> batch;
+    batch.reserve(count);
+    BaseNetworkSession::Ptr batchSession = nullptr;
+    for (int32_t i = 0; i < count; i++) {
+        if (readMsgs_[i].msg_len == 0) {
+            continue;
+        }
+
+        auto session = FindCachedSession(readAddrs_[i]);
+        if (session == nullptr) {
+            continue;
+        }
+
+        // one callback per run of datagrams from the same peer
+        if (session != batchSession && !batch.empty()) {
+            callback->OnServerReadBatch(fd, batch, batchSession);
+            batch.clear();
+        }
+        batchSession = session;
+        readBuffers_[i]->UpdateSize(static_cast<int32_t>(readMsgs_[i].msg_len));
+        batch.push_back(std::move(readBuffers_[i]));
+    }
+
+    if (!batch.empty()) {
+        callback->OnServerReadBatch(fd, batch, batchSession);
+    }
+}
+
+std::shared_ptr<BaseNetworkSession> UdpServer::FindCachedSession(const struct sockaddr_in &addr)
+{
+    uint32_t generation = sessionGeneration_.load(std::memory_order_acquire);
+    if (generation != lastPeerGeneration_) {
+        lastPeerSession_ = nullptr;
+        lastPeerGeneration_ = generation;
+    }
+
+    if (lastPeerSession_ != nullptr && lastPeerAddr_.sin_addr.s_addr == addr.sin_addr.s_addr &&
+        lastPeerAddr_.sin_port == addr.sin_port) {
+        return lastPeerSession_;
+    }
+
+    lastPeerSession_ = FindOrCreateSession(addr);
+    lastPeerAddr_ = addr;
+    return lastPeerSession_;
+}
+
 std::shared_ptr<BaseNetworkSession> UdpServer::FindOrCreateSession(const struct sockaddr_in &addr)
 {
     MEDIA_LOGD("trace.");
@@ -16,7 +16,11 @@
 #ifndef OHOS_SHARING_UDP_SERVER_H
 #define OHOS_SHARING_UDP_SERVER_H
 
+#include <atomic>
+#include <netinet/in.h>
 #include <shared_mutex>
+#include <sys/socket.h>
+#include <vector>
 #include "base_server.h"
 
 namespace OHOS {
@@ -40,13 +44,35 @@ public:
     SocketInfo::Ptr GetSocketInfo() override;
     void CloseClientSocket(int32_t fd) override;
 
+    bool JoinMulticastGroup(const std::string &group, const std::string &localIp) override;
+    bool LeaveMulticastGroup(const std::string &group, const std::string &localIp) override;
+
     void OnServerReadable(int32_t fd) override;
 
 private:
     bool BindAndConnectClinetFd(int32_t fd, const struct sockaddr_in &addr);
     std::shared_ptr<BaseNetworkSession> FindOrCreateSession(const struct sockaddr_in &addr);
+    std::shared_ptr<BaseNetworkSession> FindCachedSession(const struct sockaddr_in &addr);
+
+    int32_t ReceiveBatch(int32_t fd);
+    void DeliverBatch(int32_t fd, int32_t count, const std::shared_ptr<IServerCallback> &callback);
 
 private:
+    static constexpr int32_t RECV_BATCH_SIZE = 32;
+
+    // recvmmsg state, only touched by the reading thread
+    std::vector<DataBuffer::Ptr> readBuffers_;
+    std::vector<struct mmsghdr> readMsgs_;
+    std::vector<struct iovec> readIovs_;
+    std::vector<struct sockaddr_in> readAddrs_;
+
+    // peer cache, also confined to the reading thread
+    struct sockaddr_in lastPeerAddr_ {};
+    std::shared_ptr<BaseNetworkSession> lastPeerSession_ = nullptr;
+    uint32_t lastPeerGeneration_ = 0;
+    // bumped when sessions are closed, the reading thread drops its cached peer when it changes
+    std::atomic<uint32_t> sessionGeneration_ = 0;
+
     std::shared_mutex mutex_;
     std::shared_ptr<UdpSocket> socket_ = nullptr;
     std::map<int32_t, std::shared_ptr<BaseNetworkSession>> sessionMap_;
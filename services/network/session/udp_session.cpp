@@ -115,7 +115,7 @@ void UdpSession::OnSessionReadble(int32_t fd)
     if (fd == socket_->GetLocalFd()) {
         int32_t retCode = 0;
         do {
-            DataBuffer::Ptr buf = std::make_shared<DataBuffer>(DEFAULT_READ_BUFFER_SIZE);
+            DataBuffer::Ptr buf = DataBuffer::CreatePooled(DEFAULT_READ_BUFFER_SIZE);
             struct sockaddr_in clientAddr;
             socklen_t len = sizeof(struct sockaddr_in);
             retCode = ::recvfrom(fd, buf->Data(), DEFAULT_READ_BUFFER_SIZE, 0, (struct sockaddr *)&clientAddr, &len);
@@ -394,6 +394,99 @@ bool SocketUtils::SetRecvBuf(int32_t fd, int32_t size)
     return true;
 }
 
+bool SocketUtils::IsMulticastIp(const std::string &ip)
+{
+    struct in_addr addr = {};
+    if (inet_pton(AF_INET, ip.c_str(), &addr) <= 0) {
+        return false;
+    }
+
+    return IN_MULTICAST(ntohl(addr.s_addr));
+}
+
+bool SocketUtils::SetMulticastTtl(int32_t fd, uint8_t ttl)
+{
+    SHARING_LOGD("trace.");
+    if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0) {
+        char errmsg[ERRNO_MAX_LEN] = {0};
+        strerror_r(errno, errmsg, ERRNO_MAX_LEN);
+        SHARING_LOGE("error: %{public}s!", errmsg);
+        return false;
+    }
+
+    return true;
+}
+
+bool SocketUtils::SetMulticastIf(int32_t fd, const std::string &localIp)
+{
+    SHARING_LOGD("trace.");
+    struct in_addr addr = {};
+    if (inet_pton(AF_INET, localIp.c_str(), &addr) <= 0) {
+        SHARING_LOGE("invalid interface ip: %{public}s!", GetAnonymousIp(localIp).c_str());
+        return false;
+    }
+
+    if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &addr, sizeof(addr)) != 0) {
+        char errmsg[ERRNO_MAX_LEN] = {0};
+        strerror_r(errno, errmsg, ERRNO_MAX_LEN);
+        SHARING_LOGE("error: %{public}s!", errmsg);
+        return false;
+    }
+
+    return true;
+}
+
+bool SocketUtils::SetMulticastLoop(int32_t fd, bool isOn)
+{
+    SHARING_LOGD("trace.");
+    uint8_t on = isOn ? 1 : 0;
+    if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &on, sizeof(on)) != 0) {
+        char errmsg[ERRNO_MAX_LEN] = {0};
+        strerror_r(errno, errmsg, ERRNO_MAX_LEN);
+        SHARING_LOGE("error: %{public}s!", errmsg);
+        return false;
+    }
+
+    return true;
+}
+
+static bool SetMulticastMembership(int32_t fd, int32_t option, const std::string &group, const std::string &localIp)
+{
+    struct ip_mreq mreq = {};
+    if (inet_pton(AF_INET, group.c_str(), &mreq.imr_multiaddr) <= 0 ||
+        !IN_MULTICAST(ntohl(mreq.imr_multiaddr.s_addr))) {
+        SHARING_LOGE("invalid group: %{public}s!", GetAnonymousIp(group).c_str());
+        return false;
+    }
+    // empty: the kernel picks the interface by the route to the group
+    mreq.imr_interface.s_addr = INADDR_ANY;
+    if (!localIp.empty() && inet_pton(AF_INET, localIp.c_str(), &mreq.imr_interface) <= 0) {
+        SHARING_LOGE("invalid interface ip: %{public}s!", GetAnonymousIp(localIp).c_str());
+        return false;
+    }
+
+    if (setsockopt(fd, IPPROTO_IP, option, &mreq, sizeof(mreq)) != 0) {
+        char errmsg[ERRNO_MAX_LEN] = {0};
+        strerror_r(errno, errmsg, ERRNO_MAX_LEN);
+        SHARING_LOGE("error: %{public}s!", errmsg);
+        return false;
+    }
+
+    return true;
+}
+
+bool SocketUtils::JoinMulticastGroup(int32_t fd, const std::string &group, const std::string &localIp)
+{
+    SHARING_LOGD("trace.");
+    return SetMulticastMembership(fd, IP_ADD_MEMBERSHIP, group, localIp);
+}
+
+bool SocketUtils::LeaveMulticastGroup(int32_t fd, const std::string &group, const std::string &localIp)
+{
+    SHARING_LOGD("trace.");
+    return SetMulticastMembership(fd, IP_DROP_MEMBERSHIP, group, localIp);
+}
+
 void SocketUtils::CloseSocket(int32_t fd)
 {
     SHARING_LOGD("trace.");
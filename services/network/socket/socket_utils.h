@@ -46,6 +46,13 @@ public:
     static bool SetRecvBuf(int32_t fd, int32_t size = SOCKET_DEFAULT_BUF_SIZE);
     static bool SetNonBlocking(int32_t fd, bool isNonBlock = true, uint32_t write_timeout = 0);
 
+    static bool IsMulticastIp(const std::string &ip);
+    static bool SetMulticastTtl(int32_t fd, uint8_t ttl);
+    static bool SetMulticastIf(int32_t fd, const std::string &localIp);
+    static bool SetMulticastLoop(int32_t fd, bool isOn);
+    static bool JoinMulticastGroup(int32_t fd, const std::string &group, const std::string &localIp = "");
+    static bool LeaveMulticastGroup(int32_t fd, const std::string &group, const std::string &localIp = "");
+
     static int32_t ReadSocket(int32_t fd, DataBuffer::Ptr buf, int32_t &error);
     static int32_t ReadSocket(int32_t fd, char *buf, uint32_t len, int32_t &error);
 
@@ -17,6 +17,18 @@
 
 namespace OHOS {
 namespace Sharing {
+size_t AdtsHeaderSize(const uint8_t *ptr, size_t len)
+{
+    if (ptr == nullptr || len < 7) { // 7:adts header without crc
+        return 0;
+    }
+    if (ptr[0] != 0xFF || (ptr[1] & 0xF0) != 0xF0) { // 12 bit syncword
+        return 0;
+    }
+    size_t size = (ptr[1] & 0x01) ? 7 : 9; // protection_absent, 7:no crc, 9:2 bytes crc
+    return size < len ? size : 0;
+}
+
 AACFrame::AACFrame(uint8_t *ptr, size_t size, uint32_t dts, uint64_t pts, size_t prefix_size)
 {
     this->Assign((char *)ptr, (int32_t)size);
@@ -23,6 +23,9 @@
 
 namespace OHOS {
 namespace Sharing {
+// 7, 9 with crc; 0 when ptr does not start with an adts header
+size_t AdtsHeaderSize(const uint8_t *ptr, size_t len);
+
 class AACFrame : public FrameImpl {
 public:
     using Ptr = std::shared_ptr<AACFrame>;
@@ -135,6 +135,46 @@ public:
     size_t prefixSize_ = 0;
     CodecId codecId_ = CODEC_NONE;
 };
+
+/**
+ * Read-only frame that references (a range of) a shared buffer instead of
+ * owning a copy. The referenced buffer is kept alive as long as the frame and
+ * must not be modified by its owner meanwhile.
+ */
+template <typename Parent>
+class SharedFrame : public Parent {
+public:
+    using Ptr = std::shared_ptr<SharedFrame>;
+
+    explicit SharedFrame(const DataBuffer::Ptr &buffer) : SharedFrame(buffer, 0, buffer ? buffer->Size() : 0) {}
+    SharedFrame(const DataBuffer::Ptr &buffer, size_t offset, int32_t size)
+        : buffer_(buffer), offset_(offset), size_(buffer ? size : 0)
+    {
+    }
+    ~SharedFrame() override = default;
+
+    uint8_t *Data() override
+    {
+        return (buffer_ && buffer_->Data()) ? buffer_->Data() + offset_ : nullptr;
+    }
+
+    int32_t Size() const override
+    {
+        return size_;
+    }
+
+    void Clear() override
+    {
+        buffer_ = nullptr;
+        offset_ = 0;
+        size_ = 0;
+    }
+
+private:
+    DataBuffer::Ptr buffer_ = nullptr;
+    size_t offset_ = 0;
+    int32_t size_ = 0;
+};
 } // namespace Sharing
 } // namespace OHOS
 #endif
\ No newline at end of file
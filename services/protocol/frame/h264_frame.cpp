@@ -17,6 +17,14 @@
 #include "common/common_macro.h"
 #include "common/sharing_log.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 namespace OHOS {
 namespace Sharing {
 size_t PrefixSize(const char *ptr, size_t len)
@@ -41,19 +49,68 @@ size_t PrefixSize(const char *ptr, size_t len)
     return 0;
 }
 
-static const char *MemFind(const char *buf, ssize_t len, const char *subBuf, ssize_t subLen)
+const char *FindStartCode(const char *begin, const char *end)
 {
-    if (buf == nullptr || subBuf == nullptr) {
-        return NULL;
+    if (begin == nullptr || end == nullptr || end - begin < 3) { // 3: 00 00 01
+        return nullptr;
+    }
+
+    auto p = reinterpret_cast<const uint8_t *>(begin);
+    // a start code must begin before last
+    auto last = reinterpret_cast<const uint8_t *>(end) - 2; // 2: bytes after the first zero
+
+    // compare the block at p, p + 1 and p + 2 at once, the first block with a hit
+    // is resolved by the scalar loop below.
+#if defined(__AVX2__)
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    for (; last - p >= 32; p += 32) { // 32: bytes per block
+        __m256i b0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)), zero);
+        __m256i b1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 1)), zero);
+        __m256i b2 = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 2)), one);
+        if (_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(b0, b1), b2)) != 0) {
+            break;
+        }
+    }
+#elif defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    for (; last - p >= 16; p += 16) { // 16: bytes per block
+        __m128i b0 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)), zero);
+        __m128i b1 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 1)), zero);
+        __m128i b2 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 2)), one);
+        if (_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(b0, b1), b2)) != 0) {
+            break;
+        }
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t one = vdupq_n_u8(1);
+    for (; last - p >= 16; p += 16) { // 16: bytes per block
+        uint8x16_t b0 = vceqq_u8(vld1q_u8(p), zero);
+        uint8x16_t b1 = vceqq_u8(vld1q_u8(p + 1), zero);
+        uint8x16_t b2 = vceqq_u8(vld1q_u8(p + 2), one);
+        uint64x2_t hit = vreinterpretq_u64_u8(vandq_u8(vandq_u8(b0, b1), b2));
+        if ((vgetq_lane_u64(hit, 0) | vgetq_lane_u64(hit, 1)) != 0) {
+            break;
+        }
     }
+#endif
 
-    for (auto i = 0; i < len - subLen; ++i) {
-        if (memcmp(buf + i, subBuf, subLen) == 0) {
-            return buf + i;
+    // scalar: p[2] decides how far we may skip
+    while (p < last) {
+        if (p[2] > 1) {                      // 2: byte offset
+            p += 3;                          // 3: none can start at p, p + 1 or p + 2
+        } else if (p[1] != 0) {
+            p += 2;                          // 2: none can start at p or p + 1
+        } else if (p[0] != 0 || p[2] != 1) { // 2: byte offset
+            p++;
+        } else {
+            return reinterpret_cast<const char *>(p);
         }
     }
 
-    return NULL;
+    return nullptr;
 }
 
 void SplitH264(const char *ptr, size_t len, size_t prefix, const std::function<void(const char *, size_t, size_t)> &cb)
@@ -67,7 +124,7 @@ void SplitH264(const char *ptr, size_t len, size_t prefix, const std::function<v
     auto end = ptr + len;
     size_t nextPrefix;
     while (true) {
-        auto nextStart = MemFind(start, end - start, "\x00\x00\x01", 3);
+        auto nextStart = FindStartCode(start, end);
         if (nextStart) {
             if ((nextStart > start) && *(nextStart - 1) == 0x00) {
                 nextStart -= 1;
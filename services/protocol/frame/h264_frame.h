@@ -27,6 +27,8 @@ namespace Sharing {
 #define H264_TYPE(v) ((uint8_t)(v)&0x1F)
 
 size_t PrefixSize(const char *ptr, size_t len);
+// first 00 00 01 in [begin, end), nullptr if there is none
+const char *FindStartCode(const char *begin, const char *end);
 void SplitH264(const char *ptr, size_t len, size_t prefix, const std::function<void(const char *, size_t, size_t)> &cb);
 // template <typename Parent>
 class H264Frame : public FrameImpl {
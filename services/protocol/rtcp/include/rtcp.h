@@ -42,33 +42,45 @@ public:
     int32_t GetSize() const;
     int32_t GetPaddingSize() const;
 
+    // splits a compound packet, returns nothing if any of its headers is malformed
+    static std::vector<RtcpHeader *> LoadFromBytes(uint8_t *data, size_t size);
+
 public:
-    uint8_t pt_;
-    uint8_t padding_ : 1;
+#if __BYTE_ORDER == __BIG_ENDIAN
     uint8_t version_ : 2;
+    uint8_t padding_ : 1;
     uint8_t reportCount_ : 5;
+#else
+    uint8_t reportCount_ : 5;
+    uint8_t padding_ : 1;
+    uint8_t version_ : 2;
+#endif
+    uint8_t pt_;
 
 private:
     uint16_t length_;
 };
 
-// ReportBlock
+// ReportBlock, fields in wire order
 struct ReportItem {
 public:
-    // Highest sequence number received
-    uint16_t seqMax_;
-    // Sequence number cycles count
-    uint16_t seqCycles_;
+    void SetCumulative(uint32_t lost);
+    uint32_t GetCumulative() const;
 
+public:
     uint32_t ssrc_;
+    // Packet loss rate (percentage) * 256
+    uint8_t fractionLost_;
+    // Cumulative number of packets lost, 24 bits big endian
+    uint8_t cumulative_[3];
+    // Sequence number cycles count
+    uint16_t seqCycles_;
+    // Highest sequence number received
+    uint16_t seqMax_;
     // Interarrival jitter
     uint32_t jitter_;
     // Last SR timestamp, NTP timestamp,(ntpmsw & 0xFFFF) << 16  | (ntplsw >> 16) & 0xFFFF)
     uint32_t lastSrStamp_;
-    // Cumulative number of packets lost
-    uint32_t cumulative_ : 24;
-    // Packet loss rate (percentage) * 256
-    uint32_t fractionLost_ : 8;
     // Delay since last SR timestamp,expressed in units of 1/65536 seconds
     uint32_t delaySinceLastSr_;
 };
@@ -134,16 +146,16 @@ public:
 
 public:
     uint32_t ssrc_;
-    // rtp timestamp
-    uint32_t rtpts_;
     // ntp timestamp MSW(in second)
     uint32_t ntpmsw_;
     // ntp timestamp LSW(in picosecond)
     uint32_t ntplsw_;
-    // sender octet count
-    uint32_t octetCount_;
+    // rtp timestamp
+    uint32_t rtpts_;
     // sender packet count
     uint32_t packetCount_;
+    // sender octet count
+    uint32_t octetCount_;
 
     ReportItem items_;
 };
@@ -273,10 +285,18 @@ struct RtcpFB : public RtcpHeader {
 public:
     int32_t GetFciSize() const;
     const uint8_t *GetFciPtr() const;
+    // lost sequence numbers of a generic nack, empty for any other feedback
+    std::vector<uint16_t> GetNackSeqs() const;
+    // true for a pli or a fir asking the sender of ssrcMedia for a key frame
+    bool IsKeyFrameRequest(uint32_t ssrcMedia) const;
     // for psfb fb
     static std::shared_ptr<RtcpFB> Create(PsfbType fmt, const void *fci = nullptr, size_t fci_len = 0);
     // for rtpfb fb
     static std::shared_ptr<RtcpFB> Create(RtpfbType fmt, const void *fci = nullptr, size_t fci_len = 0);
+    // generic nack of seqs, in ascending order modulo 2^16
+    static std::shared_ptr<RtcpFB> CreateNack(uint32_t ssrc, uint32_t ssrcMedia, const std::vector<uint16_t> &seqs);
+    // picture loss indication, no fci
+    static std::shared_ptr<RtcpFB> CreatePli(uint32_t ssrc, uint32_t ssrcMedia);
 
 private:
     static std::shared_ptr<RtcpFB> CreateInner(RtcpType type, int32_t fmt, const void *fci, size_t fci_len);
@@ -286,6 +306,45 @@ public:
     uint32_t ssrcMedia_;
 };
 
+/*
+    Generic NACK FCI, RFC 4585 6.2.1
+
+        0                   1                   2                   3
+        0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+       +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+       |            PID                |             BLP               |
+       +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+
+    PID: seq of the first lost packet, BLP: bit i set if PID + i + 1 is lost too
+*/
+
+struct RtcpNackItem {
+public:
+    static constexpr size_t BLP_BITS = 16;
+
+    uint16_t pid_;
+    uint16_t blp_;
+};
+
+/*
+    Full Intra Request FCI, RFC 5104 4.3.1, the media ssrc of the common header is 0
+
+        0                   1                   2                   3
+        0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+       +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+       |                              SSRC                             |
+       +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+       | Seq nr.       |    Reserved                                   |
+       +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+*/
+
+struct RtcpFirItem {
+public:
+    uint32_t ssrc_;
+    uint8_t seq_;
+    uint8_t reserved_[3];
+};
+
 //------------------------------ RtcpBye ------------------------------//
 
 /*
@@ -352,11 +411,16 @@ public:
 // XR - Receiver Reference Time Report
 struct RtcpXRRRTR : public RtcpHeader {
 public:
+    static std::shared_ptr<RtcpXRRRTR> Create(uint32_t ssrc, uint64_t unixStampMs);
+    // middle 32 bits of the ntp timestamp, echoed back as the lrr of a dlrr block
+    uint32_t GetLrr() const;
+
+public:
+    uint32_t ssrc_;
+
     uint8_t bt_ = 4;
     uint8_t reserved_;
     uint16_t blockLength_ = 0x0200; // = htons(2)
-
-    uint32_t ssrc_;
     // ntp timestamp MSW(in second)
     uint32_t ntpmsw_;
     // ntp timestamp LSW(in picosecond)
@@ -387,8 +451,8 @@ public:
 
 struct RtcpXRDLRRReportItem {
 public:
-    uint32_t lrr_;
     uint32_t ssrc_;
+    uint32_t lrr_;
     uint32_t dlrr_;
 };
 
@@ -399,10 +463,11 @@ public:
     static std::shared_ptr<RtcpXRDLRR> Create(size_t itemCount);
 
 public:
+    uint32_t ssrc_;
+
     uint8_t bt_;
     uint8_t reserved_;
     uint16_t blockLength_;
-    uint32_t ssrc_;
 
     RtcpXRDLRRReportItem items_;
 };
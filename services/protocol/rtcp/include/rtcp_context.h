@@ -48,6 +48,11 @@ public:
         return nullptr;
     }
 
+    virtual DataBuffer::Ptr CreateRtcpXRRRTR(uint32_t rtcpSSRC)
+    {
+        return nullptr;
+    }
+
     virtual size_t GetLost()
     {
         return 0;
@@ -83,6 +88,7 @@ public:
     void OnRtcp(RtcpHeader *rtcp) override;
 
     DataBuffer::Ptr CreateRtcpSR(uint32_t rtcp_ssrc) override;
+    // rtp_ssrc: the receiver whose rrtr is answered, nullptr before one arrived
     DataBuffer::Ptr CreateRtcpXRDLRR(uint32_t rtcp_ssrc, uint32_t rtp_ssrc) override;
 
 private:
@@ -100,7 +106,10 @@ public:
     void OnRtp(uint16_t seq, uint32_t stamp, uint64_t ntpStampMs, uint32_t sampleRate, size_t bytes) override;
 
     DataBuffer::Ptr CreateRtcpRR(uint32_t rtcp_ssrc, uint32_t rtp_ssrc) override;
+    DataBuffer::Ptr CreateRtcpXRRRTR(uint32_t rtcp_ssrc) override;
 
+    // from the sender's dlrr answer to our rrtr, 0 before the first one
+    uint32_t GetRtt() const;
     size_t GetLost() override;
     size_t GetLostInterval() override;
     size_t GetExpectedPackets() const override;
@@ -124,6 +133,9 @@ private:
     uint64_t lastSrNtpSys_ = 0;
     uint64_t lastRtpSysStamp_ = 0;
 
+    uint32_t rtt_ = 0;
+    std::map<uint32_t, uint64_t> rrtrSendStamp_; // lrr, sys stamp
+
     size_t lastLost_ = 0;
     // last expected rtp packet num
     size_t lastExpected_ = 0;
@@ -14,6 +14,7 @@
  */
 
 #include "rtcp.h"
+#include <algorithm>
 #include <cstring>
 #include <ctime>
 #include <netinet/in.h>
@@ -46,6 +47,28 @@ int32_t RtcpHeader::GetPaddingSize() const
     return ((uint8_t *)this)[GetSize() - 1];
 }
 
+std::vector<RtcpHeader *> RtcpHeader::LoadFromBytes(uint8_t *data, size_t size)
+{
+    std::vector<RtcpHeader *> ret;
+    if (data == nullptr) {
+        return ret;
+    }
+
+    size_t offset = 0;
+    while (size - offset >= sizeof(RtcpHeader)) {
+        auto rtcp = (RtcpHeader *)(data + offset);
+        auto rtcpSize = (size_t)rtcp->GetSize();
+        if (rtcp->version_ != 2 || rtcpSize > size - offset) { // 2:rtp version
+            SHARING_LOGW("invalid rtcp, pt: %{public}u, size: %{public}zu.", rtcp->pt_, rtcpSize);
+            return {};
+        }
+        ret.emplace_back(rtcp);
+        offset += rtcpSize;
+    }
+
+    return ret;
+}
+
 //------------------------------ common ------------------------------//
 
 static inline int32_t AlignSize(int32_t bytes)
@@ -84,6 +107,22 @@ static void SetupPadding(RtcpHeader *rtcp, size_t paddingSize)
     }
 }
 
+//------------------------------ ReportItem ------------------------------//
+
+void ReportItem::SetCumulative(uint32_t lost)
+{
+    // 24 bits, clamped rather than wrapped
+    lost = std::min<uint32_t>(lost, 0xFFFFFF);
+    cumulative_[0] = (lost >> 16) & 0xFF; // 16:byte offset
+    cumulative_[1] = (lost >> 8) & 0xFF;  // 8:byte offset
+    cumulative_[2] = lost & 0xFF;         // 2:last byte
+}
+
+uint32_t ReportItem::GetCumulative() const
+{
+    return (cumulative_[0] << 16) | (cumulative_[1] << 8) | cumulative_[2]; // 16, 8:byte offset, 2:last byte
+}
+
 //------------------------------ RtcpSR ------------------------------//
 
 std::shared_ptr<RtcpSR> RtcpSR::Create(int32_t itemCount)
@@ -305,6 +344,98 @@ int32_t RtcpFB::GetFciSize() const
     return GetSize() - GetPaddingSize() - sizeof(RtcpFB);
 }
 
+std::vector<uint16_t> RtcpFB::GetNackSeqs() const
+{
+    std::vector<uint16_t> seqs;
+    if ((RtcpType)pt_ != RtcpType::RTCP_RTPFB || (RtpfbType)reportCount_ != RtpfbType::RTCP_RTPFB_NACK) {
+        return seqs;
+    }
+
+    auto item = (const RtcpNackItem *)GetFciPtr();
+    auto count = GetFciSize() / (int32_t)sizeof(RtcpNackItem);
+    for (int32_t i = 0; i < count; ++i, ++item) {
+        uint16_t pid = ntohs(item->pid_);
+        uint16_t blp = ntohs(item->blp_);
+        seqs.emplace_back(pid);
+        for (size_t bit = 0; bit < RtcpNackItem::BLP_BITS; ++bit) {
+            if (blp & (1 << bit)) {
+                seqs.emplace_back((uint16_t)(pid + bit + 1));
+            }
+        }
+    }
+
+    return seqs;
+}
+
+std::shared_ptr<RtcpFB> RtcpFB::CreateNack(uint32_t ssrc, uint32_t ssrcMedia, const std::vector<uint16_t> &seqs)
+{
+    std::vector<RtcpNackItem> items;
+    for (auto seq : seqs) {
+        if (!items.empty()) {
+            auto distance = (uint16_t)(seq - items.back().pid_);
+            if (distance == 0) {
+                continue;
+            }
+            if (distance <= RtcpNackItem::BLP_BITS) {
+                items.back().blp_ |= (uint16_t)(1 << (distance - 1));
+                continue;
+            }
+        }
+        items.push_back({seq, 0});
+    }
+
+    if (items.empty()) {
+        return nullptr;
+    }
+
+    for (auto &item : items) {
+        item.pid_ = htons(item.pid_);
+        item.blp_ = htons(item.blp_);
+    }
+
+    auto ret = Create(RtpfbType::RTCP_RTPFB_NACK, items.data(), items.size() * sizeof(RtcpNackItem));
+    if (ret == nullptr) {
+        return nullptr;
+    }
+    ret->ssrc_ = htonl(ssrc);
+    ret->ssrcMedia_ = htonl(ssrcMedia);
+    return ret;
+}
+
+bool RtcpFB::IsKeyFrameRequest(uint32_t ssrcMedia) const
+{
+    if ((RtcpType)pt_ != RtcpType::RTCP_PSFB) {
+        return false;
+    }
+
+    if ((PsfbType)reportCount_ == PsfbType::RTCP_PSFB_PLI) {
+        return ntohl(ssrcMedia_) == ssrcMedia;
+    }
+
+    if ((PsfbType)reportCount_ == PsfbType::RTCP_PSFB_FIR) {
+        auto item = (const RtcpFirItem *)GetFciPtr();
+        auto count = GetFciSize() / (int32_t)sizeof(RtcpFirItem);
+        for (int32_t i = 0; i < count; ++i, ++item) {
+            if (ntohl(item->ssrc_) == ssrcMedia) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+std::shared_ptr<RtcpFB> RtcpFB::CreatePli(uint32_t ssrc, uint32_t ssrcMedia)
+{
+    auto ret = Create(PsfbType::RTCP_PSFB_PLI);
+    if (ret == nullptr) {
+        return nullptr;
+    }
+    ret->ssrc_ = htonl(ssrc);
+    ret->ssrcMedia_ = htonl(ssrcMedia);
+    return ret;
+}
+
 std::shared_ptr<RtcpFB> RtcpFB::CreateInner(RtcpType type, int32_t fmt, const void *fci, size_t fciLen)
 {
     if (!fci) {
@@ -390,7 +521,35 @@ std::string RtcpBye::GetReason() const
     return std::string((char *)reasonLenPtr + 1, *reasonLenPtr);
 }
 
-//-----------------------------------------------------------------------------
+//------------------------------ RtcpXR ------------------------------//
+
+std::shared_ptr<RtcpXRRRTR> RtcpXRRRTR::Create(uint32_t ssrc, uint64_t unixStampMs)
+{
+    auto bytes = sizeof(RtcpXRRRTR);
+    auto ptr = (RtcpXRRRTR *)new (std::nothrow) char[bytes];
+    if (ptr == nullptr) {
+        return nullptr;
+    }
+    SetupHeader(ptr, RtcpType::RTCP_XR, 0, bytes);
+    SetupPadding(ptr, 0);
+    ptr->ssrc_ = htonl(ssrc);
+    ptr->bt_ = 4; // 4:rrtr block type
+    ptr->reserved_ = 0;
+    ptr->blockLength_ = htons(2); // 2:ntp timestamp words
+
+    uint64_t seconds = unixStampMs / 1000; // 1000:unit
+    ptr->ntpmsw_ = htonl(static_cast<uint32_t>(seconds + 0x83AA7E80)); /* 0x83AA7E80 seconds from 1900 to 1970 */
+    ptr->ntplsw_ = htonl(static_cast<uint32_t>(((unixStampMs % 1000) << 32) / 1000)); // 1000:unit, 32:byte offset
+    return std::shared_ptr<RtcpXRRRTR>(ptr, [](RtcpXRRRTR *ptr) {
+        delete[] (char *)ptr;
+        ptr = nullptr;
+    });
+}
+
+uint32_t RtcpXRRRTR::GetLrr() const
+{
+    return ((ntohl(ntpmsw_) & 0xFFFF) << 16) | ((ntohl(ntplsw_) >> 16) & 0xFFFF); // 16:byte offset
+}
 
 std::shared_ptr<RtcpXRDLRR> RtcpXRDLRR::Create(size_t itemCount)
 {
@@ -405,6 +564,9 @@ std::shared_ptr<RtcpXRDLRR> RtcpXRDLRR::Create(size_t itemCount)
     }
     SetupHeader(ptr, RtcpType::RTCP_XR, 0, bytes);
     SetupPadding(ptr, bytes - realSize);
+    ptr->bt_ = 5; // 5:dlrr block type
+    ptr->reserved_ = 0;
+    ptr->blockLength_ = htons(static_cast<uint16_t>(itemCount * 3)); // 3:words per item
     return std::shared_ptr<RtcpXRDLRR>(ptr, [](RtcpXRDLRR *ptr) {
         delete[] (char *)ptr;
         ptr = nullptr;
@@ -413,7 +575,7 @@ std::shared_ptr<RtcpXRDLRR> RtcpXRDLRR::Create(size_t itemCount)
 
 std::vector<RtcpXRDLRRReportItem *> RtcpXRDLRR::GetItemList()
 {
-    auto count = blockLength_ / 3;
+    auto count = ntohs(blockLength_) / 3; // 3:words per item
     RtcpXRDLRRReportItem *ptr = &items_;
     std::vector<RtcpXRDLRRReportItem *> list;
     for (int32_t i = 0; i < (int32_t)count; ++i) {
@@ -14,6 +14,7 @@
  */
 
 #include "rtcp_context.h"
+#include <algorithm>
 #include <netinet/in.h>
 #include "common/common_macro.h"
 #include "common/media_log.h"
@@ -21,6 +22,41 @@
 
 namespace OHOS {
 namespace Sharing {
+constexpr size_t XR_RECORD_CAPACITY = 5;
+
+namespace {
+struct XRBlockHeader {
+    uint8_t bt_;
+    uint8_t reserved_;
+    uint16_t blockLength_;
+};
+
+struct XRRRTRBlock {
+    XRBlockHeader header_;
+    uint32_t ntpmsw_;
+    uint32_t ntplsw_;
+};
+
+// calls onBlock(block) for each report block of an xr packet
+template <typename OnBlock>
+void ForEachXRBlock(RtcpHeader *rtcp, OnBlock onBlock)
+{
+    auto begin = (uint8_t *)rtcp;
+    auto end = begin + rtcp->GetSize() - rtcp->GetPaddingSize();
+    auto ptr = begin + sizeof(RtcpHeader) + sizeof(uint32_t); // the ssrc of the xr sender
+    while (ptr + sizeof(XRBlockHeader) <= end) {
+        auto block = (XRBlockHeader *)ptr;
+        size_t blockBytes = sizeof(XRBlockHeader) + ntohs(block->blockLength_) * 4; // 4:bytes per word
+        if (ptr + blockBytes > end) {
+            SHARING_LOGW("truncated xr block, bt: %{public}u.", block->bt_);
+            return;
+        }
+        onBlock(block);
+        ptr += blockBytes;
+    }
+}
+} // namespace
+
 void RtcpContext::OnRtp(uint16_t /*seq*/, uint32_t stamp, uint64_t ntpStampMs, uint32_t /*sampleRate*/, size_t bytes)
 {
     ++packets_;
@@ -64,34 +100,39 @@ void RtcpSenderContext::OnRtcp(RtcpHeader *rtcp)
                 if (item == nullptr || !item->lastSrStamp_) {
                     continue;
                 }
-                auto it = senderReportNtp_.find(item->lastSrStamp_);
+                auto it = senderReportNtp_.find(ntohl(item->lastSrStamp_));
                 if (it == senderReportNtp_.end()) {
                     continue;
                 }
                 // time: sender (send SR) -> receiver (recv SR) -> receiver (send RR) -> sender (recv RR)
                 auto msInc = GetCurrentMillisecond() - it->second;
                 // time: receiver (recv SR) -> receiver (send RR)
-                auto delayMs = (uint64_t)item->delaySinceLastSr_ * 1000 / 65536; // 1000:unit, 65536:max seq
+                auto delayMs = (uint64_t)ntohl(item->delaySinceLastSr_) * 1000 / 65536; // 1000:unit, 65536:max seq
                 // time: [sender (send SR) -> receiver (recv SR)] + [receiver (send RR) -> sender (recv RR)]
                 auto rtt = (int32_t)(msInc - delayMs);
                 if (rtt >= 0) {
-                    rtt_[item->ssrc_] = (uint32_t)rtt;
+                    rtt_[ntohl(item->ssrc_)] = (uint32_t)rtt;
                 }
             }
             break;
         }
         case RtcpType::RTCP_XR: {
-            auto rtcp_xr = (RtcpXRRRTR *)rtcp;
-            RETURN_IF_NULL(rtcp_xr);
-            if (rtcp_xr->bt_ == 4) { // 4:xrXrrtr
-                xrXrrtrRecvLastRr_[rtcp_xr->ssrc_] =
-                    ((rtcp_xr->ntpmsw_ & 0xFFFF) << 16) | ((rtcp_xr->ntplsw_ >> 16) & 0xFFFF); // 16:byte offset
-                xrRrtrRecvSysStamp_[rtcp_xr->ssrc_] = GetCurrentMillisecond();
-            } else if (rtcp_xr->bt_ == 5) { // 5:dlrr
-                SHARING_LOGD("for sender not recive dlrr.");
-            } else {
-                SHARING_LOGD("not support xr bt.");
+            if ((size_t)rtcp->GetSize() < sizeof(RtcpHeader) + sizeof(uint32_t)) {
+                break;
             }
+            auto ssrc = ntohl(((RtcpXRRRTR *)rtcp)->ssrc_);
+            ForEachXRBlock(rtcp, [this, ssrc](XRBlockHeader *block) {
+                if (block->bt_ == 4 && ntohs(block->blockLength_) >= 2) { // 4:xrXrrtr, 2:ntp timestamp words
+                    auto rrtr = (XRRRTRBlock *)block;
+                    xrXrrtrRecvLastRr_[ssrc] = ((ntohl(rrtr->ntpmsw_) & 0xFFFF) << 16) | // 16:byte offset
+                                               ((ntohl(rrtr->ntplsw_) >> 16) & 0xFFFF);  // 16:byte offset
+                    xrRrtrRecvSysStamp_[ssrc] = GetCurrentMillisecond();
+                } else if (block->bt_ == 5) { // 5:dlrr
+                    SHARING_LOGD("for sender not recive dlrr.");
+                } else {
+                    SHARING_LOGD("not support xr bt: %{public}u.", block->bt_);
+                }
+            });
             break;
         }
         default:
@@ -101,7 +142,26 @@ void RtcpSenderContext::OnRtcp(RtcpHeader *rtcp)
 
 DataBuffer::Ptr RtcpSenderContext::CreateRtcpXRDLRR(uint32_t rtcp_ssrc, uint32_t rtp_ssrc)
 {
-    return nullptr;
+    auto lrr = xrXrrtrRecvLastRr_.find(rtp_ssrc);
+    auto stamp = xrRrtrRecvSysStamp_.find(rtp_ssrc);
+    if (lrr == xrXrrtrRecvLastRr_.end() || stamp == xrRrtrRecvSysStamp_.end()) {
+        return nullptr;
+    }
+
+    auto rtcp = RtcpXRDLRR::Create(1);
+    if (rtcp == nullptr) {
+        return nullptr;
+    }
+    rtcp->ssrc_ = htonl(rtcp_ssrc);
+    rtcp->items_.ssrc_ = htonl(rtp_ssrc);
+    rtcp->items_.lrr_ = htonl(lrr->second);
+    // in units of 1/65536 seconds
+    auto delay = GetCurrentMillisecond() - stamp->second;
+    rtcp->items_.dlrr_ = htonl((uint32_t)(delay * 65536 / 1000)); // 65536:units per second, 1000:unit
+
+    DataBuffer::Ptr ret = std::make_shared<DataBuffer>();
+    ret->PushData((char *)rtcp.get(), rtcp->GetSize());
+    return ret;
 }
 
 uint32_t RtcpSenderContext::GetRtt(uint32_t ssrc) const
@@ -163,6 +223,9 @@ void RtcpReceiverContext::OnRtcp(RtcpHeader *rtcp)
     RETURN_IF_NULL(rtcp);
     switch ((RtcpType)rtcp->pt_) {
         case RtcpType::RTCP_SR: {
+            if ((size_t)rtcp->GetSize() < sizeof(RtcpSR) - sizeof(ReportItem)) {
+                break;
+            }
             auto rtcpSR = (RtcpSR *)rtcp;
             // last SR timestamp (LSR): 32 bits
             //  The middle 32 bits out of 64 in the NTP timestamp (as explained in
@@ -174,6 +237,27 @@ void RtcpReceiverContext::OnRtcp(RtcpHeader *rtcp)
             lastSrNtpSys_ = GetCurrentMillisecond();
             break;
         }
+        case RtcpType::RTCP_XR: {
+            ForEachXRBlock(rtcp, [this](XRBlockHeader *block) {
+                if (block->bt_ != 5) { // 5:dlrr
+                    return;
+                }
+                auto item = (RtcpXRDLRRReportItem *)(block + 1);
+                for (auto end = item + ntohs(block->blockLength_) / 3; item < end; ++item) { // 3:words per item
+                    auto it = rrtrSendStamp_.find(ntohl(item->lrr_));
+                    if (it == rrtrSendStamp_.end()) {
+                        continue;
+                    }
+                    // time: receiver (send RRTR) -> sender (recv RRTR) -> sender (send DLRR) -> receiver (recv DLRR)
+                    auto msInc = (int64_t)(GetCurrentMillisecond() - it->second);
+                    auto delayMs = (int64_t)ntohl(item->dlrr_) * 1000 / 65536; // 1000:unit, 65536:units per second
+                    if (msInc >= delayMs) {
+                        rtt_ = (uint32_t)(msInc - delayMs);
+                    }
+                }
+            });
+            break;
+        }
         default:
             break;
     }
@@ -195,15 +279,16 @@ DataBuffer::Ptr RtcpReceiverContext::CreateRtcpRR(uint32_t rtcpSSRC, uint32_t rt
 
     item->ssrc_ = htonl(rtpSSRC);
 
-    uint8_t fraction = 0;
+    size_t fraction = 0;
     auto expectedInterval = GetExpectedPacketsInterval();
+    auto lostInterval = GetLostInterval();
     if (expectedInterval != 0) {
-        fraction = uint8_t((GetLostInterval() << 8) / expectedInterval); // 8:byte offset
+        fraction = std::min<size_t>((lostInterval << 8) / expectedInterval, 0xFF); // 8:byte offset
     }
 
     // fraction = packet loss rate (percentage) * 256
-    item->fractionLost_ = fraction;
-    item->cumulative_ = htonl(uint32_t(GetLost())) >> 8; // 8:byte offset
+    item->fractionLost_ = (uint8_t)fraction;
+    item->SetCumulative((uint32_t)GetLost());
     item->seqCycles_ = htons(seqCycles_);
     item->seqMax_ = htons(seqMax_);
     item->jitter_ = htonl(uint32_t(jitter_));
@@ -220,6 +305,29 @@ DataBuffer::Ptr RtcpReceiverContext::CreateRtcpRR(uint32_t rtcpSSRC, uint32_t rt
     return ret;
 }
 
+DataBuffer::Ptr RtcpReceiverContext::CreateRtcpXRRRTR(uint32_t rtcp_ssrc)
+{
+    auto now = GetCurrentMillisecond();
+    auto rtcp = RtcpXRRRTR::Create(rtcp_ssrc, now);
+    if (rtcp == nullptr) {
+        return nullptr;
+    }
+
+    rrtrSendStamp_[rtcp->GetLrr()] = now;
+    if (rrtrSendStamp_.size() > XR_RECORD_CAPACITY) {
+        rrtrSendStamp_.erase(rrtrSendStamp_.begin());
+    }
+
+    DataBuffer::Ptr ret = std::make_shared<DataBuffer>();
+    ret->PushData((char *)rtcp.get(), rtcp->GetSize());
+    return ret;
+}
+
+uint32_t RtcpReceiverContext::GetRtt() const
+{
+    return rtt_;
+}
+
 size_t RtcpReceiverContext::GetExpectedPackets() const
 {
     return (seqCycles_ << 16) + seqMax_ - seqBase_ + 1; // 16:byte offset
@@ -235,13 +343,15 @@ size_t RtcpReceiverContext::GetExpectedPacketsInterval()
 
 size_t RtcpReceiverContext::GetLost()
 {
-    return GetExpectedPackets() - packets_;
+    // duplicates can outnumber the losses
+    auto expected = GetExpectedPackets();
+    return expected > packets_ ? expected - packets_ : 0;
 }
 
 size_t RtcpReceiverContext::GetLostInterval()
 {
     auto lost = GetLost();
-    auto ret = lost - lastLost_;
+    auto ret = lost > lastLost_ ? lost - lastLost_ : 0;
     lastLost_ = lost;
     return ret;
 }
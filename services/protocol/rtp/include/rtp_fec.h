@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_RTP_FEC_H
+#define OHOS_SHARING_RTP_FEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace OHOS {
+namespace Sharing {
+/*
+    RFC 5109 ulp fec, one protection level. A parity packet protects a group
+    of up to RTP_FEC_MAX_GROUP consecutive media packets of one ssrc and is
+    sent on the same ssrc with its own payload type and seq space. Any single
+    lost packet of a group is rebuilt from the others and the parity.
+
+    0                   1                   2                   3
+    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   |E|L|P|X|  CC   |M| PT recovery |            SN base            |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   |                          TS recovery                          |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   |        length recovery        |       Protection Length       |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   |             mask              |  parity of everything after
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+  the rtp fixed header ...
+*/
+struct RtpFecHeader {
+    uint8_t recovery0_; // E L P X CC
+    uint8_t recovery1_; // M PT
+    uint16_t snBase_;
+    uint32_t tsRecovery_;
+    uint16_t lengthRecovery_;
+    // ulp level 0 header, L = 0: 16 bit mask, the msb stands for SN base
+    uint16_t protectionLength_;
+    uint16_t mask_;
+} __attribute__((packed));
+
+constexpr size_t RTP_FEC_MAX_GROUP = 16;        // 16: mask bits
+constexpr size_t RTP_FEC_MAX_PROTECTED = 1500; // 1500: ethernet mtu, more than any packet we send
+
+// dst ^= src over len bytes
+void XorBytes(uint8_t *dst, const uint8_t *src, size_t len);
+} // namespace Sharing
+} // namespace OHOS
+#endif
@@ -84,6 +84,9 @@ public:
         RTP_HEADER_SIZE = 12,
     };
 
+    // packet and its storage are drawn from the packet pools
+    static Ptr Create(int32_t capacity);
+
     uint16_t GetSeq();
     uint32_t GetSSRC();
     uint32_t GetStamp();
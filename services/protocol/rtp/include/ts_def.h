@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_TS_DEF_H
+#define OHOS_SHARING_TS_DEF_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace OHOS {
+namespace Sharing {
+// ISO/IEC 13818-1 transport stream, pid layout follows the Wi-Fi Display spec.
+constexpr size_t TS_PACKET_SIZE = 188;
+constexpr size_t TS_HEADER_SIZE = 4;
+constexpr size_t TS_PAYLOAD_SIZE = TS_PACKET_SIZE - TS_HEADER_SIZE;
+constexpr size_t TS_PACKETS_PER_RTP = 7;
+constexpr uint8_t TS_SYNC_BYTE = 0x47;
+
+constexpr uint16_t TS_PID_PAT = 0x0000;
+constexpr uint16_t TS_PID_PMT = 0x0100;
+constexpr uint16_t TS_PID_PCR = 0x1000;
+constexpr uint16_t TS_PID_VIDEO = 0x1011;
+constexpr uint16_t TS_PID_AUDIO = 0x1100;
+constexpr uint16_t TS_PID_NULL = 0x1FFF;
+constexpr uint16_t TS_PROGRAM_NUMBER = 0x0001;
+
+constexpr uint8_t TS_TABLE_PAT = 0x00;
+constexpr uint8_t TS_TABLE_PMT = 0x02;
+
+constexpr uint8_t TS_STREAM_AAC = 0x0F;  // ADTS
+constexpr uint8_t TS_STREAM_H264 = 0x1B;
+constexpr uint8_t TS_STREAM_LPCM = 0x83; // Wi-Fi Display LPCM in private_stream_1
+
+constexpr uint8_t PES_STREAM_PRIVATE_1 = 0xBD;
+constexpr uint8_t PES_STREAM_AUDIO = 0xC0;
+constexpr uint8_t PES_STREAM_VIDEO = 0xE0;
+
+constexpr uint32_t TS_CLOCK_PER_MS = 90;
+constexpr uint64_t TS_TIMESTAMP_MASK = 0x1FFFFFFFFULL; // 33 bits
+
+// crc32/mpeg-2 of a psi section
+uint32_t TsCrc32(const uint8_t *data, size_t len);
+} // namespace Sharing
+} // namespace OHOS
+#endif
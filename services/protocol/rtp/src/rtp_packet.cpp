@@ -16,6 +16,7 @@
 #include "rtp_packet.h"
 #include <arpa/inet.h>
 #include <cstdlib>
+#include "utils/packet_pool.h"
 
 namespace OHOS {
 namespace Sharing {
@@ -108,6 +109,14 @@ RtpHeader *RtpPacket::GetHeader()
     return (RtpHeader *)Data();
 }
 
+RtpPacket::Ptr RtpPacket::Create(int32_t capacity)
+{
+    auto rtp = std::allocate_shared<RtpPacket>(PacketObjectAllocator<RtpPacket>());
+    rtp->UsePool();
+    rtp->SetCapacity(capacity);
+    return rtp;
+}
+
 uint16_t RtpPacket::GetSeq()
 {
     return ntohs(GetHeader()->seq_);
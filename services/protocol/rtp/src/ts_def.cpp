@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ts_def.h"
+
+namespace OHOS {
+namespace Sharing {
+uint32_t TsCrc32(const uint8_t *data, size_t len)
+{
+    constexpr uint32_t polynomial = 0x04C11DB7;
+    uint32_t crc = 0xFFFFFFFF;
+    if (data == nullptr) {
+        return crc;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= static_cast<uint32_t>(data[i]) << 24; // 24: top byte
+        for (int32_t bit = 0; bit < 8; bit++) {      // 8: bits per byte
+            crc = (crc & 0x80000000) ? (crc << 1) ^ polynomial : crc << 1;
+        }
+    }
+
+    return crc;
+}
+} // namespace Sharing
+} // namespace OHOS
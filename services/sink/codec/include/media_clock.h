@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_MEDIA_CLOCK_H
+#define OHOS_SHARING_MEDIA_CLOCK_H
+
+#include <cstdint>
+
+namespace OHOS {
+namespace Sharing {
+
+/**
+ * The source's media clock recovered on the sink from (timestamp, arrival time)
+ * samples. Network delay only ever adds to an arrival, so the clock follows the
+ * lower envelope: the smallest offset of each window drives a second order loop
+ * that corrects the phase and learns the rate difference of the two clocks. Once
+ * the rate is learned the mapping stays put over hours instead of creeping by the
+ * crystals' ppm.
+ *
+ * Not thread safe, the owner serializes the calls.
+ */
+class MediaClock {
+public:
+    MediaClock() = default;
+    ~MediaClock() = default;
+
+    void Reset();
+    // ptsUs: on the source clock, arrivalUs: GetMonotonicMicrosecond() when it came in
+    void OnSample(int64_t ptsUs, int64_t arrivalUs);
+
+    // one window was seen, ToLocalUs means something
+    bool IsLocked() const
+    {
+        return locked_;
+    }
+
+    // the local time a timestamp arrives at on the envelope, i.e. with the least network delay seen
+    int64_t ToLocalUs(int64_t ptsUs) const;
+    // arrival delay above the envelope, smoothed as the rtp interarrival jitter
+    int64_t GetJitterUs() const;
+    double GetDriftPpm() const;
+
+private:
+    void Anchor(int64_t ptsUs, double localUs);
+    void CloseWindow();
+
+private:
+    static constexpr int64_t WINDOW_US = 1000 * 1000;            // the envelope is taken once a second
+    static constexpr int64_t DISCONTINUITY_US = 2 * 1000 * 1000; // source restart, wrap or a long stall
+    static constexpr double PHASE_GAIN = 0.25;
+    static constexpr double RATE_GAIN = 0.05;
+    static constexpr double MAX_DRIFT = 1e-3; // 1e-3: 1000 ppm, far beyond any crystal
+    static constexpr double JITTER_GAIN = 1.0 / 16; // 16: rfc 3550 interarrival jitter
+
+    bool anchored_ = false;
+    bool locked_ = false;
+    int64_t anchorPts_ = 0;
+    double anchorLocalUs_ = 0;
+    double drift_ = 0; // local us per source us, minus one
+
+    int64_t lastPts_ = 0;
+    int64_t windowStartPts_ = 0;
+    int64_t windowStartLocalUs_ = 0;
+    double windowMinUs_ = 0;
+    double jitterUs_ = 0;
+};
+
+} // namespace Sharing
+} // namespace OHOS
+#endif
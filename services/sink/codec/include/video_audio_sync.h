@@ -17,41 +17,77 @@
 #define OHOS_SHARING_VIDEO_AUDIO_SYNC_H
 
 #include <memory>
+#include <mutex>
 #include "audio_play_controller.h"
+#include "media_clock.h"
 
 namespace OHOS {
 namespace Sharing {
 
+/**
+ * Schedules video presentation against the media clock recovered from the
+ * arrival of video frames. A frame is due at its envelope arrival time plus
+ * one playout delay: the delay that puts it next to the audio that is heard
+ * with the same timestamp, or without audio the delay decoding and network
+ * jitter need. The delay only slews, so neither a late audio sample nor a
+ * burst of frames makes the picture jump, and since the clock follows the
+ * source's rate the delay does not creep. Frames are dropped only when more
+ * than one real frame interval late, never two in a row.
+ *
+ * Audio that falls behind its own baseline is trimmed one frame at a time.
+ */
 class VideoAudioSync : public std::enable_shared_from_this<VideoAudioSync> {
 public:
     VideoAudioSync();
     ~VideoAudioSync();
 
-    bool IsNeedDrop(int64_t videoTimestamp);
+    void Reset();
+    // a video frame came in, arrivalUs on the GetMonotonicMicrosecond() clock
+    void OnVideoArrival(int64_t videoTimestamp, int64_t arrivalUs);
+    // false: drop the decoded frame, true: render it at renderUs on the GetMonotonicMicrosecond() clock
+    bool ScheduleVideoFrame(int64_t videoTimestamp, int64_t &renderUs);
+
     void SetAudioPlayController(std::shared_ptr<AudioPlayController> audioPlayController);
     void GetAVSyncExceptionCount(uint32_t &videoTooLateCount, uint32_t &audioTooLateCount,
                                  uint32_t &videoDropFrameCount);
     void ResetAVSyncExceptionCount();
 
 private:
-    bool ProcessAVSyncStrategy(int64_t videoTimestamp);
+    bool Schedule(int64_t videoTimestamp, int64_t audioPts, int64_t &renderUs, bool &trimAudio);
+    void UpdateFrameInterval(int64_t videoTimestamp);
+    // true: audio runs too far behind and is trimmed by a frame
+    bool UpdateAudioDelay(int64_t audioDelayUs);
+    void UpdatePlayoutDelay(int64_t targetUs);
 
-    static constexpr int64_t AUDIO_TOO_LATE_US = 300 * 1000;
-    static constexpr int64_t AUDIO_LATE_US = 100 * 1000;
-    static constexpr int64_t VIDEO_LATE_US = -100 * 1000;
-    static constexpr int64_t VIDEO_TOO_LATE_US = -200 * 1000;
-    static constexpr int64_t DROP_ONE_FRAME_TIME = 1000 * 1000 / 30;
+    static constexpr int64_t DEFAULT_FRAME_INTERVAL_US = 1000 * 1000 / 30;
+    static constexpr int64_t MAX_FRAME_INTERVAL_US = 200 * 1000; // a pts gap beyond it is a pause, not a frame
+    static constexpr int64_t MAX_PLAYOUT_DELAY_US = 500 * 1000;
+    static constexpr int64_t PLAYOUT_SLEW_US = 1000; // per frame, 3% at 30 fps is not visible
+    static constexpr int64_t JITTER_MARGIN = 2; // jitter multiples kept in the video delay
+    static constexpr int64_t AUDIO_CREEP_US = 60 * 1000; // audio backlog above its baseline worth a drop
+    static constexpr int64_t VIDEO_TOO_LATE_US = 200 * 1000;
     static constexpr int32_t CONSECUTIVE_THRESHOLD = 10;
+    static constexpr int32_t DELAY_SMOOTHING = 16; // ewma weight 1/16 per frame
 
-    bool isFirstFrame_ = true;
-    int32_t continueDropCount_ = 0;
+    std::mutex mutex_;
+    MediaClock clock_;
     std::shared_ptr<AudioPlayController> audioPlayController_ = nullptr;
 
+    int64_t lastVideoTimestamp_ = -1;
+    int64_t frameIntervalUs_ = DEFAULT_FRAME_INTERVAL_US;
+    int64_t outputDelayUs_ = -1;  // envelope arrival to decoder output, -1: none yet
+    int64_t playoutDelayUs_ = -1; // envelope arrival to presentation, -1: none yet
+    bool lastDropped_ = false;
+
+    int64_t audioDelayUs_ = -1;   // envelope arrival to the audio being heard, -1: no audio
+    int64_t audioBaseUs_ = 0;     // the least audio delay seen, what audio needs by itself
+    int64_t excessAtTrimUs_ = -1; // audio delay above the base when audio was last trimmed
+    uint32_t audioCreepCount_ = 0;
+
     uint32_t videoTooLateCount_ = 0;
     uint32_t audioTooLateCount_ = 0;
     uint32_t videoDropFrameCount_ = 0;
     uint32_t videoTooLateConsecutiveCount_ = 0;
-    uint32_t audioTooLateConsecutiveCount_ = 0;
 };
 } // namespace Sharing
 } // namespace OHOS
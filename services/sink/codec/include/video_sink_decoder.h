@@ -17,7 +17,8 @@
 #define OHOS_SHARING_VIDEO_SINK_DECODER_H
 
 #include <condition_variable>
-#include <queue>
+#include <deque>
+#include <thread>
 #include "avcodec_video_decoder.h"
 #include "common/const_def.h"
 #include "common/event_comm.h"
@@ -46,8 +47,22 @@ public:
     bool Start();
     void Stop();
     void Release();
+    // a codec input buffer, filled by the caller in place
+    struct InputBuffer {
+        uint32_t index = 0;
+        std::shared_ptr<MediaAVCodec::AVSharedMemory> memory = nullptr;
+    };
+
     bool Init(CodecId videoCodecId = CODEC_H264);
+    // copies the data into the next free input buffer, waits up to DECODE_WAIT_MILLISECONDS for one
     bool DecodeVideoData(const char *data, int32_t size, uint64_t pts);
+    // the next free input buffer, false after timeoutMs or once the decoder stops
+    bool AcquireInputBuffer(InputBuffer &buffer, uint32_t timeoutMs);
+    // size bytes were written at the base of an acquired buffer, each one is queued or recycled once;
+    // keyFrame: a whole access unit, its sps/pps in band ahead of the picture
+    bool QueueInputBuffer(const InputBuffer &buffer, int32_t size, uint64_t pts, bool keyFrame = false);
+    // an acquired buffer left unused goes back to the front
+    void RecycleInputBuffer(const InputBuffer &buffer);
 
     bool SetSurface(sptr<OHOS::Surface> surface);
     bool SetDecoderFormat(const VideoTrack &track);
@@ -65,14 +80,32 @@ private:
     bool StopDecoder();
     bool StartDecoder();
     bool SetVideoCallback();
+    void StartRenderThread();
+    void StopRenderThread();
+    void RenderThread();
+    // presented once renderUs (GetMonotonicMicrosecond()) is reached, in order behind the held ones
+    void QueueOutputBuffer(uint32_t index, int64_t renderUs);
+    void ReleaseOutputBuffer(uint32_t index, bool render);
 
 public:
     bool enableSurface_ = false;
     bool forceSWDecoder_ = false;
     uint32_t controlId_ = -1;
 
-    std::queue<int32_t> inQueue_;
-    std::queue<std::shared_ptr<MediaAVCodec::AVSharedMemory>> inBufferQueue_;
+    std::deque<InputBuffer> inBuffers_;
+
+    // decoded frames held until the sync engine's presentation time
+    struct OutputBuffer {
+        uint32_t index = 0;
+        int64_t renderUs = 0;
+    };
+    static constexpr size_t MAX_HELD_OUTPUTS = 4; // the codec stalls once all its output buffers are held
+    static constexpr int64_t RENDER_AHEAD_US = 2000; // closer than that is now
+    bool isRendering_ = false;
+    std::deque<OutputBuffer> outBuffers_;
+    std::mutex outMutex_;
+    std::condition_variable outCond_;
+    std::unique_ptr<std::thread> renderThread_ = nullptr;
 
     std::mutex inMutex_;
     std::condition_variable inCond_;
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "media_clock.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <limits>
+#include "common/media_log.h"
+
+namespace OHOS {
+namespace Sharing {
+constexpr double NO_SAMPLE = std::numeric_limits<double>::max();
+
+void MediaClock::Reset()
+{
+    anchored_ = false;
+    locked_ = false;
+    drift_ = 0;
+    jitterUs_ = 0;
+}
+
+void MediaClock::Anchor(int64_t ptsUs, double localUs)
+{
+    anchorPts_ = ptsUs;
+    anchorLocalUs_ = localUs;
+}
+
+void MediaClock::OnSample(int64_t ptsUs, int64_t arrivalUs)
+{
+    if (anchored_) {
+        double offset = static_cast<double>(arrivalUs) - (anchorLocalUs_ + (ptsUs - anchorPts_) * (1 + drift_));
+        if (std::llabs(ptsUs - lastPts_) > DISCONTINUITY_US || (locked_ && std::fabs(offset) > DISCONTINUITY_US)) {
+            // the rate of the two crystals is still what it was, only the phase starts over
+            SHARING_LOGI("media clock discontinuity, pts: %{public}" PRId64 " last: %{public}" PRId64 ".", ptsUs,
+                         lastPts_);
+            anchored_ = false;
+            locked_ = false;
+        } else {
+            windowMinUs_ = std::min(windowMinUs_, offset);
+            if (locked_) {
+                jitterUs_ += (std::max(offset, 0.0) - jitterUs_) * JITTER_GAIN;
+            }
+            lastPts_ = ptsUs;
+            if (arrivalUs - windowStartLocalUs_ >= WINDOW_US) {
+                CloseWindow();
+                windowStartLocalUs_ = arrivalUs;
+            }
+            return;
+        }
+    }
+
+    Anchor(ptsUs, static_cast<double>(arrivalUs));
+    anchored_ = true;
+    lastPts_ = ptsUs;
+    windowStartPts_ = ptsUs;
+    windowStartLocalUs_ = arrivalUs;
+    windowMinUs_ = 0;
+}
+
+void MediaClock::CloseWindow()
+{
+    // the envelope should sit at offset 0, whatever it is away from that is the phase error
+    double error = windowMinUs_;
+    double localUs = anchorLocalUs_ + (lastPts_ - anchorPts_) * (1 + drift_);
+    if (!locked_) {
+        Anchor(lastPts_, localUs + error);
+        locked_ = true;
+        SHARING_LOGI("media clock locked, envelope moved %{public}.0f us.", error);
+    } else {
+        int64_t spanUs = lastPts_ - windowStartPts_;
+        if (spanUs > 0) {
+            drift_ = std::clamp(drift_ + RATE_GAIN * error / spanUs, -MAX_DRIFT, MAX_DRIFT);
+        }
+        Anchor(lastPts_, localUs + PHASE_GAIN * error);
+        MEDIA_LOGD("media clock error: %{public}.0f us, drift: %{public}.1f ppm, jitter: %{public}.0f us.", error,
+                   GetDriftPpm(), jitterUs_);
+    }
+    windowStartPts_ = lastPts_;
+    windowMinUs_ = NO_SAMPLE;
+}
+
+int64_t MediaClock::ToLocalUs(int64_t ptsUs) const
+{
+    return std::llround(anchorLocalUs_ + (ptsUs - anchorPts_) * (1 + drift_));
+}
+
+int64_t MediaClock::GetJitterUs() const
+{
+    return std::llround(jitterUs_);
+}
+
+double MediaClock::GetDriftPpm() const
+{
+    return drift_ * 1e6; // 1e6: ppm
+}
+
+} // namespace Sharing
+} // namespace OHOS
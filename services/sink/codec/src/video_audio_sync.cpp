@@ -14,7 +14,9 @@
  */
 
 #include "video_audio_sync.h"
+#include <algorithm>
 #include "common/media_log.h"
+#include "utils/utils.h"
 
 namespace OHOS {
 namespace Sharing {
@@ -32,60 +34,145 @@ VideoAudioSync::~VideoAudioSync()
     }
 }
 
-bool VideoAudioSync::IsNeedDrop(int64_t videoTimestamp)
+void VideoAudioSync::Reset()
 {
-    if (isFirstFrame_) {
-        isFirstFrame_ = false;
-        continueDropCount_ = 0;
-        return false;
-    }
-    return ProcessAVSyncStrategy(videoTimestamp);
+    std::lock_guard<std::mutex> lock(mutex_);
+    clock_.Reset();
+    lastVideoTimestamp_ = -1;
+    outputDelayUs_ = -1;
+    playoutDelayUs_ = -1;
+    lastDropped_ = false;
+    audioDelayUs_ = -1;
+    excessAtTrimUs_ = -1;
+    audioCreepCount_ = 0;
+}
+
+void VideoAudioSync::OnVideoArrival(int64_t videoTimestamp, int64_t arrivalUs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    clock_.OnSample(videoTimestamp, arrivalUs);
 }
 
-bool VideoAudioSync::ProcessAVSyncStrategy(int64_t videoTimestamp)
+bool VideoAudioSync::ScheduleVideoFrame(int64_t videoTimestamp, int64_t &renderUs)
 {
+    // both outside the lock, the audio controller holds its own while it feeds the renderer
     int64_t audioPts = 0;
-    if (audioPlayController_ == nullptr) {
-        return false;
+    if (audioPlayController_ != nullptr) {
+        audioPts = audioPlayController_->GetAudioDecoderTimestamp();
     }
 
-    audioPts = audioPlayController_->GetAudioDecoderTimestamp();
-    if (audioPts == 0) {
-        continueDropCount_ = 0;
-        return false;
+    bool trimAudio = false;
+    bool render = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        render = Schedule(videoTimestamp, audioPts, renderUs, trimAudio);
+    }
+    if (trimAudio) {
+        audioPlayController_->DropOneFrame();
+    }
+    return render;
+}
+
+bool VideoAudioSync::Schedule(int64_t videoTimestamp, int64_t audioPts, int64_t &renderUs, bool &trimAudio)
+{
+    int64_t nowUs = GetMonotonicMicrosecond();
+    renderUs = nowUs;
+    UpdateFrameInterval(videoTimestamp);
+    if (!clock_.IsLocked()) {
+        return true;
+    }
+
+    int64_t arrivalUs = clock_.ToLocalUs(videoTimestamp);
+    int64_t outputDelayUs = nowUs - arrivalUs;
+    outputDelayUs_ = outputDelayUs_ < 0 ? outputDelayUs :
+        outputDelayUs_ + (outputDelayUs - outputDelayUs_) / DELAY_SMOOTHING;
+    int64_t targetUs = outputDelayUs_ + JITTER_MARGIN * clock_.GetJitterUs();
+    if (audioPts != 0) {
+        trimAudio = UpdateAudioDelay(nowUs - clock_.ToLocalUs(audioPts));
+        targetUs = audioDelayUs_;
+    } else {
+        audioDelayUs_ = -1;
     }
+    UpdatePlayoutDelay(targetUs);
 
-    int64_t earlyUs = videoTimestamp - audioPts;
-    SHARING_LOGD("videoTimestamp: %{public}" PRId64 "; audioPts: %{public}" PRId64 "; earlyUs: %{public}" PRId64 "",
-                 videoTimestamp, audioPts, earlyUs);
-    if (earlyUs < VIDEO_TOO_LATE_US) {
-        SHARING_LOGE("Video is too late, something may wrong! earlyUs = %{public}" PRId64"", earlyUs);
-        ++videoTooLateConsecutiveCount_;
-        if (videoTooLateConsecutiveCount_ >= CONSECUTIVE_THRESHOLD) {
+    int64_t dueUs = arrivalUs + playoutDelayUs_;
+    int64_t lateUs = nowUs - dueUs;
+    MEDIA_LOGD("videoTimestamp: %{public}" PRId64 ", audioPts: %{public}" PRId64 ", playout delay: %{public}" PRId64
+               ", late: %{public}" PRId64 ".", videoTimestamp, audioPts, playoutDelayUs_, lateUs);
+    if (lateUs > VIDEO_TOO_LATE_US) {
+        if (++videoTooLateConsecutiveCount_ >= CONSECUTIVE_THRESHOLD) {
             ++videoTooLateCount_;
             videoTooLateConsecutiveCount_ = 0;
-            SHARING_LOGE("Video is too late consecutive %{public}d times", videoTooLateCount_);
+            SHARING_LOGE("Video is too late consecutive %{public}d times, late: %{public}" PRId64 " us",
+                         videoTooLateCount_, lateUs);
         }
-    } else if (earlyUs < VIDEO_LATE_US && continueDropCount_ <= 0) {
-        ++continueDropCount_;
-        ++videoDropFrameCount_;
-        return true;
-    } else if (earlyUs > AUDIO_LATE_US) {
-        SHARING_LOGE("Audio is too late, drop audio fram! earlyUs =  %{public}" PRId64 "", earlyUs);
-        ++audioTooLateConsecutiveCount_;
-        if (audioTooLateConsecutiveCount_ >= CONSECUTIVE_THRESHOLD) {
-            ++audioTooLateCount_;
-            audioTooLateConsecutiveCount_ = 0;
-            SHARING_LOGE("Audio is too late consecutive %{public}d times", audioTooLateCount_);
-        }
-        audioPlayController_->DropOneFrame();
     } else {
         videoTooLateConsecutiveCount_ = 0;
-        audioTooLateConsecutiveCount_ = 0;
     }
 
-    continueDropCount_ = 0;
-    return false;
+    // a frame late by less than one frame interval still shows, the next one would replace it anyway
+    if (lateUs > frameIntervalUs_ && !lastDropped_) {
+        lastDropped_ = true;
+        ++videoDropFrameCount_;
+        return false;
+    }
+    lastDropped_ = false;
+    renderUs = std::clamp(dueUs, nowUs, nowUs + MAX_PLAYOUT_DELAY_US);
+    return true;
+}
+
+void VideoAudioSync::UpdateFrameInterval(int64_t videoTimestamp)
+{
+    // the real frame rate, screen capture sources send frames only when something changed
+    int64_t interval = videoTimestamp - lastVideoTimestamp_;
+    if (lastVideoTimestamp_ >= 0 && interval > 0 && interval <= MAX_FRAME_INTERVAL_US) {
+        frameIntervalUs_ += (interval - frameIntervalUs_) / 8; // 8: ewma weight 1/8
+    }
+    lastVideoTimestamp_ = videoTimestamp;
+}
+
+bool VideoAudioSync::UpdateAudioDelay(int64_t audioDelayUs)
+{
+    if (audioDelayUs_ < 0) {
+        audioDelayUs_ = audioDelayUs;
+        audioBaseUs_ = audioDelayUs;
+        excessAtTrimUs_ = -1;
+        audioCreepCount_ = 0;
+        return false;
+    }
+    audioDelayUs_ += (audioDelayUs - audioDelayUs_) / DELAY_SMOOTHING;
+    audioBaseUs_ = std::min(audioBaseUs_, audioDelayUs_);
+
+    int64_t excessUs = audioDelayUs_ - audioBaseUs_;
+    if (excessUs <= AUDIO_CREEP_US) {
+        audioCreepCount_ = 0;
+        return false;
+    }
+    if (++audioCreepCount_ < CONSECUTIVE_THRESHOLD) {
+        return false;
+    }
+    audioCreepCount_ = 0;
+    if (excessAtTrimUs_ >= 0 && excessUs >= excessAtTrimUs_) {
+        // trimming did not bring it down, the route itself got slower: that is the new baseline
+        SHARING_LOGI("audio delay settled %{public}" PRId64 " us higher.", excessUs);
+        audioBaseUs_ = audioDelayUs_;
+        excessAtTrimUs_ = -1;
+        return false;
+    }
+    SHARING_LOGE("Audio is too late, drop audio frame! excess: %{public}" PRId64 " us", excessUs);
+    ++audioTooLateCount_;
+    excessAtTrimUs_ = excessUs;
+    return true;
+}
+
+void VideoAudioSync::UpdatePlayoutDelay(int64_t targetUs)
+{
+    targetUs = std::clamp<int64_t>(targetUs, 0, MAX_PLAYOUT_DELAY_US);
+    if (playoutDelayUs_ < 0) {
+        playoutDelayUs_ = targetUs;
+        return;
+    }
+    playoutDelayUs_ += std::clamp(targetUs - playoutDelayUs_, -PLAYOUT_SLEW_US, PLAYOUT_SLEW_US);
 }
 
 void VideoAudioSync::SetAudioPlayController(std::shared_ptr<AudioPlayController> audioPlayController)
@@ -96,6 +183,7 @@ void VideoAudioSync::SetAudioPlayController(std::shared_ptr<AudioPlayController>
 void VideoAudioSync::GetAVSyncExceptionCount(uint32_t &videoTooLateCount, uint32_t &audioTooLateCount,
                                              uint32_t &videoDropFrameCount)
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     videoTooLateCount = videoTooLateCount_;
     audioTooLateCount = audioTooLateCount_;
     videoDropFrameCount = videoDropFrameCount_;
@@ -103,11 +191,11 @@ void VideoAudioSync::GetAVSyncExceptionCount(uint32_t &videoTooLateCount, uint32
 
 void VideoAudioSync::ResetAVSyncExceptionCount()
 {
+    std::lock_guard<std::mutex> lock(mutex_);
     videoTooLateCount_ = 0;
     audioTooLateCount_ = 0;
     videoDropFrameCount_ = 0;
     videoTooLateConsecutiveCount_ = 0;
-    audioTooLateConsecutiveCount_ = 0;
 }
 
 } // namespace Sharing
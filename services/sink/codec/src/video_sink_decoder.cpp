@@ -14,6 +14,7 @@
  */
 
 #include "video_sink_decoder.h"
+#include <chrono>
 #include <securec.h>
 #include "avcodec_codec_name.h"
 #include "avcodec_errors.h"
@@ -129,6 +130,7 @@ bool VideoSinkDecoder::Start()
     }
     if (StartDecoder()) {
         isRunning_ = true;
+        StartRenderThread();
         return true;
     } else {
         WfdSinkHiSysEvent::GetInstance().ReportError(__func__, "", SinkStage::VIDEO_DECODE,
@@ -145,18 +147,24 @@ void VideoSinkDecoder::Stop()
         return;
     }
 
+    // held output indices mean nothing to the codec once it stopped
+    StopRenderThread();
     if (StopDecoder()) {
         SHARING_LOGD("stop success.");
-        isRunning_ = false;
-        std::lock_guard<std::mutex> lock(inMutex_);
-        std::queue<int32_t> temp;
-        std::swap(temp, inQueue_);
+        {
+            std::lock_guard<std::mutex> lock(inMutex_);
+            isRunning_ = false;
+            inBuffers_.clear();
+        }
+        // a feeder waiting for an input buffer gives up now
+        inCond_.notify_all();
     }
 }
 
 void VideoSinkDecoder::Release()
 {
     SHARING_LOGD("trace.");
+    StopRenderThread();
     if (videoDecoder_ != nullptr) {
         videoDecoder_->Release();
         videoDecoder_.reset();
@@ -221,26 +229,59 @@ bool VideoSinkDecoder::StopDecoder()
 bool VideoSinkDecoder::DecodeVideoData(const char *data, int32_t size, uint64_t pts)
 {
     MEDIA_LOGD("decode data controlId: %{public}u.", controlId_);
-    RETURN_FALSE_IF_NULL(videoDecoder_);
-
-    std::unique_lock<std::mutex> lock(inMutex_);
-    if (inQueue_.empty() || inBufferQueue_.empty()) {
+    RETURN_FALSE_IF_NULL(data);
+    InputBuffer inputBuffer;
+    if (!AcquireInputBuffer(inputBuffer, DECODE_WAIT_MILLISECONDS)) {
         MEDIA_LOGE("input queue is empty, controlId: %{public}u.", controlId_);
         return false;
     }
-    auto inputIndex = inQueue_.front();
-    MEDIA_LOGD("inQueue front: %{public}d.", inputIndex);
-    auto inputBuffer = inBufferQueue_.front();
-    if (inputBuffer == nullptr || (inputBuffer->GetSize() < size)) {
-        MEDIA_LOGE("GetInputBuffer failed or bufferSize invalid, controlId: %{public}u.", controlId_);
+
+    if (size <= 0 || inputBuffer.memory->GetSize() < size) {
+        MEDIA_LOGE("bufferSize invalid, controlId: %{public}u.", controlId_);
+        RecycleInputBuffer(inputBuffer);
         return false;
     }
-    lock.unlock();
-    MEDIA_LOGD("try copy data dest size: %{public}d data size: %{public}d.", inputBuffer->GetSize(), size);
-
-    auto ret = memcpy_s(inputBuffer->GetBase(), inputBuffer->GetSize(), data, size);
+    MEDIA_LOGD("try copy data dest size: %{public}d data size: %{public}d.", inputBuffer.memory->GetSize(), size);
+    auto ret = memcpy_s(inputBuffer.memory->GetBase(), inputBuffer.memory->GetSize(), data, size);
     if (ret != EOK) {
         MEDIA_LOGE("copy data failed controlId: %{public}u.", controlId_);
+        RecycleInputBuffer(inputBuffer);
+        return false;
+    }
+
+    return QueueInputBuffer(inputBuffer, size, pts);
+}
+
+bool VideoSinkDecoder::AcquireInputBuffer(InputBuffer &buffer, uint32_t timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(inMutex_);
+    inCond_.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                     [this]() { return !inBuffers_.empty() || !isRunning_; });
+    if (inBuffers_.empty() || !isRunning_) {
+        return false;
+    }
+
+    buffer = std::move(inBuffers_.front());
+    inBuffers_.pop_front();
+    return true;
+}
+
+void VideoSinkDecoder::RecycleInputBuffer(const InputBuffer &buffer)
+{
+    std::lock_guard<std::mutex> lock(inMutex_);
+    // the codec took back its buffers when it stopped
+    if (isRunning_ && buffer.memory != nullptr) {
+        inBuffers_.push_front(buffer);
+    }
+}
+
+bool VideoSinkDecoder::QueueInputBuffer(const InputBuffer &buffer, int32_t size, uint64_t pts, bool keyFrame)
+{
+    RETURN_FALSE_IF_NULL(videoDecoder_);
+    RETURN_FALSE_IF_NULL(buffer.memory);
+    if (size < 5 || buffer.memory->GetSize() < size) { // 5: start code and nal header
+        MEDIA_LOGE("data size invalid: %{public}d, controlId: %{public}u.", size, controlId_);
+        RecycleInputBuffer(buffer);
         return false;
     }
 
@@ -250,28 +291,24 @@ bool VideoSinkDecoder::DecodeVideoData(const char *data, int32_t size, uint64_t
     bufferInfo.offset = 0;
     WfdSinkHiSysEvent::GetInstance().RecordMediaDecodeStartTime(MediaReportType::VIDEO, bufferInfo.presentationTimeUs);
 
-    auto p = data;
-    if (size < 5) { // 5: data size
-        MEDIA_LOGE("data size too small: %{public}d, controlId: %{public}u.", size, controlId_);
-        return false;
-    }
+    const uint8_t *p = buffer.memory->GetBase();
     p = *(p + 2) == 0x01 ? p + 3 : p + 4; // 2: offset, 3: offset, 4: offset
-    if ((p[0] & 0x1f) == 0x06 || (p[0] & 0x1f) == 0x07 || (p[0] & 0x1f) == 0x08) {
+    int32_t ret = MediaAVCodec::AVCS_ERR_OK;
+    // a key frame starts with its sps, yet it carries the picture too
+    if (!keyFrame && ((p[0] & 0x1f) == 0x06 || (p[0] & 0x1f) == 0x07 || (p[0] & 0x1f) == 0x08)) {
         MEDIA_LOGD("media flag codec data controlId: %{public}u.", controlId_);
-        ret = videoDecoder_->QueueInputBuffer(inputIndex, bufferInfo, MediaAVCodec::AVCODEC_BUFFER_FLAG_CODEC_DATA);
+        ret = videoDecoder_->QueueInputBuffer(buffer.index, bufferInfo, MediaAVCodec::AVCODEC_BUFFER_FLAG_CODEC_DATA);
     } else {
         MEDIA_LOGD("media flag none controlId: %{public}u.", controlId_);
-        ret = videoDecoder_->QueueInputBuffer(inputIndex, bufferInfo, MediaAVCodec::AVCODEC_BUFFER_FLAG_NONE);
+        ret = videoDecoder_->QueueInputBuffer(buffer.index, bufferInfo, MediaAVCodec::AVCODEC_BUFFER_FLAG_NONE);
     }
 
     if (ret != MediaAVCodec::AVCS_ERR_OK) {
         MEDIA_LOGE("QueueInputBuffer failed error: %{public}d controlId: %{public}u.", ret, controlId_);
+        // still ours, used again as the former queue did
+        RecycleInputBuffer(buffer);
         return false;
     }
-    
-    lock.lock();
-    inQueue_.pop();
-    inBufferQueue_.pop();
 
     MEDIA_LOGD("process data success controlId: %{public}u.", controlId_);
     return true;
@@ -320,16 +357,90 @@ void VideoSinkDecoder::OnOutputBufferAvailable(uint32_t index, MediaAVCodec::AVC
         }
     }
 
-    if (videoAudioSync_ && videoAudioSync_->IsNeedDrop(info.presentationTimeUs)) {
+    int64_t renderUs = 0;
+    if (videoAudioSync_ && !videoAudioSync_->ScheduleVideoFrame(info.presentationTimeUs, renderUs)) {
         SHARING_LOGI("ReleaseOutputBuffer drop one frame.");
-        if (videoDecoder_->ReleaseOutputBuffer(index, false) != MediaAVCodec::AVCS_ERR_OK) {
-            MEDIA_LOGW("ReleaseOutputBuffer failed!");
+        ReleaseOutputBuffer(index, false);
+        return;
+    }
+    QueueOutputBuffer(index, renderUs);
+}
+
+void VideoSinkDecoder::QueueOutputBuffer(uint32_t index, int64_t renderUs)
+{
+    // released under the lock, a frame due now never overtakes a held one
+    std::lock_guard<std::mutex> lock(outMutex_);
+    if (!isRendering_ || (outBuffers_.empty() && renderUs <= GetMonotonicMicrosecond() + RENDER_AHEAD_US)) {
+        ReleaseOutputBuffer(index, true);
+        return;
+    }
+
+    outBuffers_.push_back({index, renderUs});
+    if (outBuffers_.size() > MAX_HELD_OUTPUTS) {
+        ReleaseOutputBuffer(outBuffers_.front().index, true);
+        outBuffers_.pop_front();
+    }
+    outCond_.notify_one();
+}
+
+void VideoSinkDecoder::ReleaseOutputBuffer(uint32_t index, bool render)
+{
+    auto decoder = videoDecoder_;
+    RETURN_IF_NULL(decoder);
+    if (decoder->ReleaseOutputBuffer(index, render) != MediaAVCodec::AVCS_ERR_OK) {
+        MEDIA_LOGW("ReleaseOutputBuffer failed!");
+    }
+}
+
+void VideoSinkDecoder::StartRenderThread()
+{
+    SHARING_LOGD("trace.");
+    std::lock_guard<std::mutex> lock(outMutex_);
+    if (renderThread_ != nullptr) {
+        return;
+    }
+    isRendering_ = true;
+    renderThread_ = std::make_unique<std::thread>(&VideoSinkDecoder::RenderThread, this);
+    pthread_setname_np(renderThread_->native_handle(), "videorender");
+}
+
+void VideoSinkDecoder::StopRenderThread()
+{
+    SHARING_LOGD("trace.");
+    std::unique_ptr<std::thread> thread;
+    {
+        std::lock_guard<std::mutex> lock(outMutex_);
+        isRendering_ = false;
+        for (auto &output : outBuffers_) {
+            ReleaseOutputBuffer(output.index, false);
         }
-    } else {
-        if (videoDecoder_->ReleaseOutputBuffer(index, true) != MediaAVCodec::AVCS_ERR_OK) {
-            MEDIA_LOGW("ReleaseOutputBuffer failed!");
+        outBuffers_.clear();
+        thread = std::move(renderThread_);
+    }
+    outCond_.notify_all();
+    if (thread != nullptr && thread->joinable()) {
+        thread->join();
+    }
+}
+
+void VideoSinkDecoder::RenderThread()
+{
+    SHARING_LOGD("video render thread start, controlId: %{public}u.", controlId_);
+    std::unique_lock<std::mutex> lock(outMutex_);
+    while (isRendering_) {
+        if (outBuffers_.empty()) {
+            outCond_.wait(lock);
+            continue;
+        }
+        int64_t waitUs = outBuffers_.front().renderUs - GetMonotonicMicrosecond();
+        if (waitUs > RENDER_AHEAD_US) {
+            outCond_.wait_for(lock, std::chrono::microseconds(waitUs));
+            continue;
         }
+        ReleaseOutputBuffer(outBuffers_.front().index, true);
+        outBuffers_.pop_front();
     }
+    SHARING_LOGD("video render thread exit, controlId: %{public}u.", controlId_);
 }
 
 void VideoSinkDecoder::OnInputBufferAvailable(uint32_t index, std::shared_ptr<MediaAVCodec::AVSharedMemory> buffer)
@@ -340,10 +451,9 @@ void VideoSinkDecoder::OnInputBufferAvailable(uint32_t index, std::shared_ptr<Me
         if (buffer == nullptr) {
             return;
         }
-        inQueue_.push(index);
-        inBufferQueue_.push(buffer);
+        inBuffers_.push_back({index, buffer});
     }
-    inCond_.notify_all();
+    inCond_.notify_one();
     MEDIA_LOGD("OnInputBufferAvailable notify.");
 }
 
@@ -33,6 +33,11 @@ struct WfdConsumerEventMsg : public ChannelEventMsg {
     AudioTrack audioTrack;
     VideoTrack videoTrack;
     MediaType mediaType = MEDIA_TYPE_AV;
+
+    // the source sends h264 and aac with these payload types instead of ts
+    bool rtpDirect = false;
+    uint8_t videoPt = 0;
+    uint8_t audioPt = 0;
 };
 
 } // namespace Sharing
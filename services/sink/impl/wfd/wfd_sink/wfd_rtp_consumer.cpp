@@ -14,18 +14,45 @@
  */
 
 #include "wfd_rtp_consumer.h"
+#include <algorithm>
 #include <chrono>
+#include <netinet/in.h>
+#include <securec.h>
 #include "extend/magic_enum/magic_enum.hpp"
 #include "common/reflect_registration.h"
 #include "configuration/include/config.h"
 #include "event_comm.h"
+#include "network/socket/socket_utils.h"
 #include "protocol/frame/h264_frame.h"
 #include "sink_media_def.h"
 #include "sink_session_def.h"
 #include "sharing_sink_hisysevent.h"
+#include "utils/utils.h"
 
 namespace OHOS {
 namespace Sharing {
+// aac sampling frequency index order
+constexpr uint32_t AAC_SAMPLE_RATES[] = {96000, 88200, 64000, 48000, 44100, 32000, 24000,
+                                         22050, 16000, 12000, 11025, 8000, 7350};
+
+// aac-lc AudioSpecificConfig in hex like the sdp config, the decoder builds the adts headers from it
+static std::string MakeAacConfig(uint32_t sampleRate, uint32_t channels)
+{
+    uint32_t index = 3; // 3: 48000
+    for (uint32_t i = 0; i < sizeof(AAC_SAMPLE_RATES) / sizeof(AAC_SAMPLE_RATES[0]); i++) {
+        if (AAC_SAMPLE_RATES[i] == sampleRate) {
+            index = i;
+            break;
+        }
+    }
+    // 2: aac-lc object type, 5/4/4 bits: object type, frequency index, channel configuration
+    uint32_t config = (2 << 11) | (index << 7) | ((channels & 0x0F) << 3); // 11, 7, 3: bit offsets
+    char hex[5] = {0};                                                      // 5: 4 hex digits and the nul
+    if (sprintf_s(hex, sizeof(hex), "%04X", config) < 0) {
+        return "";
+    }
+    return hex;
+}
 
 WfdRtpConsumer::WfdRtpConsumer()
 {
@@ -49,6 +76,9 @@ int32_t WfdRtpConsumer::HandleEvent(SharingEvent &event)
         case EventType::EVENT_WFD_MEDIA_INIT:
             HandleProsumerInitState(event);
             break;
+        case EventType::EVENT_WFD_MEDIA_JOIN_GROUP:
+            HandleJoinGroup(event);
+            break;
         default:
             SHARING_LOGI("none process case.");
             break;
@@ -73,6 +103,12 @@ void WfdRtpConsumer::HandleProsumerInitState(SharingEvent &event)
         if (msg->videoTrack.codecId != CodecId::CODEC_NONE) {
             videoTrack_ = msg->videoTrack;
         }
+        rtpDirect_ = msg->rtpDirect;
+        rtpDirectVideoPt_ = msg->videoPt;
+        rtpDirectAudioPt_ = msg->rtpDirect ? msg->audioPt : -1;
+        if (rtpDirect_ && rtpUnpacker_ != nullptr) {
+            AddDirectRtpPayloads();
+        }
     }
 
     isInit_ = true;
@@ -91,6 +127,47 @@ void WfdRtpConsumer::HandleProsumerInitState(SharingEvent &event)
     NotifyPrivateEvent(pPrivateMsg);
 }
 
+void WfdRtpConsumer::HandleJoinGroup(SharingEvent &event)
+{
+    SHARING_LOGD("trace.");
+    auto msg = ConvertEventMsg<WfdConsumerEventMsg>(event);
+    RETURN_IF_NULL(msg);
+    if (!SocketUtils::IsMulticastIp(msg->ip)) {
+        SHARING_LOGE("invalid multicast group: %{public}s.", GetAnonymousIp(msg->ip).c_str());
+        return;
+    }
+
+    multicastGroup_ = msg->ip;
+    multicastPort_ = msg->port;
+    SHARING_LOGI("multicast group: %{public}s, port: %{public}u.", GetAnonymousIp(multicastGroup_).c_str(),
+                 multicastPort_);
+    // the source only sends its reports to the sink it negotiated the rtcp port with, a sink that merely joined
+    // the group never learns a peer and asks for no retransmission or key frame, it recovers at the next idr
+    NetworkFactory::ServerPtr server = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(rtpMutex_);
+        if (!isRunning_ || rtpServer_.second == nullptr) {
+            // joined when started
+            return;
+        }
+        server = std::move(rtpServer_.second);
+        rtpServer_ = {0, nullptr};
+    }
+
+    // the running server is bound to the unicast address, maybe on another port; Stop waits for a read callback
+    // of that server, which may itself wait for rtpMutex_
+    server->Stop();
+    server.reset();
+    if (!StartRtpServer()) {
+        SHARING_LOGE("join multicast group failed.");
+        return;
+    }
+    if (playoutMaxDelayMs_ > 0) {
+        std::lock_guard<std::mutex> lock(rtpMutex_);
+        SchedulePlayoutPoll(rtpServer_.second);
+    }
+}
+
 void WfdRtpConsumer::UpdateOperation(ProsumerStatusMsg::Ptr &statusMsg)
 {
     SHARING_LOGD("trace.");
@@ -144,19 +221,96 @@ void WfdRtpConsumer::UpdateOperation(ProsumerStatusMsg::Ptr &statusMsg)
 bool WfdRtpConsumer::Init()
 {
     SHARING_LOGD("trace.");
+    int32_t enable = 0;
+    SharingValue::Ptr values = nullptr;
+    auto ret = Config::GetInstance().GetConfig("mediachannel", "rtpNack", "enable", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(enable);
+    }
+    nackEnabled_ = enable != 0;
+
+    enable = 0;
+    ret = Config::GetInstance().GetConfig("mediachannel", "rtpKeyFrame", "enable", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(enable);
+    }
+    keyFrameRequestEnabled_ = enable != 0;
+    ret = Config::GetInstance().GetConfig("mediachannel", "rtpKeyFrame", "requestIntervalMs", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(keyFrameRequestIntervalMs_);
+    }
+
+    enable = 0;
+    ret = Config::GetInstance().GetConfig("mediachannel", "rtpJitterBuffer", "enable", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(enable);
+    }
+    if (enable != 0) {
+        ret = Config::GetInstance().GetConfig("mediachannel", "rtpJitterBuffer", "minDelayMs", values);
+        if (ret == CONFIGURE_ERROR_NONE) {
+            values->GetValue<int32_t>(playoutMinDelayMs_);
+        }
+        ret = Config::GetInstance().GetConfig("mediachannel", "rtpJitterBuffer", "maxDelayMs", values);
+        if (ret == CONFIGURE_ERROR_NONE) {
+            values->GetValue<int32_t>(playoutMaxDelayMs_);
+        }
+    }
+
+    enable = 0;
+    ret = Config::GetInstance().GetConfig("mediachannel", "rtpFec", "enable", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(enable);
+    }
+    ret = Config::GetInstance().GetConfig("mediachannel", "rtpFec", "payloadType", values);
+    if (enable != 0 && ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(fecPayloadType_);
+    }
+
+    enable = 0;
+    ret = Config::GetInstance().GetConfig("mediachannel", "rtcpReport", "enable", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(enable);
+    }
+    rtcpReportEnabled_ = enable != 0;
+    ret = Config::GetInstance().GetConfig("mediachannel", "rtcpReport", "intervalMs", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(rtcpReportIntervalMs_);
+    }
+    if (rtcpReportEnabled_) {
+        rtcpReportIntervalMs_ = std::max(rtcpReportIntervalMs_, 100); // 100: ms, keeps rtcp a small share of traffic
+        std::lock_guard<std::mutex> lock(rtcpMutex_);
+        rtcpContext_ = std::make_shared<RtcpReceiverContext>();
+    }
+
     return InitRtpUnpacker();
 }
 
 bool WfdRtpConsumer::Start()
 {
     SHARING_LOGD("trace.");
-    if (!StartNetworkServer(port_, rtpServer_.second, rtpServer_.first)) {
+    if (!StartRtpServer()) {
         SHARING_LOGE("start rtp server port: %{public}d failed.", port_);
         return false;
     }
 
+    if ((nackEnabled_ || keyFrameRequestEnabled_ || rtcpReportEnabled_) &&
+        !NetworkFactory::CreateUdpServer(port_ + 1, localIp_, shared_from_this(), rtcpServer_.second)) {
+        // playback works without it, only lost packets and key frames are not asked for
+        SHARING_LOGW("start rtcp server port: %{public}d failed.", port_ + 1);
+        rtcpServer_.second.reset();
+    } else if (rtcpServer_.second) {
+        rtcpServer_.first = rtcpServer_.second->GetSocketInfo()->GetLocalFd();
+    }
+
     SHARING_LOGD("start receiver server success.");
     isRunning_ = true;
+    if (rtcpReportEnabled_ && rtcpServer_.second) {
+        ScheduleRtcpReport(rtcpServer_.second);
+    }
+    if (playoutMaxDelayMs_ > 0) {
+        std::lock_guard<std::mutex> lock(rtpMutex_);
+        SchedulePlayoutPoll(rtpServer_.second);
+    }
     return true;
 }
 
@@ -164,14 +318,40 @@ bool WfdRtpConsumer::Stop()
 {
     SHARING_LOGD("trace.");
     isRunning_ = false;
-    if (rtpServer_.second) {
-        rtpServer_.second->Stop();
-        rtpServer_.second.reset();
+    NetworkFactory::ServerPtr server = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(rtpMutex_);
+        server = std::move(rtpServer_.second);
+        rtpServer_ = {0, nullptr};
+    }
+    if (server) {
+        server->Stop();
+        server.reset();
+    }
+
+    if (rtcpServer_.second) {
+        rtcpServer_.second->Stop();
+        rtcpServer_.second.reset();
+        SHARING_LOGI("nack sent: %{public}" PRIu64 ", pli sent: %{public}" PRIu64 ", recoveries: %{public}" PRIu64
+                     ", avg recovery: %{public}" PRId64 " ms, max recovery: %{public}" PRId64 " ms.",
+                     nackSent_, pliSent_, recoveries_, recoveries_ > 0 ? totalRecoveryMs_ / (int64_t)recoveries_ : 0,
+                     maxRecoveryMs_);
     }
 
-    if (rtpUnpacker_) {
-        rtpUnpacker_->Release();
-        rtpUnpacker_.reset();
+    {
+        std::lock_guard<std::mutex> lock(rtcpMutex_);
+        if (rtcpContext_) {
+            SHARING_LOGI("rtcp reports sent: %{public}" PRIu64 ", lost: %{public}zu, rtt: %{public}u ms.",
+                         rtcpReportSent_, rtcpContext_->GetLost(), rtcpContext_->GetRtt());
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(rtpMutex_);
+        if (rtpUnpacker_) {
+            rtpUnpacker_->Release();
+            rtpUnpacker_.reset();
+        }
     }
 
     return true;
@@ -204,6 +384,24 @@ bool WfdRtpConsumer::InitRtpUnpacker()
             std::bind(&WfdRtpConsumer::OnRtpUnpackCallback, this, std::placeholders::_1, std::placeholders::_2));
         // notify callback
         rtpUnpacker_->SetOnRtpNotify(std::bind(&WfdRtpConsumer::OnRtpUnpackNotify, this, std::placeholders::_1));
+        if (nackEnabled_) {
+            rtpUnpacker_->SetOnRtpLost(
+                std::bind(&WfdRtpConsumer::OnRtpLost, this, std::placeholders::_1, std::placeholders::_2));
+        }
+        if (keyFrameRequestEnabled_) {
+            rtpUnpacker_->SetOnKeyFrameRequest(
+                std::bind(&WfdRtpConsumer::OnKeyFrameRequest, this, std::placeholders::_1));
+        }
+        if (playoutMaxDelayMs_ > 0) {
+            rtpUnpacker_->SetPlayoutDelay(static_cast<uint32_t>(std::max(playoutMinDelayMs_, 0)),
+                                          static_cast<uint32_t>(playoutMaxDelayMs_));
+        }
+        if (fecPayloadType_ >= 0 && fecPayloadType_ <= 127) { // 127: 7 bit payload type
+            rtpUnpacker_->SetFecPayloadType(static_cast<uint8_t>(fecPayloadType_));
+        }
+        if (rtpDirect_) {
+            AddDirectRtpPayloads();
+        }
     } else {
         SHARING_LOGE("wfd init rtp unpacker failed.");
         return false;
@@ -212,6 +410,21 @@ bool WfdRtpConsumer::InitRtpUnpacker()
     return true;
 }
 
+void WfdRtpConsumer::AddDirectRtpPayloads()
+{
+    uint32_t sampleRate = audioTrack_.sampleRate > 0 ? audioTrack_.sampleRate : 48000; // 48000: wfd default
+    uint32_t channels = audioTrack_.channels > 0 ? audioTrack_.channels : 2;           // 2: wfd default
+    SHARING_LOGI("rtp direct video pt: %{public}u, audio pt: %{public}d, rate: %{public}u, channels: %{public}u.",
+                 rtpDirectVideoPt_, rtpDirectAudioPt_, sampleRate, channels);
+    // the decoders hand over annex-b nalus and adts frames like the ts decoder
+    rtpUnpacker_->AddPayload(RtpPlaylodParam{rtpDirectVideoPt_, 90000, RtpPayloadStream::H264}); // 90000: h264 clock
+    auto extra = std::make_shared<AACExtra>();
+    extra->aacConfig_ = MakeAacConfig(sampleRate, channels);
+    rtpUnpacker_->AddPayload(RtpPlaylodParam{static_cast<uint32_t>(rtpDirectAudioPt_),
+                                             static_cast<int32_t>(sampleRate), RtpPayloadStream::MPEG4_GENERIC,
+                                             extra});
+}
+
 void WfdRtpConsumer::OnRtpUnpackNotify(int32_t errCode)
 {
     SHARING_LOGD("errCode: %{public}d.", errCode);
@@ -275,6 +488,16 @@ void WfdRtpConsumer::HandleVideoKeyFrame()
         }
     }
 
+    if (keyFramePending_) {
+        auto recoveryMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                                 keyFrameRequested_).count();
+        keyFramePending_ = false;
+        recoveries_++;
+        totalRecoveryMs_ += recoveryMs;
+        maxRecoveryMs_ = std::max(maxRecoveryMs_, (int64_t)recoveryMs);
+        MEDIA_LOGD("video recovered after %{public}" PRId64 " ms.", (int64_t)recoveryMs);
+    }
+
     frameNums_ = 1;
     gopInterval_ = std::chrono::steady_clock::now();
 }
@@ -289,6 +512,9 @@ void WfdRtpConsumer::OnRtpUnpackCallback(uint32_t ssrc, const Frame::Ptr &frame)
     auto dispatcher = listener->GetDispatcher();
     RETURN_IF_NULL(dispatcher);
 
+    // the sink's clock recovery pairs each timestamp with the time it arrived
+    int64_t arrivalUs = GetMonotonicMicrosecond();
+    uint64_t pts = frame->Pts();
     MediaData::Ptr mediaData;
     if (frame->GetTrackType() == TRACK_AUDIO) {
         if (isPaused_ && (mediaTypePaused_ == MEDIA_TYPE_AUDIO || mediaTypePaused_ == MEDIA_TYPE_AV)) {
@@ -300,7 +526,8 @@ void WfdRtpConsumer::OnRtpUnpackCallback(uint32_t ssrc, const Frame::Ptr &frame)
         mediaData->keyFrame = false;
         mediaData->mediaType = MEDIA_TYPE_AUDIO;
         mediaData->buff = frame;
-        mediaData->pts = frame->Pts();
+        mediaData->pts = pts;
+        mediaData->arrivalUs = arrivalUs;
         MEDIA_LOGD("audio & put it into dispatcher: %{public}u, consumerId: %{public}u.", dispatcher->GetDispatcherId(),
                    GetId());
 
@@ -322,7 +549,8 @@ void WfdRtpConsumer::OnRtpUnpackCallback(uint32_t ssrc, const Frame::Ptr &frame)
             mediaData->isRaw = false;
             mediaData->keyFrame = false;
             mediaData->buff = frame;
-            mediaData->pts = frame->Pts();
+            mediaData->pts = pts;
+            mediaData->arrivalUs = arrivalUs;
 
             dispatcher->InputData(mediaData);
             frameNums_++;
@@ -360,7 +588,8 @@ void WfdRtpConsumer::OnRtpUnpackCallback(uint32_t ssrc, const Frame::Ptr &frame)
                     }
 
                     mediaData->buff->ReplaceData(buf, len);
-                    mediaData->pts = frame->Pts();
+                    mediaData->pts = pts;
+                    mediaData->arrivalUs = arrivalUs;
 
                     dispatcher->InputData(mediaData);
                 });
@@ -368,12 +597,174 @@ void WfdRtpConsumer::OnRtpUnpackCallback(uint32_t ssrc, const Frame::Ptr &frame)
     }
 }
 
+INetworkSession::Ptr WfdRtpConsumer::GetRtcpSession()
+{
+    std::lock_guard<std::mutex> lock(rtcpMutex_);
+    return rtcpSession_.lock();
+}
+
+void WfdRtpConsumer::OnRtpLost(uint32_t ssrc, const std::vector<uint16_t> &seqs)
+{
+    auto session = GetRtcpSession();
+    if (session == nullptr) {
+        MEDIA_LOGD("no sender report yet, drop nack of %{public}zu packets.", seqs.size());
+        return;
+    }
+
+    auto nack = RtcpFB::CreateNack(RTCP_SSRC, ssrc, seqs);
+    RETURN_IF_NULL(nack);
+    if (session->Send((const char *)nack.get(), nack->GetSize())) {
+        nackSent_++;
+    }
+}
+
+void WfdRtpConsumer::OnKeyFrameRequest(uint32_t ssrc)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (!keyFramePending_) {
+        keyFramePending_ = true;
+        keyFrameRequested_ = now;
+    } else if (now - pliSentTime_ < std::chrono::milliseconds(keyFrameRequestIntervalMs_)) {
+        return;
+    }
+
+    auto session = GetRtcpSession();
+    if (session == nullptr) {
+        MEDIA_LOGD("no sender report yet, drop pli.");
+        return;
+    }
+
+    auto pli = RtcpFB::CreatePli(RTCP_SSRC, ssrc);
+    RETURN_IF_NULL(pli);
+    if (session->Send((const char *)pli.get(), pli->GetSize())) {
+        pliSent_++;
+        pliSentTime_ = now;
+        SHARING_LOGI("pli sent, ssrc: %{public}u.", ssrc);
+    }
+}
+
+void WfdRtpConsumer::OnRtcpReadData(const DataBuffer::Ptr &buf, INetworkSession::Ptr session)
+{
+    RETURN_IF_NULL(buf);
+    auto rtcps = RtcpHeader::LoadFromBytes(buf->Data(), buf->Size());
+    if (session == nullptr || rtcps.empty()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(rtcpMutex_);
+    if (rtcpSession_.lock() != session) {
+        SHARING_LOGI("rtcp peer of consumer: %{public}u ready.", GetId());
+        rtcpSession_ = session;
+    }
+    if (rtcpContext_ == nullptr) {
+        return;
+    }
+    // sr for the lsr/dlsr of the next report, xr for the dlrr answer to our rrtr
+    for (auto &rtcp : rtcps) {
+        rtcpContext_->OnRtcp(rtcp);
+    }
+}
+
+void WfdRtpConsumer::FeedRtcpContext(const char *data, size_t size)
+{
+    if (rtcpContext_ == nullptr || data == nullptr || size < RtpPacket::RTP_HEADER_SIZE) {
+        return;
+    }
+
+    auto header = (const RtpHeader *)data;
+    // parity packets are not part of the media sequence, the audio stream is not reported on
+    if (header->version_ != RtpPacket::RTP_VERSION || (int32_t)header->pt_ == fecPayloadType_ ||
+        (int32_t)header->pt_ == rtpDirectAudioPt_) {
+        return;
+    }
+    mediaSsrc_ = ntohl(header->ssrc_);
+    rtcpContext_->OnRtp(ntohs(header->seq_), ntohl(header->stamp_), 0, 90000, size); // 90000: ts clock rate
+}
+
+void WfdRtpConsumer::ScheduleRtcpReport(const std::weak_ptr<IServer> &server)
+{
+    auto rtcpServer = server.lock();
+    RETURN_IF_NULL(rtcpServer);
+    std::weak_ptr<WfdRtpConsumer> weakSelf = shared_from_this();
+    // the server's own runner, the report never waits on media or on a thread of its own
+    auto task = [weakSelf, server]() {
+        auto self = weakSelf.lock();
+        if (self == nullptr || !self->isRunning_) {
+            return;
+        }
+        self->SendRtcpReport();
+        self->ScheduleRtcpReport(server);
+    };
+    if (!rtcpServer->PostTask(task, rtcpReportIntervalMs_)) {
+        SHARING_LOGW("post rtcp report failed, consumer: %{public}u.", GetId());
+    }
+}
+
+void WfdRtpConsumer::SchedulePlayoutPoll(const std::weak_ptr<IServer> &server)
+{
+    auto rtpServer = server.lock();
+    RETURN_IF_NULL(rtpServer);
+    std::weak_ptr<WfdRtpConsumer> weakSelf = shared_from_this();
+    // the same runner as the reads, rtpMutex_ only matters while a group join swaps the server
+    auto task = [weakSelf, server]() {
+        auto self = weakSelf.lock();
+        if (self == nullptr || !self->isRunning_) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(self->rtpMutex_);
+            if (self->rtpUnpacker_ != nullptr) {
+                self->rtpUnpacker_->Poll();
+            }
+        }
+        self->SchedulePlayoutPoll(server);
+    };
+    if (!rtpServer->PostTask(task, PLAYOUT_POLL_INTERVAL_MS)) {
+        SHARING_LOGW("post playout poll failed, consumer: %{public}u.", GetId());
+    }
+}
+
+void WfdRtpConsumer::SendRtcpReport()
+{
+    INetworkSession::Ptr session = nullptr;
+    DataBuffer::Ptr report = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(rtcpMutex_);
+        session = rtcpSession_.lock();
+        if (session == nullptr || rtcpContext_ == nullptr || mediaSsrc_ == 0) {
+            MEDIA_LOGD("no sender report or media yet, skip rtcp report.");
+            return;
+        }
+        // compound: rr first, then the xr carrying the rrtr
+        report = rtcpContext_->CreateRtcpRR(RTCP_SSRC, mediaSsrc_);
+        auto rrtr = rtcpContext_->CreateRtcpXRRRTR(RTCP_SSRC);
+        RETURN_IF_NULL(report);
+        if (rrtr) {
+            report->Append(rrtr->Peek(), rrtr->Size());
+        }
+    }
+
+    if (session->Send(report->Peek(), report->Size())) {
+        rtcpReportSent_++;
+    }
+}
+
 void WfdRtpConsumer::OnServerReadData(int32_t fd, DataBuffer::Ptr buf, INetworkSession::Ptr sesssion)
 {
+    if (rtcpServer_.second && fd == rtcpServer_.first) {
+        OnRtcpReadData(buf, sesssion);
+        return;
+    }
+
     if (isFirstPacket_) {
         WfdSinkHiSysEvent::GetInstance().Report(__func__, "", SinkStage::RECEIVE_DATA, SinkStageRes::SUCCESS);
     }
+    std::lock_guard<std::mutex> lock(rtpMutex_);
     if (rtpUnpacker_ != nullptr && isRunning_) {
+        if (rtcpReportEnabled_) {
+            std::lock_guard<std::mutex> lock(rtcpMutex_);
+            FeedRtcpContext(buf->Peek(), buf->Size());
+        }
         rtpUnpacker_->ParseRtp(buf->Peek(), buf->Size());
         if (isFirstPacket_) {
             SHARING_LOGD("TEST STATISTICS Miracast:first, agent ID:%{public}d, recv first packet.", GetSinkAgentId());
@@ -382,6 +773,13 @@ void WfdRtpConsumer::OnServerReadData(int32_t fd, DataBuffer::Ptr buf, INetworkS
     }
 }
 
+void WfdRtpConsumer::OnServerReadBatch(int32_t fd, std::vector<DataBuffer::Ptr> &bufs, INetworkSession::Ptr session)
+{
+    for (auto &buf : bufs) {
+        OnServerReadData(fd, buf, session);
+    }
+}
+
 bool WfdRtpConsumer::StartNetworkServer(uint16_t port, NetworkFactory::ServerPtr &server, int32_t &fd)
 {
     SHARING_LOGD("trace.");
@@ -400,6 +798,37 @@ bool WfdRtpConsumer::StartNetworkServer(uint16_t port, NetworkFactory::ServerPtr
     return true;
 }
 
+bool WfdRtpConsumer::StartRtpServer()
+{
+    SHARING_LOGD("trace.");
+    // built outside rtpMutex_, the server reads as soon as it exists and a failed one is stopped here
+    NetworkFactory::ServerPtr server = nullptr;
+    int32_t fd = 0;
+    if (multicastGroup_.empty()) {
+        if (!StartNetworkServer(port_, server, fd)) {
+            return false;
+        }
+    } else {
+        // a socket bound to the unicast address never sees the datagrams of the group
+        uint16_t port = multicastPort_ > 0 ? multicastPort_ : port_;
+        if (!NetworkFactory::CreateUdpServer(port, "", shared_from_this(), server) ||
+            !server->JoinMulticastGroup(multicastGroup_, localIp_)) {
+            SHARING_LOGE("join group %{public}s port: %{public}u failed.", GetAnonymousIp(multicastGroup_).c_str(),
+                         port);
+            if (server) {
+                server->Stop();
+                server.reset();
+            }
+            return false;
+        }
+        fd = server->GetSocketInfo()->GetLocalFd();
+    }
+
+    std::lock_guard<std::mutex> lock(rtpMutex_);
+    rtpServer_ = {fd, std::move(server)};
+    return true;
+}
+
 REGISTER_CLASS_REFLECTOR(WfdRtpConsumer);
 } // namespace Sharing
 } // namespace OHOS
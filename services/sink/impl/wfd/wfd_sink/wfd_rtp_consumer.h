@@ -18,6 +18,8 @@
 
 #include <atomic>
 #include <chrono>
+#include <mutex>
+#include <vector>
 #include "common/common_macro.h"
 #include "common/object.h"
 #include "mediachannel/base_consumer.h"
@@ -48,21 +50,36 @@ public:
     void OnServerException(int32_t fd) override {}
     void OnAccept(std::weak_ptr<INetworkSession> session) override {}
     void OnServerReadData(int32_t fd, DataBuffer::Ptr buf, INetworkSession::Ptr session = nullptr) override;
+    void OnServerReadBatch(int32_t fd, std::vector<DataBuffer::Ptr> &bufs,
+                           INetworkSession::Ptr session = nullptr) override;
 
     int32_t Release() override;
     int32_t HandleEvent(SharingEvent &event) override;
 
 private:
     void HandleProsumerInitState(SharingEvent &event);
+    void HandleJoinGroup(SharingEvent &event);
 
     void OnRtpUnpackNotify(int32_t errCode);
     void OnRtpUnpackCallback(uint32_t ssrc, const Frame::Ptr &frame);
+    void OnRtpLost(uint32_t ssrc, const std::vector<uint16_t> &seqs);
+    void OnKeyFrameRequest(uint32_t ssrc);
+    void OnRtcpReadData(const DataBuffer::Ptr &buf, INetworkSession::Ptr session);
+    INetworkSession::Ptr GetRtcpSession();
+    // with rtcpMutex_ held
+    void FeedRtcpContext(const char *data, size_t size);
+    void ScheduleRtcpReport(const std::weak_ptr<IServer> &server);
+    // the playout delay runs out on the rtp server's event loop even when no packet comes in
+    void SchedulePlayoutPoll(const std::weak_ptr<IServer> &server);
+    void SendRtcpReport();
 
     bool Init();
     bool Stop();
     bool Start();
     bool InitRtpUnpacker();
+    void AddDirectRtpPayloads();
     bool StartNetworkServer(uint16_t port, NetworkFactory::ServerPtr &server, int32_t &fd);
+    bool StartRtpServer();
     void HandleVideoKeyFrame();
     
     // 定义一个模板函数来处理 SPS 和 PPS 的更新逻辑
@@ -81,11 +98,51 @@ private:
 
     uint16_t port_ = 0;
     std::string localIp_;
+    // the source's multicast group, the rtp server binds the any address and joins it; empty for unicast
+    std::string multicastGroup_;
+    uint16_t multicastPort_ = 0;
     int32_t frameNums_ = 1;
     uint32_t contextId_ = 0;
 
     std::chrono::steady_clock::time_point gopInterval_;
+    // guards rtpServer_ and the unpacker, a group join starts a second server while the first may still read
+    std::mutex rtpMutex_;
     std::pair<int32_t, NetworkFactory::ServerPtr> rtpServer_ = {0, nullptr};
+    // rtp port + 1, feedback goes back to where the sender reports come from
+    std::pair<int32_t, NetworkFactory::ServerPtr> rtcpServer_ = {0, nullptr};
+
+    bool nackEnabled_ = false;
+    uint64_t nackSent_ = 0;
+    // pli while the decoder waits for a key frame, resent every keyFrameRequestIntervalMs_
+    bool keyFrameRequestEnabled_ = false;
+    int32_t keyFrameRequestIntervalMs_ = 200;
+    bool keyFramePending_ = false;
+    std::chrono::steady_clock::time_point keyFrameRequested_;
+    std::chrono::steady_clock::time_point pliSentTime_;
+    uint64_t pliSent_ = 0;
+    uint64_t recoveries_ = 0;
+    int64_t totalRecoveryMs_ = 0;
+    int64_t maxRecoveryMs_ = 0;
+    // adaptive reorder delay, a packet count window when the max is 0
+    int32_t playoutMinDelayMs_ = 0;
+    int32_t playoutMaxDelayMs_ = 0;
+    static constexpr int64_t PLAYOUT_POLL_INTERVAL_MS = 5; // 5: half the smallest target delay
+    // payload type of the source's parity packets, -1 without fec
+    int32_t fecPayloadType_ = -1;
+    // h264 and aac in rtp streams of their own next to the ts decoder, -1 while the source sends ts
+    bool rtpDirect_ = false;
+    uint8_t rtpDirectVideoPt_ = 0;
+    int32_t rtpDirectAudioPt_ = -1;
+    // rr + rrtr every rtcpReportIntervalMs_, on the rtcp server's event loop
+    bool rtcpReportEnabled_ = false;
+    int32_t rtcpReportIntervalMs_ = 1000;
+    uint64_t rtcpReportSent_ = 0;
+    std::mutex rtcpMutex_;
+    // learned from the first sender report; in a multicast group only the sink the source set up rtcp with has one
+    std::weak_ptr<INetworkSession> rtcpSession_;
+    RtcpReceiverContext::Ptr rtcpContext_ = nullptr;
+    uint32_t mediaSsrc_ = 0;
+    static constexpr uint32_t RTCP_SSRC = 0x3000;
 
     std::atomic<int> mediaTypePaused_ = MEDIA_TYPE_AV;
 
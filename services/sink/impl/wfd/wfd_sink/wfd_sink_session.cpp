@@ -19,6 +19,7 @@
 #include "common/common_macro.h"
 #include "common/reflect_registration.h"
 #include "common/sharing_log.h"
+#include "configuration/include/config.h"
 #include "extend/magic_enum/magic_enum.hpp"
 #include "mediachannel/media_channel_def.h"
 #include "utils/utils.h"
@@ -113,6 +114,14 @@ void WfdSinkSession::HandleSessionInit(SharingEvent &event)
         SHARING_LOGE("unknow event msg.");
     }
 
+    int32_t enable = 0;
+    SharingValue::Ptr values = nullptr;
+    auto ret = Config::GetInstance().GetConfig("mediachannel", "rtpDirect", "enable", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(enable);
+    }
+    rtpDirectEnabled_ = enable != 0;
+
     SHARING_LOGI("sessionInit localIp: %{public}s, remoteIp: %{public}s", GetAnonymousIp(localIp_).c_str(),
         GetAnonymousIp(remoteRtspIp_).c_str());
 }
@@ -260,6 +269,9 @@ void WfdSinkSession::NotifyProsumerInit(SessionStatusMsg::Ptr &statusMsg)
     eventMsg->audioTrack = audioTrack_;
     eventMsg->videoTrack = videoTrack_;
     eventMsg->isPcSource = isPcSource_;
+    eventMsg->rtpDirect = rtpDirect_;
+    eventMsg->videoPt = rtpDirectVideoPt_;
+    eventMsg->audioPt = rtpDirectAudioPt_;
 
     statusMsg->msg = std::move(eventMsg);
     statusMsg->status = NOTIFY_SESSION_PRIVATE_EVENT;
@@ -580,6 +592,14 @@ void WfdSinkSession::HandleM6Response(const RtspResponse &response, const std::s
         keepAliveTimeout_ = WFD_KEEP_ALIVE_TIMEOUT_DEFAULT;
     }
 
+    WfdRtspM6Response m6Response;
+    if (m6Response.Parse(message).code == RtspErrorType::OK) {
+        auto group = m6Response.GetDestination();
+        if (!group.empty()) {
+            NotifyJoinGroup(group, static_cast<uint16_t>(m6Response.GetMulticastPort()));
+        }
+    }
+
     SendM7Request();
 }
 
@@ -646,6 +666,20 @@ void WfdSinkSession::NotifyAgentPrivateEvent(EventType type)
     NotifyAgentSessionStatus(statusMsg);
 }
 
+void WfdSinkSession::NotifyJoinGroup(const std::string &group, uint16_t port)
+{
+    SHARING_LOGI("multicast group: %{public}s, port: %{public}u.", GetAnonymousIp(group).c_str(), port);
+    auto statusMsg = std::make_shared<SessionStatusMsg>();
+    auto eventMsg = std::make_shared<WfdConsumerEventMsg>();
+    eventMsg->type = EventType::EVENT_WFD_MEDIA_JOIN_GROUP;
+    eventMsg->toMgr = ModuleType::MODULE_MEDIACHANNEL;
+    eventMsg->ip = group;
+    eventMsg->port = port;
+    statusMsg->msg = std::move(eventMsg);
+    statusMsg->status = NOTIFY_SESSION_PRIVATE_EVENT;
+    NotifyAgentSessionStatus(statusMsg);
+}
+
 void WfdSinkSession::HandleCommonResponse(const RtspResponse &response, const std::string &message)
 {
     SHARING_LOGD("trace.");
@@ -772,6 +806,8 @@ void WfdSinkSession::SetM3ResponseParam(std::list<std::string> &params, WfdRtspM
             m3Response.SetCustomParam(WFD_PARAM_RTCP_CAPABILITY, wfdParamsInfo_.microsofRtcpCapability);
         } else if (param == WFD_PARAM_IDR_REQUEST_CAPABILITY) {
             m3Response.SetCustomParam(WFD_PARAM_IDR_REQUEST_CAPABILITY, wfdParamsInfo_.idrRequestCapablity);
+        } else if (param == WFD_PARAM_RTP_DIRECT) {
+            m3Response.SetCustomParam(WFD_PARAM_RTP_DIRECT, rtpDirectEnabled_ ? WFD_RTP_DIRECT_CAPABILITY : "none");
         }
     }
 }
@@ -806,6 +842,10 @@ bool WfdSinkSession::HandleM4Request(const std::string &message)
     rtspUrl_ = m4Request.GetPresentationUrl();
     m4Request.GetVideoTrack(videoTrack_);
     m4Request.GetAudioTrack(audioTrack_);
+    rtpDirect_ = rtpDirectEnabled_ && m4Request.GetRtpDirect(rtpDirectVideoPt_, rtpDirectAudioPt_);
+    if (rtpDirect_) {
+        SHARING_LOGI("rtp direct video pt: %{public}u, audio pt: %{public}u.", rtpDirectVideoPt_, rtpDirectAudioPt_);
+    }
     int incomingCSeq = m4Request.GetCSeq();
     if (timeoutTimer_ && isFirstCast) {
         timeoutTimer_->StartTimer(WFD_TIMEOUT_6_SECOND, "Waiting for M5/SET_PARAMETER Triger request");
@@ -64,6 +64,7 @@ private:
     void HandleProsumerInitState(SharingEvent &event);
 
     void NotifyAgentPrivateEvent(EventType type);
+    void NotifyJoinGroup(const std::string &group, uint16_t port);
     void NotifySessionInterrupted();
     void NotifyServiceError(SharingErrorCode errorCode = ERR_INTERACTION_FAILURE);
 
@@ -120,6 +121,11 @@ private:
     AudioTrack audioTrack_;
     VideoTrack videoTrack_;
     WfdParamsInfo wfdParamsInfo_;
+    // h264 and aac in rtp streams of their own, offered in m3 when enabled, used when m4 selects it
+    bool rtpDirectEnabled_ = false;
+    bool rtpDirect_ = false;
+    uint8_t rtpDirectVideoPt_ = 0;
+    uint8_t rtpDirectAudioPt_ = 0;
 };
 
 } // namespace Sharing
@@ -31,15 +31,16 @@ namespace Sharing {
 class AudioPlayController {
 public:
     explicit AudioPlayController(uint32_t mediaChannelId);
-    ~AudioPlayController();
+    virtual ~AudioPlayController();
 
     void Release();
     void SetVolume(float volume);
     void Stop(BufferDispatcher::Ptr &dispatcher);
-    void DropOneFrame();
+    virtual void DropOneFrame();
     bool Init(AudioTrack &audioTrack, bool isPcSource);
     bool Start(BufferDispatcher::Ptr &dispatcher);
-    int64_t GetAudioDecoderTimestamp();
+    // pts being heard now, 0 while no audio plays
+    virtual int64_t GetAudioDecoderTimestamp();
     void SetAudioFocusState(bool hasFocus);
 
 protected:
@@ -76,6 +76,16 @@ protected:
     void OnVideoDataDecoded(DataBuffer::Ptr decodedData) final;
 
 private:
+    // what the dispatcher read left in the input buffer, size 0: nothing
+    struct FeedFrame {
+        int32_t size = 0;
+        uint64_t pts = 0;
+        bool keyFrame = false;
+        int64_t arrivalUs = 0;
+    };
+
+    void ReadIntoInput(const MediaData::Ptr &data, const VideoSinkDecoder::InputBuffer &input, FeedFrame &frame);
+
     void StopVideoThread();
     void VideoPlayThread();
     void StartVideoThread();
@@ -96,6 +106,7 @@ private:
     std::shared_ptr<std::thread> videoPlayThread_ = nullptr;
     std::shared_ptr<BufferReceiver> bufferReceiver_ = nullptr;
     std::shared_ptr<VideoSinkDecoder> videoSinkDecoder_ = nullptr;
+    std::shared_ptr<VideoAudioSync> videoAudioSync_ = nullptr;
 
     VideoTrack videoTrack_;
 };
@@ -79,6 +79,10 @@ void MediaController::Start()
 
     auto dispatcher = mediaChannel->GetDispatcher();
     RETURN_IF_NULL(dispatcher);
+    if (nullptr != videoAudioSync_) {
+        // the source clock is recovered again, timestamps may restart after a pause
+        videoAudioSync_->Reset();
+    }
     {
         std::lock_guard<std::mutex> lock(playAudioMutex_);
         if (nullptr != audioPlayController_) {
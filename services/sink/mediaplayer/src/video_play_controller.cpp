@@ -14,7 +14,6 @@
  */
 
 #include "video_play_controller.h"
-#include <chrono>
 #include <securec.h>
 #include "avcodec_errors.h"
 #include "common/common_macro.h"
@@ -205,48 +204,93 @@ void VideoPlayController::VideoPlayThread()
 {
     SHARING_LOGD("video play thread start mediaChannelId: %{public}u tid: %{public}d.", mediachannelId_, gettid());
     while (isVideoRunning_) {
-        MediaData::Ptr outData = std::make_shared<MediaData>();
-        outData->buff = std::make_shared<DataBuffer>();
-        int32_t ret = 0;
-        if (bufferReceiver_) {
-            ret = bufferReceiver_->RequestRead(MediaType::MEDIA_TYPE_VIDEO, [&outData](const MediaData::Ptr &data) {
-                if (data == nullptr) {
-                    return;
-                }
-                outData->buff->ReplaceData(data->buff->Peek(), data->buff->Size());
-                outData->keyFrame = data->keyFrame;
-                outData->mediaType = data->mediaType;
-                outData->pts = data->pts;
-                outData->isRaw = data->isRaw;
-                outData->ssrc = data->ssrc;
-            });
+        if (!videoSinkDecoder_ || !bufferReceiver_) {
+            break;
         }
-        if (ret != 0) {
+
+        // the codec buffer first: nothing is held on the dispatcher side while the codec is busy
+        VideoSinkDecoder::InputBuffer input;
+        if (!videoSinkDecoder_->AcquireInputBuffer(input, DECODE_WAIT_MILLISECONDS)) {
+            if (isVideoRunning_) {
+                WfdSinkHiSysEvent::GetInstance().ReportError(__func__, "", SinkStage::VIDEO_DECODE,
+                                                             SinkErrorCode::WIFI_DISPLAY_VIDEO_DECODE_TIMEOUT);
+                SHARING_LOGD("index queue empty, mediachannelId: %{public}u.", mediachannelId_);
+            }
             continue;
         }
-        if (videoSinkDecoder_) {
-            if (outData->keyFrame) {
-                MEDIA_LOGD("get key frame.");
-                auto sps = bufferReceiver_->GetSPS();
-                if (sps != nullptr && sps->buff != nullptr) {
-                    MEDIA_LOGD("get sps from dispatcher.");
-                    ProcessVideoData(sps->buff->Peek(), sps->buff->Size(), outData->pts);
-                }
-                auto pps = bufferReceiver_->GetPPS();
-                if (pps != nullptr && pps->buff != nullptr) {
-                    MEDIA_LOGD("get pps from dispatcher.");
-                    ProcessVideoData(pps->buff->Peek(), pps->buff->Size(), outData->pts);
-                }
-            }
-            MEDIA_LOGD("process video data, size: %{public}d, keyFrame: %{public}d.", outData->buff->Size(),
-                       outData->keyFrame);
-            ProcessVideoData(outData->buff->Peek(), outData->buff->Size(), outData->pts);
+
+        FeedFrame frame;
+        int32_t ret = bufferReceiver_->RequestRead(MediaType::MEDIA_TYPE_VIDEO, [this, &input, &frame](
+                                                       const MediaData::Ptr &data) {
+            ReadIntoInput(data, input, frame);
+        });
+        if (ret != 0 || frame.size <= 0) {
+            videoSinkDecoder_->RecycleInputBuffer(input);
+            continue;
+        }
+
+        if (videoAudioSync_ != nullptr && frame.arrivalUs > 0) {
+            videoAudioSync_->OnVideoArrival(static_cast<int64_t>(frame.pts), frame.arrivalUs);
+        }
+
+        MEDIA_LOGD("process video data, size: %{public}d, keyFrame: %{public}d.", frame.size, frame.keyFrame);
+        if (!videoSinkDecoder_->QueueInputBuffer(input, frame.size, frame.pts, frame.keyFrame)) {
+            WfdSinkHiSysEvent::GetInstance().ReportError(__func__, "", SinkStage::VIDEO_DECODE,
+                                                         SinkErrorCode::WIFI_DISPLAY_VIDEO_DECODE_FAILED);
+            SHARING_LOGE("sink decode data failed.");
         }
     }
 
     SHARING_LOGD("play thread exit, mediachannelId: %{public}u tid: %{public}d.", mediachannelId_, gettid());
 }
 
+void VideoPlayController::ReadIntoInput(const MediaData::Ptr &data, const VideoSinkDecoder::InputBuffer &input,
+                                        FeedFrame &frame)
+{
+    // runs inside the dispatcher read, one copy straight into codec memory
+    if (data == nullptr || data->buff == nullptr || input.memory == nullptr) {
+        return;
+    }
+
+    // a key frame goes as one access unit with its parameter sets in band ahead of it, still one copy of each
+    MediaData::Ptr paramSets[] = {nullptr, nullptr};
+    if (data->keyFrame) {
+        MEDIA_LOGD("get key frame.");
+        paramSets[0] = bufferReceiver_->GetSPS();
+        paramSets[1] = bufferReceiver_->GetPPS();
+    }
+
+    auto base = input.memory->GetBase();
+    int32_t capacity = input.memory->GetSize();
+    int32_t offset = 0;
+    for (auto &nalu : paramSets) {
+        if (nalu == nullptr || nalu->buff == nullptr || nalu->buff->Size() <= 0) {
+            continue;
+        }
+        if (memcpy_s(base + offset, static_cast<size_t>(capacity - offset), nalu->buff->Peek(),
+                     static_cast<size_t>(nalu->buff->Size())) != EOK) {
+            SHARING_LOGE("copy sps/pps failed.");
+            return;
+        }
+        offset += nalu->buff->Size();
+    }
+
+    int32_t size = data->buff->Size();
+    if (size <= 0 || size > capacity - offset) {
+        SHARING_LOGE("frame size %{public}d does not fit input buffer %{public}d.", offset + size, capacity);
+        return;
+    }
+
+    if (memcpy_s(base + offset, static_cast<size_t>(capacity - offset), data->buff->Peek(), size) != EOK) {
+        SHARING_LOGE("copy frame failed.");
+        return;
+    }
+    frame.size = offset + size;
+    frame.pts = data->pts;
+    frame.keyFrame = data->keyFrame;
+    frame.arrivalUs = data->arrivalUs;
+}
+
 void VideoPlayController::ProcessVideoData(const char *data, int32_t size, uint64_t pts)
 {
     MEDIA_LOGD("trace.");
@@ -255,25 +299,6 @@ void VideoPlayController::ProcessVideoData(const char *data, int32_t size, uint6
         return;
     }
 
-    {
-        std::unique_lock<std::mutex> lock(videoSinkDecoder_->inMutex_);
-        if (videoSinkDecoder_->inQueue_.empty()) {
-            while (isVideoRunning_) {
-                SHARING_LOGD("try wait, mediachannelId: %{public}u.", mediachannelId_);
-                videoSinkDecoder_->inCond_.wait_for(lock, std::chrono::milliseconds(DECODE_WAIT_MILLISECONDS),
-                                                    [this]() { return (!videoSinkDecoder_->inQueue_.empty()); });
-
-                if (videoSinkDecoder_->inQueue_.empty()) {
-                    WfdSinkHiSysEvent::GetInstance().ReportError(__func__, "", SinkStage::VIDEO_DECODE,
-                                                                SinkErrorCode::WIFI_DISPLAY_VIDEO_DECODE_TIMEOUT);
-                    SHARING_LOGD("index queue empty, mediachannelId: %{public}u.", mediachannelId_);
-                    continue;
-                }
-                break;
-            }
-        }
-    }
-
     if (!isVideoRunning_) {
         SHARING_LOGD("stop return, mediachannelId: %{public}u.", mediachannelId_);
         return;
@@ -434,6 +459,7 @@ void VideoPlayController::OnKeyModeNotify(bool enable)
 
 void VideoPlayController::SetVideoAudioSync(std::shared_ptr<VideoAudioSync> videoAudioSync)
 {
+    videoAudioSync_ = videoAudioSync;
     if (videoSinkDecoder_ != nullptr) {
         videoSinkDecoder_->SetVideoAudioSync(videoAudioSync);
     }
@@ -26,16 +26,24 @@ class RtpDecoder {
 public:
     using Ptr = std::shared_ptr<RtpDecoder>;
     using OnFrame = std::function<void(const Frame::Ptr &frame)>;
+    // video can not be decoded until the next key frame
+    using OnKeyFrameNeeded = std::function<void()>;
 
     virtual void SetOnFrame(const OnFrame &cb) = 0;
     virtual void InputRtp(const RtpPacket::Ptr &rtp) = 0;
 
+    virtual void SetOnKeyFrameNeeded(const OnKeyFrameNeeded &cb)
+    {
+        onKeyFrameNeeded_ = cb;
+    }
+
 protected:
     RtpDecoder() = default;
     virtual ~RtpDecoder() = default;
 
 protected:
     OnFrame onFrame_ = nullptr;
+    OnKeyFrameNeeded onKeyFrameNeeded_ = nullptr;
 };
 } // namespace Sharing
 } // namespace OHOS
@@ -16,18 +16,21 @@
 #ifndef OHOS_SHARING_RTP_DECODER_TS_H
 #define OHOS_SHARING_RTP_DECODER_TS_H
 
-#include <condition_variable>
+#include <map>
 #include <memory>
-#include <queue>
-#include <thread>
+#include <mutex>
+#include <vector>
 #include "frame/frame.h"
 #include "rtp_decoder.h"
-extern "C" {
-#include <libavformat/avformat.h>
-}
+#include "ts_def.h"
 
 namespace OHOS {
 namespace Sharing {
+/**
+ * Streaming MPEG-TS over RTP demuxer. TS packets are parsed in place inside the
+ * sorted rtp packets and PES payloads are collected as views of them, frames are
+ * emitted on the calling thread as soon as a PES is complete.
+ */
 class RtpDecoderTs : public RtpDecoder {
 public:
     using Ptr = std::shared_ptr<RtpDecoderTs>;
@@ -39,27 +42,49 @@ public:
 
     void InputRtp(const RtpPacket::Ptr &rtp) override;
     void SetOnFrame(const OnFrame &cb) override;
+    void SetOnKeyFrameNeeded(const OnKeyFrameNeeded &cb) override;
 
 private:
-    void StartDecoding();
-    int ReadPacket(uint8_t *buf, int buf_size);
+    struct PesView {
+        RtpPacket::Ptr rtp = nullptr;
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+    };
+
+    struct TsStream {
+        uint8_t streamType = 0;
+        TrackType trackType = TRACK_INVALID;
+        int32_t counter = -1;
+        bool pesOpen = false;
+        size_t pesRemaining = 0; // 0: unbounded, ends with the next unit start
+        size_t pesSize = 0;
+        uint64_t pts = 0;
+        uint64_t dts = 0;
+        std::vector<PesView> views;
+    };
 
-    static int StaticReadPacket(void *opaque, uint8_t *buf, int buf_size);
+    void InputTsPacket(const RtpPacket::Ptr &rtp, const uint8_t *packet);
+    void InputPes(TsStream &stream, const RtpPacket::Ptr &rtp, const uint8_t *payload, size_t size, bool unitStart);
+    bool StartPes(TsStream &stream, const RtpPacket::Ptr &rtp, const uint8_t *payload, size_t size);
+    void FlushPes(TsStream &stream);
+    void ResetPes(TsStream &stream);
+    void ParseSection(uint16_t pid, const uint8_t *payload, size_t size);
+    void ParsePat(const uint8_t *section, size_t size);
+    void ParsePmt(const uint8_t *section, size_t size);
+    void OutputFrame(const Frame::Ptr &frame);
+    uint64_t UnwrapTimestamp(uint64_t ts);
 
 private:
     constexpr static int64_t US_PER_SEC = 1000 * 1000;
+    constexpr static uint64_t INVALID_TIMESTAMP = UINT64_MAX;
 
     bool exit_ = false;
-    int videoStreamIndex_ = -1;
-    int audioStreamIndex_ = -1;
-
-    std::mutex queueMutex_;
-    std::condition_variable queueCond_;
-    std::queue<RtpPacket::Ptr> dataQueue_;
-    std::unique_ptr<std::thread> decodeThread_;
+    int32_t pmtVersion_ = -1;
+    uint16_t pmtPid_ = TS_PID_NULL;
+    uint64_t lastTimestamp_ = INVALID_TIMESTAMP; // unwrapped, shared by all the streams of the program
 
-    AVIOContext *avioContext_ = nullptr;
-    AVFormatContext *avFormatContext_ = nullptr;
+    std::mutex decoderMutex_;
+    std::map<uint16_t, TsStream> streams_;
 };
 } // namespace Sharing
 } // namespace OHOS
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_RTP_FEC_DECODER_H
+#define OHOS_SHARING_RTP_FEC_DECODER_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "rtp_fec.h"
+#include "utils/data_buffer.h"
+
+namespace OHOS {
+namespace Sharing {
+/**
+ * Rebuilds a lost media packet from the xor parity of its group. Received
+ * media packets are copied into a small ring indexed by seq, long enough to
+ * still hold a group when its parity arrives. Runs on the receiving thread
+ * ahead of the reorder buffer, a rebuilt packet goes the way a received one
+ * would.
+ *
+ * Only the ssrc the parity is sent on is protected, other streams on the
+ * port (the audio of a direct rtp session) have their own seq space and are
+ * kept out of the ring once a parity packet told which ssrc that is.
+ */
+class RtpFecDecoder {
+public:
+    using Ptr = std::shared_ptr<RtpFecDecoder>;
+    using OnRecovered = std::function<void(const char *data, size_t len)>;
+
+    struct Stats {
+        uint64_t parity = 0;
+        uint64_t recovered = 0;
+        uint64_t unrecoverable = 0; // more than one packet of the group lost
+    };
+
+    explicit RtpFecDecoder(uint8_t pt);
+
+    uint8_t GetPayloadType() const;
+    void SetOnRecovered(const OnRecovered &cb);
+
+    void Clear();
+    void InputMedia(const char *data, size_t len);
+    void InputFec(const char *data, size_t len);
+
+    Stats GetStats() const;
+
+private:
+    struct Slot {
+        DataBuffer::Ptr rtp = nullptr;
+        uint16_t seq = 0;
+        uint32_t ssrc = 0;
+    };
+
+    const Slot *FindMedia(uint16_t seq, uint32_t ssrc) const;
+
+private:
+    static constexpr size_t MEDIA_SLOTS = 64; // 64: a few groups, power of two
+
+    uint8_t pt_ = 0;
+    bool ssrcKnown_ = false;
+    uint32_t ssrc_ = 0; // network order, as the parity carries it
+    OnRecovered onRecovered_ = nullptr;
+    std::vector<Slot> slots_;
+    std::vector<uint8_t> recovered_;
+    Stats stats_;
+};
+} // namespace Sharing
+} // namespace OHOS
+#endif
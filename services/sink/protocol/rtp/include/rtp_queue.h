@@ -16,18 +16,48 @@
 #ifndef OHOS_SHARING_RTP_QUEUE_H
 #define OHOS_SHARING_RTP_QUEUE_H
 
+#include <chrono>
 #include <cstdlib>
 #include <functional>
-#include <map>
+#include <unordered_set>
+#include <vector>
 #include "sink/common/include/sharing_sink_hisysevent.h"
 #include "rtp_packet.h"
 
 namespace OHOS {
 namespace Sharing {
+/**
+ * Reorders rtp packets by sequence number. Packets waiting for an earlier seq
+ * are kept in a ring indexed by seq & mask_, with a bitmap of the occupied
+ * slots, so that insertion and the in-order drain never allocate. The ring
+ * covers more than kMax seqs ahead of the next expected one; a packet beyond
+ * it is a restart and flushes what is cached.
+ *
+ * By default a missing packet is waited for until a packet count window,
+ * growing from kMin to kMax, is full. With SetPlayoutDelay it is waited for
+ * until the packet after it has been cached for the target delay instead, and
+ * the owner calls Poll so that a stall of the stream doesn't hold the cache back.
+ * The target follows the interarrival jitter (RFC 3550 6.4.1): it rises at
+ * once with the jitter or a late packet and decays slowly when the link calms.
+ */
 class RtpPacketSortor {
 public:
     using Ptr = std::shared_ptr<RtpPacketSortor>;
     using OnSort = std::function<void(uint16_t seq, const RtpPacket::Ptr &packet)>;
+    // seqs still missing once REORDER_PACKETS later ones arrived, in ascending order
+    using OnLost = std::function<void(const std::vector<uint16_t> &seqs)>;
+
+    struct LossStats {
+        uint64_t nacked = 0;      // reported through OnLost
+        uint64_t recovered = 0;   // arrived later, in time to be sorted
+        uint64_t unrecovered = 0; // given up when the cache was full
+    };
+
+    struct PlayoutStats {
+        uint32_t targetDelayMs = 0;
+        uint32_t jitterMs = 0;
+        uint64_t lateDrops = 0; // arrived after their seq was played out or skipped
+    };
 
     RtpPacketSortor(int32_t sampleRate, size_t kMax = 1024, size_t kMin = SORT_CACHE_MIN_SIZE);
     ~RtpPacketSortor() = default;
@@ -35,7 +65,12 @@ public:
     void Clear();
     void Flush();
     void SetOnSort(const OnSort &cb);
+    void SetOnLost(const OnLost &cb);
     void SortPacket(uint16_t seq, RtpPacket::Ptr packet);
+    // switches to the time based window, maxDelayMs 0 switches back to the packet count one
+    void SetPlayoutDelay(uint32_t minDelayMs, uint32_t maxDelayMs);
+    // releases what waited out the playout delay while nothing arrived, time based window only
+    void Poll();
     void InputRtp(TrackType type, uint8_t *ptr, size_t len);
 
     uint32_t GetSSRC() const;
@@ -43,16 +78,41 @@ public:
     size_t GetJitterSize() const;
 
     int32_t GetRtpPacketLostCount() const;
+    LossStats GetLossStats() const;
+    uint32_t GetTargetDelay() const;
+    PlayoutStats GetPlayoutStats() const;
 
 private:
+    using Clock = std::chrono::steady_clock;
+
+    static int64_t NowMs();
+    void SortPacket(uint16_t seq, RtpPacket::Ptr packet, int64_t nowMs);
     bool IsSeqValid(uint16_t seq) const;
+    void UpdateJitter(const RtpPacket::Ptr &packet, int64_t nowMs);
+    void OnLatePacket();
+    bool IsWaitOver(int64_t nowMs) const;
+    void DetectLoss(uint16_t seq);
+    bool IsMissing(uint16_t seq) const;
+    void GiveUpLost(uint16_t from, uint16_t to);
     void SetSortSize();
-    void TryPopPacket();
-    void PopIterator(std::map<uint16_t, RtpPacket::Ptr>::iterator it);
+    void TryPopPacket(int64_t nowMs = 0);
+    void PopSlot(uint16_t seq);
+    bool IsSlotUsed(uint16_t seq) const;
+    void StoreSlot(uint16_t seq, RtpPacket::Ptr &&packet, int64_t nowMs = 0);
+    void SkipTo(uint16_t seq);
+    // distance from nextSeqOut_ to the first cached seq, the cache must not be empty
+    uint16_t FindFirstCached() const;
 
 private:
     static const size_t SORT_CACHE_MIN_SIZE = 64;
+    static constexpr size_t SLOT_WORD_BITS = 64;
+    static constexpr double JITTER_GAIN = 16.0;   // 16: rfc 3550 estimator gain
+    static constexpr double JITTER_FACTOR = 3.0;  // target delay in multiples of the jitter
+    static constexpr double DELAY_DECAY = 256.0;  // packets to lower the target by 1/e
+    static constexpr double LATE_STEP_MS = 10.0;  // target delay added by a late packet
     static constexpr int32_t RTP_PACKET_LOST_THRESHOLD = 5;
+    // 3: as tcp's duplicate acks, a packet overtaken by fewer is taken as reordered, not lost
+    static constexpr uint16_t REORDER_PACKETS = 3;
 
     uint16_t nextSeqOut_ = 0;
 
@@ -63,9 +123,33 @@ private:
     size_t kMax_ = 1024;
     size_t maxSortSize_ = kMin_;
 
-    std::map<uint16_t, RtpPacket::Ptr> pktSortCacheMap_;
+    // ring of the cached packets, its size is a power of two
+    size_t mask_ = 0;
+    size_t cacheSize_ = 0;
+    std::vector<RtpPacket::Ptr> slots_;
+    std::vector<uint64_t> usedSlots_;
+    std::vector<int64_t> arrivals_; // ms, time based window only
+
+    // time based window
+    bool playoutDelay_ = false;
+    double minDelayMs_ = 0;
+    double maxDelayMs_ = 0;
+    double targetDelayMs_ = 0;
+    bool hasArrival_ = false;
+    int64_t lastArrivalMs_ = 0;
+    uint32_t lastStamp_ = 0;
+    double jitter_ = 0; // in units of the rtp clock
+    uint64_t lateDrops_ = 0;
 
     OnSort onSort_ = nullptr;
+    OnLost onLost_ = nullptr;
+
+    // gap detection, seqs reported lost and not arrived yet
+    bool hasHighestSeq_ = false;
+    uint16_t highestSeq_ = 0;
+    uint16_t checkedSeq_ = 0; // seqs up to here were checked for loss
+    std::unordered_set<uint16_t> lostSeqs_;
+    LossStats lossStats_;
 
     int32_t rtpPacketLostCount_ = 0;
     int32_t rtpPacketLostConsecutiveCount_ = 0;
@@ -18,7 +18,9 @@
 
 #include <functional>
 #include <map>
+#include <vector>
 #include "rtp_decoder.h"
+#include "rtp_def.h"
 #include "rtp_packet.h"
 
 namespace OHOS {
@@ -27,8 +29,12 @@ class RtpUnpack {
 public:
     using Ptr = std::shared_ptr<RtpUnpack>;
     using OnRtpNotify = std::function<void(int32_t)>;
-    // Unpack a RtpPackget callback
+    // Unpack a RtpPackget callback, the frame's pts is in us whatever the payload
     using OnRtpUnpack = std::function<void(uint32_t, const Frame::Ptr &frame)>;
+    // Sequence numbers found missing in the stream of a ssrc
+    using OnRtpLost = std::function<void(uint32_t ssrc, const std::vector<uint16_t> &seqs)>;
+    // Video of a ssrc is broken until the sender sends a key frame
+    using OnKeyFrameRequest = std::function<void(uint32_t ssrc)>;
 
     enum {
         RTP_UNPACK_OK = 0,
@@ -53,6 +59,52 @@ public:
      * @param cb rtp notify callback
      */
     virtual void SetOnRtpNotify(const OnRtpNotify &cb) = 0;
+    /**
+     * @brief Externally exposed rtp loss callback function, e.g. to request retransmissions
+     * @param cb rtp lost callback
+     */
+    virtual void SetOnRtpLost(const OnRtpLost &cb)
+    {
+        onRtpLost_ = cb;
+    }
+    /**
+     * @brief Externally exposed key frame request callback function, e.g. to send a pli
+     * @param cb key frame request callback
+     */
+    virtual void SetOnKeyFrameRequest(const OnKeyFrameRequest &cb)
+    {
+        onKeyFrameRequest_ = cb;
+    }
+    /**
+     * @brief Reorder packets within an adaptive playout delay instead of a packet count window
+     * @param minDelayMs lower bound of the target delay
+     * @param maxDelayMs upper bound of the target delay, 0 keeps the packet count window
+     */
+    virtual void SetPlayoutDelay(uint32_t minDelayMs, uint32_t maxDelayMs)
+    {
+        minDelayMs_ = minDelayMs;
+        maxDelayMs_ = maxDelayMs;
+    }
+    /**
+     * @brief Release the packets whose playout delay ran out while no packet arrived, on the parsing thread
+     */
+    virtual void Poll() {}
+    /**
+     * @brief Recover lost packets from the xor parity packets sent with payload type pt
+     * @param pt payload type of the parity packets
+     */
+    virtual void SetFecPayloadType(uint8_t pt)
+    {
+        (void)pt;
+    }
+    /**
+     * @brief Decode one more payload type with a sortor of its own, e.g. the audio next to the video stream
+     * @param rpp payload type, clock rate and format of the stream
+     */
+    virtual void AddPayload(const RtpPlaylodParam &rpp)
+    {
+        (void)rpp;
+    }
 
 protected:
     RtpUnpack() = default;
@@ -61,6 +113,10 @@ protected:
 protected:
     OnRtpUnpack onRtpUnpack_ = nullptr;
     OnRtpNotify onRtpNotify_ = nullptr;
+    OnRtpLost onRtpLost_ = nullptr;
+    OnKeyFrameRequest onKeyFrameRequest_ = nullptr;
+    uint32_t minDelayMs_ = 0;
+    uint32_t maxDelayMs_ = 0;
 };
 } // namespace Sharing
 } // namespace OHOS
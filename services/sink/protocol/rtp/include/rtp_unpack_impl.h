@@ -16,8 +16,10 @@
 #ifndef OHOS_SHARING_RTP_UNPACK_IMPL_H
 #define OHOS_SHARING_RTP_UNPACK_IMPL_H
 
+#include <set>
 #include "rtp_decoder.h"
 #include "rtp_def.h"
+#include "rtp_fec_decoder.h"
 #include "rtp_queue.h"
 #include "rtp_unpack.h"
 
@@ -32,6 +34,10 @@ public:
     void SetSdp(const std::string &sdp);
     void SetOnRtpUnpack(const OnRtpUnpack &cb) override;
     void SetOnRtpNotify(const OnRtpNotify &cb) override;
+    void SetPlayoutDelay(uint32_t minDelayMs, uint32_t maxDelayMs) override;
+    void Poll() override;
+    void SetFecPayloadType(uint8_t pt) override;
+    void AddPayload(const RtpPlaylodParam &rpp) override;
 
     void Release() override;
     void ParseRtp(const char *data, size_t len) override;
@@ -39,6 +45,8 @@ public:
 private:
     void OnRtpDecode(int32_t pt, const Frame::Ptr &frame);
     void OnRtpSorted(uint16_t seq, const RtpPacket::Ptr &rtp);
+    void OnRtpLost(int32_t pt, const std::vector<uint16_t> &seqs);
+    void OnKeyFrameNeeded(int32_t pt);
 
     void CreateRtpDecoder(const RtpPlaylodParam &rpp);
 
@@ -47,6 +55,10 @@ private:
 
     std::map<uint8_t, RtpDecoder::Ptr> rtpDecoder_;
     std::map<uint8_t, RtpPacketSortor::Ptr> rtpSort_;
+    // the payload decoders stamp in ms, only the ts demuxer in us
+    std::set<int32_t> msStampPayloads_;
+    // rebuilds lost packets ahead of the sortors, nullptr without fec
+    RtpFecDecoder::Ptr fecDecoder_ = nullptr;
     std::chrono::steady_clock::time_point lastReportMissTime_ = std::chrono::steady_clock::now();
 };
 } // namespace Sharing
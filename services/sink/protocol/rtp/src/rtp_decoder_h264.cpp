@@ -180,6 +180,9 @@ void RtpDecoderH264::OutputFrame(const RtpPacket::Ptr &rtp, const H264Frame::Ptr
 
     if (!gopDropped_) {
         onFrame_(frame);
+    } else if (onKeyFrameNeeded_) {
+        // asked again for every dropped frame, the receiver throttles the requests
+        onKeyFrameNeeded_();
     }
     frame_ = ObtainFrame();
 }
@@ -14,6 +14,7 @@
  */
 
 #include "rtp_decoder_ts.h"
+#include <algorithm>
 #include <securec.h>
 #include "common/common_macro.h"
 #include "common/media_log.h"
@@ -22,8 +23,50 @@
 
 namespace OHOS {
 namespace Sharing {
-constexpr int32_t FF_BUFFER_SIZE = 1500;
-static std::mutex frameLock;
+namespace {
+constexpr size_t PES_FIXED_HEADER_SIZE = 9;
+constexpr size_t PES_PTS_SIZE = 5;
+constexpr size_t PSI_HEADER_SIZE = 8;
+constexpr size_t PSI_CRC_SIZE = 4;
+constexpr size_t PMT_FIXED_SIZE = 12;
+constexpr size_t PMT_STREAM_SIZE = 5;
+constexpr uint8_t TS_STREAM_MPEG1_AUDIO = 0x03;
+constexpr uint8_t TS_STREAM_MPEG2_AUDIO = 0x04;
+constexpr uint8_t TS_STREAM_LATM = 0x11;
+constexpr uint8_t TS_STREAM_AC3 = 0x81;
+
+// 33 bits pts/dts spread over 5 bytes with marker bits, 2/3/4: byte index, 7/14/22/29: bit position
+uint64_t ReadTimestamp(const uint8_t *p)
+{
+    return ((uint64_t)(p[0] & 0x0E) << 29) | ((uint64_t)p[1] << 22) | ((uint64_t)(p[2] & 0xFE) << 14) |
+           ((uint64_t)p[3] << 7) | ((uint64_t)p[4] >> 1);
+}
+
+bool CheckSectionCrc(const uint8_t *section, size_t size)
+{
+    const uint8_t *crc = section + size - PSI_CRC_SIZE;
+    // 2, 3: crc bytes, 8, 16, 24: shifts
+    uint32_t expected = ((uint32_t)crc[0] << 24) | ((uint32_t)crc[1] << 16) | ((uint32_t)crc[2] << 8) | crc[3];
+    return TsCrc32(section, size - PSI_CRC_SIZE) == expected;
+}
+
+TrackType GetTsTrackType(uint8_t streamType)
+{
+    switch (streamType) {
+        case TS_STREAM_H264:
+            return TRACK_VIDEO;
+        case TS_STREAM_MPEG1_AUDIO: // fall-through
+        case TS_STREAM_MPEG2_AUDIO: // fall-through
+        case TS_STREAM_AAC:         // fall-through
+        case TS_STREAM_LATM:        // fall-through
+        case TS_STREAM_AC3:         // fall-through
+        case TS_STREAM_LPCM:
+            return TRACK_AUDIO;
+        default:
+            return TRACK_INVALID;
+    }
+}
+} // namespace
 
 RtpDecoderTs::RtpDecoderTs()
 {
@@ -38,202 +81,323 @@ RtpDecoderTs::~RtpDecoderTs()
 
 void RtpDecoderTs::Release()
 {
-    {
-        std::lock_guard<std::mutex> lock(frameLock);
-        onFrame_ = nullptr;
-    }
-
+    std::lock_guard<std::mutex> lock(decoderMutex_);
+    onFrame_ = nullptr;
+    onKeyFrameNeeded_ = nullptr;
     exit_ = true;
-    queueCond_.notify_one();
-    if (decodeThread_ && decodeThread_->joinable()) {
-        decodeThread_->join();
-        decodeThread_ = nullptr;
-    }
+    streams_.clear();
+    lastTimestamp_ = INVALID_TIMESTAMP;
+}
 
-    {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-        while (!dataQueue_.empty()) {
-            dataQueue_.pop();
-        }
+uint64_t RtpDecoderTs::UnwrapTimestamp(uint64_t ts)
+{
+    // the 33 bits clock wraps every 26.5 hours, take the 64 bits value nearest to the previous one
+    if (lastTimestamp_ == INVALID_TIMESTAMP) {
+        lastTimestamp_ = ts;
+        return ts;
     }
 
-    if (avFormatContext_) {
-        avformat_close_input(&avFormatContext_);
+    uint64_t delta = (ts - lastTimestamp_) & TS_TIMESTAMP_MASK;
+    if (delta > (TS_TIMESTAMP_MASK >> 1)) {
+        // a step back, e.g. a dts behind the last pts
+        uint64_t back = TS_TIMESTAMP_MASK + 1 - delta;
+        lastTimestamp_ = lastTimestamp_ > back ? lastTimestamp_ - back : 0;
+    } else {
+        lastTimestamp_ += delta;
     }
 
-    if (avioContext_) {
-        av_freep(&avioContext_->buffer);
-        avio_context_free(&avioContext_);
-    }
+    return lastTimestamp_;
 }
 
 void RtpDecoderTs::InputRtp(const RtpPacket::Ptr &rtp)
 {
     MEDIA_LOGD("trace.");
     RETURN_IF_NULL(rtp);
+    std::lock_guard<std::mutex> lock(decoderMutex_);
     if (exit_) {
         SHARING_LOGE("ignore rtp seq:%{public}d, exit", rtp->GetSeq());
         return;
     }
 
-    if (decodeThread_ == nullptr) {
-        decodeThread_ = std::make_unique<std::thread>(&RtpDecoderTs::StartDecoding, this);
-    }
-
-    auto payload_size = rtp->GetPayloadSize();
-    if (payload_size <= 0) {
+    auto payload = rtp->GetPayload();
+    auto payloadSize = rtp->GetPayloadSize();
+    if (payload == nullptr || payloadSize < TS_PACKET_SIZE) {
         SHARING_LOGE("ignore rtp seq:%{public}d, payload size invalid", rtp->GetSeq());
         return;
     }
 
-    std::lock_guard<std::mutex> lock(queueMutex_);
-    dataQueue_.emplace(rtp);
-    queueCond_.notify_one();
+    for (size_t offset = 0; offset + TS_PACKET_SIZE <= payloadSize; offset += TS_PACKET_SIZE) {
+        InputTsPacket(rtp, payload + offset);
+    }
 }
 
 void RtpDecoderTs::SetOnFrame(const OnFrame &cb)
 {
+    std::lock_guard<std::mutex> lock(decoderMutex_);
     onFrame_ = cb;
 }
 
-void RtpDecoderTs::StartDecoding()
+void RtpDecoderTs::SetOnKeyFrameNeeded(const OnKeyFrameNeeded &cb)
 {
-    SHARING_LOGE("trace.");
-    avFormatContext_ = avformat_alloc_context();
-    if (avFormatContext_ == nullptr) {
-        SHARING_LOGE("avformat_alloc_context failed.");
+    std::lock_guard<std::mutex> lock(decoderMutex_);
+    onKeyFrameNeeded_ = cb;
+}
+
+void RtpDecoderTs::InputTsPacket(const RtpPacket::Ptr &rtp, const uint8_t *packet)
+{
+    if (packet[0] != TS_SYNC_BYTE) {
+        MEDIA_LOGW("lost ts sync.");
         return;
     }
 
-    auto buffer = (uint8_t *)av_malloc(FF_BUFFER_SIZE);
-    if (buffer == nullptr) {
-        SHARING_LOGE("av_malloc failed.");
+    bool unitStart = packet[1] & 0x40;
+    uint16_t pid = (uint16_t)(((packet[1] & 0x1F) << 8) | packet[2]); // 2: pid low byte, 8: high bits
+    uint8_t adaptation = (packet[3] >> 4) & 0x03;                     // 3: flags byte, 4: adaptation_field_control
+    uint8_t counter = packet[3] & 0x0F;                               // 3: continuity_counter
+    if (!(adaptation & 0x01)) {
         return;
     }
-    avioContext_ =
-        avio_alloc_context(buffer, FF_BUFFER_SIZE, 0, this, &RtpDecoderTs::StaticReadPacket, nullptr, nullptr);
-    if (avioContext_ == nullptr) {
-        SHARING_LOGE("avio_alloc_context failed.");
-        av_freep(&buffer);
+
+    size_t offset = TS_HEADER_SIZE;
+    if (adaptation & 0x02) {
+        offset += 1 + packet[TS_HEADER_SIZE];
+    }
+    if (offset >= TS_PACKET_SIZE) {
         return;
     }
-    avFormatContext_->pb = avioContext_;
 
-    int ret = avformat_open_input(&avFormatContext_, nullptr, nullptr, nullptr);
-    if (ret != 0) {
-        SHARING_LOGE("avformat_open_input failed.");
+    const uint8_t *payload = packet + offset;
+    size_t size = TS_PACKET_SIZE - offset;
+    if (pid == TS_PID_PAT || pid == pmtPid_) {
+        if (unitStart) {
+            ParseSection(pid, payload, size);
+        }
         return;
     }
 
-    AVRational videoTimeBase;
-    AVRational audioTimeBase;
-    AVRational PtsTimeBase = {1, US_PER_SEC};
+    auto iter = streams_.find(pid);
+    if (iter == streams_.end()) {
+        return;
+    }
 
-    for (int32_t i = 0; i < static_cast<int32_t>(avFormatContext_->nb_streams); i++) {
-        if (avFormatContext_->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
-            videoTimeBase = avFormatContext_->streams[i]->time_base;
-            if (videoTimeBase.den == 0) {
-                videoTimeBase = AV_TIME_BASE_Q;
-            }
-            videoStreamIndex_ = i;
-            SHARING_LOGD("find video stream %{public}u.", i);
-        } else if (avFormatContext_->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
-            audioTimeBase = avFormatContext_->streams[i]->time_base;
-            if (audioTimeBase.den == 0) {
-                audioTimeBase = AV_TIME_BASE_Q;
-            }
-            audioStreamIndex_ = i;
-            SHARING_LOGD("find audio stream %{public}u.", i);
+    TsStream &stream = iter->second;
+    if (stream.counter >= 0 && counter != ((stream.counter + 1) & 0x0F)) {
+        if (counter == stream.counter) {
+            return; // duplicate
+        }
+        MEDIA_LOGW("ts pid 0x%{public}x discontinuity, drop pes.", pid);
+        ResetPes(stream);
+        if (stream.trackType == TRACK_VIDEO && onKeyFrameNeeded_) {
+            onKeyFrameNeeded_();
+        }
+    }
+    stream.counter = counter;
+    InputPes(stream, rtp, payload, size, unitStart);
+}
+
+void RtpDecoderTs::InputPes(TsStream &stream, const RtpPacket::Ptr &rtp, const uint8_t *payload, size_t size,
+                            bool unitStart)
+{
+    if (unitStart) {
+        if (stream.pesOpen && stream.pesRemaining == 0) {
+            FlushPes(stream);
+        }
+        ResetPes(stream);
+        if (!StartPes(stream, rtp, payload, size)) {
+            return;
+        }
+    } else if (stream.pesOpen) {
+        if (stream.pesRemaining > 0) {
+            size = std::min(size, stream.pesRemaining - stream.pesSize);
+        }
+        stream.views.push_back({rtp, payload, size});
+        stream.pesSize += size;
+    } else {
+        return;
+    }
+
+    if (stream.pesRemaining > 0 && stream.pesSize >= stream.pesRemaining) {
+        FlushPes(stream);
+        ResetPes(stream);
+    }
+}
+
+bool RtpDecoderTs::StartPes(TsStream &stream, const RtpPacket::Ptr &rtp, const uint8_t *payload, size_t size)
+{
+    if (size < PES_FIXED_HEADER_SIZE || payload[0] != 0x00 || payload[1] != 0x00 || payload[2] != 0x01) { // 2: prefix
+        MEDIA_LOGW("invalid pes start code.");
+        return false;
+    }
+
+    size_t pesLength = ((size_t)payload[4] << 8) | payload[5]; // 4, 5: PES_packet_length
+    uint8_t ptsDtsFlags = (payload[7] >> 6) & 0x03;             // 7: flags byte, 6: PTS_DTS_flags
+    size_t headerSize = PES_FIXED_HEADER_SIZE + payload[8];     // 8: PES_header_data_length
+    if (headerSize > size || (pesLength > 0 && pesLength + 6 < headerSize)) { // 6: bytes before PES_packet_length end
+        MEDIA_LOGW("pes header exceeds ts packet.");
+        return false;
+    }
+
+    if ((ptsDtsFlags & 0x02) && payload[8] >= PES_PTS_SIZE) { // 8: PES_header_data_length
+        stream.pts = UnwrapTimestamp(ReadTimestamp(payload + PES_FIXED_HEADER_SIZE));
+        stream.dts = stream.pts;
+        if (ptsDtsFlags == 0x03 && payload[8] >= PES_PTS_SIZE * 2) { // 8: PES_header_data_length, 2: pts and dts
+            stream.dts = UnwrapTimestamp(ReadTimestamp(payload + PES_FIXED_HEADER_SIZE + PES_PTS_SIZE));
         }
     }
 
-    AVPacket *packet = av_packet_alloc();
-    if (packet == nullptr) {
-        av_freep(&buffer);
+    stream.pesOpen = true;
+    stream.pesRemaining = pesLength > 0 ? pesLength + 6 - headerSize : 0; // 6: bytes before PES_packet_length end
+    size = size - headerSize;
+    if (stream.pesRemaining > 0) {
+        size = std::min(size, stream.pesRemaining);
+    }
+    if (size > 0) {
+        stream.views.push_back({rtp, payload + headerSize, size});
+        stream.pesSize = size;
+    }
+
+    return true;
+}
+
+void RtpDecoderTs::ResetPes(TsStream &stream)
+{
+    stream.pesOpen = false;
+    stream.pesRemaining = 0;
+    stream.pesSize = 0;
+    stream.views.clear();
+}
+
+void RtpDecoderTs::FlushPes(TsStream &stream)
+{
+    if (stream.views.empty() || stream.pesSize == 0) {
         return;
     }
-    while (!exit_ && av_read_frame(avFormatContext_, packet) >= 0) {
-        if (exit_) {
-            SHARING_LOGI("ignore av read frame.");
-            break;
+
+    // a pes inside a single ts packet is referenced in place, otherwise it is gathered once
+    DataBuffer::Ptr buffer;
+    size_t base = 0;
+    if (stream.views.size() == 1) {
+        buffer = stream.views[0].rtp;
+        base = (size_t)(stream.views[0].data - buffer->Data());
+    } else {
+        buffer = std::make_shared<DataBuffer>((int32_t)stream.pesSize);
+        for (auto &view : stream.views) {
+            buffer->Append(view.data, (int32_t)view.size);
         }
-        if (packet->stream_index == videoStreamIndex_) {
-            SplitH264((char *)packet->data, (size_t)packet->size, 0, [&](const char *buf, size_t len, size_t prefix) {
-                if (H264_TYPE(buf[prefix]) == H264Frame::NAL_AUD) {
-                    return;
-                }
-                int64_t ptsUsec = av_rescale_q(packet->pts, videoTimeBase, PtsTimeBase);
-                auto outFrame = std::make_shared<H264Frame>((uint8_t *)buf, len, (uint32_t)packet->dts,
-                                                            (uint64_t)ptsUsec, prefix);
-                std::lock_guard<std::mutex> lock(frameLock);
-                if (onFrame_) {
-                    onFrame_(outFrame);
-                }
-            });
-        } else if (packet->stream_index == audioStreamIndex_) {
-            int64_t ptsUsec = av_rescale_q(packet->pts, audioTimeBase, PtsTimeBase);
-            auto outFrame = std::make_shared<AACFrame>((uint8_t *)packet->data, packet->size, (uint32_t)packet->dts,
-                                                        (uint64_t)ptsUsec);
-            std::lock_guard<std::mutex> lock(frameLock);
-            if (onFrame_) {
-                onFrame_(outFrame);
+    }
+    if (buffer->Data() == nullptr || (size_t)buffer->Size() < base + stream.pesSize) {
+        SHARING_LOGE("gather pes failed.");
+        return;
+    }
+
+    uint64_t ptsUsec = stream.pts * US_PER_SEC / SAMPLE_RATE_90K;
+    if (stream.trackType == TRACK_VIDEO) {
+        uint8_t *start = buffer->Data();
+        SplitH264((char *)start + base, stream.pesSize, 0, [&](const char *buf, size_t len, size_t prefix) {
+            if (len <= prefix || H264_TYPE(buf[prefix]) == H264Frame::NAL_AUD) {
+                return;
             }
-        }
-        av_packet_unref(packet);
+            size_t offset = (size_t)((const uint8_t *)buf - start);
+            auto outFrame = std::make_shared<SharedFrame<H264Frame>>(buffer, offset, (int32_t)len);
+            outFrame->dts_ = (uint32_t)stream.dts;
+            outFrame->pts_ = ptsUsec;
+            outFrame->prefixSize_ = prefix;
+            OutputFrame(outFrame);
+        });
+    } else if (stream.trackType == TRACK_AUDIO) {
+        auto outFrame = std::make_shared<SharedFrame<AACFrame>>(buffer, base, (int32_t)stream.pesSize);
+        outFrame->dts_ = (uint32_t)stream.dts;
+        outFrame->pts_ = ptsUsec;
+        OutputFrame(outFrame);
     }
+}
 
-    av_packet_free(&packet);
-    SHARING_LOGD("ts decoding Thread_ exit.");
+void RtpDecoderTs::OutputFrame(const Frame::Ptr &frame)
+{
+    if (onFrame_) {
+        onFrame_(frame);
+    }
 }
 
-int RtpDecoderTs::StaticReadPacket(void *opaque, uint8_t *buf, int buf_size)
+void RtpDecoderTs::ParseSection(uint16_t pid, const uint8_t *payload, size_t size)
 {
-    RETURN_INVALID_IF_NULL(opaque);
-    RETURN_INVALID_IF_NULL(buf);
-    RtpDecoderTs *decoder = (RtpDecoderTs *)opaque;
-    if (decoder == nullptr) {
-        SHARING_LOGE("decoder is nullptr.");
-        return 0;
+    size_t pointer = payload[0];
+    if (1 + pointer + PSI_HEADER_SIZE > size) {
+        return;
+    }
+
+    const uint8_t *section = payload + 1 + pointer;
+    size_t sectionSize = 3 + ((((size_t)section[1] & 0x0F) << 8) | section[2]); // 3: header, 1, 2: section_length
+    if (sectionSize > size - 1 - pointer || sectionSize < PSI_HEADER_SIZE + PSI_CRC_SIZE) {
+        MEDIA_LOGW("psi section spans ts packets, ignore.");
+        return;
+    }
+
+    if (pid == TS_PID_PAT && section[0] == TS_TABLE_PAT) {
+        ParsePat(section, sectionSize);
+    } else if (pid == pmtPid_ && section[0] == TS_TABLE_PMT) {
+        ParsePmt(section, sectionSize);
     }
-    return decoder->ReadPacket(buf, buf_size);
 }
 
-int RtpDecoderTs::ReadPacket(uint8_t *buf, int buf_size)
+void RtpDecoderTs::ParsePat(const uint8_t *section, size_t size)
 {
-    RETURN_INVALID_IF_NULL(buf);
-    std::unique_lock<std::mutex> lock(queueMutex_);
-    if (dataQueue_.empty()) {
-        if (exit_ == true) {
-            SHARING_LOGI("read packet exit.");
-            return -1;
+    // the first program is the one we play
+    for (size_t offset = PSI_HEADER_SIZE; offset + 4 <= size - PSI_CRC_SIZE; offset += 4) { // 4: program entry
+        uint16_t program = (uint16_t)((section[offset] << 8) | section[offset + 1]);       // 8: high byte
+        uint16_t pid = (uint16_t)(((section[offset + 2] & 0x1F) << 8) | section[offset + 3]); // 2, 3: pid, 8: high
+        if (program == 0) {
+            continue; // network pid
         }
-        queueCond_.wait(lock, [this] { return !dataQueue_.empty() || exit_; });
-        if (exit_) {
-            SHARING_LOGI("read packet exit.");
-            return -1;
-        }
-        if (dataQueue_.empty()) {
-            return 0;
+        if (pid != pmtPid_) {
+            if (!CheckSectionCrc(section, size)) {
+                MEDIA_LOGW("pat crc mismatch.");
+                return;
+            }
+            SHARING_LOGI("ts pmt pid: 0x%{public}x.", pid);
+            pmtPid_ = pid;
+            pmtVersion_ = -1;
         }
+        return;
     }
-    auto &rtp = dataQueue_.front();
-    auto data = rtp->GetPayload();
-    if (data == nullptr) {
-        SHARING_LOGE("payload null");
-        return 0;
+}
+
+void RtpDecoderTs::ParsePmt(const uint8_t *section, size_t size)
+{
+    int32_t version = (section[5] >> 1) & 0x1F; // 5: version byte
+    if (version == pmtVersion_ || size < PMT_FIXED_SIZE + PSI_CRC_SIZE) {
+        return;
     }
-    int length = static_cast<int>(rtp->GetPayloadSize());
-    if (length > buf_size) {
-        SHARING_LOGE("rtp length exceed buf_size!");
-        return 0;
+
+    if (!CheckSectionCrc(section, size)) {
+        MEDIA_LOGW("pmt crc mismatch.");
+        return;
     }
-    auto ret = memcpy_s(buf, length, data, length);
-    if (ret != EOK) {
-        return 0;
+
+    size_t programInfoSize = (((size_t)section[10] & 0x0F) << 8) | section[11]; // 10, 11: program_info_length
+    std::map<uint16_t, TsStream> streams;
+    for (size_t offset = PMT_FIXED_SIZE + programInfoSize; offset + PMT_STREAM_SIZE <= size - PSI_CRC_SIZE;) {
+        uint8_t streamType = section[offset];
+        uint16_t pid = (uint16_t)(((section[offset + 1] & 0x1F) << 8) | section[offset + 2]); // 2: pid, 8: high
+        size_t infoSize = (((size_t)section[offset + 3] & 0x0F) << 8) | section[offset + 4];   // 3, 4: es_info_length
+        offset += PMT_STREAM_SIZE + infoSize;
+
+        TrackType trackType = GetTsTrackType(streamType);
+        if (trackType == TRACK_INVALID) {
+            SHARING_LOGW("unsupported ts stream type: 0x%{public}x.", streamType);
+            continue;
+        }
+        auto iter = streams_.find(pid);
+        TsStream stream = (iter != streams_.end() && iter->second.streamType == streamType) ? iter->second : TsStream();
+        stream.streamType = streamType;
+        stream.trackType = trackType;
+        streams.emplace(pid, std::move(stream));
+        SHARING_LOGD("ts stream pid: 0x%{public}x, type: 0x%{public}x.", pid, streamType);
     }
 
-    dataQueue_.pop();
-    return length;
+    SHARING_LOGI("ts pmt version: %{public}d, streams: %{public}zu.", version, streams.size());
+    streams_ = std::move(streams);
+    pmtVersion_ = version;
 }
 } // namespace Sharing
 } // namespace OHOS
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rtp_fec_decoder.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <securec.h>
+#include "common/common_macro.h"
+#include "common/media_log.h"
+#include "rtp_packet.h"
+
+namespace OHOS {
+namespace Sharing {
+RtpFecDecoder::RtpFecDecoder(uint8_t pt)
+    : pt_(pt), slots_(MEDIA_SLOTS), recovered_(RtpPacket::RTP_HEADER_SIZE + RTP_FEC_MAX_PROTECTED, 0)
+{
+}
+
+uint8_t RtpFecDecoder::GetPayloadType() const
+{
+    return pt_;
+}
+
+void RtpFecDecoder::SetOnRecovered(const OnRecovered &cb)
+{
+    onRecovered_ = cb;
+}
+
+void RtpFecDecoder::Clear()
+{
+    for (auto &slot : slots_) {
+        slot = Slot();
+    }
+    ssrcKnown_ = false;
+}
+
+void RtpFecDecoder::InputMedia(const char *data, size_t len)
+{
+    RETURN_IF_NULL(data);
+    if (len < RtpPacket::RTP_HEADER_SIZE || len > RtpPacket::RTP_HEADER_SIZE + RTP_FEC_MAX_PROTECTED) {
+        return;
+    }
+
+    auto header = reinterpret_cast<const RtpHeader *>(data);
+    if (ssrcKnown_ && header->ssrc_ != ssrc_) {
+        return;
+    }
+    uint16_t seq = ntohs(header->seq_);
+    auto &slot = slots_[seq & (MEDIA_SLOTS - 1)];
+    if (slot.rtp == nullptr) {
+        slot.rtp = DataBuffer::CreatePooled(static_cast<int32_t>(RtpPacket::RTP_HEADER_SIZE + RTP_FEC_MAX_PROTECTED));
+    }
+    slot.rtp->ReplaceData(data, static_cast<int32_t>(len));
+    slot.seq = seq;
+    slot.ssrc = header->ssrc_;
+}
+
+const RtpFecDecoder::Slot *RtpFecDecoder::FindMedia(uint16_t seq, uint32_t ssrc) const
+{
+    auto &slot = slots_[seq & (MEDIA_SLOTS - 1)];
+    if (slot.rtp == nullptr || slot.rtp->Size() == 0 || slot.seq != seq || slot.ssrc != ssrc) {
+        return nullptr;
+    }
+
+    return &slot;
+}
+
+void RtpFecDecoder::InputFec(const char *data, size_t len)
+{
+    RETURN_IF_NULL(data);
+    auto header = reinterpret_cast<const RtpHeader *>(data);
+    if (len < RtpPacket::RTP_HEADER_SIZE + sizeof(RtpFecHeader) || header->csrc_ != 0 || header->ext_ != 0) {
+        return;
+    }
+
+    auto fec = reinterpret_cast<const RtpFecHeader *>(data + RtpPacket::RTP_HEADER_SIZE);
+    auto parity = reinterpret_cast<const uint8_t *>(fec + 1);
+    size_t parityLength = ntohs(fec->protectionLength_);
+    if (parityLength > len - RtpPacket::RTP_HEADER_SIZE - sizeof(RtpFecHeader) ||
+        parityLength > RTP_FEC_MAX_PROTECTED) {
+        return;
+    }
+    ++stats_.parity;
+    ssrcKnown_ = true;
+    ssrc_ = header->ssrc_;
+
+    uint16_t snBase = ntohs(fec->snBase_);
+    uint16_t mask = ntohs(fec->mask_);
+    const Slot *group[RTP_FEC_MAX_GROUP] = {};
+    size_t received = 0;
+    bool lost = false;
+    uint16_t lostSeq = 0;
+    for (size_t i = 0; i < RTP_FEC_MAX_GROUP; i++) {
+        if ((mask & (0x8000 >> i)) == 0) { // 0x8000: the msb stands for SN base
+            continue;
+        }
+        uint16_t seq = static_cast<uint16_t>(snBase + i);
+        auto slot = FindMedia(seq, header->ssrc_);
+        if (slot != nullptr) {
+            group[received++] = slot;
+        } else if (lost) {
+            ++stats_.unrecoverable;
+            return;
+        } else {
+            lost = true;
+            lostSeq = seq;
+        }
+    }
+    if (!lost) {
+        return;
+    }
+
+    uint8_t *payload = recovered_.data() + RtpPacket::RTP_HEADER_SIZE;
+    if (memcpy_s(payload, RTP_FEC_MAX_PROTECTED, parity, parityLength) != EOK) {
+        return;
+    }
+    uint8_t recovery0 = fec->recovery0_;
+    uint8_t recovery1 = fec->recovery1_;
+    uint32_t tsRecovery = fec->tsRecovery_;
+    uint16_t lengthRecovery = ntohs(fec->lengthRecovery_);
+    for (size_t i = 0; i < received; i++) {
+        auto media = group[i]->rtp->Data();
+        size_t length = static_cast<size_t>(group[i]->rtp->Size()) - RtpPacket::RTP_HEADER_SIZE;
+        XorBytes(payload, media + RtpPacket::RTP_HEADER_SIZE, std::min(length, parityLength));
+        recovery0 ^= media[0];
+        recovery1 ^= media[1];
+        tsRecovery ^= reinterpret_cast<const RtpHeader *>(media)->stamp_;
+        lengthRecovery ^= static_cast<uint16_t>(length);
+    }
+    if (lengthRecovery > parityLength) {
+        ++stats_.unrecoverable;
+        return;
+    }
+
+    recovered_[0] = (RtpPacket::RTP_VERSION << 6) | (recovery0 & 0x3F); // 6: version bits, 0x3F: P X CC
+    recovered_[1] = recovery1;
+    auto rebuilt = reinterpret_cast<RtpHeader *>(recovered_.data());
+    rebuilt->seq_ = htons(lostSeq);
+    rebuilt->stamp_ = tsRecovery;
+    rebuilt->ssrc_ = header->ssrc_;
+    ++stats_.recovered;
+    MEDIA_LOGD("fec recovered seq: %{public}hu.", lostSeq);
+
+    size_t size = RtpPacket::RTP_HEADER_SIZE + lengthRecovery;
+    auto rtp = reinterpret_cast<const char *>(recovered_.data());
+    InputMedia(rtp, size);
+    if (onRecovered_) {
+        onRecovered_(rtp, size);
+    }
+}
+
+RtpFecDecoder::Stats RtpFecDecoder::GetStats() const
+{
+    return stats_;
+}
+} // namespace Sharing
+} // namespace OHOS
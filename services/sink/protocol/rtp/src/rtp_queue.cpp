@@ -14,7 +14,9 @@
  */
 
 #include "rtp_queue.h"
+#include <algorithm>
 #include <arpa/inet.h>
+#include <cmath>
 #include <iostream>
 #include <limits>
 #include <securec.h>
@@ -29,7 +31,16 @@ static const uint16_t HALF_MAX_SEQ = (MAX_SEQ >> 1);
 
 RtpPacketSortor::RtpPacketSortor(int32_t sampleRate, size_t kMax, size_t kMin)
     : sampleRate_(sampleRate), kMin_(kMin), kMax_(kMax)
-{}
+{
+    // the ring must hold any kMax + 1 consecutive seqs
+    size_t ringSize = SLOT_WORD_BITS;
+    while (ringSize <= kMax_ && ringSize <= MAX_SEQ) {
+        ringSize <<= 1;
+    }
+    mask_ = ringSize - 1;
+    slots_.resize(ringSize);
+    usedSlots_.resize(ringSize / SLOT_WORD_BITS);
+}
 
 void RtpPacketSortor::InputRtp(TrackType type, uint8_t *ptr, size_t len)
 {
@@ -54,7 +65,7 @@ void RtpPacketSortor::InputRtp(TrackType type, uint8_t *ptr, size_t len)
         return;
     }
 
-    auto rtp = std::make_shared<RtpPacket>();
+    auto rtp = RtpPacket::Create((int32_t)len);
     RETURN_IF_NULL(rtp);
     rtp->ReplaceData(reinterpret_cast<char*>(ptr), len);
     rtp->sampleRate_ = (uint32_t)sampleRate_;
@@ -83,16 +94,30 @@ void RtpPacketSortor::SetOnSort(const OnSort &cb)
     onSort_ = std::move(cb);
 }
 
+void RtpPacketSortor::SetOnLost(const OnLost &cb)
+{
+    onLost_ = cb;
+}
+
 void RtpPacketSortor::Clear()
 {
-    pktSortCacheMap_.clear();
+    for (size_t word = 0; word < usedSlots_.size(); ++word) {
+        for (uint64_t bits = usedSlots_[word]; bits != 0; bits &= bits - 1) {
+            slots_[word * SLOT_WORD_BITS + static_cast<size_t>(__builtin_ctzll(bits))] = nullptr;
+        }
+        usedSlots_[word] = 0;
+    }
+    cacheSize_ = 0;
+    hasArrival_ = false;
     nextSeqOut_ = 0;
     maxSortSize_ = kMin_;
+    hasHighestSeq_ = false;
+    lostSeqs_.clear();
 }
 
 size_t RtpPacketSortor::GetJitterSize() const
 {
-    return pktSortCacheMap_.size();
+    return cacheSize_;
 }
 
 bool RtpPacketSortor::IsSeqValid(uint16_t seq) const
@@ -108,9 +133,30 @@ bool RtpPacketSortor::IsSeqValid(uint16_t seq) const
     return true;
 }
 
+int64_t RtpPacketSortor::NowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+}
+
 void RtpPacketSortor::SortPacket(uint16_t seq, RtpPacket::Ptr packet)
+{
+    SortPacket(seq, std::move(packet), playoutDelay_ ? NowMs() : 0);
+}
+
+void RtpPacketSortor::Poll()
+{
+    if (!playoutDelay_ || cacheSize_ == 0) {
+        return;
+    }
+    TryPopPacket(NowMs());
+}
+
+void RtpPacketSortor::SortPacket(uint16_t seq, RtpPacket::Ptr packet, int64_t nowMs)
 {
     RETURN_IF_NULL(packet);
+    if (playoutDelay_) {
+        UpdateJitter(packet, nowMs);
+    }
     if (!IsSeqValid(seq)) {
         SHARING_LOGW("ignore rtp seq:%{public}hu out of expect range, expect seq:%{public}hu", seq, nextSeqOut_);
         ++rtpPacketLostConsecutiveCount_;
@@ -118,12 +164,216 @@ void RtpPacketSortor::SortPacket(uint16_t seq, RtpPacket::Ptr packet)
             ++rtpPacketLostCount_;
             rtpPacketLostConsecutiveCount_ = 0;
         }
+        OnLatePacket();
         return;
     }
 
     rtpPacketLostConsecutiveCount_ = 0;
-    pktSortCacheMap_.emplace(seq, std::move(packet));
-    TryPopPacket();
+    uint16_t distance = seq - nextSeqOut_;
+    if (distance > mask_) {
+        SkipTo(seq);
+    }
+    // a duplicate keeps the first copy
+    if (!IsSlotUsed(seq)) {
+        StoreSlot(seq, std::move(packet), nowMs);
+    }
+    DetectLoss(seq);
+    TryPopPacket(nowMs);
+}
+
+void RtpPacketSortor::SetPlayoutDelay(uint32_t minDelayMs, uint32_t maxDelayMs)
+{
+    playoutDelay_ = maxDelayMs > 0;
+    maxDelayMs_ = maxDelayMs;
+    minDelayMs_ = std::min(minDelayMs, maxDelayMs);
+    targetDelayMs_ = minDelayMs_;
+    if (playoutDelay_) {
+        arrivals_.assign(slots_.size(), 0);
+    } else {
+        arrivals_.clear();
+    }
+    SHARING_LOGI("playout delay min: %{public}u ms, max: %{public}u ms.", minDelayMs, maxDelayMs);
+}
+
+void RtpPacketSortor::UpdateJitter(const RtpPacket::Ptr &packet, int64_t nowMs)
+{
+    if (sampleRate_ <= 0 || packet->Size() < static_cast<int32_t>(RtpPacket::RTP_HEADER_SIZE)) {
+        return;
+    }
+
+    uint32_t stamp = packet->GetStamp();
+    if (hasArrival_) {
+        // jitter unit: sampling numbers, as RtcpReceiverContext reports it
+        double diff = (nowMs - lastArrivalMs_) * (sampleRate_ / 1000.0) - // 1000.0: ms per second
+                      static_cast<int32_t>(stamp - lastStamp_);
+        jitter_ += (std::fabs(diff) - jitter_) / JITTER_GAIN;
+    }
+    hasArrival_ = true;
+    lastArrivalMs_ = nowMs;
+    lastStamp_ = stamp;
+
+    double jitterMs = jitter_ * 1000.0 / sampleRate_; // 1000.0: ms per second
+    double target = std::clamp(jitterMs * JITTER_FACTOR, minDelayMs_, maxDelayMs_);
+    if (target > targetDelayMs_) {
+        targetDelayMs_ = target;
+    } else {
+        targetDelayMs_ += (target - targetDelayMs_) / DELAY_DECAY;
+    }
+}
+
+void RtpPacketSortor::OnLatePacket()
+{
+    ++lateDrops_;
+    if (playoutDelay_) {
+        // the packet would have made it with a longer wait
+        targetDelayMs_ = std::min(maxDelayMs_, targetDelayMs_ + LATE_STEP_MS);
+    }
+}
+
+bool RtpPacketSortor::IsWaitOver(int64_t nowMs) const
+{
+    if (cacheSize_ == 0) {
+        return false;
+    }
+    if (!playoutDelay_) {
+        return cacheSize_ > maxSortSize_;
+    }
+    // the cache stays bounded whatever the delay
+    if (cacheSize_ > kMax_) {
+        return true;
+    }
+
+    size_t first = (nextSeqOut_ + FindFirstCached()) & mask_;
+    return nowMs - arrivals_[first] >= targetDelayMs_;
+}
+
+bool RtpPacketSortor::IsSlotUsed(uint16_t seq) const
+{
+    size_t index = seq & mask_;
+    return (usedSlots_[index / SLOT_WORD_BITS] >> (index % SLOT_WORD_BITS)) & 1;
+}
+
+void RtpPacketSortor::StoreSlot(uint16_t seq, RtpPacket::Ptr &&packet, int64_t nowMs)
+{
+    size_t index = seq & mask_;
+    slots_[index] = std::move(packet);
+    if (playoutDelay_) {
+        arrivals_[index] = nowMs;
+    }
+    usedSlots_[index / SLOT_WORD_BITS] |= 1ULL << (index % SLOT_WORD_BITS);
+    ++cacheSize_;
+}
+
+void RtpPacketSortor::SkipTo(uint16_t seq)
+{
+    // the ring cannot hold seq along with what is cached. The cached packets are played out in order, not
+    // dropped; only the seqs still missing before seq are given up, a gap beyond kMax is never nacked.
+    if (!lostSeqs_.empty()) {
+        GiveUpLost(nextSeqOut_, seq);
+    }
+    Flush();
+    SHARING_LOGI("seq jump, set new expect seq as:%{public}hu", seq);
+    nextSeqOut_ = seq;
+}
+
+uint16_t RtpPacketSortor::FindFirstCached() const
+{
+    size_t start = nextSeqOut_ & mask_;
+    size_t scanned = 0;
+    while (scanned <= mask_) {
+        size_t index = (start + scanned) & mask_;
+        uint64_t bits = usedSlots_[index / SLOT_WORD_BITS] >> (index % SLOT_WORD_BITS);
+        if (bits != 0) {
+            // past the wrap only the bits before start can be set, the others were scanned first
+            return static_cast<uint16_t>(scanned + static_cast<size_t>(__builtin_ctzll(bits)));
+        }
+        scanned += SLOT_WORD_BITS - index % SLOT_WORD_BITS;
+    }
+
+    return 0;
+}
+
+void RtpPacketSortor::DetectLoss(uint16_t seq)
+{
+    if (!hasHighestSeq_) {
+        hasHighestSeq_ = true;
+        highestSeq_ = seq;
+        checkedSeq_ = seq;
+        return;
+    }
+
+    uint16_t distance = seq - highestSeq_;
+    if (distance == 0 || distance > HALF_MAX_SEQ) {
+        // duplicate, reordered or late packet, possibly a retransmission
+        if (lostSeqs_.erase(seq) > 0) {
+            ++lossStats_.recovered;
+        }
+        return;
+    }
+    highestSeq_ = seq;
+
+    // a seq is only reported once REORDER_PACKETS later seqs are in, a reordered packet shows up before that
+    uint16_t until = seq - REORDER_PACKETS;
+    uint16_t pending = until - checkedSeq_;
+    if (pending == 0 || pending > HALF_MAX_SEQ) {
+        return;
+    }
+
+    // a gap larger than the cache can never be filled in time, do not ask for it
+    if (pending <= kMax_ && onLost_) {
+        std::vector<uint16_t> lost;
+        for (uint16_t check = checkedSeq_ + 1; check != static_cast<uint16_t>(until + 1); ++check) {
+            if (IsMissing(check)) {
+                lost.emplace_back(check);
+                lostSeqs_.emplace(check);
+            }
+        }
+        if (!lost.empty()) {
+            lossStats_.nacked += lost.size();
+            onLost_(lost);
+        }
+    }
+    checkedSeq_ = until;
+}
+
+bool RtpPacketSortor::IsMissing(uint16_t seq) const
+{
+    // behind nextSeqOut_ it was played out or given up already
+    uint16_t ahead = seq - nextSeqOut_;
+    return ahead <= mask_ && !IsSlotUsed(seq);
+}
+
+void RtpPacketSortor::GiveUpLost(uint16_t from, uint16_t to)
+{
+    // seqs in [from, to) will not be waited for anymore
+    uint16_t range = to - from;
+    for (auto it = lostSeqs_.begin(); it != lostSeqs_.end();) {
+        if ((uint16_t)(*it - from) < range) {
+            ++lossStats_.unrecovered;
+            it = lostSeqs_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+RtpPacketSortor::LossStats RtpPacketSortor::GetLossStats() const
+{
+    return lossStats_;
+}
+
+uint32_t RtpPacketSortor::GetTargetDelay() const
+{
+    return playoutDelay_ ? static_cast<uint32_t>(targetDelayMs_) : 0;
+}
+
+RtpPacketSortor::PlayoutStats RtpPacketSortor::GetPlayoutStats() const
+{
+    PlayoutStats stats;
+    stats.targetDelayMs = GetTargetDelay();
+    stats.jitterMs = sampleRate_ > 0 ? static_cast<uint32_t>(jitter_ * 1000.0 / sampleRate_) : 0; // 1000.0: ms
+    stats.lateDrops = lateDrops_;
+    return stats;
 }
 
 int32_t RtpPacketSortor::GetRtpPacketLostCount() const
@@ -133,8 +383,8 @@ int32_t RtpPacketSortor::GetRtpPacketLostCount() const
 
 void RtpPacketSortor::Flush()
 {
-    while (!pktSortCacheMap_.empty()) {
-        PopIterator(pktSortCacheMap_.begin());
+    while (cacheSize_ > 0) {
+        PopSlot(nextSeqOut_ + FindFirstCached());
     }
 }
 
@@ -143,44 +393,43 @@ uint32_t RtpPacketSortor::GetSSRC() const
     return ssrc_;
 }
 
-void RtpPacketSortor::PopIterator(std::map<uint16_t, RtpPacket::Ptr>::iterator it)
+void RtpPacketSortor::PopSlot(uint16_t seq)
 {
-    auto seq = it->first;
-    auto data = std::move(it->second);
-    pktSortCacheMap_.erase(it);
+    size_t index = seq & mask_;
+    auto data = std::move(slots_[index]);
+    usedSlots_[index / SLOT_WORD_BITS] &= ~(1ULL << (index % SLOT_WORD_BITS));
+    --cacheSize_;
     nextSeqOut_ = seq == MAX_SEQ ? 0 : seq + 1;
     if (onSort_) {
         onSort_(seq, data);
     }
 }
 
-void RtpPacketSortor::TryPopPacket()
+void RtpPacketSortor::TryPopPacket(int64_t nowMs)
 {
-    auto it = pktSortCacheMap_.lower_bound((nextSeqOut_));
-    // eg: expect 65530, but map = {0,1,...} or expect 65530, but map = {65531, 65532,...}
-    if (it == pktSortCacheMap_.end() || it->first != nextSeqOut_) {
-        if (pktSortCacheMap_.size() <= maxSortSize_) {
-            // cache not full, wait nextSeqOut_
+    if (!IsSlotUsed(nextSeqOut_)) {
+        if (!IsWaitOver(nowMs)) {
+            // cache not full nor waited long enough, wait nextSeqOut_
             return;
         }
-        // cache full, not wait nextSeqOut_ anymore,set next packet in cache as new expect seq
-        if (it == pktSortCacheMap_.end()) {
-            it = pktSortCacheMap_.begin();
+        // not wait nextSeqOut_ anymore, set the first packet in cache as new expect seq
+        uint16_t first = nextSeqOut_ + FindFirstCached();
+        if (!lostSeqs_.empty()) {
+            GiveUpLost(nextSeqOut_, first);
         }
-        nextSeqOut_ = it->first;
-        SHARING_LOGI("cache full, set new expect seq as:%{public}hu", nextSeqOut_);
+        nextSeqOut_ = first;
+        SHARING_LOGI("wait over, set new expect seq as:%{public}hu", nextSeqOut_);
     }
 
-    while (it != pktSortCacheMap_.end() && it->first == nextSeqOut_) {
-        PopIterator(it);
-        it = pktSortCacheMap_.lower_bound(nextSeqOut_);
+    while (cacheSize_ > 0 && IsSlotUsed(nextSeqOut_)) {
+        PopSlot(nextSeqOut_);
     }
     SetSortSize();
 }
 
 void RtpPacketSortor::SetSortSize()
 {
-    maxSortSize_ = kMin_ + pktSortCacheMap_.size();
+    maxSortSize_ = kMin_ + cacheSize_;
     if (maxSortSize_ > kMax_) {
         maxSortSize_ = kMax_;
     }
@@ -48,6 +48,13 @@ void RtpUnpackImpl::ParseRtp(const char *data, size_t len)
     }
     RtpHeader *header = (RtpHeader *)data;
     auto pt = header->pt_;
+    if (fecDecoder_ != nullptr) {
+        if (pt == fecDecoder_->GetPayloadType()) {
+            fecDecoder_->InputFec(data, len);
+            return;
+        }
+        fecDecoder_->InputMedia(data, len);
+    }
     auto decoder = rtpDecoder_[pt];
 
     if (!decoder) {
@@ -94,6 +101,39 @@ void RtpUnpackImpl::SetOnRtpNotify(const OnRtpNotify &cb)
     onRtpNotify_ = std::move(cb);
 }
 
+void RtpUnpackImpl::SetPlayoutDelay(uint32_t minDelayMs, uint32_t maxDelayMs)
+{
+    RtpUnpack::SetPlayoutDelay(minDelayMs, maxDelayMs);
+    for (auto &item : rtpSort_) {
+        if (item.second != nullptr) {
+            item.second->SetPlayoutDelay(minDelayMs, maxDelayMs);
+        }
+    }
+}
+
+void RtpUnpackImpl::Poll()
+{
+    for (auto &item : rtpSort_) {
+        if (item.second != nullptr) {
+            item.second->Poll();
+        }
+    }
+}
+
+void RtpUnpackImpl::SetFecPayloadType(uint8_t pt)
+{
+    fecDecoder_ = std::make_shared<RtpFecDecoder>(pt);
+    // a rebuilt packet goes through the sortor as if it had been received
+    fecDecoder_->SetOnRecovered(
+        std::bind(&RtpUnpackImpl::ParseRtp, this, std::placeholders::_1, std::placeholders::_2));
+}
+
+void RtpUnpackImpl::AddPayload(const RtpPlaylodParam &rpp)
+{
+    SHARING_LOGI("add rtp payload pt: %{public}u, rate: %{public}d.", rpp.pt_, rpp.sampleRate_);
+    CreateRtpDecoder(rpp);
+}
+
 void RtpUnpackImpl::OnRtpSorted(uint16_t seq, const RtpPacket::Ptr &rtp)
 {
     RETURN_IF_NULL(rtp);
@@ -112,11 +152,33 @@ void RtpUnpackImpl::OnRtpSorted(uint16_t seq, const RtpPacket::Ptr &rtp)
 
 void RtpUnpackImpl::OnRtpDecode(int32_t pt, const Frame::Ptr &frame)
 {
+    if (frame != nullptr && msStampPayloads_.count(pt) > 0) {
+        // every decoder hands out a frame of its own, the 32 bit dts keeps the ms
+        auto impl = std::static_pointer_cast<FrameImpl>(frame);
+        impl->pts_ = impl->Pts() * 1000; // 1000: ms to us
+    }
     if (onRtpUnpack_) {
         onRtpUnpack_(rtpSort_[pt]->GetSSRC(), frame);
     }
 }
 
+void RtpUnpackImpl::OnRtpLost(int32_t pt, const std::vector<uint16_t> &seqs)
+{
+    MEDIA_LOGD("rtp lost pt: %{public}d, first seq: %{public}hu, count: %{public}zu.", pt, seqs.front(),
+               seqs.size());
+    if (onRtpLost_) {
+        onRtpLost_(rtpSort_[pt]->GetSSRC(), seqs);
+    }
+}
+
+void RtpUnpackImpl::OnKeyFrameNeeded(int32_t pt)
+{
+    MEDIA_LOGD("key frame needed pt: %{public}d.", pt);
+    if (onKeyFrameRequest_) {
+        onKeyFrameRequest_(rtpSort_[pt]->GetSSRC());
+    }
+}
+
 void RtpUnpackImpl::Release()
 {
     for (auto &item : rtpSort_) {
@@ -125,10 +187,28 @@ void RtpUnpackImpl::Release()
             if (lostCount > 0) {
                 WfdSinkHiSysEvent::GetInstance().ReportRtpPacketLost(__func__, lostCount);
             }
+            auto loss = item.second->GetLossStats();
+            if (loss.nacked > 0) {
+                SHARING_LOGI("rtp pt: %{public}u nacked: %{public}" PRIu64 ", recovered: %{public}" PRIu64
+                             ", unrecovered: %{public}" PRIu64 ".",
+                             item.first, loss.nacked, loss.recovered, loss.unrecovered);
+            }
+            auto playout = item.second->GetPlayoutStats();
+            SHARING_LOGI("rtp pt: %{public}u target delay: %{public}u ms, jitter: %{public}u ms, late drops: "
+                         "%{public}" PRIu64 ".",
+                         item.first, playout.targetDelayMs, playout.jitterMs, playout.lateDrops);
         }
     }
+    if (fecDecoder_ != nullptr) {
+        auto fec = fecDecoder_->GetStats();
+        SHARING_LOGI("rtp fec parity: %{public}" PRIu64 ", recovered: %{public}" PRIu64
+                     ", unrecoverable: %{public}" PRIu64 ".",
+                     fec.parity, fec.recovered, fec.unrecoverable);
+        fecDecoder_.reset();
+    }
     rtpDecoder_.clear();
     rtpSort_.clear();
+    msStampPayloads_.clear();
 }
 
 void RtpUnpackImpl::CreateRtpDecoder(const RtpPlaylodParam &rpp)
@@ -155,7 +235,15 @@ void RtpUnpackImpl::CreateRtpDecoder(const RtpPlaylodParam &rpp)
         auto &ref = rtpSort_[rpp.pt_];
         ref = std::make_shared<RtpPacketSortor>(rpp.sampleRate_);
         ref->SetOnSort(std::bind(&RtpUnpackImpl::OnRtpSorted, this, std::placeholders::_1, std::placeholders::_2));
+        ref->SetOnLost(std::bind(&RtpUnpackImpl::OnRtpLost, this, rpp.pt_, std::placeholders::_1));
+        if (maxDelayMs_ > 0) {
+            ref->SetPlayoutDelay(minDelayMs_, maxDelayMs_);
+        }
+        if (rpp.ps_ != RtpPayloadStream::MPEG2_TS) {
+            msStampPayloads_.insert(rpp.pt_);
+        }
         rtpDecoder_[rpp.pt_]->SetOnFrame(std::bind(&RtpUnpackImpl::OnRtpDecode, this, rpp.pt_, std::placeholders::_1));
+        rtpDecoder_[rpp.pt_]->SetOnKeyFrameNeeded(std::bind(&RtpUnpackImpl::OnKeyFrameNeeded, this, rpp.pt_));
     }
 }
 } // namespace Sharing
@@ -36,6 +36,7 @@ public:
     uint32_t videoWidth_ = DEFAULT_VIDEO_WIDTH;
     uint32_t videoHeight_ = DEFAULT_VIDEO_HEIGHT;
     uint32_t frameRate_ = DEFAULT_FRAME_RATE;
+    uint32_t bitrate_ = SCREEN_CAPTURE_ENCODE_BITRATE;
 
     int32_t codecType_ = CodecId::CODEC_H264;
     int32_t pixleFormat_ = static_cast<int32_t>(OHOS::MediaAVCodec::VideoPixelFormat::RGBA);
@@ -74,6 +75,10 @@ public:
     bool StopEncoder();
     bool ReleaseEncoder();
     bool InitEncoder(const VideoSourceConfigure &configure);
+    // the next encoded frame is an idr frame
+    bool RequestKeyFrame();
+    // retunes the running encoder, frameRate 0 keeps the current one
+    bool SetBitrate(uint32_t bitrate, uint32_t frameRate);
 
     sptr<Surface> &GetEncoderSurface();
 
@@ -146,7 +146,7 @@ bool VideoSourceEncoder::ConfigEncoder(const VideoSourceConfigure &configure)
     videoFormat.PutIntValue("width", configure.videoWidth_);
     videoFormat.PutIntValue("height", configure.videoHeight_);
     videoFormat.PutIntValue("frame_rate", configure.frameRate_);
-    videoFormat.PutIntValue("bitrate", SCREEN_CAPTURE_ENCODE_BITRATE);
+    videoFormat.PutIntValue("bitrate", configure.bitrate_);
     int32_t ret = videoEncoder_->Configure(videoFormat);
     if (ret != MediaAVCodec::AVCodecServiceErrCode::AVCS_ERR_OK) {
         SHARING_LOGE("Configure encoder failed!");
@@ -224,6 +224,47 @@ bool VideoSourceEncoder::ReleaseEncoder()
     return true;
 }
 
+bool VideoSourceEncoder::RequestKeyFrame()
+{
+    SHARING_LOGI("%{public}s.", __FUNCTION__);
+    if (videoEncoder_ == nullptr) {
+        SHARING_LOGE("Encoder is null!");
+        return false;
+    }
+
+    MediaAVCodec::Format format;
+    format.PutIntValue("req_i_frame", 1);
+    int32_t ret = videoEncoder_->SetParameter(format);
+    if (ret != MediaAVCodec::AVCodecServiceErrCode::AVCS_ERR_OK) {
+        SHARING_LOGE("Request key frame failed!");
+        return false;
+    }
+
+    return true;
+}
+
+bool VideoSourceEncoder::SetBitrate(uint32_t bitrate, uint32_t frameRate)
+{
+    SHARING_LOGI("bitrate: %{public}u, frame rate: %{public}u.", bitrate, frameRate);
+    if (videoEncoder_ == nullptr) {
+        SHARING_LOGE("Encoder is null!");
+        return false;
+    }
+
+    MediaAVCodec::Format format;
+    format.PutIntValue("bitrate", bitrate);
+    if (frameRate > 0) {
+        format.PutIntValue("frame_rate", frameRate);
+    }
+    int32_t ret = videoEncoder_->SetParameter(format);
+    if (ret != MediaAVCodec::AVCodecServiceErrCode::AVCS_ERR_OK) {
+        SHARING_LOGE("Set bitrate failed!");
+        return false;
+    }
+
+    return true;
+}
+
 void VideoSourceEncoder::OnOutputBufferAvailable(uint32_t index, MediaAVCodec::AVCodecBufferInfo info,
                                                  MediaAVCodec::AVCodecBufferFlag flag,
                                                  std::shared_ptr<MediaAVCodec::AVSharedMemory> buffer)
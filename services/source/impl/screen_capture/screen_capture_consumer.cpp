@@ -274,6 +274,28 @@ int32_t ScreenCaptureConsumer::Release()
     return 0;
 }
 
+void ScreenCaptureConsumer::RequestKeyFrame()
+{
+    SHARING_LOGD("trace.");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isRunning_ || videoSourceEncoder_ == nullptr) {
+        return;
+    }
+
+    videoSourceEncoder_->RequestKeyFrame();
+}
+
+void ScreenCaptureConsumer::SetVideoBitrate(uint32_t bitrate, uint32_t frameRate)
+{
+    SHARING_LOGD("trace.");
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!isRunning_ || videoSourceEncoder_ == nullptr) {
+        return;
+    }
+
+    videoSourceEncoder_->SetBitrate(bitrate, frameRate);
+}
+
 bool ScreenCaptureConsumer::IsPaused()
 {
     SHARING_LOGD("trace.");
@@ -51,6 +51,8 @@ public:
 
     void OnInitVideoCaptureError();
     void OnFrameBufferUsed() override;
+    void RequestKeyFrame() override;
+    void SetVideoBitrate(uint32_t bitrate, uint32_t frameRate) override;
     void UpdateOperation(ProsumerStatusMsg::Ptr &statusMsg) override;
     void OnFrame(const Frame::Ptr &frame, FRAME_TYPE frameType, bool keyFrame) override;
 
@@ -29,6 +29,19 @@ struct WfdProducerEventMsg : public ChannelEventMsg {
 
     std::string localIp;
     std::string ip;
+
+    // rtp goes to this multicast group instead of ip:port, rtcp stays with ip; empty for unicast
+    std::string group;
+    uint16_t groupPort = 0;
+    uint8_t groupTtl = 1;
+    bool groupLoop = false;
+
+    // h264 and aac in rtp streams of their own instead of one ts stream, negotiated in m3/m4
+    bool rtpDirect = false;
+    uint8_t videoPt = 96;
+    uint8_t audioPt = 97;
+    uint32_t audioSampleRate = 48000;
+    uint32_t audioChannels = 2;
 };
 
 } // namespace Sharing
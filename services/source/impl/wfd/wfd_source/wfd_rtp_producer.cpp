@@ -14,6 +14,9 @@
  */
 
 #include "wfd_rtp_producer.h"
+#include <algorithm>
+#include <chrono>
+#include <netinet/in.h>
 #include <unistd.h>
 #include "common/common_macro.h"
 #include "common/reflect_registration.h"
@@ -21,6 +24,7 @@
 #include "extend/magic_enum/magic_enum.hpp"
 #include "protocol/frame/aac_frame.h"
 #include "protocol/frame/h264_frame.h"
+#include "network/socket/socket_utils.h"
 #include "utils/utils.h"
 #include "source_media_def.h"
 #include "source_session_def.h"
@@ -89,6 +93,20 @@ void WfdRtpProducer::UdpClient::Release()
     Stop();
 }
 
+int32_t WfdRtpProducer::UdpClient::GetLocalFd()
+{
+    if (networkClientPtr_ == nullptr || networkClientPtr_->GetSocketInfo() == nullptr) {
+        return -1;
+    }
+    return networkClientPtr_->GetSocketInfo()->GetLocalFd();
+}
+
+bool WfdRtpProducer::UdpClient::SetMulticastOptions(uint8_t ttl, bool loop, const std::string &localIp)
+{
+    RETURN_FALSE_IF_NULL(networkClientPtr_);
+    return networkClientPtr_->SetMulticastOptions(ttl, loop, localIp);
+}
+
 bool WfdRtpProducer::UdpClient::Connect(const std::string &peerIp, uint16_t peerPort, const std::string &localIp,
                                         uint16_t localPort)
 {
@@ -105,6 +123,15 @@ bool WfdRtpProducer::UdpClient::SendDataBuffer(const DataBuffer::Ptr &buf)
     return false;
 }
 
+bool WfdRtpProducer::UdpClient::SendDataBuffers(const std::vector<DataBuffer::Ptr> &bufs)
+{
+    MEDIA_LOGD("trace.");
+    if (networkClientPtr_) {
+        return networkClientPtr_->SendBatch(bufs);
+    }
+    return false;
+}
+
 WfdRtpProducer::WfdRtpProducer()
 {
     SHARING_LOGI("ctor.");
@@ -175,26 +202,163 @@ void WfdRtpProducer::PublishOneFrame(const MediaData::Ptr &mediaData)
     MEDIA_LOGD("trace.");
     RETURN_IF_NULL(mediaData);
     RETURN_IF_NULL(mediaData->buff);
-    RETURN_IF_NULL(mediaData->buff->Peek());
-    auto buff = mediaData->buff;
+    RETURN_IF_NULL(mediaData->buff->Data());
     if (isRunning_ && !isPaused_) { // paused check at this pos or in DispatchMediaData
+        // frames only reference the dispatcher buffer, it stays untouched until the packer drops them
         if (mediaData->mediaType == MEDIA_TYPE_AUDIO) {
             MEDIA_LOGD("audio frame codec:%{public}d, pts:%{public}" PRId64 ".", mediaData->codecId, mediaData->pts);
-            auto audioFrame = FrameImpl::CreateFrom(std::move(*buff));
+            auto audioFrame = std::make_shared<SharedFrame<FrameImpl>>(mediaData->buff);
             audioFrame->codecId_ = mediaData->codecId;
             audioFrame->dts_ = audioFrame->pts_ = static_cast<uint32_t>(mediaData->pts);
-            tsPacker_->InputFrame(audioFrame);
+            if (audioPacker_ == nullptr) {
+                tsPacker_->InputFrame(audioFrame);
+            } else if (mediaData->codecId == CODEC_AAC) {
+                // the rtp payload is the raw access unit, the sink rebuilds the adts header
+                audioFrame->prefixSize_ = AdtsHeaderSize(audioFrame->Data(), audioFrame->Size());
+                audioPacker_->InputFrame(audioFrame);
+            }
         } else if (mediaData->mediaType == MEDIA_TYPE_VIDEO) {
             MEDIA_LOGD("video frame pts:%{public}" PRId64 ".", mediaData->pts);
-            auto h264Frame = std::make_shared<H264Frame>(std::move(*buff));
-            h264Frame->dts_ = h264Frame->pts_ = static_cast<uint32_t>(mediaData->pts);
-            h264Frame->prefixSize_ = PrefixSize(h264Frame->Peek(), h264Frame->Size());
-            h264Frame->codecId_ = CODEC_H264;
-            tsPacker_->InputFrame(h264Frame);
+            if (videoPacker_ != nullptr) {
+                InputDirectVideo(mediaData);
+            } else {
+                auto h264Frame = std::make_shared<SharedFrame<H264Frame>>(mediaData->buff);
+                h264Frame->dts_ = h264Frame->pts_ = static_cast<uint32_t>(mediaData->pts);
+                h264Frame->prefixSize_ =
+                    PrefixSize(reinterpret_cast<const char *>(h264Frame->Data()), h264Frame->Size());
+                h264Frame->codecId_ = CODEC_H264;
+                tsPacker_->InputFrame(h264Frame);
+            }
+            // the tail of a frame is not left waiting for the next one
+            if (rtpFec_ != nullptr) {
+                auto parity = rtpFec_->Flush();
+                if (parity != nullptr) {
+                    rtpBatch_.push_back(parity);
+                }
+            }
         }
+        FlushRtpBatch();
     }
 }
 
+void WfdRtpProducer::InputDirectVideo(const MediaData::Ptr &mediaData)
+{
+    auto &buff = mediaData->buff;
+    auto base = reinterpret_cast<const char *>(buff->Data());
+    auto pts = static_cast<uint32_t>(mediaData->pts);
+    // one frame per nalu, the encoder sends each as single, stap-a or fu-a packets
+    SplitH264(base, buff->Size(), 0, [&](const char *nalu, size_t len, size_t prefix) {
+        if (len <= prefix) {
+            return;
+        }
+        H264Frame::Ptr frame = nullptr;
+        uint8_t type = H264_TYPE(nalu[prefix]);
+        if (type == H264Frame::NAL_SPS || type == H264Frame::NAL_PPS) {
+            // kept until the next idr, a copy does not pin the dispatcher buffer
+            frame = std::make_shared<H264Frame>((uint8_t *)nalu, len, pts, pts, prefix);
+        } else {
+            frame = std::make_shared<SharedFrame<H264Frame>>(buff, nalu - base, static_cast<int32_t>(len));
+            frame->dts_ = frame->pts_ = pts;
+            frame->prefixSize_ = prefix;
+        }
+        videoPacker_->InputFrame(frame);
+    });
+    // the frame is a whole access unit, its last packet gets the marker now instead of with the next frame
+    videoPacker_->Flush();
+}
+
+void WfdRtpProducer::FlushRtpBatch()
+{
+    if (rtpBatch_.empty()) {
+        return;
+    }
+
+    AdaptRtpFec();
+    if (rateController_ != nullptr) {
+        size_t bytes = 0;
+        for (auto &packet : rtpBatch_) {
+            bytes += packet->Size();
+        }
+        rateController_->OnSent(bytes);
+    }
+    statsPackets_ += rtpBatch_.size();
+    statsFrames_++;
+    if (rtpPacer_ != nullptr) {
+        // the fanout sinks are sent from the pacer too, the latency is taken when the last burst left
+        rtpPacer_->InputFrame(std::move(rtpBatch_), frameIntervalMs_);
+    } else {
+        auto start = std::chrono::steady_clock::now();
+        if (tsUdpClient_ != nullptr) {
+            tsUdpClient_->SendDataBuffers(rtpBatch_);
+        }
+        if (rtpFanout_ != nullptr) {
+            rtpFanout_->Send(rtpBatch_);
+        }
+        int64_t latency =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        statsLatencyUs_ += latency;
+        statsMaxLatencyUs_ = std::max(statsMaxLatencyUs_, latency);
+    }
+
+    if (statsFrames_ >= SEND_STATS_FRAMES) {
+        uint64_t sentFrames = statsFrames_;
+        RtpPacer::Stats pacer;
+        if (rtpPacer_ != nullptr) {
+            pacer = rtpPacer_->TakeStats();
+            sentFrames = pacer.frames;
+            statsLatencyUs_ = pacer.totalDelayUs;
+            statsMaxLatencyUs_ = pacer.maxDelayUs;
+        }
+        SHARING_LOGI("frame send latency avg: %{public}" PRId64 "us, max: %{public}" PRId64
+                     "us, rtp per frame: %{public}" PRIu64 ".",
+                     sentFrames ? statsLatencyUs_ / static_cast<int64_t>(sentFrames) : 0, statsMaxLatencyUs_,
+                     statsPackets_ / statsFrames_);
+        if (rtpHistory_ != nullptr) {
+            auto history = rtpHistory_->GetStats();
+            SHARING_LOGI("rtp nack requested: %{public}" PRIu64 ", retransmitted: %{public}" PRIu64
+                         ", missing: %{public}" PRIu64 ", throttled: %{public}" PRIu64 ".",
+                         history.requested, history.retransmitted, history.missing, history.throttled);
+        }
+        if (rateController_ != nullptr) {
+            auto rate = rateController_->GetStats();
+            SHARING_LOGI("rate control target: %{public}u, fps: %{public}u, delay: %{public}u, loss: %{public}u, "
+                         "send: %{public}u, queue delay: %{public}u ms, decreases: %{public}" PRIu64 ".",
+                         rate.targetBitrate, rate.frameRate, rate.delayBitrate, rate.lossBitrate, rate.sendBitrate,
+                         rate.queueDelayMs, rate.decreases);
+        }
+        if (rtpFec_ != nullptr) {
+            auto fec = rtpFec_->GetStats();
+            SHARING_LOGI("rtp fec media: %{public}" PRIu64 ", parity: %{public}" PRIu64 ", group: %{public}u.",
+                         fec.media, fec.parity, fec.groupPackets);
+        }
+        {
+            std::lock_guard<std::mutex> lock(keyFrameMutex_);
+            if (keyFrameRequests_ > 0) {
+                SHARING_LOGI("key frame requests: %{public}" PRIu64 ", forced: %{public}" PRIu64 ".",
+                             keyFrameRequests_, keyFramesForced_);
+            }
+        }
+        if (rtpFanout_ != nullptr) {
+            std::lock_guard<std::mutex> lock(fanoutMutex_);
+            for (auto &sink : fanoutSinks_) {
+                auto fanout = rtpFanout_->GetStats(sink.id);
+                SHARING_LOGI("fanout sink: %{public}u, ssrc: %{public}u, packets: %{public}" PRIu64
+                             ", dropped: %{public}" PRIu64 ", queued: %{public}u, rtt: %{public}u ms.",
+                             sink.id, fanout.ssrc, fanout.packets, fanout.dropped, fanout.queued, fanout.rtt);
+            }
+        }
+        if (rtpPacer_ != nullptr) {
+            SHARING_LOGI("rtp pacer queue: %{public}u, max: %{public}u, unpaced frames: %{public}" PRIu64 ".",
+                         pacer.queueDepth, pacer.maxQueueDepth, pacer.unpacedFrames);
+        }
+        statsFrames_ = 0;
+        statsPackets_ = 0;
+        statsLatencyUs_ = 0;
+        statsMaxLatencyUs_ = 0;
+    }
+    rtpBatch_.clear();
+}
+
 int32_t WfdRtpProducer::HandleEvent(SharingEvent &event)
 {
     RETURN_INVALID_IF_NULL(event.eventMsg);
@@ -204,6 +368,15 @@ int32_t WfdRtpProducer::HandleEvent(SharingEvent &event)
             HandleMediaInit(ConvertEventMsg<WfdProducerEventMsg>(event));
             break;
         }
+        case EventType::EVENT_WFD_REQUEST_IDR:
+            RequestKeyFrame();
+            break;
+        case EventType::EVENT_WFD_MEDIA_ADD_SINK:
+            AddFanoutSink(ConvertEventMsg<WfdProducerEventMsg>(event));
+            break;
+        case EventType::EVENT_WFD_MEDIA_REMOVE_SINK:
+            RemoveFanoutSink(ConvertEventMsg<WfdProducerEventMsg>(event));
+            break;
         default:
             break;
     }
@@ -213,7 +386,7 @@ int32_t WfdRtpProducer::HandleEvent(SharingEvent &event)
 bool WfdRtpProducer::ProducerInit()
 {
     SHARING_LOGI("%{public}s.", __FUNCTION__);
-    if (InitTsRtpPacker(ssrc_) != 0) {
+    if ((rtpDirect_ ? InitDirectRtpPackers() : InitTsRtpPacker(ssrc_)) != 0) {
         SHARING_LOGE("init rtp packer failed.");
         return false;
     }
@@ -223,6 +396,13 @@ bool WfdRtpProducer::ProducerInit()
         return false;
     }
 
+    InitRtpPacer();
+    InitKeyFrameRequest();
+    InitRateControl();
+    InitRtpHistory();
+    InitRtpFec();
+    InitRtpFanout();
+
     isInit_ = true;
     return true;
 }
@@ -236,14 +416,46 @@ int32_t WfdRtpProducer::InitTsRtpPacker(uint32_t ssrc, size_t mtuSize, uint32_t
         SHARING_LOGE("createRtpPacker failed.");
         return -1;
     }
-    tsPacker_->SetOnRtpPack([=](const RtpPacket::Ptr &rtp) {
-        MEDIA_LOGD("rtp packed seq: %{public}d timestamp: %{public}d size: %{public}d.", rtp->GetSeq(), rtp->GetStamp(),
-                   rtp->Size());
-        SendDataBuffer(rtp);
-    });
+    tsPacker_->SetOnRtpPack([=](const RtpPacket::Ptr &rtp) { OnRtpPacked(rtp); });
     return 0;
 }
 
+int32_t WfdRtpProducer::InitDirectRtpPackers()
+{
+    SHARING_LOGI("%{public}s video pt: %{public}u, audio pt: %{public}u, audio rate: %{public}u.", __FUNCTION__,
+                 videoPt_, audioPt_, audioSampleRate_);
+    // 1400: mtu of the ts stream, 90000: h264 clock
+    videoPacker_ = RtpSourceFactory::CreateRtpPack(ssrc_, 1400, 90000, videoPt_, RtpPayloadStream::H264, 0);
+    // the aac clock is its sample rate
+    audioPacker_ = RtpSourceFactory::CreateRtpPack(ssrc_ + 1, 1400, audioSampleRate_, audioPt_,
+                                                   RtpPayloadStream::MPEG4_GENERIC, audioChannels_);
+    if (videoPacker_ == nullptr || audioPacker_ == nullptr) {
+        SHARING_LOGE("createRtpPacker failed.");
+        return -1;
+    }
+    videoPacker_->SetOnRtpPack([=](const RtpPacket::Ptr &rtp) { OnRtpPacked(rtp); });
+    // nacks, fec and sender reports are about the video ssrc only
+    audioPacker_->SetOnRtpPack([=](const RtpPacket::Ptr &rtp) { rtpBatch_.push_back(rtp); });
+    return 0;
+}
+
+void WfdRtpProducer::OnRtpPacked(const RtpPacket::Ptr &rtp)
+{
+    MEDIA_LOGD("rtp packed seq: %{public}d timestamp: %{public}d size: %{public}d.", rtp->GetSeq(), rtp->GetStamp(),
+               rtp->Size());
+    rtpBatch_.push_back(rtp);
+    if (rtpHistory_ != nullptr) {
+        rtpHistory_->Insert(rtp);
+    }
+    if (rtpFec_ != nullptr) {
+        fecPackets_++;
+        auto parity = rtpFec_->AddPacket(rtp);
+        if (parity != nullptr) {
+            rtpBatch_.push_back(parity);
+        }
+    }
+}
+
 int32_t WfdRtpProducer::InitUdpClients()
 {
     SHARING_LOGI("%{public}s.", __FUNCTION__);
@@ -257,11 +469,478 @@ int32_t WfdRtpProducer::InitUdpClients()
         values->GetValue<int32_t>(rtcpCheckInterval_);
     }
 
-    if (rtcpCheckInterval_ > 0) {
+    return 0;
+}
+
+void WfdRtpProducer::InitRtpPacer()
+{
+    SHARING_LOGI("%{public}s.", __FUNCTION__);
+    int32_t enable = 0;
+    SharingValue::Ptr values = nullptr;
+    auto ret = Config::GetInstance().GetConfig("mediachannel", "rtpPacer", "enable", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(enable);
+    }
+
+    if (enable == 0) {
+        rtpPacer_ = nullptr;
+        return;
+    }
+
+    int32_t framerate = 0;
+    ret = Config::GetInstance().GetConfig("mediachannel", "videoFormat", "defaultFramerate", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(framerate);
+    }
+    if (framerate > 0) {
+        frameIntervalMs_ = static_cast<uint32_t>(1000 / framerate); // 1000: ms per second
+    }
+
+    RtpPacer::Config config;
+    // the encoder starts at this rate, see VideoSourceConfigure; rate control moves both together
+    config.bitrate = SCREEN_CAPTURE_ENCODE_BITRATE;
+    std::pair<const char *, uint32_t *> keys[] = {
+        {"headroomPercent", &config.headroomPercent},
+        {"spreadPercent", &config.spreadPercent},
+        {"burstPackets", &config.burstPackets},
+        {"maxQueueFrames", &config.maxQueueFrames},
+    };
+    for (auto &key : keys) {
+        int32_t value = 0;
+        ret = Config::GetInstance().GetConfig("mediachannel", "rtpPacer", key.first, values);
+        if (ret == CONFIGURE_ERROR_NONE && values->GetValue<int32_t>(value) && value >= 0) {
+            *key.second = static_cast<uint32_t>(value);
+        }
+    }
+
+    rtpPacer_ = std::make_shared<RtpPacer>(config);
+    rtpPacer_->SetOnSend([this](const std::vector<DataBuffer::Ptr> &packets) {
+        auto client = tsUdpClient_;
+        if (client != nullptr) {
+            client->SendDataBuffers(packets);
+        }
+        // the other sinks get the same bursts, so OnRateReport paces them as well
+        auto fanout = rtpFanout_;
+        if (fanout != nullptr) {
+            fanout->Send(packets);
+        }
+    });
+}
+
+void WfdRtpProducer::InitRtpHistory()
+{
+    SHARING_LOGI("%{public}s.", __FUNCTION__);
+    int32_t enable = 0;
+    int32_t historyPackets = 1024; // 1024: about a 1080p idr frame
+    SharingValue::Ptr values = nullptr;
+    auto ret = Config::GetInstance().GetConfig("mediachannel", "rtpNack", "enable", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(enable);
+    }
+    ret = Config::GetInstance().GetConfig("mediachannel", "rtpNack", "historyPackets", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(historyPackets);
+    }
+
+    rtpHistory_ = (enable != 0 && historyPackets > 0) ? std::make_shared<RtpPacketHistory>(historyPackets) : nullptr;
+    // the sink learns where to send its feedback from the first sender report
+    if (rtcpCheckInterval_ > 0 || rtpHistory_ != nullptr || keyFrameRequestEnabled_ || rateController_ != nullptr) {
+        std::lock_guard<std::mutex> lock(rtcpMutex_);
         rtcpSendContext_ = std::make_shared<RtcpSenderContext>();
     }
+}
 
-    return 0;
+void WfdRtpProducer::InitRtpFec()
+{
+    SHARING_LOGI("%{public}s.", __FUNCTION__);
+    int32_t enable = 0;
+    int32_t pt = 127;      // 127: last dynamic payload type
+    int32_t minGroup = 4;  // 4: 25% parity
+    int32_t maxGroup = 16; // 16: 6% parity
+    int32_t adaptive = 0;
+    std::pair<const char *, int32_t *> keys[] = {
+        {"enable", &enable},
+        {"payloadType", &pt},
+        {"minGroupPackets", &minGroup},
+        {"maxGroupPackets", &maxGroup},
+        {"adaptive", &adaptive},
+    };
+    SharingValue::Ptr values = nullptr;
+    for (auto &key : keys) {
+        auto ret = Config::GetInstance().GetConfig("mediachannel", "rtpFec", key.first, values);
+        if (ret == CONFIGURE_ERROR_NONE) {
+            values->GetValue<int32_t>(*key.second);
+        }
+    }
+
+    if (enable == 0 || pt < 0 || pt > 127 || pt == 33 || minGroup <= 0 || maxGroup <= 0) { // 127: 7 bits, 33: ts
+        rtpFec_ = nullptr;
+        return;
+    }
+    rtpFec_ = std::make_shared<RtpFecEncoder>(static_cast<uint8_t>(pt), static_cast<uint32_t>(minGroup),
+                                              static_cast<uint32_t>(maxGroup));
+    fecAdaptive_ = adaptive != 0;
+}
+
+void WfdRtpProducer::InitRtpFanout()
+{
+    SHARING_LOGI("%{public}s.", __FUNCTION__);
+    int32_t enable = 0;
+    int32_t maxSinks = 0;
+    int32_t maxQueuePackets = 0;
+    std::pair<const char *, int32_t *> keys[] = {
+        {"enable", &enable},
+        {"maxSinks", &maxSinks},
+        {"maxQueuePackets", &maxQueuePackets},
+    };
+    SharingValue::Ptr values = nullptr;
+    for (auto &key : keys) {
+        auto ret = Config::GetInstance().GetConfig("mediachannel", "rtpFanout", key.first, values);
+        if (ret == CONFIGURE_ERROR_NONE) {
+            values->GetValue<int32_t>(*key.second);
+        }
+    }
+
+    if (enable == 0) {
+        rtpFanout_ = nullptr;
+        return;
+    }
+    if (rtpDirect_) {
+        // a sink's stream gets one ssrc and seq space, the direct mode has two
+        SHARING_LOGW("fanout needs the ts stream, disabled.");
+        rtpFanout_ = nullptr;
+        return;
+    }
+    RtpFanout::Config config;
+    config.maxSinks = maxSinks > 0 ? static_cast<uint32_t>(maxSinks) : config.maxSinks;
+    config.maxQueuePackets = maxQueuePackets > 0 ? static_cast<uint32_t>(maxQueuePackets) : config.maxQueuePackets;
+    config.payloadType = 33; // 33: ts, the parity of the fec stays with the primary sink
+    rtpFanout_ = std::make_shared<RtpFanout>(config);
+}
+
+void WfdRtpProducer::AddFanoutSink(std::shared_ptr<WfdProducerEventMsg> msg)
+{
+    RETURN_IF_NULL(msg);
+    if (rtpFanout_ == nullptr) {
+        SHARING_LOGW("fanout disabled, sink %{public}s:%{public}d ignored.", GetAnonyString(msg->ip).c_str(),
+                     msg->port);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(fanoutMutex_);
+        for (auto &sink : fanoutSinks_) {
+            if (sink.ip == msg->ip && sink.port == msg->port) {
+                return;
+            }
+        }
+
+        if (fanoutFd_ < 0) {
+            int32_t fd = -1;
+            if (!SocketUtils::CreateSocket(SOCK_DGRAM, fd)) {
+                return;
+            }
+            SocketUtils::SetNonBlocking(fd);
+            SocketUtils::SetSendBuf(fd);
+            SocketUtils::SetCloExec(fd, true);
+            int32_t tos = 0xBC; // 0xBC: the same class as the primary stream
+            setsockopt(fd, IPPROTO_IP, IP_TOS, &tos, sizeof(tos));
+            fanoutFd_ = fd;
+            rtpFanout_->SetSocket(fanoutFd_);
+        }
+
+        FanoutSink sink;
+        sink.id = fanoutNextId_++;
+        sink.ip = msg->ip;
+        sink.port = msg->port;
+        sink.rtcpClient = std::make_shared<UdpClient>(true);
+        sink.rtcpClient->SetUdpDataListener(shared_from_this());
+        // the sink answers to where its sender reports come from
+        if (!sink.rtcpClient->Connect(msg->ip, msg->port + 1, localIp_, 0) ||
+            !rtpFanout_->AddSink(sink.id, msg->ip, msg->port, ssrc_ + sink.id)) {
+            SHARING_LOGE("add fanout sink %{public}s:%{public}d failed.", GetAnonyString(msg->ip).c_str(), msg->port);
+            sink.rtcpClient->Stop();
+            return;
+        }
+        sink.rtcpFd = sink.rtcpClient->GetLocalFd();
+        sink.rtcpClient->SendDataBuffer(rtpFanout_->CreateSenderReport(sink.id));
+        fanoutSinks_.push_back(sink);
+    }
+
+    // the new sink cannot decode anything before the next idr
+    RequestKeyFrame();
+}
+
+void WfdRtpProducer::RemoveFanoutSink(std::shared_ptr<WfdProducerEventMsg> msg)
+{
+    RETURN_IF_NULL(msg);
+    RETURN_IF_NULL(rtpFanout_);
+    std::lock_guard<std::mutex> lock(fanoutMutex_);
+    for (auto it = fanoutSinks_.begin(); it != fanoutSinks_.end(); ++it) {
+        if (it->ip == msg->ip && it->port == msg->port) {
+            it->rtcpClient->Stop();
+            rtpFanout_->RemoveSink(it->id);
+            fanoutSinks_.erase(it);
+            return;
+        }
+    }
+}
+
+void WfdRtpProducer::StopFanout()
+{
+    RETURN_IF_NULL(rtpFanout_);
+    std::lock_guard<std::mutex> lock(fanoutMutex_);
+    for (auto &sink : fanoutSinks_) {
+        sink.rtcpClient->Stop();
+        rtpFanout_->RemoveSink(sink.id);
+    }
+    fanoutSinks_.clear();
+    if (fanoutFd_ >= 0) {
+        rtpFanout_->SetSocket(-1);
+        SocketUtils::CloseSocket(fanoutFd_);
+        fanoutFd_ = -1;
+    }
+}
+
+void WfdRtpProducer::OnFanoutRtcp(uint32_t id, DataBuffer::Ptr buf)
+{
+    auto ssrc = rtpFanout_->GetSsrc(id);
+    for (auto rtcp : RtcpHeader::LoadFromBytes(buf->Data(), buf->Size())) {
+        auto type = (RtcpType)rtcp->pt_;
+        if (type == RtcpType::RTCP_RR) {
+            // 4: sender ssrc
+            if ((size_t)rtcp->GetSize() >= sizeof(RtcpHeader) + 4 + rtcp->reportCount_ * sizeof(ReportItem)) {
+                rtpFanout_->OnRtcp(id, rtcp);
+            }
+            continue;
+        }
+        if (type == RtcpType::RTCP_XR) {
+            // 4: sender ssrc
+            if ((size_t)rtcp->GetSize() >= sizeof(RtcpHeader) + 4) {
+                rtpFanout_->OnRtcp(id, rtcp);
+                SendFanoutRtcp(id, rtpFanout_->CreateDlrr(id, ntohl(((RtcpXRRRTR *)rtcp)->ssrc_)));
+            }
+            continue;
+        }
+
+        if (rtcp->GetSize() < (int32_t)sizeof(RtcpFB)) {
+            continue;
+        }
+        auto fb = (RtcpFB *)rtcp;
+        if (type == RtcpType::RTCP_RTPFB && ntohl(fb->ssrcMedia_) == ssrc) {
+            if (rtpHistory_ != nullptr) {
+                auto seqs = rtpFanout_->ToSourceSeqs(id, fb->GetNackSeqs());
+                rtpFanout_->SendTo(id, rtpHistory_->Lookup(seqs, RETRANSMIT_MIN_INTERVAL_MS));
+            }
+        } else if (fb->IsKeyFrameRequest(ssrc)) {
+            // one encoder for all sinks, any of them may ask for an idr
+            RequestKeyFrame();
+        }
+    }
+}
+
+void WfdRtpProducer::SendFanoutRtcp(uint32_t id, const DataBuffer::Ptr &buf)
+{
+    RETURN_IF_NULL(buf);
+    std::lock_guard<std::mutex> lock(fanoutMutex_);
+    for (auto &sink : fanoutSinks_) {
+        if (sink.id == id) {
+            sink.rtcpClient->SendDataBuffer(buf);
+            return;
+        }
+    }
+}
+
+void WfdRtpProducer::AdaptRtpFec()
+{
+    // with nacks the loss is known per packet, otherwise the receiver reports tell it
+    if (rtpFec_ == nullptr || !fecAdaptive_ || rtpHistory_ == nullptr) {
+        return;
+    }
+
+    fecFrames_++;
+    if (fecFrames_ < FEC_ADAPT_FRAMES) {
+        return;
+    }
+    uint64_t nacked = fecNacked_.exchange(0);
+    rtpFec_->OnLossRate(fecPackets_ > 0 ? std::min(1.0, static_cast<double>(nacked) / fecPackets_) : 0);
+    fecFrames_ = 0;
+    fecPackets_ = 0;
+}
+
+void WfdRtpProducer::InitRateControl()
+{
+    SHARING_LOGI("%{public}s.", __FUNCTION__);
+    int32_t enable = 0;
+    SharingValue::Ptr values = nullptr;
+    auto ret = Config::GetInstance().GetConfig("mediachannel", "rtpRateControl", "enable", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(enable);
+    }
+
+    if (enable == 0) {
+        rateController_ = nullptr;
+        return;
+    }
+
+    RtpRateController::Config config;
+    // the encoder starts at this rate, see VideoSourceConfigure
+    config.startBitrate = SCREEN_CAPTURE_ENCODE_BITRATE;
+    int32_t framerate = 0;
+    ret = Config::GetInstance().GetConfig("mediachannel", "videoFormat", "defaultFramerate", values);
+    if (ret == CONFIGURE_ERROR_NONE && values->GetValue<int32_t>(framerate) && framerate > 0) {
+        config.maxFrameRate = static_cast<uint32_t>(framerate);
+    }
+    std::pair<const char *, uint32_t *> keys[] = {
+        {"minBitrate", &config.minBitrate},
+        {"maxBitrate", &config.maxBitrate},
+        {"lowBitrate", &config.lowBitrate},
+        {"minFrameRate", &config.minFrameRate},
+        {"delayThresholdMs", &config.delayThresholdMs},
+    };
+    for (auto &key : keys) {
+        int32_t value = 0;
+        ret = Config::GetInstance().GetConfig("mediachannel", "rtpRateControl", key.first, values);
+        if (ret == CONFIGURE_ERROR_NONE && values->GetValue<int32_t>(value) && value >= 0) {
+            *key.second = static_cast<uint32_t>(value);
+        }
+    }
+
+    rateController_ = std::make_shared<RtpRateController>(config);
+}
+
+void WfdRtpProducer::OnRateReport(RtcpRR *rr)
+{
+    RETURN_IF_NULL(rr);
+    RETURN_IF_NULL(rateController_);
+    for (auto item : rr->GetItemList()) {
+        if (item == nullptr || ntohl(item->ssrc_) != ssrc_) {
+            continue;
+        }
+
+        RtpRateController::Report report;
+        report.lossRate = item->fractionLost_ / 256.0; // 256.0: fixed point 8 bits
+        report.jitterMs = ntohl(item->jitter_) / 90;   // 90: video clock per ms
+        {
+            std::lock_guard<std::mutex> lock(rtcpMutex_);
+            if (rtcpSendContext_ != nullptr) {
+                report.rttMs = rtcpSendContext_->GetRtt(ssrc_);
+            }
+        }
+        int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (!rateController_->OnReport(report, now)) {
+            continue;
+        }
+
+        uint32_t bitrate = rateController_->GetTargetBitrate();
+        if (rtpPacer_ != nullptr) {
+            rtpPacer_->SetBitrate(bitrate);
+        }
+        auto eventMsg = std::make_shared<ChannelSetBitrateEventMsg>();
+        eventMsg->bitrate = bitrate;
+        eventMsg->frameRate = rateController_->GetFrameRate();
+        auto statusMsg = std::make_shared<ProsumerStatusMsg>();
+        statusMsg->eventMsg = eventMsg;
+        statusMsg->status = PROSUMER_NOTIFY_BITRATE_CHANGE;
+        Notify(statusMsg);
+    }
+}
+
+void WfdRtpProducer::InitKeyFrameRequest()
+{
+    SHARING_LOGI("%{public}s.", __FUNCTION__);
+    int32_t enable = 0;
+    SharingValue::Ptr values = nullptr;
+    auto ret = Config::GetInstance().GetConfig("mediachannel", "rtpKeyFrame", "enable", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(enable);
+    }
+    ret = Config::GetInstance().GetConfig("mediachannel", "rtpKeyFrame", "minIntervalMs", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<int32_t>(keyFrameMinIntervalMs_);
+    }
+
+    keyFrameRequestEnabled_ = enable != 0;
+}
+
+void WfdRtpProducer::RequestKeyFrame()
+{
+    uint32_t rtt = 0;
+    {
+        std::lock_guard<std::mutex> lock(rtcpMutex_);
+        if (rtcpSendContext_ != nullptr) {
+            rtt = rtcpSendContext_->GetRtt(ssrc_);
+        }
+    }
+
+    // the sink keeps asking until the forced idr frame reached it, that takes a round trip plus a frame
+    auto interval = std::chrono::milliseconds(std::max<int64_t>(keyFrameMinIntervalMs_, rtt + frameIntervalMs_));
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(keyFrameMutex_);
+        keyFrameRequests_++;
+        if (keyFramesForced_ > 0 && now - keyFrameForced_ < interval) {
+            return;
+        }
+        keyFrameForced_ = now;
+        keyFramesForced_++;
+    }
+
+    SHARING_LOGI("force key frame, producerId: %{public}u, rtt: %{public}u ms.", GetId(), rtt);
+    auto statusMsg = std::make_shared<ProsumerStatusMsg>();
+    statusMsg->eventMsg = std::make_shared<EventMsg>();
+    statusMsg->status = PROSUMER_NOTIFY_KEY_FRAME_REQUEST;
+    Notify(statusMsg);
+}
+
+void WfdRtpProducer::SendSenderReport()
+{
+    {
+        std::lock_guard<std::mutex> lock(rtcpMutex_);
+        if (rtcpSendContext_ != nullptr && tsRtcpUdpClient_ != nullptr) {
+            tsRtcpUdpClient_->SendDataBuffer(rtcpSendContext_->CreateRtcpSR(ssrc_));
+        }
+    }
+
+    if (rtpFanout_ != nullptr) {
+        std::lock_guard<std::mutex> lock(fanoutMutex_);
+        for (auto &sink : fanoutSinks_) {
+            sink.rtcpClient->SendDataBuffer(rtpFanout_->CreateSenderReport(sink.id));
+        }
+    }
+}
+
+void WfdRtpProducer::OnRtcpXR(RtcpHeader *rtcp)
+{
+    // 4: sender ssrc
+    if ((size_t)rtcp->GetSize() < sizeof(RtcpHeader) + 4) {
+        return;
+    }
+
+    // the dlrr answer to the sink's rrtr, so the receiver learns the round trip too
+    std::lock_guard<std::mutex> lock(rtcpMutex_);
+    if (rtcpSendContext_ == nullptr || tsRtcpUdpClient_ == nullptr) {
+        return;
+    }
+    rtcpSendContext_->OnRtcp(rtcp);
+    auto dlrr = rtcpSendContext_->CreateRtcpXRDLRR(ssrc_, ntohl(((RtcpXRRRTR *)rtcp)->ssrc_));
+    if (dlrr != nullptr) {
+        tsRtcpUdpClient_->SendDataBuffer(dlrr);
+    }
+}
+
+void WfdRtpProducer::OnRtcpNack(const std::vector<uint16_t> &seqs)
+{
+    RETURN_IF_NULL(rtpHistory_);
+    fecNacked_ += seqs.size();
+    auto packets = rtpHistory_->Lookup(seqs, RETRANSMIT_MIN_INTERVAL_MS);
+    MEDIA_LOGD("nack seqs: %{public}zu, retransmit: %{public}zu.", seqs.size(), packets.size());
+    // straight to the socket, a retransmission queued behind the pacer would come too late
+    auto client = tsUdpClient_;
+    if (!packets.empty() && client != nullptr) {
+        client->SendDataBuffers(packets);
+    }
 }
 
 bool WfdRtpProducer::SendDataBuffer(const DataBuffer::Ptr &buf, bool audio)
@@ -275,7 +954,7 @@ bool WfdRtpProducer::SendDataBuffer(const DataBuffer::Ptr &buf, bool audio)
 int32_t WfdRtpProducer::Connect()
 {
     SHARING_LOGI("%{public}s.", __FUNCTION__);
-    if (tsPacker_ == nullptr) {
+    if (tsPacker_ == nullptr && videoPacker_ == nullptr) {
         SHARING_LOGE("connect resource not useable.");
         return -1;
     }
@@ -284,15 +963,27 @@ int32_t WfdRtpProducer::Connect()
         SHARING_LOGE("udp network need init.");
         return -1;
     }
-    // create two udp client
-    if (!tsUdpClient_->Connect(primarySinkIp_, primarySinkPort_, localIp_, localPort_) ||
+    // create two udp client, with a group only the media goes there, the primary sink keeps the rtcp
+    bool multicast = !group_.empty();
+    if (!tsUdpClient_->Connect(multicast ? group_ : primarySinkIp_, multicast ? groupPort_ : primarySinkPort_,
+                               localIp_, localPort_) ||
         !tsRtcpUdpClient_->Connect(primarySinkIp_, primarySinkPort_ + 1, localIp_, localPort_ + 1)) {
         SHARING_LOGE("createNetworkClient failed.");
         return -1;
     }
 
+    if (multicast && !tsUdpClient_->SetMulticastOptions(groupTtl_, groupLoop_, localIp_)) {
+        SHARING_LOGE("set multicast options failed.");
+        return -1;
+    }
+
     SHARING_LOGI("createNetworkClient success.");
 
+    if (rtpPacer_ != nullptr) {
+        rtpPacer_->Start();
+    }
+
+    SendSenderReport();
     isRunning_ = true;
     return 0;
 }
@@ -301,6 +992,12 @@ int32_t WfdRtpProducer::Stop()
 {
     SHARING_LOGI("producerId: %{public}u.", GetId());
     isRunning_ = false;
+    if (rtpPacer_ != nullptr) {
+        rtpPacer_->Stop();
+    }
+
+    StopFanout();
+
     if (tsUdpClient_ != nullptr) {
         tsUdpClient_->Stop();
     }
@@ -321,6 +1018,10 @@ int32_t WfdRtpProducer::Stop()
 int32_t WfdRtpProducer::Release()
 {
     SHARING_LOGI("producerId: %{public}u.", GetId());
+    if (rtpPacer_ != nullptr) {
+        rtpPacer_.reset();
+    }
+
     if (tsUdpClient_ != nullptr) {
         tsUdpClient_.reset();
     }
@@ -333,19 +1034,86 @@ int32_t WfdRtpProducer::Release()
         tsPacker_.reset();
     }
 
-    if (rtcpSendContext_ != nullptr) {
+    videoPacker_.reset();
+    audioPacker_.reset();
+
+    {
+        std::lock_guard<std::mutex> lock(rtcpMutex_);
         rtcpSendContext_.reset();
     }
+
+    if (rtpHistory_ != nullptr) {
+        rtpHistory_.reset();
+    }
+
+    if (rtpFec_ != nullptr) {
+        rtpFec_.reset();
+    }
+
+    StopFanout();
+    rtpFanout_.reset();
     return 0;
 }
 
 void WfdRtpProducer::OnRtcpReadData(int32_t fd, DataBuffer::Ptr buf)
 {
     MEDIA_LOGD("trace.");
-    (void)fd;
+    if (buf && (buf->Size() > 0) && rtpFanout_ != nullptr) {
+        uint32_t sinkId = 0;
+        {
+            std::lock_guard<std::mutex> lock(fanoutMutex_);
+            for (auto &sink : fanoutSinks_) {
+                sinkId = sink.rtcpFd == fd ? sink.id : sinkId;
+            }
+        }
+        if (sinkId != 0) {
+            OnFanoutRtcp(sinkId, buf);
+            return;
+        }
+    }
+
     if (buf && (buf->Size() > 0)) {
         MEDIA_LOGD("recv rtcp rsp, producerId: %{public}u.", GetId());
         rtcpOvertimes_ = 0;
+        for (auto rtcp : RtcpHeader::LoadFromBytes(buf->Data(), buf->Size())) {
+            if ((RtcpType)rtcp->pt_ == RtcpType::RTCP_RR) {
+                // 4: sender ssrc
+                if ((size_t)rtcp->GetSize() < sizeof(RtcpHeader) + 4 + rtcp->reportCount_ * sizeof(ReportItem)) {
+                    continue;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(rtcpMutex_);
+                    if (rtcpSendContext_ != nullptr) {
+                        rtcpSendContext_->OnRtcp(rtcp);
+                    }
+                }
+                // without nacks the fec follows the reported loss
+                if (rtpFec_ != nullptr && fecAdaptive_ && rtpHistory_ == nullptr) {
+                    for (auto item : ((RtcpRR *)rtcp)->GetItemList()) {
+                        if (item != nullptr && ntohl(item->ssrc_) == ssrc_) {
+                            rtpFec_->OnLossRate(item->fractionLost_ / 256.0); // 256.0: fixed point 8 bits
+                        }
+                    }
+                }
+                OnRateReport((RtcpRR *)rtcp);
+                continue;
+            }
+
+            if ((RtcpType)rtcp->pt_ == RtcpType::RTCP_XR) {
+                OnRtcpXR(rtcp);
+                continue;
+            }
+
+            if (rtcp->GetSize() < (int32_t)sizeof(RtcpFB)) {
+                continue;
+            }
+            auto fb = (RtcpFB *)rtcp;
+            if ((RtcpType)rtcp->pt_ == RtcpType::RTCP_RTPFB && ntohl(fb->ssrcMedia_) == ssrc_) {
+                OnRtcpNack(fb->GetNackSeqs());
+            } else if (fb->IsKeyFrameRequest(ssrc_)) {
+                RequestKeyFrame();
+            }
+        }
     }
 }
 
@@ -368,9 +1136,7 @@ void WfdRtpProducer::OnRtcpTimeOut()
     } else {
         rtcpOvertimes_++;
     }
-    if (rtcpSendContext_ && tsRtcpUdpClient_) {
-        tsRtcpUdpClient_->SendDataBuffer(rtcpSendContext_->CreateRtcpSR(ssrc_));
-    }
+    SendSenderReport();
 }
 
 void WfdRtpProducer::StartDispatchThread()
@@ -384,20 +1150,10 @@ void WfdRtpProducer::DispatchMediaData()
 {
     SHARING_LOGI("%{public}s.", __FUNCTION__);
     uint32_t rtpCount = 0;
-    MediaData::Ptr mediaData = std::make_shared<MediaData>();
-    mediaData->buff = std::make_shared<DataBuffer>();
     while (dispatching_) {
-        int32_t ret = RequestRead(MEDIA_TYPE_AV, [&mediaData](const MediaData::Ptr &data) {
-            mediaData->buff->ReplaceData(data->buff->Peek(), data->buff->Size());
-            mediaData->keyFrame = data->keyFrame;
-            mediaData->mediaType = data->mediaType;
-            mediaData->pts = data->pts;
-            mediaData->isRaw = data->isRaw;
-            mediaData->codecId = data->codecId;
-            mediaData->format = data->format;
-            mediaData->ssrc = data->ssrc;
-        });
-        if (ret != 0) {
+        MediaData::Ptr mediaData = nullptr;
+        int32_t ret = RequestRead(MEDIA_TYPE_AV, [&mediaData](const MediaData::Ptr &data) { mediaData = data; });
+        if (ret != 0 || mediaData == nullptr || mediaData->buff == nullptr) {
             SHARING_LOGE("Request media data err :%{public}d.", ret);
             continue;
         }
@@ -408,7 +1164,6 @@ void WfdRtpProducer::DispatchMediaData()
             auto sps = GetSPS();
             if (sps != nullptr && sps->buff != nullptr) {
                 auto spsFrame = std::make_shared<MediaData>(*sps);
-                spsFrame->buff = std::make_shared<DataBuffer>(*(sps->buff));
                 spsFrame->pts = mediaData->pts;
                 PublishOneFrame(spsFrame);
             }
@@ -416,7 +1171,6 @@ void WfdRtpProducer::DispatchMediaData()
             auto pps = GetPPS();
             if (pps != nullptr && pps->buff != nullptr) {
                 auto ppsFrame = std::make_shared<MediaData>(*pps);
-                ppsFrame->buff = std::make_shared<DataBuffer>(*(pps->buff));
                 ppsFrame->pts = mediaData->pts;
                 PublishOneFrame(ppsFrame);
             }
@@ -443,8 +1197,21 @@ void WfdRtpProducer::HandleMediaInit(std::shared_ptr<WfdProducerEventMsg> msg)
     primarySinkIp_ = msg->ip;
     localPort_ = msg->localPort;
     localIp_ = msg->localIp;
+    group_ = msg->group;
+    groupPort_ = msg->groupPort > 0 ? msg->groupPort : msg->port;
+    groupTtl_ = msg->groupTtl;
+    groupLoop_ = msg->groupLoop;
+    rtpDirect_ = msg->rtpDirect;
+    videoPt_ = msg->videoPt;
+    audioPt_ = msg->audioPt;
+    audioSampleRate_ = msg->audioSampleRate;
+    audioChannels_ = msg->audioChannels;
     SHARING_LOGI("primarySinkIp:%s port:%d localIp:%s localPort:%d.", GetAnonyString(primarySinkIp_).c_str(),
                  primarySinkPort_, GetAnonyString(localIp_).c_str(), localPort_);
+    if (!group_.empty()) {
+        SHARING_LOGI("multicast group:%{public}s port:%{public}d ttl:%{public}u.", GetAnonyString(group_).c_str(),
+                     groupPort_, groupTtl_);
+    }
     SharingErrorCode errCode = ERR_OK;
     if (!ProducerInit()) {
         errCode = ERR_PROSUMER_INIT;
@@ -17,7 +17,10 @@
 #define OHOS_SHARING_WFD_RTP_PRODUCER_H
 
 #include <atomic>
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <vector>
 #include "buffer_dispatcher.h"
 #include "source/codec/include/source_codec_factory.h"
 #include "common/event_comm.h"
@@ -30,6 +33,11 @@
 #include "network/network_factory.h"
 #include "protocol/rtcp/include/rtcp_context.h"
 #include "protocol/rtp/include/rtp_def.h"
+#include "source/protocol/rtp/include/rtp_fanout.h"
+#include "source/protocol/rtp/include/rtp_fec_encoder.h"
+#include "source/protocol/rtp/include/rtp_pacer.h"
+#include "source/protocol/rtp/include/rtp_packet_history.h"
+#include "source/protocol/rtp/include/rtp_rate_controller.h"
 #include "source/protocol/rtp/include/rtp_source_factory.h"
 #include "source/protocol/rtp/include/rtp_pack.h"
 #include "source_media_def.h"
@@ -61,6 +69,9 @@ public:
         void SetUdpDataListener(std::weak_ptr<WfdRtpProducer> udpDataListener);
 
         bool SendDataBuffer(const DataBuffer::Ptr &buf);
+        bool SendDataBuffers(const std::vector<DataBuffer::Ptr> &bufs);
+        int32_t GetLocalFd();
+        bool SetMulticastOptions(uint8_t ttl, bool loop, const std::string &localIp);
         bool Connect(const std::string &peerIp, uint16_t peerPort, const std::string &localIp, uint16_t localPort);
 
     private:
@@ -85,12 +96,33 @@ public:
 private:
     bool ProducerInit();
     bool SendDataBuffer(const DataBuffer::Ptr &buf, bool audio = true);
+    void FlushRtpBatch();
 
     int32_t Stop();
     int32_t Connect();
     int32_t InitUdpClients();
+    void InitRtpPacer();
+    void InitRtpHistory();
+    void InitRtpFec();
+    void AdaptRtpFec();
+    void InitRateControl();
+    void OnRateReport(RtcpRR *rr);
+    void OnRtcpNack(const std::vector<uint16_t> &seqs);
+    void OnRtcpXR(RtcpHeader *rtcp);
+    void InitRtpFanout();
+    void AddFanoutSink(std::shared_ptr<WfdProducerEventMsg> msg);
+    void RemoveFanoutSink(std::shared_ptr<WfdProducerEventMsg> msg);
+    void StopFanout();
+    void OnFanoutRtcp(uint32_t id, DataBuffer::Ptr buf);
+    void SendFanoutRtcp(uint32_t id, const DataBuffer::Ptr &buf);
+    void InitKeyFrameRequest();
+    void RequestKeyFrame();
+    void SendSenderReport();
     int32_t InitTsRtpPacker(uint32_t ssrc, size_t mtuSize = 1400, uint32_t sampleRate = 90000, uint8_t pt = 33,
                             RtpPayloadStream ps = RtpPayloadStream::MPEG2_TS);
+    int32_t InitDirectRtpPackers();
+    void OnRtpPacked(const RtpPacket::Ptr &rtp);
+    void InputDirectVideo(const MediaData::Ptr &mediaData);
 
     void OnRtcpTimeOut();
     void DispatchMediaData();
@@ -108,13 +140,74 @@ private:
 
     std::string localIp_ = "127.0.0.1";
     std::string primarySinkIp_ = "127.0.0.1";
+    // the multicast group every sink of the room joins, empty for unicast
+    std::string group_;
+    uint16_t groupPort_ = 0;
+    uint8_t groupTtl_ = 1;
+    bool groupLoop_ = false;
 
     std::shared_ptr<UdpClient> tsUdpClient_ = nullptr;
     std::shared_ptr<UdpClient> tsRtcpUdpClient_ = nullptr;
     std::shared_ptr<std::thread> dispatchThread_ = nullptr;
+    // shared by the dispatch thread and the rtcp receive thread
+    std::mutex rtcpMutex_;
     std::shared_ptr<RtcpSenderContext> rtcpSendContext_ = nullptr;
 
     RtpPack::Ptr tsPacker_ = nullptr;
+    // h264 and aac in rtp streams of their own instead of tsPacker_, negotiated in m3/m4
+    bool rtpDirect_ = false;
+    uint8_t videoPt_ = 96;
+    uint8_t audioPt_ = 97;
+    uint32_t audioSampleRate_ = 48000;
+    uint32_t audioChannels_ = 2;
+    RtpPack::Ptr videoPacker_ = nullptr;
+    RtpPack::Ptr audioPacker_ = nullptr;
+    // rtp packets of the frame being packed, sent together once it is done
+    std::vector<DataBuffer::Ptr> rtpBatch_;
+    // smooths key frame bursts, nullptr when disabled in the config
+    RtpPacer::Ptr rtpPacer_ = nullptr;
+    uint32_t frameIntervalMs_ = 33; // 33: 30 fps
+    // sent packets kept for retransmission on nack, nullptr when disabled in the config
+    RtpPacketHistory::Ptr rtpHistory_ = nullptr;
+    static constexpr uint32_t RETRANSMIT_MIN_INTERVAL_MS = 20;
+    // xor parity after every group of packets, nullptr when disabled in the config
+    RtpFecEncoder::Ptr rtpFec_ = nullptr;
+    bool fecAdaptive_ = false;
+    // loss seen through nacks over the last FEC_ADAPT_FRAMES frames
+    static constexpr uint32_t FEC_ADAPT_FRAMES = 30;
+    std::atomic<uint64_t> fecNacked_ = 0;
+    uint32_t fecFrames_ = 0;
+    // the protected media packets, the ones a nack can be about; audio and parity are not counted
+    uint64_t fecPackets_ = 0;
+    // more sinks fed from the same encoder, each with its own ssrc and rtcp client, nullptr when disabled
+    struct FanoutSink {
+        uint32_t id = 0;
+        std::string ip;
+        uint16_t port = 0;
+        int32_t rtcpFd = -1;
+        std::shared_ptr<UdpClient> rtcpClient = nullptr;
+    };
+    RtpFanout::Ptr rtpFanout_ = nullptr;
+    std::mutex fanoutMutex_;
+    std::vector<FanoutSink> fanoutSinks_;
+    uint32_t fanoutNextId_ = 1;
+    int32_t fanoutFd_ = -1;
+    // encoder bitrate and frame rate follow the receiver reports, nullptr when disabled in the config
+    RtpRateController::Ptr rateController_ = nullptr;
+    // idr frames forced by pli/fir or rtsp idr requests, at most one per round trip plus a frame
+    bool keyFrameRequestEnabled_ = false;
+    int32_t keyFrameMinIntervalMs_ = 200;
+    std::mutex keyFrameMutex_;
+    std::chrono::steady_clock::time_point keyFrameForced_;
+    uint64_t keyFrameRequests_ = 0;
+    uint64_t keyFramesForced_ = 0;
+
+    // per frame send latency, reported every SEND_STATS_FRAMES frames
+    static constexpr uint32_t SEND_STATS_FRAMES = 300;
+    uint32_t statsFrames_ = 0;
+    uint64_t statsPackets_ = 0;
+    int64_t statsLatencyUs_ = 0;
+    int64_t statsMaxLatencyUs_ = 0;
 };
 } // namespace Sharing
 } // namespace OHOS
@@ -14,11 +14,15 @@
  */
 
 #include "wfd_source_session.h"
+#include <algorithm>
 #include <iomanip>
+#include "common/common.h"
 #include "common/common_macro.h"
 #include "common/reflect_registration.h"
 #include "common/sharing_log.h"
+#include "configuration/include/config.h"
 #include "mediachannel/media_channel_def.h"
+#include "network/socket/socket_utils.h"
 #include "screen_capture_def.h"
 #include "utils/utils.h"
 #include "source_media_def.h"
@@ -221,6 +225,19 @@ void WfdSourceSession::NotifyProsumerInit(SessionStatusMsg::Ptr &statusMsg)
     eventMsg->ip = sinkIp_;
     eventMsg->localPort = sourceRtpPort_;
     eventMsg->localIp = sourceIp_;
+    eventMsg->group = multicastGroup_;
+    eventMsg->groupPort = multicastPort_ > 0 ? multicastPort_ : sinkRtpPort_;
+    eventMsg->groupTtl = multicastTtl_;
+    eventMsg->groupLoop = multicastLoop_;
+    if (rtpDirect_) {
+        AudioTrack audioTrack;
+        Common::SetAudioTrack(audioTrack, audioFormat_);
+        eventMsg->rtpDirect = true;
+        eventMsg->videoPt = rtpDirectVideoPt_;
+        eventMsg->audioPt = rtpDirectAudioPt_;
+        eventMsg->audioSampleRate = audioTrack.sampleRate > 0 ? audioTrack.sampleRate : eventMsg->audioSampleRate;
+        eventMsg->audioChannels = audioTrack.channels > 0 ? audioTrack.channels : eventMsg->audioChannels;
+    }
     SHARING_LOGD("sinkRtpPort %{public}d, sinkIp %{public}s sourceRtpPort %{public}d.", sinkRtpPort_,
                  GetAnonyString(sinkIp_).c_str(), sourceRtpPort_);
     statusMsg->msg = std::move(eventMsg);
@@ -310,6 +327,84 @@ void WfdSourceSession::HandleSessionInit(SharingEvent &event)
     } else {
         SHARING_LOGE("unknow event msg.");
     }
+
+    LoadMulticastConfig();
+    LoadRtpDirectConfig();
+}
+
+void WfdSourceSession::LoadMulticastConfig()
+{
+    int32_t enable = 0;
+    int32_t port = 0;
+    int32_t ttl = 1;
+    int32_t loop = 0;
+    std::string group;
+    SharingValue::Ptr values = nullptr;
+    std::pair<const char *, int32_t *> keys[] = {
+        {"enable", &enable},
+        {"port", &port},
+        {"ttl", &ttl},
+        {"loop", &loop},
+    };
+    for (auto &key : keys) {
+        auto ret = Config::GetInstance().GetConfig("mediachannel", "multicast", key.first, values);
+        if (ret == CONFIGURE_ERROR_NONE) {
+            values->GetValue<int32_t>(*key.second);
+        }
+    }
+    auto ret = Config::GetInstance().GetConfig("mediachannel", "multicast", "group", values);
+    if (ret == CONFIGURE_ERROR_NONE) {
+        values->GetValue<std::string>(group);
+    }
+
+    multicastGroup_.clear();
+    if (enable == 0) {
+        return;
+    }
+    if (!SocketUtils::IsMulticastIp(group)) {
+        SHARING_LOGE("invalid multicast group: %{public}s, stay unicast.", GetAnonyString(group).c_str());
+        return;
+    }
+    multicastGroup_ = group;
+    // 0: the rtp port of the first sink, the others have to bind the same one
+    multicastPort_ = static_cast<uint16_t>(std::clamp(port, 0, 65534)); // 65534: leaves port + 1 for rtcp
+    multicastTtl_ = static_cast<uint8_t>(std::clamp(ttl, 1, 255));      // 255: ip ttl range
+    multicastLoop_ = loop != 0;
+    SHARING_LOGI("multicast group: %{public}s, port: %{public}u, ttl: %{public}u.",
+                 GetAnonyString(multicastGroup_).c_str(), multicastPort_, multicastTtl_);
+}
+
+void WfdSourceSession::LoadRtpDirectConfig()
+{
+    int32_t enable = 0;
+    int32_t videoPt = rtpDirectVideoPt_;
+    int32_t audioPt = rtpDirectAudioPt_;
+    SharingValue::Ptr values = nullptr;
+    std::pair<const char *, int32_t *> keys[] = {
+        {"enable", &enable},
+        {"videoPt", &videoPt},
+        {"audioPt", &audioPt},
+    };
+    for (auto &key : keys) {
+        auto ret = Config::GetInstance().GetConfig("mediachannel", "rtpDirect", key.first, values);
+        if (ret == CONFIGURE_ERROR_NONE) {
+            values->GetValue<int32_t>(*key.second);
+        }
+    }
+
+    rtpDirectEnabled_ = false;
+    rtpDirect_ = false;
+    if (enable == 0) {
+        return;
+    }
+    // 96, 127: dynamic payload types
+    if (videoPt < 96 || videoPt > 127 || audioPt < 96 || audioPt > 127 || videoPt == audioPt) {
+        SHARING_LOGE("invalid rtp direct payload types: %{public}d, %{public}d, stay with ts.", videoPt, audioPt);
+        return;
+    }
+    rtpDirectEnabled_ = true;
+    rtpDirectVideoPt_ = static_cast<uint8_t>(videoPt);
+    rtpDirectAudioPt_ = static_cast<uint8_t>(audioPt);
 }
 
 void WfdSourceSession::HandleProsumerInitState(SharingEvent &event)
@@ -456,6 +551,14 @@ bool WfdSourceSession::HandleIDRRequest(const RtspRequest &request, int32_t cseq
         for (auto &param : params) {
             if (param == WFD_PARAM_IDR_REQUEST) {
                 SHARING_LOGD("receive idr request.");
+                // the producer forces the idr frame, throttled together with rtcp key frame requests
+                auto statusMsg = std::make_shared<SessionStatusMsg>();
+                auto eventMsg = std::make_shared<WfdProducerEventMsg>();
+                eventMsg->type = EventType::EVENT_WFD_REQUEST_IDR;
+                eventMsg->toMgr = ModuleType::MODULE_MEDIACHANNEL;
+                statusMsg->msg = std::move(eventMsg);
+                statusMsg->status = NOTIFY_SESSION_PRIVATE_EVENT;
+                NotifyAgentSessionStatus(statusMsg);
                 return SendCommonResponse(cseq, session);
             }
         }
@@ -625,6 +728,10 @@ bool WfdSourceSession::HandleM3Response(const RtspResponse &response, const std:
         wfdVideoFormatsInfo_ = m3Res.GetWfdVideoFormatsInfo();
         SHARING_LOGD("sinkRtpPort:%{public}d, audioFormat:%{public}d, audioCodec:%{public}d, videoFormat:%{public}d.",
                      sinkRtpPort_, wfdAudioCodec_.format, wfdAudioCodec_.codecId, videoFormat_);
+        // the aac stream has no lpcm counterpart, lpcm sessions stay with ts
+        rtpDirect_ = rtpDirectEnabled_ && wfdAudioCodec_.codecId != CODEC_PCM &&
+                     m3Res.GetCustomParam(WFD_PARAM_RTP_DIRECT) == WFD_RTP_DIRECT_CAPABILITY;
+        SHARING_LOGI("rtp direct: %{public}d.", rtpDirect_);
         std::string value = m3Res.GetContentProtection();
         if (value == "" || value == "none") {
             SHARING_LOGE("WFD sink doesn't support hdcp.");
@@ -785,6 +892,9 @@ bool WfdSourceSession::SendM3Request(INetworkSession::Ptr &session)
         return false;
     }
     WfdRtspM3Request m3Request(++cseq_, WFD_RTSP_URL_DEFAULT);
+    if (rtpDirectEnabled_) {
+        m3Request.AddBodyItem(WFD_PARAM_RTP_DIRECT);
+    }
     std::string m3Req(m3Request.Stringify());
     SHARING_LOGD("%{public}s.", m3Req.c_str());
 
@@ -811,6 +921,9 @@ bool WfdSourceSession::SendM4Request(INetworkSession::Ptr &session)
     m4Request.SetVideoFormats(wfdVideoFormatsInfo_, videoFormat_);
     m4Request.SetAudioCodecs(wfdAudioCodec_);
     m4Request.SetClientRtpPorts(sinkRtpPort_);
+    if (rtpDirect_) {
+        m4Request.SetRtpDirect(rtpDirectVideoPt_, rtpDirectAudioPt_);
+    }
     std::string m4Req(m4Request.Stringify());
     SHARING_LOGD("%{public}s.", m4Req.c_str());
 
@@ -856,6 +969,9 @@ bool WfdSourceSession::SendM6Response(INetworkSession::Ptr &session, int32_t cse
     WfdRtspM6Response m6Response(cseq, RTSP_STATUS_OK, sessionID_, rtspTimeout_);
     m6Response.SetClientPort(sinkRtpPort_);
     m6Response.SetServerPort(sourceRtpPort_);
+    if (!multicastGroup_.empty()) {
+        m6Response.SetMulticast(multicastGroup_, multicastPort_ > 0 ? multicastPort_ : sinkRtpPort_, multicastTtl_);
+    }
     std::string m6Res(m6Response.StringifyEx());
     SHARING_LOGD("%{public}s.", m6Res.c_str());
 
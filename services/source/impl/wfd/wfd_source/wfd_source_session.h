@@ -76,6 +76,8 @@ private:
     };
 
     void HandleSessionInit(SharingEvent &event);
+    void LoadMulticastConfig();
+    void LoadRtpDirectConfig();
     void HandleProsumerInitState(SharingEvent &event);
 
     bool StopWfdSession();
@@ -136,6 +138,16 @@ private:
     std::string sourceMac_;
     std::string sessionID_;
     std::string lastMessage_;
+    // conference room mode, every sink gets the stream from this group, empty for unicast
+    std::string multicastGroup_;
+    uint16_t multicastPort_ = 0;
+    uint8_t multicastTtl_ = 1;
+    bool multicastLoop_ = false;
+    // h264 and aac in rtp streams of their own, offered in m3 when enabled and used when the sink agrees
+    bool rtpDirectEnabled_ = false;
+    bool rtpDirect_ = false;
+    uint8_t rtpDirectVideoPt_ = 96;
+    uint8_t rtpDirectAudioPt_ = 97;
 
     WfdAudioCodec wfdAudioCodec_ = {CODEC_DEFAULT, AUDIO_48000_16_2};
     WfdVideoFormatsInfo wfdVideoFormatsInfo_;
@@ -29,6 +29,8 @@ public:
 
     virtual void SetOnRtpPack(const OnRtpPack &cb) = 0;
     virtual void InputFrame(const Frame::Ptr &frame) = 0;
+    // packs what waits for the next frame, e.g. the last nalu of an access unit that needs the marker bit
+    virtual void Flush() {}
 
 protected:
     RtpEncoder() = default;
@@ -17,18 +17,20 @@
 #define OHOS_SHARING_RTP_ENCODER_TS_H
 
 #include <memory>
-#include <queue>
-#include <thread>
+#include <mutex>
+#include <vector>
 #include "frame/frame.h"
-#include "frame/frame_merger.h"
 #include "rtp_encoder.h"
 #include "rtp_maker.h"
-extern "C" {
-#include <libavformat/avformat.h>
-}
+#include "ts_def.h"
 
 namespace OHOS {
 namespace Sharing {
+/**
+ * MPEG-TS over RTP (RFC 2250) muxer. PAT/PMT/PCR/PES are written straight into
+ * the payload of preallocated RTP packets, 7 TS packets per RTP, on the caller's
+ * thread. Each frame is flushed right away so no RTP waits for the next frame.
+ */
 class RtpEncoderTs : public RtpEncoder,
                      public RtpMaker {
 public:
@@ -43,30 +45,65 @@ public:
     void SetOnRtpPack(const OnRtpPack &cb) override;
 
 private:
-    void StartEncoding();
-    void RemoveFrameAfterMuxing();
-    Frame::Ptr ReadFrame(AVPacket *packet);
-    void SaveFrame(Frame::Ptr frame);
-    static int WritePacket(void *opaque, const uint8_t *buf, int buf_size);
+    struct TsStream {
+        uint16_t pid = TS_PID_NULL;
+        uint8_t streamType = 0;
+        uint8_t streamId = 0;
+        uint8_t counter = 0;
+    };
+
+    struct TsChunk {
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+    };
+
+    void InputVideoFrame(const Frame::Ptr &frame);
+    void InputAudioFrame(const Frame::Ptr &frame);
+
+    void BuildTables();
+    void WriteTables();
+    void WritePcr(uint64_t pcr);
+    void WritePes(TsStream &stream, uint64_t pts, uint64_t dts, bool randomAccess, const std::vector<TsChunk> &chunks);
+    void WritePayload(TsStream &stream, bool unitStart, bool randomAccess, const TsChunk &head,
+                      const std::vector<TsChunk> &chunks);
+    void WriteSection(uint16_t pid, uint8_t &counter, const std::vector<uint8_t> &section);
+    void BeginFrame(uint32_t dts, bool keyFrame);
+
+    uint8_t *NextTsPacket();
+    void FlushRtp();
 
 private:
     bool exit_ = false;
-    uint8_t *avioCtxBuffer_ = nullptr;
-
     bool keyFrame_ = false;
+    bool tablesSent_ = false;
+    bool pcrSent_ = false;
+    bool videoPesOpen_ = false;
+
+    uint8_t patCounter_ = 0;
+    uint8_t pmtCounter_ = 0;
+    uint8_t pcrCounter_ = 0;
+    uint8_t pmtVersion_ = 0;
+
     uint32_t timeStamp_ = 0;
-    FrameMerger merger_;
-
-    std::mutex queueMutex_;
-    std::mutex cbLockMutex_;
-    std::queue<Frame::Ptr> dataQueue_;
-    std::unique_ptr<std::thread> encodeThread_;
-
-    AVCodecID audioCodeId_ = AV_CODEC_ID_NONE;
-    AVStream *videoStream = nullptr;
-    AVStream *audioStream = nullptr;
-    AVIOContext *avioContext_ = nullptr;
-    AVFormatContext *avFormatContext_ = nullptr;
+    uint32_t pcrClock_ = 0;
+    uint32_t lastPcr_ = 0;
+    uint32_t lastTables_ = 0;
+
+    size_t tsPerRtp_ = TS_PACKETS_PER_RTP;
+    size_t tsInRtp_ = 0;
+    RtpPacket::Ptr rtp_ = nullptr;
+
+    TsStream video_;
+    TsStream audio_;
+    CodecId audioCodecId_ = CODEC_NONE;
+
+    std::mutex muxMutex_;
+    std::vector<uint8_t> pat_;
+    std::vector<uint8_t> pmt_;
+    // sps/pps/sei waiting for the picture they belong to
+    std::vector<Frame::Ptr> pendingNalus_;
+    // packets finished by the current frame, handed to onRtpPack_ once muxMutex_ is released
+    std::vector<RtpPacket::Ptr> finishedRtps_;
 };
 } // namespace Sharing
 } // namespace OHOS
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_RTP_FANOUT_H
+#define OHOS_SHARING_RTP_FANOUT_H
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <string>
+#include <vector>
+#include "protocol/rtcp/include/rtcp_context.h"
+#include "utils/data_buffer.h"
+
+namespace OHOS {
+namespace Sharing {
+/**
+ * Sends the rtp stream of one encoder to several sinks. Each sink sees a
+ * stream of its own: the ssrc is replaced and the sequence numbers continue
+ * from a random base, so its reports and nacks are told apart by ssrc and
+ * kept in an rtcp context per sink. Only the 12 byte header is rewritten, the
+ * payload is shared by all sinks.
+ *
+ * The packets of all sinks leave through one sendmmsg on an unconnected
+ * socket, interleaved so every sink gets its share when the socket buffer
+ * fills up. What does not fit waits in the sink's own queue; a sink that
+ * falls maxQueuePackets behind loses its oldest packets instead of holding
+ * back the others.
+ */
+class RtpFanout {
+public:
+    using Ptr = std::shared_ptr<RtpFanout>;
+
+    struct Config {
+        uint32_t maxSinks = 4;
+        uint32_t maxQueuePackets = 1024; // about a 1080p idr frame
+        // only this one is forwarded, fec parity covers the source headers and cannot be rewritten; -1: all
+        int32_t payloadType = -1;
+    };
+
+    struct SinkStats {
+        uint32_t ssrc = 0;
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+        uint64_t dropped = 0; // queue overflow or a send error of this sink only
+        uint32_t queued = 0;
+        uint32_t rtt = 0;
+    };
+
+    explicit RtpFanout(const Config &config);
+
+    // fd: unconnected and non-blocking, stays owned by the caller
+    void SetSocket(int32_t fd);
+    bool AddSink(uint32_t id, const std::string &ip, uint16_t port, uint32_t ssrc);
+    void RemoveSink(uint32_t id);
+    size_t GetSinkCount();
+
+    // packets of the source stream for every sink, also retries what was left queued
+    void Send(const std::vector<DataBuffer::Ptr> &packets);
+    // source packets for one sink only, e.g. answers to its nacks
+    void SendTo(uint32_t id, const std::vector<DataBuffer::Ptr> &packets);
+
+    // seqs of a sink's nack in the numbering of the source stream
+    std::vector<uint16_t> ToSourceSeqs(uint32_t id, const std::vector<uint16_t> &seqs);
+    // the sink's ssrc, 0 when unknown
+    uint32_t GetSsrc(uint32_t id);
+    void OnRtcp(uint32_t id, RtcpHeader *rtcp);
+    DataBuffer::Ptr CreateSenderReport(uint32_t id);
+    DataBuffer::Ptr CreateDlrr(uint32_t id, uint32_t receiverSsrc);
+
+    SinkStats GetStats(uint32_t id);
+
+private:
+    static constexpr size_t RTP_HEADER_SIZE = 12;
+    static constexpr size_t MAX_BATCH_MESSAGES = 64;
+
+    struct Pending {
+        DataBuffer::Ptr packet = nullptr;
+        uint8_t header[RTP_HEADER_SIZE] = {0};
+    };
+
+    struct Sink {
+        sockaddr_in addr = {};
+        uint32_t ssrc = 0;
+        uint16_t seqBase = 0;
+        // sink seq - source seq, set by the first packet
+        uint16_t seqOffset = 0;
+        bool synced = false;
+        std::deque<Pending> queue;
+        std::shared_ptr<RtcpSenderContext> rtcp = nullptr;
+        SinkStats stats;
+    };
+
+    void Enqueue(Sink &sink, const DataBuffer::Ptr &packet);
+    void Flush();
+    void OnSent(Sink &sink, const Pending &pending, uint64_t nowMs);
+
+private:
+    Config config_;
+    int32_t fd_ = -1;
+    std::mutex mutex_;
+    std::map<uint32_t, Sink> sinks_;
+};
+} // namespace Sharing
+} // namespace OHOS
+#endif
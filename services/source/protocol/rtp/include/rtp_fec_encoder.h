@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_RTP_FEC_ENCODER_H
+#define OHOS_SHARING_RTP_FEC_ENCODER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "rtp_fec.h"
+#include "rtp_packet.h"
+
+namespace OHOS {
+namespace Sharing {
+/**
+ * Builds one xor parity packet per group of consecutive media packets. The
+ * parity is accumulated as the packets go by, none of them is kept. The group
+ * size sets the protection ratio, from minGroupPackets (most parity) to
+ * maxGroupPackets, and follows the measured loss if told about it.
+ * Packets are added from the sending thread, loss may come from any thread.
+ */
+class RtpFecEncoder {
+public:
+    using Ptr = std::shared_ptr<RtpFecEncoder>;
+
+    struct Stats {
+        uint64_t media = 0;
+        uint64_t parity = 0;
+        uint32_t groupPackets = 0;
+    };
+
+    RtpFecEncoder(uint8_t pt, uint32_t minGroupPackets, uint32_t maxGroupPackets);
+
+    // returns the parity packet when rtp completes a group, nullptr otherwise
+    RtpPacket::Ptr AddPacket(const RtpPacket::Ptr &rtp);
+    // closes the open group early, e.g. at the end of a video frame
+    RtpPacket::Ptr Flush();
+    // lossRate: fraction of media packets lost, 0 to 1
+    void OnLossRate(double lossRate);
+
+    Stats GetStats() const;
+
+private:
+    void Reset();
+    RtpPacket::Ptr MakeParity();
+
+private:
+    static constexpr double LOSSES_PER_GROUP = 0.5; // expected losses a group is sized for
+
+    uint8_t pt_ = 0;
+    uint32_t minGroupPackets_ = 2;
+    uint32_t maxGroupPackets_ = RTP_FEC_MAX_GROUP;
+    std::atomic<uint32_t> groupPackets_{RTP_FEC_MAX_GROUP};
+
+    // the open group, sending thread only
+    uint32_t count_ = 0;
+    uint32_t target_ = 0;
+    uint16_t snBase_ = 0;
+    uint16_t parityLength_ = 0;
+    uint8_t recovery0_ = 0;
+    uint8_t recovery1_ = 0;
+    uint32_t tsRecovery_ = 0;
+    uint16_t lengthRecovery_ = 0;
+    uint32_t lastStamp_ = 0; // network order
+    uint32_t ssrc_ = 0;      // network order
+    uint16_t seq_ = 0;
+    std::vector<uint8_t> parity_;
+
+    std::atomic<uint64_t> media_{0};
+    std::atomic<uint64_t> parityPackets_{0};
+};
+} // namespace Sharing
+} // namespace OHOS
+#endif
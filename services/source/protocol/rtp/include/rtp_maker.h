@@ -32,6 +32,9 @@ public:
     uint32_t GetSsrc() const;
     size_t GetMaxSize() const;
     RtpPacket::Ptr MakeRtp(const void *data, size_t len, bool mark, uint32_t stamp);
+    // the payload of an allocated packet is filled in place, then FinishRtp() writes the header
+    RtpPacket::Ptr AllocRtp(size_t capacity);
+    bool FinishRtp(const RtpPacket::Ptr &rtp, size_t len, bool mark, uint32_t stamp);
 
 private:
     uint8_t pt_ = 0;
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_RTP_PACER_H
+#define OHOS_SHARING_RTP_PACER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "utils/data_buffer.h"
+
+namespace OHOS {
+namespace Sharing {
+/**
+ * Token-bucket pacer between the rtp packer and the socket. The packets of a
+ * frame are released in bursts of at most burstPackets, at the configured
+ * bitrate plus headroom, but never slower than needed to get the frame out
+ * within spreadPercent of the frame interval. When frames pile up the backlog
+ * is sent unpaced so latency does not grow.
+ */
+class RtpPacer {
+public:
+    using Ptr = std::shared_ptr<RtpPacer>;
+    using OnSend = std::function<void(const std::vector<DataBuffer::Ptr> &)>;
+    using Clock = std::chrono::steady_clock;
+
+    struct Config {
+        uint32_t bitrate = 0;        // bit/s, 0: only the frame spread bounds the rate
+        uint32_t headroomPercent = 150;
+        uint32_t spreadPercent = 50; // of the frame interval
+        uint32_t burstPackets = 8;
+        uint32_t maxQueueFrames = 4;
+    };
+
+    struct Stats {
+        uint32_t queueDepth = 0;
+        uint32_t maxQueueDepth = 0;
+        uint64_t frames = 0;
+        uint64_t unpacedFrames = 0;
+        int64_t totalDelayUs = 0; // enqueue to last packet sent
+        int64_t maxDelayUs = 0;
+    };
+
+    explicit RtpPacer(const Config &config);
+    ~RtpPacer();
+
+    void SetOnSend(const OnSend &cb);
+    // follows the encoder when the congestion control retunes it
+    void SetBitrate(uint32_t bitrate);
+    bool Start();
+    void Stop();
+
+    // packets of one frame, intervalMs: expected time until the next frame
+    void InputFrame(std::vector<DataBuffer::Ptr> &&packets, uint32_t intervalMs);
+
+    // returns the counters and resets the per period ones
+    Stats TakeStats();
+
+private:
+    struct PacedFrame {
+        std::vector<DataBuffer::Ptr> packets;
+        uint32_t intervalMs = 0;
+        Clock::time_point enqueued;
+    };
+
+    void PaceLoop();
+    void SendFrame(PacedFrame &frame, bool paced);
+    bool WaitTokens(double bytes, double rate, double capacity);
+
+private:
+    Config config_;
+    std::atomic<uint32_t> bitrate_{0};
+    OnSend onSend_ = nullptr;
+
+    bool running_ = false;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<PacedFrame> queue_;
+    std::thread thread_;
+
+    // bucket state, pacing thread only
+    double tokens_ = 0;
+    Clock::time_point refilled_;
+
+    Stats stats_;
+};
+} // namespace Sharing
+} // namespace OHOS
+#endif
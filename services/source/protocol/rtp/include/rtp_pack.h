@@ -33,6 +33,11 @@ public:
      */
     virtual void InputFrame(const Frame::Ptr &frame) = 0;
 
+    /**
+     * @brief Pack the frames held back to find the end of an access unit, call when the unit is complete
+     */
+    virtual void Flush() {}
+
     /**
      * @brief SetOnRtpPack
      * @param cb pack a rtp packget callback
@@ -32,6 +32,7 @@ public:
 
     void SetOnRtpPack(const OnRtpPack &cb) override;
     void InputFrame(const Frame::Ptr &frame) override;
+    void Flush() override;
 
 private:
     void InitEncoder();
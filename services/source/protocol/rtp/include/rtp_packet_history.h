@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef OHOS_SHARING_RTP_PACKET_HISTORY_H
+#define OHOS_SHARING_RTP_PACKET_HISTORY_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "rtp_packet.h"
+
+namespace OHOS {
+namespace Sharing {
+/**
+ * Recently sent rtp packets, indexed by sequence number, for answering nacks.
+ * A fixed ring of slots: a packet stays available until capacity newer ones
+ * have been sent. Inserted from the sending thread, looked up from the rtcp one.
+ */
+class RtpPacketHistory {
+public:
+    using Ptr = std::shared_ptr<RtpPacketHistory>;
+
+    struct Stats {
+        uint64_t requested = 0;     // seqs asked for by nacks
+        uint64_t retransmitted = 0; // packets handed out again
+        uint64_t missing = 0;       // too old or never sent
+        uint64_t throttled = 0;     // resent too recently, the first resend may still be in flight
+    };
+
+    // capacity is rounded up to a power of two
+    explicit RtpPacketHistory(size_t capacity = 1024);
+
+    void Clear();
+    void Insert(const RtpPacket::Ptr &rtp);
+    // packets to send again for seqs, at most once per minIntervalMs each
+    std::vector<DataBuffer::Ptr> Lookup(const std::vector<uint16_t> &seqs, uint32_t minIntervalMs);
+
+    Stats GetStats();
+
+private:
+    struct Slot {
+        RtpPacket::Ptr rtp = nullptr;
+        uint16_t seq = 0;
+        int64_t resentMs = 0;
+    };
+
+    size_t mask_ = 0;
+    std::mutex mutex_;
+    std::vector<Slot> slots_;
+    Stats stats_;
+};
+} // namespace Sharing
+} // namespace OHOS
+#endif
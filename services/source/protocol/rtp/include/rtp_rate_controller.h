@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_RTP_RATE_CONTROLLER_H
+#define OHOS_SHARING_RTP_RATE_CONTROLLER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace OHOS {
+namespace Sharing {
+/**
+ * Sender side congestion control in the spirit of GCC, fed by the receiver
+ * reports of the sink. Two estimates are kept and the target is the lower one:
+ *
+ * - delay based: the queueing delay is the rtt above its minimum over the last
+ *   seconds. Rising above max(delayThresholdMs, 2 * jitter) is overuse and cuts
+ *   the rate to 85% of what was actually sent, a draining queue holds it, and
+ *   a normal link raises it by 8% per second, or by one packet per round trip
+ *   once close to the rate of the last overuse.
+ * - loss based: above 10% loss the rate drops by half the loss, below 2% it
+ *   grows by 8% per second.
+ *
+ * Below lowBitrate the frame rate is lowered towards minFrameRate, so fewer
+ * frames keep an acceptable quality each.
+ */
+class RtpRateController {
+public:
+    using Ptr = std::shared_ptr<RtpRateController>;
+
+    enum class Usage { NORMAL, UNDERUSE, OVERUSE };
+    enum class RateState { HOLD, INCREASE, DECREASE };
+
+    struct Config {
+        uint32_t startBitrate = 2000000; // bit/s
+        uint32_t minBitrate = 500000;
+        uint32_t maxBitrate = 8000000;
+        uint32_t lowBitrate = 1000000; // the frame rate goes down below it
+        uint32_t maxFrameRate = 30;
+        uint32_t minFrameRate = 15;
+        uint32_t delayThresholdMs = 25; // queueing delay taken as overuse
+    };
+
+    struct Report {
+        double lossRate = 0; // fraction lost since the previous report, 0 to 1
+        uint32_t rttMs = 0;
+        uint32_t jitterMs = 0;
+    };
+
+    struct Stats {
+        uint32_t targetBitrate = 0;
+        uint32_t frameRate = 0;
+        uint32_t delayBitrate = 0;
+        uint32_t lossBitrate = 0;
+        uint32_t sendBitrate = 0;
+        uint32_t queueDelayMs = 0;
+        uint32_t thresholdMs = 0;
+        Usage usage = Usage::NORMAL;
+        RateState state = RateState::HOLD;
+        uint64_t reports = 0;
+        uint64_t decreases = 0;
+    };
+
+    explicit RtpRateController(const Config &config);
+
+    // media bytes handed to the network, from the sending thread
+    void OnSent(size_t bytes);
+    // returns true when the target moved enough to be worth retuning the encoder
+    bool OnReport(const Report &report, int64_t nowMs);
+
+    uint32_t GetTargetBitrate() const;
+    uint32_t GetFrameRate() const;
+    Stats GetStats() const;
+
+private:
+    Usage DetectUsage(const Report &report, int64_t nowMs);
+    void UpdateDelayBitrate(Usage usage, uint32_t rttMs, int64_t elapsedMs, uint32_t sendBitrate);
+    void UpdateLossBitrate(double lossRate, int64_t elapsedMs);
+    uint32_t FrameRateFor(uint32_t bitrate) const;
+
+private:
+    static constexpr int64_t BASE_RTT_WINDOW_MS = 10000;
+    static constexpr uint32_t RETUNE_PERCENT = 5;
+
+    Config config_;
+    std::atomic<uint64_t> sentBytes_{0};
+
+    mutable std::mutex mutex_;
+    int64_t lastReportMs_ = -1;
+    std::deque<std::pair<int64_t, uint32_t>> rttSamples_; // report time, rtt
+    double queueDelayMs_ = -1;
+    double delayBitrate_ = 0;
+    double lossBitrate_ = 0;
+    double congestedBitrate_ = 0; // send rate at the last overuse
+    RateState state_ = RateState::HOLD;
+    // what the encoder was last told
+    uint32_t appliedBitrate_ = 0;
+    uint32_t appliedFrameRate_ = 0;
+    Stats stats_;
+};
+} // namespace Sharing
+} // namespace OHOS
+#endif
@@ -66,6 +66,15 @@ void RtpEncoderH264::InputFrame(const Frame::Ptr &frame)
     lastFrame_ = frame;
 }
 
+void RtpEncoderH264::Flush()
+{
+    // the caller knows the access unit is complete, its last nalu needs no successor for the marker
+    if (lastFrame_) {
+        InputFrame(lastFrame_, true);
+        lastFrame_ = nullptr;
+    }
+}
+
 void RtpEncoderH264::SetOnRtpPack(const OnRtpPack &cb)
 {
     onRtpPack_ = cb;
@@ -124,16 +133,18 @@ void RtpEncoderH264::PackRtpFu(const uint8_t *data, size_t len, uint32_t pts, bo
             fuFlags->endBit_ = 1;
         }
 
-        auto rtp = MakeRtp(nullptr, packetSize + 2, fuFlags->endBit_ && isMark, pts); // 2:fixed size
+        // the payload is written in place, MakeRtp needs it in one piece
+        auto rtp = AllocRtp(packetSize + 2); // 2:fixed size
+        RETURN_IF_NULL(rtp);
 
-        uint8_t *payload = rtp->GetPayload();
+        uint8_t *payload = rtp->Data() + RtpPacket::RTP_HEADER_SIZE;
 
         payload[0] = fuChar0;
 
         payload[1] = fuChar1;
 
         auto ret = memcpy_s(payload + 2, packetSize, (uint8_t *)data + offset, packetSize); // 2:fixed size
-        if (ret != EOK) {
+        if (ret != EOK || !FinishRtp(rtp, packetSize + 2, fuFlags->endBit_ && isMark, pts)) { // 2:fixed size
             return;
         }
 
@@ -146,14 +157,15 @@ void RtpEncoderH264::PackRtpFu(const uint8_t *data, size_t len, uint32_t pts, bo
 void RtpEncoderH264::PackRtpStapA(const uint8_t *data, size_t len, uint32_t pts, bool isMark, bool gopPos)
 {
     RETURN_IF_NULL(data);
-    auto rtp = MakeRtp(nullptr, len + 3, isMark, pts); // 3:fixed size
-    uint8_t *payload = rtp->GetPayload();
+    auto rtp = AllocRtp(len + 3); // 3:fixed size
+    RETURN_IF_NULL(rtp);
+    uint8_t *payload = rtp->Data() + RtpPacket::RTP_HEADER_SIZE;
     // STAP-A
     payload[0] = (data[0] & (~0x1F)) | 24;                       // 24:fixed size
     payload[1] = (len >> 8) & 0xFF;                              // 8:byte offset
     payload[2] = len & 0xff;                                     // 2:byte offset
     auto ret = memcpy_s(payload + 3, len, (uint8_t *)data, len); // 3:fixed size
-    if (ret != EOK) {
+    if (ret != EOK || !FinishRtp(rtp, len + 3, isMark, pts)) {    // 3:fixed size
         return;
     }
 
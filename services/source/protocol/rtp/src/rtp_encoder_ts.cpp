@@ -14,19 +14,103 @@
  */
 
 #include "rtp_encoder_ts.h"
+#include <algorithm>
 #include <securec.h>
 #include "common/common_macro.h"
 #include "common/media_log.h"
-#include "frame/aac_frame.h"
 #include "frame/h264_frame.h"
 
 namespace OHOS {
 namespace Sharing {
+namespace {
+constexpr uint32_t TS_MUX_DELAY_MS = 100; // decoder buffering allowance between PCR and PES timestamps
+constexpr uint32_t TS_PCR_INTERVAL_MS = 40;
+constexpr uint32_t TS_TABLE_INTERVAL_MS = 100;
+constexpr size_t MAX_PENDING_NALUS = 16;
+constexpr size_t PES_HEADER_MAX_SIZE = 19;
+constexpr size_t PES_PTS_SIZE = 5;
+constexpr size_t PES_MAX_LENGTH = 0xFFFF;
+constexpr size_t TS_PCR_SIZE = 6;
+constexpr uint8_t TS_ADAPTATION_ONLY = 0x02;
+constexpr uint8_t TS_PAYLOAD_ONLY = 0x01;
+constexpr uint8_t TS_ADAPTATION_PAYLOAD = 0x03;
+constexpr uint8_t TS_AF_PCR = 0x10;
+constexpr uint8_t TS_AF_RANDOM_ACCESS = 0x40;
+constexpr uint8_t TS_STUFFING_BYTE = 0xFF;
+constexpr uint8_t PTS_ONLY = 0x02;
+constexpr uint8_t PTS_WITH_DTS = 0x03;
+constexpr uint8_t DTS_ONLY = 0x01;
+const uint8_t H264_AUD[] = {0x00, 0x00, 0x00, 0x01, 0x09, 0xF0};
+const uint8_t H264_START_CODE[] = {0x00, 0x00, 0x00, 0x01};
+
+void WriteTsHeader(uint8_t *out, uint16_t pid, bool unitStart, uint8_t adaptation, uint8_t counter)
+{
+    out[0] = TS_SYNC_BYTE;
+    out[1] = (uint8_t)((unitStart ? 0x40 : 0x00) | ((pid >> 8) & 0x1F)); // 8: pid high bits
+    out[2] = (uint8_t)(pid & 0xFF);
+    out[3] = (uint8_t)((adaptation << 4) | (counter & 0x0F)); // 4: adaptation_field_control
+}
+
+void WriteTimestamp(uint8_t *out, uint8_t prefix, uint64_t ts)
+{
+    out[0] = (uint8_t)((prefix << 4) | ((ts >> 29) & 0x0E) | 0x01); // 4: prefix, 29: bits 32..30
+    out[1] = (uint8_t)(ts >> 22);                                   // 22: bits 29..22
+    out[2] = (uint8_t)(((ts >> 14) & 0xFE) | 0x01);                 // 14: bits 21..15
+    out[3] = (uint8_t)(ts >> 7);                                    // 7: bits 14..7
+    out[4] = (uint8_t)(((ts << 1) & 0xFE) | 0x01);                  // 1: bits 6..0
+}
+
+void WritePcrField(uint8_t *out, uint64_t pcr)
+{
+    out[0] = (uint8_t)(pcr >> 25);                    // 25: bits 32..25
+    out[1] = (uint8_t)(pcr >> 17);                    // 17: bits 24..17
+    out[2] = (uint8_t)(pcr >> 9);                     // 9: bits 16..9
+    out[3] = (uint8_t)(pcr >> 1);                     // 1: bits 8..1
+    out[4] = (uint8_t)(((pcr & 0x01) << 7) | 0x7E); // 4: bit 0, reserved, extension high bit
+    out[5] = 0x00;                                    // 5: extension
+}
+
+void FinishSection(std::vector<uint8_t> &section)
+{
+    // section_length counts the bytes after itself, crc included
+    size_t length = section.size() - 3 + 4; // 3: table_id and length, 4: crc
+    section[1] = (uint8_t)(0xB0 | ((length >> 8) & 0x0F)); // 8: length high bits
+    section[2] = (uint8_t)(length & 0xFF);                  // 2: length low bits
+    uint32_t crc = TsCrc32(section.data(), section.size());
+    section.push_back((uint8_t)(crc >> 24)); // 24: crc byte 0
+    section.push_back((uint8_t)(crc >> 16)); // 16: crc byte 1
+    section.push_back((uint8_t)(crc >> 8));  // 8: crc byte 2
+    section.push_back((uint8_t)crc);
+}
+
+uint64_t ToTsClock(uint64_t ms)
+{
+    return (ms * TS_CLOCK_PER_MS) & TS_TIMESTAMP_MASK;
+}
+
+uint8_t NaluType(const Frame::Ptr &frame)
+{
+    if (frame == nullptr || (size_t)frame->Size() <= frame->PrefixSize()) {
+        return 0;
+    }
+    return H264_TYPE(frame->Data()[frame->PrefixSize()]);
+}
+} // namespace
+
 RtpEncoderTs::RtpEncoderTs(uint32_t ssrc, uint32_t mtuSize, uint32_t sampleRate, uint8_t payloadType, uint16_t seq)
     : RtpMaker(ssrc, mtuSize, payloadType, sampleRate, seq)
 {
     SHARING_LOGI("RtpEncoderTs CTOR IN");
-    merger_.SetType(FrameMerger::H264_PREFIX);
+    // an unset mtu keeps the usual 7 packets per rtp
+    if (GetMaxSize() >= TS_PACKET_SIZE) {
+        tsPerRtp_ = std::min(TS_PACKETS_PER_RTP, GetMaxSize() / TS_PACKET_SIZE);
+    }
+
+    video_.pid = TS_PID_VIDEO;
+    video_.streamType = TS_STREAM_H264;
+    video_.streamId = PES_STREAM_VIDEO;
+    audio_.pid = TS_PID_AUDIO;
+    BuildTables();
 }
 
 RtpEncoderTs::~RtpEncoderTs()
@@ -38,203 +122,325 @@ RtpEncoderTs::~RtpEncoderTs()
 void RtpEncoderTs::Release()
 {
     SHARING_LOGD("trace.");
-    {
-        std::lock_guard<std::mutex> lock(cbLockMutex_);
-        onRtpPack_ = nullptr;
-    }
+    std::lock_guard<std::mutex> lock(muxMutex_);
+    onRtpPack_ = nullptr;
     exit_ = true;
-    if (encodeThread_ && encodeThread_->joinable()) {
-        encodeThread_->join();
-        encodeThread_ = nullptr;
-    }
+    rtp_ = nullptr;
+    tsInRtp_ = 0;
+    pendingNalus_.clear();
+    finishedRtps_.clear();
+}
 
+void RtpEncoderTs::InputFrame(const Frame::Ptr &frame)
+{
+    RETURN_IF_NULL(frame);
+    OnRtpPack onRtpPack = nullptr;
+    std::vector<RtpPacket::Ptr> rtps;
     {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-        while (!dataQueue_.empty()) {
-            dataQueue_.pop();
+        std::lock_guard<std::mutex> lock(muxMutex_);
+        if (exit_) {
+            return;
         }
-    }
 
-    if (avioContext_) {
-        avio_context_free(&avioContext_);
+        switch (frame->GetCodecId()) {
+            case CODEC_H264:
+                InputVideoFrame(frame);
+                break;
+            case CODEC_AAC:
+            case CODEC_PCM:
+                InputAudioFrame(frame);
+                break;
+            default:
+                SHARING_LOGW("Unknown codec: %d", frame->GetCodecId());
+                break;
+        }
+        onRtpPack = onRtpPack_;
+        rtps.swap(finishedRtps_);
     }
 
-    if (avioCtxBuffer_) {
-        av_free(avioCtxBuffer_);
-        avioCtxBuffer_ = nullptr;
+    // the callback sends, it runs without the mux lock so a slow socket doesn't hold up the other track
+    if (onRtpPack) {
+        for (auto &rtp : rtps) {
+            onRtpPack(rtp);
+        }
     }
+}
 
-    if (avFormatContext_) {
-        avformat_free_context(avFormatContext_);
-        avFormatContext_ = nullptr;
-    }
+void RtpEncoderTs::SetOnRtpPack(const OnRtpPack &cb)
+{
+    SHARING_LOGD("trace.");
+    std::lock_guard<std::mutex> lock(muxMutex_);
+    onRtpPack_ = cb;
 }
 
-void RtpEncoderTs::InputFrame(const Frame::Ptr &frame)
+void RtpEncoderTs::InputVideoFrame(const Frame::Ptr &frame)
 {
-    RETURN_IF_NULL(frame);
-    if (exit_) {
+    uint8_t type = NaluType(frame);
+    if (type < H264Frame::NAL_B_P || type > H264Frame::NAL_IDR) {
+        // sps/pps/sei/aud go out in front of the next picture
+        if (pendingNalus_.size() >= MAX_PENDING_NALUS) {
+            SHARING_LOGW("too many nalus without picture, drop them.");
+            pendingNalus_.clear();
+        }
+        pendingNalus_.emplace_back(frame);
+        return;
+    }
+
+    std::vector<TsChunk> chunks;
+    chunks.reserve(pendingNalus_.size() * 2 + 3); // 2: start code and nalu, 3: aud and picture
+    if (!frame->DecodeAble()) {
+        // a following slice of the current picture continues the open pes
+        if (!videoPesOpen_) {
+            return;
+        }
+        if (frame->PrefixSize() == 0) {
+            chunks.push_back({H264_START_CODE, sizeof(H264_START_CODE)});
+        }
+        chunks.push_back({frame->Data(), (size_t)frame->Size()});
+        BeginFrame(frame->Dts(), false);
+        WritePayload(video_, false, false, {}, chunks);
+        FlushRtp();
         return;
     }
 
-    DataBuffer::Ptr buffer = std::make_shared<DataBuffer>();
-    switch (frame->GetCodecId()) {
-        case CODEC_H264:
-            // merge sps, pps and key frame into one packet
-            merger_.InputFrame(
-                frame, buffer, [this](uint32_t dts, uint32_t pts, const DataBuffer::Ptr &buffer, bool have_key_frame) {
-                    auto outFrame =
-                        std::make_shared<H264Frame>(buffer->Data(), buffer->Size(), (uint32_t)dts, (uint32_t)pts,
-                                                    PrefixSize((char *)buffer->Data(), buffer->Size()));
-                    SaveFrame(outFrame);
-                });
-            break;
-        case CODEC_AAC:
-        case CODEC_PCM:
-            SaveFrame(frame);
-            break;
-        default:
-            SHARING_LOGW("Unknown codec: %d", frame->GetCodecId());
-            break;
-    }
-
-    if (audioCodeId_ == AV_CODEC_ID_NONE) {
-        if (frame->GetCodecId() == CODEC_AAC) {
-            audioCodeId_ = AV_CODEC_ID_AAC;
-        } else if (frame->GetCodecId() == CODEC_PCM) {
-            audioCodeId_ = AV_CODEC_ID_PCM_S16BE;
+    if (pendingNalus_.empty() || NaluType(pendingNalus_.front()) != H264Frame::NAL_AUD) {
+        chunks.push_back({H264_AUD, sizeof(H264_AUD)});
+    }
+    for (auto &nalu : pendingNalus_) {
+        if (nalu->PrefixSize() == 0) {
+            chunks.push_back({H264_START_CODE, sizeof(H264_START_CODE)});
         }
+        chunks.push_back({nalu->Data(), (size_t)nalu->Size()});
+    }
+    if (frame->PrefixSize() == 0) {
+        chunks.push_back({H264_START_CODE, sizeof(H264_START_CODE)});
     }
-    if (encodeThread_ == nullptr && audioCodeId_ != AV_CODEC_ID_NONE) {
-        encodeThread_ = std::make_unique<std::thread>(&RtpEncoderTs::StartEncoding, this);
+    chunks.push_back({frame->Data(), (size_t)frame->Size()});
+
+    bool keyFrame = frame->KeyFrame();
+    BeginFrame(frame->Dts(), keyFrame);
+    WritePes(video_, frame->Pts(), frame->Dts(), keyFrame, chunks);
+    FlushRtp();
+    pendingNalus_.clear();
+    videoPesOpen_ = true;
+}
+
+void RtpEncoderTs::InputAudioFrame(const Frame::Ptr &frame)
+{
+    if (audioCodecId_ != frame->GetCodecId()) {
+        audioCodecId_ = frame->GetCodecId();
+        bool aac = audioCodecId_ == CODEC_AAC;
+        audio_.streamType = aac ? TS_STREAM_AAC : TS_STREAM_LPCM;
+        audio_.streamId = aac ? PES_STREAM_AUDIO : PES_STREAM_PRIVATE_1;
+        pmtVersion_ = (pmtVersion_ + 1) & 0x1F; // 5 bits version_number
+        BuildTables();
+        tablesSent_ = false;
+        SHARING_LOGI("audio codec: %{public}d, stream type: 0x%{public}x.", audioCodecId_, audio_.streamType);
     }
+
+    std::vector<TsChunk> chunks = {{frame->Data(), (size_t)frame->Size()}};
+    BeginFrame(frame->Dts(), false);
+    WritePes(audio_, frame->Pts(), frame->Dts(), false, chunks);
+    FlushRtp();
 }
 
-void RtpEncoderTs::SetOnRtpPack(const OnRtpPack &cb)
+void RtpEncoderTs::BuildTables()
 {
-    SHARING_LOGD("trace.");
-    onRtpPack_ = cb;
+    pat_ = {TS_TABLE_PAT, 0x00, 0x00, 0x00, 0x01, 0xC1, 0x00, 0x00, // transport_stream_id 1, version 0
+            (uint8_t)(TS_PROGRAM_NUMBER >> 8), (uint8_t)(TS_PROGRAM_NUMBER & 0xFF),
+            (uint8_t)(0xE0 | (TS_PID_PMT >> 8)), (uint8_t)(TS_PID_PMT & 0xFF)};
+    FinishSection(pat_);
+
+    pmt_ = {TS_TABLE_PMT, 0x00, 0x00, (uint8_t)(TS_PROGRAM_NUMBER >> 8), (uint8_t)(TS_PROGRAM_NUMBER & 0xFF),
+            (uint8_t)(0xC1 | (pmtVersion_ << 1)), 0x00, 0x00,
+            (uint8_t)(0xE0 | (TS_PID_PCR >> 8)), (uint8_t)(TS_PID_PCR & 0xFF), 0xF0, 0x00};
+    for (auto stream : {&video_, &audio_}) {
+        if (stream->streamType == 0) {
+            continue;
+        }
+        pmt_.insert(pmt_.end(), {stream->streamType, (uint8_t)(0xE0 | (stream->pid >> 8)),
+                                 (uint8_t)(stream->pid & 0xFF), 0xF0, 0x00});
+    }
+    FinishSection(pmt_);
 }
 
-void RtpEncoderTs::StartEncoding()
+void RtpEncoderTs::BeginFrame(uint32_t dts, bool keyFrame)
 {
-    SHARING_LOGD("trace.");
-    avformat_alloc_output_context2(&avFormatContext_, NULL, "mpegts", NULL);
-    if (avFormatContext_ == nullptr) {
-        SHARING_LOGE("avformat_alloc_output_context2 failed.");
-        return;
+    timeStamp_ = dts;
+    keyFrame_ = keyFrame;
+    // the pcr never steps back even if audio runs a little behind video
+    if (!pcrSent_ || (int32_t)(dts - pcrClock_) > 0) {
+        pcrClock_ = dts;
     }
 
-    videoStream = avformat_new_stream(avFormatContext_, NULL);
-    videoStream->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
-    videoStream->codecpar->codec_id = AV_CODEC_ID_H264;
-    videoStream->codecpar->codec_tag = 0;
-    videoStream->time_base.num = 1;
-    videoStream->time_base.den = SAMPLE_RATE_90K; // 90000: video sample rate
-
-    audioStream = avformat_new_stream(avFormatContext_, NULL);
-    audioStream->codecpar->codec_type = AVMEDIA_TYPE_AUDIO;
-    audioStream->codecpar->codec_id = audioCodeId_;
-    audioStream->codecpar->codec_tag = 0;
-    av_channel_layout_default(&audioStream->codecpar->ch_layout, AUDIO_CHANNEL_STEREO);
-    audioStream->codecpar->sample_rate = AUDIO_SAMPLE_RATE_48000;
-    audioStream->time_base.num = 1;
-    audioStream->time_base.den = AUDIO_SAMPLE_RATE_48000;
-    SHARING_LOGI("audio stream id: %{public}d, video stream id: %{public}d, audio codecid: %{public}d.",
-        audioStream->index, videoStream->index, audioCodeId_);
-
-    avioCtxBuffer_ = (uint8_t *)av_malloc(MAX_RTP_PAYLOAD_SIZE);
-    avioContext_ =
-        avio_alloc_context(avioCtxBuffer_, MAX_RTP_PAYLOAD_SIZE, 1, this, NULL, &RtpEncoderTs::WritePacket, NULL);
-    if (avioContext_ == nullptr) {
-        SHARING_LOGE("avio_alloc_context failed.");
-        return;
+    if (!tablesSent_ || keyFrame || pcrClock_ - lastTables_ >= TS_TABLE_INTERVAL_MS) {
+        WriteTables();
+        lastTables_ = pcrClock_;
+        tablesSent_ = true;
     }
-    avFormatContext_->pb = avioContext_;
-    avFormatContext_->flags = (int32_t)((uint32_t)(avFormatContext_->flags) | AVFMT_FLAG_CUSTOM_IO);
 
-    int32_t ret = avformat_write_header(avFormatContext_, NULL);
-    if (ret < 0) {
-        SHARING_LOGE("avformat_write_header to output failed, ret: %{public}d.", ret);
-        return;
+    if (!pcrSent_ || keyFrame || pcrClock_ - lastPcr_ >= TS_PCR_INTERVAL_MS) {
+        WritePcr(ToTsClock(pcrClock_));
+        lastPcr_ = pcrClock_;
+        pcrSent_ = true;
     }
+}
 
-    while (!exit_) {
-        AVPacket *packet = av_packet_alloc();
-        auto frame = ReadFrame(packet);
-        if (frame == nullptr) {
-            break;
-        }
-        av_write_frame(avFormatContext_, packet);
+void RtpEncoderTs::WriteTables()
+{
+    WriteSection(TS_PID_PAT, patCounter_, pat_);
+    WriteSection(TS_PID_PMT, pmtCounter_, pmt_);
+}
+
+void RtpEncoderTs::WriteSection(uint16_t pid, uint8_t &counter, const std::vector<uint8_t> &section)
+{
+    uint8_t *packet = NextTsPacket();
+    RETURN_IF_NULL(packet);
+    WriteTsHeader(packet, pid, true, TS_PAYLOAD_ONLY, counter++);
+    packet[TS_HEADER_SIZE] = 0x00; // pointer_field
+    size_t offset = TS_HEADER_SIZE + 1;
+    if (memcpy_s(packet + offset, TS_PACKET_SIZE - offset, section.data(), section.size()) != EOK) {
+        SHARING_LOGE("copy section failed.");
+        return;
     }
+    offset += section.size();
+    (void)memset_s(packet + offset, TS_PACKET_SIZE - offset, TS_STUFFING_BYTE, TS_PACKET_SIZE - offset);
+}
 
-    av_write_trailer(avFormatContext_);
+void RtpEncoderTs::WritePcr(uint64_t pcr)
+{
+    uint8_t *packet = NextTsPacket();
+    RETURN_IF_NULL(packet);
+    // adaptation only packets keep the continuity counter
+    WriteTsHeader(packet, TS_PID_PCR, false, TS_ADAPTATION_ONLY, pcrCounter_);
+    packet[TS_HEADER_SIZE] = TS_PAYLOAD_SIZE - 1;
+    packet[TS_HEADER_SIZE + 1] = TS_AF_PCR;
+    size_t offset = TS_HEADER_SIZE + 2; // 2: length and flags
+    WritePcrField(packet + offset, pcr);
+    offset += TS_PCR_SIZE;
+    (void)memset_s(packet + offset, TS_PACKET_SIZE - offset, TS_STUFFING_BYTE, TS_PACKET_SIZE - offset);
 }
 
-void RtpEncoderTs::SaveFrame(Frame::Ptr frame)
+void RtpEncoderTs::WritePes(TsStream &stream, uint64_t pts, uint64_t dts, bool randomAccess,
+                            const std::vector<TsChunk> &chunks)
 {
-    RETURN_IF_NULL(frame);
-    std::lock_guard<std::mutex> lock(queueMutex_);
-    dataQueue_.emplace(frame);
+    bool withDts = pts != dts;
+    size_t headerDataSize = withDts ? PES_PTS_SIZE * 2 : PES_PTS_SIZE; // 2: pts and dts
+    size_t payloadSize = 0;
+    for (auto &chunk : chunks) {
+        payloadSize += chunk.size;
+    }
+
+    uint8_t header[PES_HEADER_MAX_SIZE] = {0x00, 0x00, 0x01, stream.streamId};
+    size_t pesLength = 3 + headerDataSize + payloadSize; // 3: flags and header_data_length
+    if (stream.streamId == PES_STREAM_VIDEO || pesLength > PES_MAX_LENGTH) {
+        pesLength = 0; // unbounded, allowed for video only
+    }
+    header[4] = (uint8_t)(pesLength >> 8);    // 4: PES_packet_length high
+    header[5] = (uint8_t)(pesLength & 0xFF);  // 5: PES_packet_length low
+    header[6] = 0x84;                         // 6: marker bits, data_alignment_indicator
+    header[7] = withDts ? 0xC0 : 0x80;        // 7: PTS_DTS_flags
+    header[8] = (uint8_t)headerDataSize;      // 8: PES_header_data_length
+    size_t offset = 9;                        // 9: fixed header size
+    WriteTimestamp(header + offset, withDts ? PTS_WITH_DTS : PTS_ONLY, ToTsClock(pts + TS_MUX_DELAY_MS));
+    offset += PES_PTS_SIZE;
+    if (withDts) {
+        WriteTimestamp(header + offset, DTS_ONLY, ToTsClock(dts + TS_MUX_DELAY_MS));
+        offset += PES_PTS_SIZE;
+    }
+
+    WritePayload(stream, true, randomAccess, {header, offset}, chunks);
 }
 
-Frame::Ptr RtpEncoderTs::ReadFrame(AVPacket *packet)
+void RtpEncoderTs::WritePayload(TsStream &stream, bool unitStart, bool randomAccess, const TsChunk &head,
+                                const std::vector<TsChunk> &chunks)
 {
-    if (packet == nullptr) {
-        SHARING_LOGE("packet is null!");
-        return nullptr;
+    size_t remaining = head.size;
+    for (auto &chunk : chunks) {
+        remaining += chunk.size;
     }
-    while (dataQueue_.empty()) {
-        if (exit_ == true) {
-            SHARING_LOGI("exit when read frame.");
-            return nullptr;
+
+    // chunk 0 is the pes header, the others follow in order
+    size_t chunkIndex = 0;
+    size_t chunkOffset = 0;
+    bool first = true;
+    while (remaining > 0) {
+        uint8_t *packet = NextTsPacket();
+        RETURN_IF_NULL(packet);
+
+        size_t adaptationSize = (first && randomAccess) ? 2 : 0; // 2: length and flags
+        size_t space = TS_PAYLOAD_SIZE - adaptationSize;
+        size_t take = std::min(remaining, space);
+        adaptationSize += space - take; // stuffing goes into the adaptation field
+
+        uint8_t adaptation = adaptationSize > 0 ? TS_ADAPTATION_PAYLOAD : TS_PAYLOAD_ONLY;
+        WriteTsHeader(packet, stream.pid, unitStart && first, adaptation, stream.counter++);
+        uint8_t *out = packet + TS_HEADER_SIZE;
+        if (adaptationSize > 0) {
+            out[0] = (uint8_t)(adaptationSize - 1);
         }
-        std::this_thread::sleep_for(std::chrono::microseconds(100)); // 100: wait time
-    }
+        if (adaptationSize > 1) {
+            out[1] = (first && randomAccess) ? TS_AF_RANDOM_ACCESS : 0x00;
+            if (adaptationSize > 2) { // 2: length and flags
+                (void)memset_s(out + 2, adaptationSize - 2, TS_STUFFING_BYTE, adaptationSize - 2); // 2: flags end
+            }
+        }
+        out += adaptationSize;
 
-    std::unique_lock<std::mutex> lock(queueMutex_);
-    Frame::Ptr frame = dataQueue_.front();
-    dataQueue_.pop();
-    packet->data = frame->Data();
-    packet->size = frame->Size();
-    
-    keyFrame_ = frame->KeyFrame();
-    if (frame->GetTrackType() == TRACK_VIDEO) {
-        packet->dts = av_rescale(frame->Dts(), videoStream->time_base.den, WFD_MSEC_IN_SEC);
-        packet->pts = av_rescale(frame->Pts(), videoStream->time_base.den, WFD_MSEC_IN_SEC);
-        packet->stream_index = videoStream->index;
-        timeStamp_ = frame->Dts();
-    } else if (frame->GetTrackType() == TRACK_AUDIO) {
-        packet->dts = av_rescale(frame->Dts(), audioStream->time_base.den, WFD_MSEC_IN_SEC);
-        packet->pts = av_rescale(frame->Pts(), audioStream->time_base.den, WFD_MSEC_IN_SEC);
-        packet->stream_index = audioStream->index;
-        timeStamp_ = frame->Dts();
+        size_t copied = 0;
+        while (copied < take) {
+            const TsChunk &chunk = chunkIndex == 0 ? head : chunks[chunkIndex - 1];
+            size_t n = std::min(chunk.size - chunkOffset, take - copied);
+            if (n > 0 && memcpy_s(out + copied, take - copied, chunk.data + chunkOffset, n) != EOK) {
+                SHARING_LOGE("copy pes payload failed.");
+                return;
+            }
+            copied += n;
+            chunkOffset += n;
+            if (chunkOffset == chunk.size) {
+                chunkIndex++;
+                chunkOffset = 0;
+            }
+        }
+
+        remaining -= take;
+        first = false;
     }
-    return frame;
 }
 
-void RtpEncoderTs::RemoveFrameAfterMuxing()
+uint8_t *RtpEncoderTs::NextTsPacket()
 {
-    std::unique_lock<std::mutex> lock(queueMutex_);
-    dataQueue_.pop();
+    if (rtp_ != nullptr && tsInRtp_ >= tsPerRtp_) {
+        FlushRtp();
+    }
+
+    if (rtp_ == nullptr) {
+        rtp_ = AllocRtp(tsPerRtp_ * TS_PACKET_SIZE);
+        tsInRtp_ = 0;
+        if (rtp_ == nullptr) {
+            SHARING_LOGE("alloc rtp failed.");
+            return nullptr;
+        }
+    }
+
+    return rtp_->Data() + RtpPacket::RTP_HEADER_SIZE + tsInRtp_++ * TS_PACKET_SIZE;
 }
 
-int RtpEncoderTs::WritePacket(void *opaque, const uint8_t *buf, int buf_size)
+void RtpEncoderTs::FlushRtp()
 {
-    RETURN_INVALID_IF_NULL(opaque);
-    RETURN_INVALID_IF_NULL(buf);
+    if (rtp_ == nullptr || tsInRtp_ == 0) {
+        return;
+    }
 
-    RtpEncoderTs *encoder = (RtpEncoderTs *)opaque;
-    std::lock_guard<std::mutex> lock(encoder->cbLockMutex_);
-    if (encoder->onRtpPack_) {
-        auto rtp =
-            encoder->MakeRtp(reinterpret_cast<const void *>(buf), buf_size, encoder->keyFrame_, encoder->timeStamp_);
-        if (rtp != nullptr) {
-            encoder->onRtpPack_(rtp);
-        }
+    RtpPacket::Ptr rtp = rtp_;
+    size_t size = tsInRtp_ * TS_PACKET_SIZE;
+    rtp_ = nullptr;
+    tsInRtp_ = 0;
+    if (!FinishRtp(rtp, size, keyFrame_, timeStamp_)) {
+        return;
     }
 
-    return 0;
+    finishedRtps_.push_back(rtp);
 }
 } // namespace Sharing
 } // namespace OHOS
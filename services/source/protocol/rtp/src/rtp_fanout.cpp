@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rtp_fanout.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <random>
+#include <sys/socket.h>
+#include "common/common_macro.h"
+#include "common/media_log.h"
+#include "securec.h"
+#include "utils/utils.h"
+
+namespace OHOS {
+namespace Sharing {
+constexpr uint32_t RTP_CLOCK_RATE = 90000;
+constexpr uint8_t RTP_VERSION = 2;
+
+RtpFanout::RtpFanout(const Config &config) : config_(config)
+{
+    config_.maxSinks = std::max(config_.maxSinks, 1U);
+    config_.maxQueuePackets = std::max(config_.maxQueuePackets, 1U);
+}
+
+void RtpFanout::SetSocket(int32_t fd)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    fd_ = fd;
+}
+
+bool RtpFanout::AddSink(uint32_t id, const std::string &ip, uint16_t port, uint32_t ssrc)
+{
+    Sink sink;
+    sink.addr.sin_family = AF_INET;
+    sink.addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip.c_str(), &sink.addr.sin_addr) <= 0) {
+        SHARING_LOGE("invalid sink ip: %{public}s.", GetAnonymousIp(ip).c_str());
+        return false;
+    }
+
+    std::random_device random;
+    sink.ssrc = ssrc;
+    sink.seqBase = static_cast<uint16_t>(random());
+    sink.rtcp = std::make_shared<RtcpSenderContext>();
+    sink.stats.ssrc = ssrc;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sinks_.count(id) == 0 && sinks_.size() >= config_.maxSinks) {
+        SHARING_LOGW("fanout full, sinks: %{public}zu.", sinks_.size());
+        return false;
+    }
+    sinks_[id] = std::move(sink);
+    SHARING_LOGI("fanout sink: %{public}u, ssrc: %{public}u, sinks: %{public}zu.", id, ssrc, sinks_.size());
+    return true;
+}
+
+void RtpFanout::RemoveSink(uint32_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sinks_.find(id);
+    if (it == sinks_.end()) {
+        return;
+    }
+
+    auto &stats = it->second.stats;
+    SHARING_LOGI("fanout sink: %{public}u removed, packets: %{public}" PRIu64 ", dropped: %{public}" PRIu64 ".", id,
+                 stats.packets, stats.dropped);
+    sinks_.erase(it);
+}
+
+size_t RtpFanout::GetSinkCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sinks_.size();
+}
+
+void RtpFanout::Send(const std::vector<DataBuffer::Ptr> &packets)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (sinks_.empty()) {
+        return;
+    }
+
+    for (auto &packet : packets) {
+        for (auto &kv : sinks_) {
+            Enqueue(kv.second, packet);
+        }
+    }
+    Flush();
+}
+
+void RtpFanout::SendTo(uint32_t id, const std::vector<DataBuffer::Ptr> &packets)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sinks_.find(id);
+    if (it == sinks_.end()) {
+        return;
+    }
+
+    for (auto &packet : packets) {
+        Enqueue(it->second, packet);
+    }
+    Flush();
+}
+
+std::vector<uint16_t> RtpFanout::ToSourceSeqs(uint32_t id, const std::vector<uint16_t> &seqs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sinks_.find(id);
+    if (it == sinks_.end() || !it->second.synced) {
+        return {};
+    }
+
+    std::vector<uint16_t> ret;
+    ret.reserve(seqs.size());
+    for (auto seq : seqs) {
+        ret.push_back(static_cast<uint16_t>(seq - it->second.seqOffset));
+    }
+    return ret;
+}
+
+uint32_t RtpFanout::GetSsrc(uint32_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sinks_.find(id);
+    return it == sinks_.end() ? 0 : it->second.ssrc;
+}
+
+void RtpFanout::OnRtcp(uint32_t id, RtcpHeader *rtcp)
+{
+    RETURN_IF_NULL(rtcp);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sinks_.find(id);
+    if (it != sinks_.end()) {
+        it->second.rtcp->OnRtcp(rtcp);
+    }
+}
+
+DataBuffer::Ptr RtpFanout::CreateSenderReport(uint32_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sinks_.find(id);
+    if (it == sinks_.end()) {
+        return nullptr;
+    }
+    return it->second.rtcp->CreateRtcpSR(it->second.ssrc);
+}
+
+DataBuffer::Ptr RtpFanout::CreateDlrr(uint32_t id, uint32_t receiverSsrc)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sinks_.find(id);
+    if (it == sinks_.end()) {
+        return nullptr;
+    }
+    return it->second.rtcp->CreateRtcpXRDLRR(it->second.ssrc, receiverSsrc);
+}
+
+RtpFanout::SinkStats RtpFanout::GetStats(uint32_t id)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sinks_.find(id);
+    if (it == sinks_.end()) {
+        return {};
+    }
+
+    SinkStats stats = it->second.stats;
+    stats.queued = static_cast<uint32_t>(it->second.queue.size());
+    stats.rtt = it->second.rtcp->GetRtt(it->second.ssrc);
+    return stats;
+}
+
+void RtpFanout::Enqueue(Sink &sink, const DataBuffer::Ptr &packet)
+{
+    if (packet == nullptr || packet->Size() <= static_cast<int32_t>(RTP_HEADER_SIZE)) {
+        return;
+    }
+
+    auto data = packet->Data();
+    int32_t pt = data[1] & 0x7F; // 0x7F: payload type bits
+    if ((data[0] >> 6) != RTP_VERSION || (config_.payloadType >= 0 && pt != config_.payloadType)) { // 6: version
+        return;
+    }
+
+    uint16_t seq = static_cast<uint16_t>((data[2] << 8) | data[3]); // 2, 3: seq bytes, 8: byte offset
+    if (!sink.synced) {
+        sink.seqOffset = static_cast<uint16_t>(sink.seqBase - seq);
+        sink.synced = true;
+    }
+
+    if (sink.queue.size() >= config_.maxQueuePackets) {
+        sink.queue.pop_front();
+        sink.stats.dropped++;
+    }
+
+    sink.queue.emplace_back();
+    auto &pending = sink.queue.back();
+    pending.packet = packet;
+    if (memcpy_s(pending.header, sizeof(pending.header), data, RTP_HEADER_SIZE) != EOK) {
+        sink.queue.pop_back();
+        return;
+    }
+    uint16_t sinkSeq = htons(static_cast<uint16_t>(seq + sink.seqOffset));
+    uint32_t ssrc = htonl(sink.ssrc);
+    // 2: seq offset, 8: ssrc offset
+    if (memcpy_s(pending.header + 2, sizeof(pending.header) - 2, &sinkSeq, sizeof(sinkSeq)) != EOK ||
+        memcpy_s(pending.header + 8, sizeof(pending.header) - 8, &ssrc, sizeof(ssrc)) != EOK) {
+        sink.queue.pop_back();
+    }
+}
+
+void RtpFanout::Flush()
+{
+    if (fd_ < 0) {
+        return;
+    }
+
+    uint64_t nowMs = GetCurrentMillisecond();
+    struct mmsghdr msgs[MAX_BATCH_MESSAGES];
+    struct iovec iovs[MAX_BATCH_MESSAGES][2]; // 2: rewritten header, shared payload
+    Sink *owners[MAX_BATCH_MESSAGES];
+    while (true) {
+        // round robin over the queue fronts, every sink keeps its order within the batch
+        uint32_t count = 0;
+        for (size_t round = 0; count < MAX_BATCH_MESSAGES; round++) {
+            bool more = false;
+            for (auto &kv : sinks_) {
+                auto &queue = kv.second.queue;
+                if (round >= queue.size() || count >= MAX_BATCH_MESSAGES) {
+                    continue;
+                }
+                more = true;
+                auto &pending = queue[round];
+                iovs[count][0].iov_base = pending.header;
+                iovs[count][0].iov_len = RTP_HEADER_SIZE;
+                iovs[count][1].iov_base = pending.packet->Data() + RTP_HEADER_SIZE;
+                iovs[count][1].iov_len = static_cast<size_t>(pending.packet->Size()) - RTP_HEADER_SIZE;
+                msgs[count] = {};
+                msgs[count].msg_hdr.msg_name = &kv.second.addr;
+                msgs[count].msg_hdr.msg_namelen = sizeof(kv.second.addr);
+                msgs[count].msg_hdr.msg_iov = iovs[count];
+                msgs[count].msg_hdr.msg_iovlen = 2; // 2: header and payload
+                owners[count] = &kv.second;
+                count++;
+            }
+            if (!more) {
+                break;
+            }
+        }
+        if (count == 0) {
+            return;
+        }
+
+        int32_t ret = ::sendmmsg(fd_, msgs, count, MSG_DONTWAIT);
+        uint32_t sent = ret > 0 ? static_cast<uint32_t>(ret) : 0;
+        for (uint32_t i = 0; i < sent; i++) {
+            // in batch order the messages of a sink are the fronts of its queue
+            OnSent(*owners[i], owners[i]->queue.front(), nowMs);
+            owners[i]->queue.pop_front();
+        }
+        if (ret > 0) {
+            // the error of the first unsent message is only reported by the next call
+            continue;
+        }
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS || errno == EINTR) {
+            // the socket is full for everyone, the queues are retried with the next frame
+            return;
+        }
+        // an error of one destination, e.g. unreachable: only that sink loses the packet
+        MEDIA_LOGD("fanout send to ssrc: %{public}u failed, errno: %{public}d.", owners[sent]->ssrc, errno);
+        owners[sent]->queue.pop_front();
+        owners[sent]->stats.dropped++;
+    }
+}
+
+void RtpFanout::OnSent(Sink &sink, const Pending &pending, uint64_t nowMs)
+{
+    auto &header = pending.header;
+    uint16_t seq = static_cast<uint16_t>((header[2] << 8) | header[3]); // 2, 3: seq bytes, 8: byte offset
+    uint32_t stamp = ntohl(*reinterpret_cast<const uint32_t *>(header + 4)); // 4: stamp offset
+    size_t bytes = static_cast<size_t>(pending.packet->Size());
+    sink.rtcp->OnRtp(seq, stamp, nowMs, RTP_CLOCK_RATE, bytes);
+    sink.stats.packets++;
+    sink.stats.bytes += bytes;
+}
+} // namespace Sharing
+} // namespace OHOS
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rtp_fec_encoder.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cmath>
+#include <securec.h>
+#include "common/common_macro.h"
+#include "common/media_log.h"
+
+namespace OHOS {
+namespace Sharing {
+RtpFecEncoder::RtpFecEncoder(uint8_t pt, uint32_t minGroupPackets, uint32_t maxGroupPackets)
+    : pt_(pt), parity_(RTP_FEC_MAX_PROTECTED, 0)
+{
+    // 2: a group of one would be a plain copy
+    maxGroupPackets_ = std::clamp<uint32_t>(maxGroupPackets, 2, RTP_FEC_MAX_GROUP);
+    minGroupPackets_ = std::clamp<uint32_t>(minGroupPackets, 2, maxGroupPackets_);
+    groupPackets_ = maxGroupPackets_;
+}
+
+RtpPacket::Ptr RtpFecEncoder::AddPacket(const RtpPacket::Ptr &rtp)
+{
+    if (rtp == nullptr || rtp->Data() == nullptr || rtp->Size() < RtpPacket::RTP_HEADER_SIZE) {
+        return nullptr;
+    }
+
+    const uint8_t *data = rtp->Data();
+    size_t length = static_cast<size_t>(rtp->Size()) - RtpPacket::RTP_HEADER_SIZE;
+    uint16_t seq = rtp->GetSeq();
+    if (length > RTP_FEC_MAX_PROTECTED || (count_ > 0 && seq != static_cast<uint16_t>(snBase_ + count_))) {
+        // not protectable along with the open group, which is given up
+        Reset();
+        return nullptr;
+    }
+
+    if (count_ == 0) {
+        snBase_ = seq;
+        ssrc_ = rtp->GetHeader()->ssrc_;
+        target_ = groupPackets_.load(std::memory_order_relaxed);
+    }
+    XorBytes(parity_.data(), data + RtpPacket::RTP_HEADER_SIZE, length);
+    parityLength_ = std::max(parityLength_, static_cast<uint16_t>(length));
+    recovery0_ ^= data[0];
+    recovery1_ ^= data[1];
+    tsRecovery_ ^= rtp->GetHeader()->stamp_;
+    lengthRecovery_ ^= static_cast<uint16_t>(length);
+    lastStamp_ = rtp->GetHeader()->stamp_;
+    ++count_;
+    media_.fetch_add(1, std::memory_order_relaxed);
+
+    return count_ >= target_ ? MakeParity() : nullptr;
+}
+
+RtpPacket::Ptr RtpFecEncoder::Flush()
+{
+    return count_ > 0 ? MakeParity() : nullptr;
+}
+
+void RtpFecEncoder::OnLossRate(double lossRate)
+{
+    uint32_t group = maxGroupPackets_;
+    if (lossRate > 0) {
+        // one parity repairs one loss per group
+        group = static_cast<uint32_t>(std::clamp(std::round(LOSSES_PER_GROUP / lossRate),
+                                                 static_cast<double>(minGroupPackets_),
+                                                 static_cast<double>(maxGroupPackets_)));
+    }
+    if (groupPackets_.exchange(group) != group) {
+        MEDIA_LOGD("fec loss rate: %{public}.3f, group packets: %{public}u.", lossRate, group);
+    }
+}
+
+RtpFecEncoder::Stats RtpFecEncoder::GetStats() const
+{
+    Stats stats;
+    stats.media = media_.load(std::memory_order_relaxed);
+    stats.parity = parityPackets_.load(std::memory_order_relaxed);
+    stats.groupPackets = groupPackets_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void RtpFecEncoder::Reset()
+{
+    (void)memset_s(parity_.data(), parity_.size(), 0, parityLength_);
+    count_ = 0;
+    parityLength_ = 0;
+    recovery0_ = 0;
+    recovery1_ = 0;
+    tsRecovery_ = 0;
+    lengthRecovery_ = 0;
+}
+
+RtpPacket::Ptr RtpFecEncoder::MakeParity()
+{
+    size_t size = RtpPacket::RTP_HEADER_SIZE + sizeof(RtpFecHeader) + parityLength_;
+    auto rtp = RtpPacket::Create(static_cast<int32_t>(size));
+    if (rtp == nullptr || rtp->Data() == nullptr) {
+        Reset();
+        return nullptr;
+    }
+    rtp->SetSize(static_cast<int32_t>(size));
+
+    auto header = rtp->GetHeader();
+    header->version_ = RtpPacket::RTP_VERSION;
+    header->padding_ = 0;
+    header->ext_ = 0;
+    header->csrc_ = 0;
+    header->mark_ = 0;
+    header->pt_ = pt_;
+    header->seq_ = htons(seq_);
+    ++seq_;
+    header->stamp_ = lastStamp_;
+    header->ssrc_ = ssrc_;
+
+    auto fec = reinterpret_cast<RtpFecHeader *>(rtp->Data() + RtpPacket::RTP_HEADER_SIZE);
+    fec->recovery0_ = recovery0_ & 0x3F; // 0x3F: E = 0, L = 0
+    fec->recovery1_ = recovery1_;
+    fec->snBase_ = htons(snBase_);
+    fec->tsRecovery_ = tsRecovery_;
+    fec->lengthRecovery_ = htons(lengthRecovery_);
+    fec->protectionLength_ = htons(parityLength_);
+    // 0xFFFF: the first count_ bits from the msb
+    fec->mask_ = htons(static_cast<uint16_t>(0xFFFFU << (RTP_FEC_MAX_GROUP - count_)));
+    if (parityLength_ > 0 &&
+        memcpy_s(rtp->Data() + RtpPacket::RTP_HEADER_SIZE + sizeof(RtpFecHeader), parityLength_, parity_.data(),
+                 parityLength_) != EOK) {
+        Reset();
+        return nullptr;
+    }
+
+    parityPackets_.fetch_add(1, std::memory_order_relaxed);
+    Reset();
+    return rtp;
+}
+} // namespace Sharing
+} // namespace OHOS
@@ -46,27 +46,51 @@ uint32_t RtpMaker::GetSsrc() const
 
 RtpPacket::Ptr RtpMaker::MakeRtp(const void *data, size_t len, bool mark, uint32_t stamp)
 {
-    if (data == nullptr) {
+    auto rtp = AllocRtp(len);
+    if (!rtp) {
         return nullptr;
     }
 
-    if (len > MAX_USHORT - RtpPacket::RTP_HEADER_SIZE) {
+    // without data the payload is left for the caller to fill
+    if (data) {
+        auto ret = memcpy_s(rtp->Data() + RtpPacket::RTP_HEADER_SIZE, len, data, len);
+        if (ret != EOK) {
+            return nullptr;
+        }
+    }
+
+    if (!FinishRtp(rtp, len, mark, stamp)) {
         return nullptr;
     }
-    uint16_t size = (uint16_t)(len + RtpPacket::RTP_HEADER_SIZE);
-    if (size == 0) {
+
+    return rtp;
+}
+
+RtpPacket::Ptr RtpMaker::AllocRtp(size_t capacity)
+{
+    if (capacity > MAX_USHORT - RtpPacket::RTP_HEADER_SIZE) {
         return nullptr;
     }
-    auto rtp = std::make_shared<RtpPacket>();
-    if (!rtp) {
+
+    auto rtp = RtpPacket::Create((int32_t)(capacity + RtpPacket::RTP_HEADER_SIZE));
+    if (!rtp || rtp->Data() == nullptr) {
         return nullptr;
     }
-    rtp->SetCapacity(size);
-    rtp->SetSize(size);
+
+    return rtp;
+}
+
+bool RtpMaker::FinishRtp(const RtpPacket::Ptr &rtp, size_t len, bool mark, uint32_t stamp)
+{
+    RETURN_FALSE_IF_NULL(rtp);
+    if (len + RtpPacket::RTP_HEADER_SIZE > (size_t)rtp->Capacity()) {
+        return false;
+    }
+    rtp->SetSize((int32_t)(len + RtpPacket::RTP_HEADER_SIZE));
 
     auto header = rtp->GetHeader();
     if (!header) {
-        return nullptr;
+        return false;
     }
     header->version_ = RtpPacket::RTP_VERSION;
     header->padding_ = 0;
@@ -79,16 +103,7 @@ RtpPacket::Ptr RtpMaker::MakeRtp(const void *data, size_t len, bool mark, uint32
     header->stamp_ = htonl(uint64_t(stamp) * (sampleRate_ / 1000)); // 1000:unit
     header->ssrc_ = htonl(ssrc_);
 
-    if (data) {
-        auto rtpData = rtp->Data();
-
-        auto ret = memcpy_s(rtpData + RtpPacket::RTP_HEADER_SIZE, len, data, len);
-        if (ret != EOK) {
-            return nullptr;
-        }
-    }
-
-    return rtp;
+    return true;
 }
 } // namespace Sharing
 } // namespace OHOS
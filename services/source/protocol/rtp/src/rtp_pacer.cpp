@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rtp_pacer.h"
+#include <algorithm>
+#include <limits>
+#include "common/media_log.h"
+
+namespace OHOS {
+namespace Sharing {
+constexpr double BITS_PER_BYTE = 8.0;
+constexpr double PERCENT = 100.0;
+constexpr double MS_PER_SEC = 1000.0;
+
+RtpPacer::RtpPacer(const Config &config) : config_(config)
+{
+    config_.burstPackets = std::max(config_.burstPackets, 1U);
+    config_.spreadPercent = std::clamp(config_.spreadPercent, 1U, 100U); // 100: whole interval
+    config_.maxQueueFrames = std::max(config_.maxQueueFrames, 1U);
+    bitrate_ = config_.bitrate;
+}
+
+RtpPacer::~RtpPacer()
+{
+    Stop();
+}
+
+void RtpPacer::SetOnSend(const OnSend &cb)
+{
+    onSend_ = cb;
+}
+
+void RtpPacer::SetBitrate(uint32_t bitrate)
+{
+    bitrate_.store(bitrate, std::memory_order_relaxed);
+}
+
+bool RtpPacer::Start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return true;
+    }
+
+    running_ = true;
+    // a full bucket, the first burst leaves right away
+    tokens_ = std::numeric_limits<double>::max();
+    refilled_ = Clock::now();
+    thread_ = std::thread(&RtpPacer::PaceLoop, this);
+    pthread_setname_np(thread_.native_handle(), "rtp_pacer");
+    SHARING_LOGI("rtp pacer start, bitrate: %{public}u, spread: %{public}u%%, burst: %{public}u.", bitrate_.load(),
+                 config_.spreadPercent, config_.burstPackets);
+    return true;
+}
+
+void RtpPacer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        queue_.clear();
+    }
+
+    cond_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void RtpPacer::InputFrame(std::vector<DataBuffer::Ptr> &&packets, uint32_t intervalMs)
+{
+    if (packets.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        PacedFrame frame;
+        frame.packets = std::move(packets);
+        frame.intervalMs = intervalMs;
+        frame.enqueued = Clock::now();
+        queue_.emplace_back(std::move(frame));
+        stats_.queueDepth = static_cast<uint32_t>(queue_.size());
+        stats_.maxQueueDepth = std::max(stats_.maxQueueDepth, stats_.queueDepth);
+    }
+
+    cond_.notify_one();
+}
+
+RtpPacer::Stats RtpPacer::TakeStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats_ = Stats();
+    stats_.queueDepth = static_cast<uint32_t>(queue_.size());
+    return stats;
+}
+
+void RtpPacer::PaceLoop()
+{
+    SHARING_LOGD("rtp pacer loop enter.");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        cond_.wait(lock, [this]() { return !running_ || !queue_.empty(); });
+        if (!running_) {
+            break;
+        }
+
+        PacedFrame frame = std::move(queue_.front());
+        queue_.pop_front();
+        // a backlog means pacing already costs more latency than it saves
+        bool paced = queue_.size() < config_.maxQueueFrames;
+        lock.unlock();
+
+        SendFrame(frame, paced);
+        int64_t delay = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - frame.enqueued).count();
+
+        lock.lock();
+        stats_.frames++;
+        stats_.unpacedFrames += paced ? 0 : 1;
+        stats_.totalDelayUs += delay;
+        stats_.maxDelayUs = std::max(stats_.maxDelayUs, delay);
+        stats_.queueDepth = static_cast<uint32_t>(queue_.size());
+    }
+    SHARING_LOGD("rtp pacer loop exit.");
+}
+
+void RtpPacer::SendFrame(PacedFrame &frame, bool paced)
+{
+    if (onSend_ == nullptr) {
+        return;
+    }
+
+    double frameBytes = 0;
+    for (auto &packet : frame.packets) {
+        frameBytes += packet ? packet->Size() : 0;
+    }
+
+    // bytes per second: the configured rate with headroom, or faster if the frame needs it
+    double rate = bitrate_.load(std::memory_order_relaxed) / BITS_PER_BYTE * config_.headroomPercent / PERCENT;
+    if (frame.intervalMs > 0) {
+        double window = frame.intervalMs * config_.spreadPercent / PERCENT / MS_PER_SEC;
+        rate = std::max(rate, frameBytes / window);
+    }
+
+    std::vector<DataBuffer::Ptr> burst;
+    burst.reserve(config_.burstPackets);
+    for (size_t i = 0; i < frame.packets.size(); i += config_.burstPackets) {
+        size_t end = std::min(frame.packets.size(), i + config_.burstPackets);
+        burst.assign(frame.packets.begin() + i, frame.packets.begin() + end);
+        double bytes = 0;
+        for (auto &packet : burst) {
+            bytes += packet ? packet->Size() : 0;
+        }
+
+        if (paced && rate > 0 && !WaitTokens(bytes, rate, bytes)) {
+            return;
+        }
+        onSend_(burst);
+    }
+
+    if (!paced) {
+        // an unpaced frame leaves no credit behind
+        tokens_ = 0;
+        refilled_ = Clock::now();
+    }
+}
+
+bool RtpPacer::WaitTokens(double bytes, double rate, double capacity)
+{
+    while (true) {
+        auto now = Clock::now();
+        double elapsed = std::chrono::duration<double>(now - refilled_).count();
+        tokens_ = std::min(capacity, tokens_ + elapsed * rate);
+        refilled_ = now;
+        if (tokens_ >= bytes) {
+            tokens_ -= bytes;
+            return true;
+        }
+
+        auto wait = std::chrono::duration<double>((bytes - tokens_) / rate);
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (cond_.wait_for(lock, wait, [this]() { return !running_; })) {
+            return false;
+        }
+    }
+}
+} // namespace Sharing
+} // namespace OHOS
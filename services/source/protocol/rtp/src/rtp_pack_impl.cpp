@@ -14,6 +14,7 @@
  */
 
 #include "rtp_pack_impl.h"
+#include "rtp_encoder_aac.h"
 #include "rtp_encoder_g711.h"
 #include "rtp_encoder_h264.h"
 #include "rtp_encoder_ts.h"
@@ -33,6 +34,13 @@ void RtpPackImpl::InputFrame(const Frame::Ptr &frame)
     }
 }
 
+void RtpPackImpl::Flush()
+{
+    if (rtpEncoder_) {
+        rtpEncoder_->Flush();
+    }
+}
+
 void RtpPackImpl::SetOnRtpPack(const OnRtpPack &cb)
 {
     onRtpPack_ = cb;
@@ -45,6 +53,7 @@ void RtpPackImpl::InitEncoder()
             rtpEncoder_ = std::make_shared<RtpEncoderH264>(ssrc_, mtuSize_, sampleRate_, pt_, seq_);
             break;
         case RtpPayloadStream::MPEG4_GENERIC:
+            rtpEncoder_ = std::make_shared<RtpEncoderAAC>(ssrc_, mtuSize_, sampleRate_, pt_, seq_);
             break;
         case RtpPayloadStream::PCMA: // fall-through
         case RtpPayloadStream::PCMU:
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "rtp_packet_history.h"
+#include "common/common_macro.h"
+#include "common/media_log.h"
+#include "utils/utils.h"
+
+namespace OHOS {
+namespace Sharing {
+constexpr size_t MAX_HISTORY_SIZE = 0x8000; // 0x8000: half the seq space, older seqs would be ambiguous
+
+RtpPacketHistory::RtpPacketHistory(size_t capacity)
+{
+    size_t size = 1;
+    while (size < capacity && size < MAX_HISTORY_SIZE) {
+        size <<= 1;
+    }
+    mask_ = size - 1;
+    slots_.resize(size);
+}
+
+void RtpPacketHistory::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &slot : slots_) {
+        slot = Slot();
+    }
+}
+
+void RtpPacketHistory::Insert(const RtpPacket::Ptr &rtp)
+{
+    RETURN_IF_NULL(rtp);
+    uint16_t seq = rtp->GetSeq();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &slot = slots_[seq & mask_];
+    slot.rtp = rtp;
+    slot.seq = seq;
+    slot.resentMs = 0;
+}
+
+std::vector<DataBuffer::Ptr> RtpPacketHistory::Lookup(const std::vector<uint16_t> &seqs, uint32_t minIntervalMs)
+{
+    std::vector<DataBuffer::Ptr> packets;
+    auto now = static_cast<int64_t>(GetCurrentMillisecond());
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.requested += seqs.size();
+    for (auto seq : seqs) {
+        auto &slot = slots_[seq & mask_];
+        if (slot.rtp == nullptr || slot.seq != seq) {
+            ++stats_.missing;
+            continue;
+        }
+
+        if (slot.resentMs != 0 && now - slot.resentMs < minIntervalMs) {
+            ++stats_.throttled;
+            continue;
+        }
+
+        slot.resentMs = now;
+        packets.emplace_back(slot.rtp);
+        ++stats_.retransmitted;
+    }
+
+    return packets;
+}
+
+RtpPacketHistory::Stats RtpPacketHistory::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+} // namespace Sharing
+} // namespace OHOS
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rtp_rate_controller.h"
+#include <algorithm>
+#include <cmath>
+#include "common/media_log.h"
+
+namespace OHOS {
+namespace Sharing {
+constexpr double INCREASE_PER_SEC = 1.08;
+constexpr double DECREASE_FACTOR = 0.85;
+// the target does not run away from an encoder that undershoots it
+constexpr double SEND_HEADROOM = 1.5;
+// within 10% of the rate of the last overuse the increase is additive
+constexpr double NEAR_CONGESTION = 0.1;
+constexpr double PACKET_BITS = 1200 * 8;
+// added to the rtt, the time an increase takes to show in the reports
+constexpr double RESPONSE_MS = 100;
+// smoothing of the queueing delay, reports are about a second apart
+constexpr double DELAY_GAIN = 0.5;
+constexpr double HIGH_LOSS = 0.10;
+constexpr double LOW_LOSS = 0.02;
+constexpr uint32_t JITTER_FACTOR = 2;
+constexpr int64_t MS_PER_SEC = 1000;
+
+RtpRateController::RtpRateController(const Config &config) : config_(config)
+{
+    config_.minBitrate = std::max(config_.minBitrate, 1U);
+    config_.maxBitrate = std::max(config_.maxBitrate, config_.minBitrate);
+    config_.startBitrate = std::clamp(config_.startBitrate, config_.minBitrate, config_.maxBitrate);
+    config_.maxFrameRate = std::max(config_.maxFrameRate, 1U);
+    config_.minFrameRate = std::clamp(config_.minFrameRate, 1U, config_.maxFrameRate);
+
+    delayBitrate_ = lossBitrate_ = config_.startBitrate;
+    appliedBitrate_ = stats_.targetBitrate = stats_.delayBitrate = stats_.lossBitrate = config_.startBitrate;
+    appliedFrameRate_ = stats_.frameRate = FrameRateFor(config_.startBitrate);
+    stats_.thresholdMs = config_.delayThresholdMs;
+}
+
+void RtpRateController::OnSent(size_t bytes)
+{
+    sentBytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+bool RtpRateController::OnReport(const Report &report, int64_t nowMs)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    int64_t elapsedMs = lastReportMs_ < 0 ? 0 : std::max<int64_t>(nowMs - lastReportMs_, 0);
+    lastReportMs_ = nowMs;
+    uint64_t bytes = sentBytes_.exchange(0, std::memory_order_relaxed);
+    uint32_t sendBitrate = 0;
+    if (elapsedMs > 0) {
+        uint64_t bitrate = bytes * 8 * MS_PER_SEC / static_cast<uint64_t>(elapsedMs); // 8: bits per byte
+        sendBitrate = static_cast<uint32_t>(std::min<uint64_t>(bitrate, UINT32_MAX));
+    }
+
+    Usage usage = DetectUsage(report, nowMs);
+    UpdateDelayBitrate(usage, report.rttMs, elapsedMs, sendBitrate);
+    UpdateLossBitrate(report.lossRate, elapsedMs);
+
+    double target = std::clamp(std::min(delayBitrate_, lossBitrate_), static_cast<double>(config_.minBitrate),
+                               static_cast<double>(config_.maxBitrate));
+    stats_.targetBitrate = static_cast<uint32_t>(target);
+    stats_.frameRate = FrameRateFor(stats_.targetBitrate);
+    stats_.delayBitrate = static_cast<uint32_t>(delayBitrate_);
+    stats_.lossBitrate = static_cast<uint32_t>(lossBitrate_);
+    stats_.sendBitrate = sendBitrate;
+    stats_.usage = usage;
+    stats_.state = state_;
+    stats_.reports++;
+
+    uint32_t diff = stats_.targetBitrate > appliedBitrate_ ? stats_.targetBitrate - appliedBitrate_
+                                                           : appliedBitrate_ - stats_.targetBitrate;
+    if (static_cast<uint64_t>(diff) * 100 < static_cast<uint64_t>(appliedBitrate_) * RETUNE_PERCENT && // 100: %
+        stats_.frameRate == appliedFrameRate_) {
+        return false;
+    }
+
+    MEDIA_LOGI("rate control target: %{public}u -> %{public}u, fps: %{public}u, send: %{public}u, loss: %{public}.3f, "
+               "rtt: %{public}u, queue delay: %{public}u/%{public}u ms, usage: %{public}d, state: %{public}d.",
+               appliedBitrate_, stats_.targetBitrate, stats_.frameRate, sendBitrate, report.lossRate, report.rttMs,
+               stats_.queueDelayMs, stats_.thresholdMs, static_cast<int32_t>(usage), static_cast<int32_t>(state_));
+    appliedBitrate_ = stats_.targetBitrate;
+    appliedFrameRate_ = stats_.frameRate;
+    return true;
+}
+
+uint32_t RtpRateController::GetTargetBitrate() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.targetBitrate;
+}
+
+uint32_t RtpRateController::GetFrameRate() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.frameRate;
+}
+
+RtpRateController::Stats RtpRateController::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+RtpRateController::Usage RtpRateController::DetectUsage(const Report &report, int64_t nowMs)
+{
+    while (!rttSamples_.empty() && nowMs - rttSamples_.front().first > BASE_RTT_WINDOW_MS) {
+        rttSamples_.pop_front();
+    }
+    rttSamples_.emplace_back(nowMs, report.rttMs);
+    uint32_t baseRtt = report.rttMs;
+    for (auto &sample : rttSamples_) {
+        baseRtt = std::min(baseRtt, sample.second);
+    }
+
+    double delay = report.rttMs - baseRtt;
+    double last = queueDelayMs_;
+    queueDelayMs_ = last < 0 ? delay : last + (delay - last) * DELAY_GAIN;
+    uint32_t threshold = std::max(config_.delayThresholdMs, report.jitterMs * JITTER_FACTOR);
+    stats_.queueDelayMs = static_cast<uint32_t>(queueDelayMs_);
+    stats_.thresholdMs = threshold;
+
+    if (queueDelayMs_ <= threshold) {
+        return Usage::NORMAL;
+    }
+    // above the threshold but shrinking, the queue drains at the current rate
+    return last >= 0 && queueDelayMs_ < last ? Usage::UNDERUSE : Usage::OVERUSE;
+}
+
+void RtpRateController::UpdateDelayBitrate(Usage usage, uint32_t rttMs, int64_t elapsedMs, uint32_t sendBitrate)
+{
+    switch (usage) {
+        case Usage::OVERUSE:
+            state_ = RateState::DECREASE;
+            break;
+        case Usage::UNDERUSE:
+            state_ = RateState::HOLD;
+            break;
+        default:
+            state_ = state_ == RateState::DECREASE ? RateState::HOLD : RateState::INCREASE;
+            break;
+    }
+
+    double seconds = std::min<int64_t>(elapsedMs, MS_PER_SEC) / static_cast<double>(MS_PER_SEC);
+    if (state_ == RateState::DECREASE) {
+        double base = sendBitrate > 0 ? std::min<double>(sendBitrate, delayBitrate_) : delayBitrate_;
+        congestedBitrate_ = base;
+        delayBitrate_ = std::max(base * DECREASE_FACTOR, static_cast<double>(config_.minBitrate));
+        stats_.decreases++;
+    } else if (state_ == RateState::INCREASE && elapsedMs > 0) {
+        double increased = delayBitrate_;
+        bool nearCongestion = std::abs(delayBitrate_ - congestedBitrate_) < congestedBitrate_ * NEAR_CONGESTION;
+        if (congestedBitrate_ > 0 && nearCongestion) {
+            increased += PACKET_BITS * elapsedMs / (rttMs + RESPONSE_MS);
+        } else {
+            increased *= std::pow(INCREASE_PER_SEC, seconds);
+        }
+        if (sendBitrate > 0) {
+            increased = std::min(increased, std::max(delayBitrate_, sendBitrate * SEND_HEADROOM));
+        }
+        delayBitrate_ = std::min(increased, static_cast<double>(config_.maxBitrate));
+    }
+}
+
+void RtpRateController::UpdateLossBitrate(double lossRate, int64_t elapsedMs)
+{
+    if (lossRate > HIGH_LOSS) {
+        // 0.5: half the loss
+        lossBitrate_ = std::max(lossBitrate_ * (1 - 0.5 * lossRate), static_cast<double>(config_.minBitrate));
+    } else if (lossRate < LOW_LOSS && elapsedMs > 0) {
+        double seconds = std::min<int64_t>(elapsedMs, MS_PER_SEC) / static_cast<double>(MS_PER_SEC);
+        lossBitrate_ = std::min(lossBitrate_ * std::pow(INCREASE_PER_SEC, seconds),
+                                static_cast<double>(config_.maxBitrate));
+    }
+}
+
+uint32_t RtpRateController::FrameRateFor(uint32_t bitrate) const
+{
+    if (bitrate >= config_.lowBitrate || config_.lowBitrate <= config_.minBitrate) {
+        return config_.maxFrameRate;
+    }
+
+    double ratio = static_cast<double>(std::max(bitrate, config_.minBitrate) - config_.minBitrate) /
+                   (config_.lowBitrate - config_.minBitrate);
+    return config_.minFrameRate +
+           static_cast<uint32_t>(std::lround(ratio * (config_.maxFrameRate - config_.minFrameRate)));
+}
+} // namespace Sharing
+} // namespace OHOS
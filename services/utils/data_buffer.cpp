@@ -17,17 +17,18 @@
 #include <cstring>
 #include <unistd.h>
 #include <securec.h>
+#include "packet_pool.h"
 
 namespace OHOS {
 namespace Sharing {
 constexpr int32_t MAX_CAPACITY = 1000 * 1000 * 1000;
 
-DataBuffer::DataBuffer(int size)
+DataBuffer::DataBuffer(int size, bool pooled) : pooled_(pooled)
 {
     if (size <= 0 || size > MAX_CAPACITY) {
         return;
     }
-    data_ = new (std::nothrow) uint8_t[size + 1];
+    data_ = AllocData(size + 1, dataFromPool_);
     if (!data_) {
         return;
     }
@@ -36,19 +37,18 @@ DataBuffer::DataBuffer(int size)
     size_ = 0;
 }
 
-DataBuffer::DataBuffer(const DataBuffer &other) noexcept
+DataBuffer::DataBuffer(const DataBuffer &other) noexcept : pooled_(other.pooled_)
 {
     if (other.data_ && other.size_) {
         capacity_ = other.size_;
-        data_ = new (std::nothrow) uint8_t[capacity_ + 1];
+        data_ = AllocData(capacity_ + 1, dataFromPool_);
         if (!data_) {
             capacity_ = 0;
             return;
         }
         auto ret = memcpy_s(data_, capacity_ + 1, other.data_, other.size_);
         if (ret != EOK) {
-            delete[] data_;
-            data_ = nullptr;
+            FreeData();
             capacity_ = 0;
             return;
         }
@@ -60,17 +60,19 @@ DataBuffer &DataBuffer::operator=(const DataBuffer &other) noexcept
 {
     if (this != &other) {
         if (other.data_ && other.size_) {
-            auto newData = new (std::nothrow) uint8_t[other.size_ + 1];
+            bool fromPool = false;
+            auto newData = AllocData(other.size_ + 1, fromPool);
             if (!newData) {
                 return *this;
             }
             auto ret = memcpy_s(newData, other.size_ + 1, other.data_, other.size_);
             if (ret != EOK) {
-                delete[] newData;
+                ReleaseData(newData, fromPool);
                 return *this;
             }
-            delete[] data_;
+            FreeData();
             data_ = newData;
+            dataFromPool_ = fromPool;
             capacity_ = other.size_;
             size_ = other.size_;
         }
@@ -81,10 +83,13 @@ DataBuffer &DataBuffer::operator=(const DataBuffer &other) noexcept
 
 DataBuffer::DataBuffer(DataBuffer &&other) noexcept
 {
+    pooled_ = other.pooled_;
+    dataFromPool_ = other.dataFromPool_;
     data_ = other.data_;
     size_ = other.size_;
     capacity_ = other.capacity_;
     other.data_ = nullptr;
+    other.dataFromPool_ = false;
     other.size_ = 0;
     other.capacity_ = 0;
 }
@@ -92,13 +97,14 @@ DataBuffer::DataBuffer(DataBuffer &&other) noexcept
 DataBuffer &DataBuffer::operator=(DataBuffer &&other) noexcept
 {
     if (this != &other) {
-        if (data_) {
-            delete[] data_;
-        }
+        FreeData();
+        pooled_ = other.pooled_;
+        dataFromPool_ = other.dataFromPool_;
         data_ = other.data_;
         size_ = other.size_;
         capacity_ = other.capacity_;
         other.data_ = nullptr;
+        other.dataFromPool_ = false;
         other.size_ = 0;
         other.capacity_ = 0;
     }
@@ -108,7 +114,7 @@ DataBuffer &DataBuffer::operator=(DataBuffer &&other) noexcept
 
 DataBuffer::~DataBuffer()
 {
-    delete[] data_;
+    FreeData();
     capacity_ = 0;
     size_ = 0;
 }
@@ -120,28 +126,25 @@ void DataBuffer::Resize(int size)
     }
 
     if (size > capacity_) {
-        auto data2 = new (std::nothrow) uint8_t[size];
+        bool fromPool = false;
+        auto data2 = AllocData(size, fromPool);
         if (!data2) {
             return;
         }
         if (data_ && size_ > 0) {
             auto ret = memcpy_s(data2, size, data_, size_);
             if (ret != EOK) {
-                delete[] data2;
+                ReleaseData(data2, fromPool);
                 return;
             }
         }
-        if (data_) {
-            delete[] data_;
-            data_ = nullptr;
-        }
+        FreeData();
         data_ = data2;
+        dataFromPool_ = fromPool;
         capacity_ = size;
     } else if (size < capacity_) {
-        if (data_) {
-            delete[] data_;
-        }
-        data_ = new (std::nothrow) uint8_t[size];
+        FreeData();
+        data_ = AllocData(size, dataFromPool_);
         if (!data_) {
             capacity_ = 0;
             return;
@@ -165,24 +168,26 @@ void DataBuffer::PushData(const char *data, int dataLen)
         size_ += dataLen;
     } else {
         capacity_ = size_ + dataLen;
-        auto newBuffer = new (std::nothrow) uint8_t[capacity_];
+        bool fromPool = false;
+        auto newBuffer = AllocData(capacity_, fromPool);
         if (!newBuffer) {
             return;
         }
         if (data_) {
             auto ret = memcpy_s(newBuffer, capacity_, data_, size_);
             if (ret != EOK) {
-                delete[] newBuffer;
+                ReleaseData(newBuffer, fromPool);
                 return;
             }
         }
         auto ret = memcpy_s(newBuffer + size_, capacity_ - size_, data, dataLen);
         if (ret != EOK) {
-            delete[] newBuffer;
+            ReleaseData(newBuffer, fromPool);
             return;
         }
-        delete[] data_;
+        FreeData();
         data_ = newBuffer;
+        dataFromPool_ = fromPool;
         size_ = capacity_;
     }
 }
@@ -194,10 +199,9 @@ void DataBuffer::ReplaceData(const char *data, int dataLen)
     }
 
     if (dataLen > capacity_) {
-        if (data_)
-            delete[] data_;
+        FreeData();
         capacity_ = dataLen;
-        data_ = new (std::nothrow) uint8_t[capacity_];
+        data_ = AllocData(capacity_, dataFromPool_);
         if (!data_) {
             capacity_ = 0;
             return;
@@ -217,12 +221,8 @@ void DataBuffer::SetCapacity(int capacity)
         return;
     }
 
-    if (data_) {
-        delete[] data_;
-        data_ = nullptr;
-    }
-    
-    data_ = new (std::nothrow) uint8_t[capacity];
+    FreeData();
+    data_ = AllocData(capacity, dataFromPool_);
     if (!data_) {
         capacity_ = 0;
         size_ = 0;
@@ -232,5 +232,40 @@ void DataBuffer::SetCapacity(int capacity)
     size_ = 0;
 }
 
+DataBuffer::Ptr DataBuffer::CreatePooled(int32_t size)
+{
+    return std::allocate_shared<DataBuffer>(PacketObjectAllocator<DataBuffer>(), size, true);
+}
+
+uint8_t *DataBuffer::AllocData(int32_t size, bool &fromPool)
+{
+    fromPool = pooled_ && size > 0 && static_cast<size_t>(size) <= PacketPool::BlockSize();
+    if (fromPool) {
+        return static_cast<uint8_t *>(PacketPool::Allocate());
+    }
+
+    return new (std::nothrow) uint8_t[size];
+}
+
+void DataBuffer::ReleaseData(uint8_t *data, bool fromPool)
+{
+    if (fromPool) {
+        PacketPool::Free(data);
+    } else {
+        delete[] data;
+    }
+}
+
+void DataBuffer::FreeData()
+{
+    if (data_ == nullptr) {
+        return;
+    }
+
+    ReleaseData(data_, dataFromPool_);
+    data_ = nullptr;
+    dataFromPool_ = false;
+}
+
 } // namespace Sharing
 } // namespace OHOS
\ No newline at end of file
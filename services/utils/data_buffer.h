@@ -28,7 +28,11 @@ public:
     using Ptr = std::shared_ptr<DataBuffer>;
 
     DataBuffer() = default;
-    explicit DataBuffer(int32_t size);
+    // pooled: storage up to PacketPool::BlockSize() comes from the packet pool
+    explicit DataBuffer(int32_t size, bool pooled = false);
+
+    // object and storage both drawn from the packet pools
+    static Ptr CreatePooled(int32_t size);
 
     DataBuffer(const DataBuffer &other) noexcept;
     DataBuffer &operator=(const DataBuffer &other) noexcept;
@@ -59,9 +63,10 @@ public:
         }
     }
 
+    // follows Data() so buffers that reference foreign memory peek correctly
     const char *Peek() const
     {
-        return (char *)data_;
+        return (char *)const_cast<DataBuffer *>(this)->Data();
     }
 
     void SetSize(int32_t size)
@@ -74,11 +79,7 @@ public:
 
     virtual void Clear()
     {
-        if (data_) {
-            delete[] data_;
-            data_ = nullptr;
-        }
-
+        FreeData();
         size_ = 0;
         capacity_ = 0;
     }
@@ -114,7 +115,20 @@ public:
     void PushData(const char *data, int32_t dataLen);
     void ReplaceData(const char *data, int32_t dataLen);
 
+protected:
+    void UsePool()
+    {
+        pooled_ = true;
+    }
+
+private:
+    uint8_t *AllocData(int32_t size, bool &fromPool);
+    void FreeData();
+    static void ReleaseData(uint8_t *data, bool fromPool);
+
 private:
+    bool pooled_ = false;
+    bool dataFromPool_ = false;
     int32_t size_ = 0;
     int32_t capacity_ = 0;
     uint8_t *data_ = nullptr;
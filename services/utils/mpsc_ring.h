@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_MPSC_RING_H
+#define OHOS_SHARING_MPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace OHOS {
+namespace Sharing {
+
+/*
+ * Fixed-capacity multi-producer/single-consumer queue of values.
+ *
+ * Every slot carries a sequence stamp telling whose turn it is: a producer
+ * claims position p with one compare-exchange on the tail once the stamp of
+ * slot (p % capacity) reads p, writes the value and stamps p + 1; the consumer
+ * takes it when the stamp reads p + 1 and hands the slot to the next lap by
+ * stamping p + capacity. Producers never wait for each other beyond the
+ * compare-exchange and never take a lock, a full queue makes try_push fail.
+ *
+ * Only one thread at a time may call try_pop.
+ */
+template <class T>
+class mpsc_ring {
+public:
+    explicit mpsc_ring(size_t capacity) : slots_(capacity > 0 ? capacity : 1)
+    {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~mpsc_ring() = default;
+
+    mpsc_ring(const mpsc_ring &) = delete;
+    mpsc_ring &operator=(const mpsc_ring &) = delete;
+
+public:
+    // producer side, lock free
+    template <class U>
+    bool try_push(U &&item)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        Slot *slot = nullptr;
+        for (;;) {
+            slot = &slots_[pos % slots_.size()];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // the consumer has not taken the value of the previous lap yet
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->item = std::forward<U>(item);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+public:
+    // consumer side
+    bool try_pop(T &item)
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        Slot &slot = slots_[pos % slots_.size()];
+        if (slot.seq.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+
+        item = std::move(slot.item);
+        // the moved-from value may still hold resources, the slot waits a whole lap
+        slot.item = T();
+        slot.seq.store(pos + slots_.size(), std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // no value is ready at the head, a producer may be half way through a push
+    bool empty() const
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        return slots_[pos % slots_.size()].seq.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    // claimed positions not taken yet, a snapshot while producers run
+    size_t size() const
+    {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    size_t capacity() const
+    {
+        return slots_.size();
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> seq{0};
+        T item{};
+    };
+
+    std::vector<Slot> slots_;
+    // 64: cache line, producers hammer the tail while the consumer moves the head
+    alignas(64) std::atomic<size_t> tail_ = 0;
+    alignas(64) std::atomic<size_t> head_ = 0;
+};
+
+} // namespace Sharing
+} // namespace OHOS
+#endif
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_PACKET_POOL_H
+#define OHOS_SHARING_PACKET_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace OHOS {
+namespace Sharing {
+
+struct PoolStats {
+    uint64_t hits = 0;     // served from a free list
+    uint64_t misses = 0;   // had to go to the heap
+    uint64_t recycled = 0; // returned to a free list
+    uint64_t released = 0; // returned to the heap, free lists full
+};
+
+/*
+ * Fixed-size block allocator with a per-thread cache in front of a shared free
+ * list. Every thread keeps up to CACHE_BLOCKS blocks of its own and trades them
+ * with the shared list in batches, so the steady state of a send or receive
+ * loop never takes the lock nor calls malloc. At most MAX_FREE_BLOCKS idle
+ * blocks are kept in the shared list, the rest go back to the heap.
+ *
+ * Blocks freed on another thread than the one that allocated them are fine,
+ * they land in the cache of the freeing thread.
+ */
+template <size_t BLOCK_SIZE, size_t MAX_FREE_BLOCKS>
+class BlockPool {
+public:
+    static constexpr size_t CACHE_BLOCKS = 64;
+    static constexpr size_t BATCH_BLOCKS = CACHE_BLOCKS / 2;
+
+    static constexpr size_t BlockSize()
+    {
+        return BLOCK_SIZE;
+    }
+
+    static void *Allocate()
+    {
+        Cache &cache = LocalCache();
+        if (cache.blocks.empty()) {
+            Shared &shared = GetShared();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            size_t count = shared.blocks.size() < BATCH_BLOCKS ? shared.blocks.size() : BATCH_BLOCKS;
+            cache.blocks.insert(cache.blocks.end(), shared.blocks.end() - count, shared.blocks.end());
+            shared.blocks.resize(shared.blocks.size() - count);
+        }
+
+        if (!cache.blocks.empty()) {
+            void *block = cache.blocks.back();
+            cache.blocks.pop_back();
+            GetShared().hits.fetch_add(1, std::memory_order_relaxed);
+            return block;
+        }
+
+        GetShared().misses.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(BLOCK_SIZE, std::nothrow);
+    }
+
+    static void Free(void *block)
+    {
+        if (block == nullptr) {
+            return;
+        }
+
+        Cache &cache = LocalCache();
+        if (cache.blocks.size() >= CACHE_BLOCKS) {
+            Spill(cache.blocks, BATCH_BLOCKS);
+        }
+        cache.blocks.push_back(block);
+        GetShared().recycled.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static PoolStats GetStats()
+    {
+        Shared &shared = GetShared();
+        PoolStats stats;
+        stats.hits = shared.hits.load(std::memory_order_relaxed);
+        stats.misses = shared.misses.load(std::memory_order_relaxed);
+        stats.recycled = shared.recycled.load(std::memory_order_relaxed);
+        stats.released = shared.released.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    struct Shared {
+        std::mutex mutex;
+        std::vector<void *> blocks;
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> recycled{0};
+        std::atomic<uint64_t> released{0};
+
+        ~Shared()
+        {
+            for (auto block : blocks) {
+                ::operator delete(block);
+            }
+        }
+    };
+
+    struct Cache {
+        std::vector<void *> blocks;
+
+        Cache()
+        {
+            // the shared list must outlive every cache that spills into it
+            GetShared();
+            blocks.reserve(CACHE_BLOCKS);
+        }
+
+        ~Cache()
+        {
+            Spill(blocks, blocks.size());
+        }
+    };
+
+    static Shared &GetShared()
+    {
+        static Shared shared;
+        return shared;
+    }
+
+    static Cache &LocalCache()
+    {
+        static thread_local Cache cache;
+        return cache;
+    }
+
+    // moves the last count blocks of a thread cache to the shared list
+    static void Spill(std::vector<void *> &blocks, size_t count)
+    {
+        Shared &shared = GetShared();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (size_t i = 0; i < count; i++) {
+            void *block = blocks.back();
+            blocks.pop_back();
+            if (shared.blocks.size() < MAX_FREE_BLOCKS) {
+                shared.blocks.push_back(block);
+            } else {
+                shared.released.fetch_add(1, std::memory_order_relaxed);
+                ::operator delete(block);
+            }
+        }
+    }
+};
+
+// payload storage of datagrams and rtp packets, 2048 covers an ethernet mtu
+using PacketPool = BlockPool<2048, 1024>;
+// shared_ptr control block plus the RtpPacket/DataBuffer object itself
+using PacketObjectPool = BlockPool<128, 1024>;
+
+/*
+ * Stateless allocator for std::allocate_shared, object and reference count
+ * share one PacketObjectPool block. Larger requests fall back to the heap.
+ */
+template <typename T>
+class PacketObjectAllocator {
+public:
+    using value_type = T;
+
+    PacketObjectAllocator() = default;
+    template <typename U>
+    PacketObjectAllocator(const PacketObjectAllocator<U> &) noexcept
+    {
+    }
+
+    T *allocate(size_t n)
+    {
+        if (n * sizeof(T) <= PacketObjectPool::BlockSize()) {
+            void *block = PacketObjectPool::Allocate();
+            // keeps the block size so that it can be recycled as any other
+            return static_cast<T *>(block ? block : ::operator new(PacketObjectPool::BlockSize()));
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t n) noexcept
+    {
+        if (n * sizeof(T) <= PacketObjectPool::BlockSize()) {
+            PacketObjectPool::Free(ptr);
+            return;
+        }
+        ::operator delete(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const PacketObjectAllocator<U> &) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PacketObjectAllocator<U> &) const noexcept
+    {
+        return false;
+    }
+};
+
+} // namespace Sharing
+} // namespace OHOS
+#endif
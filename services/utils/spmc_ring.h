@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_SPMC_RING_H
+#define OHOS_SHARING_SPMC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace OHOS {
+namespace Sharing {
+
+/*
+ * Fixed-capacity single-producer/multi-consumer ring of shared objects.
+ *
+ * Every element is addressed by a monotonically increasing 32-bit sequence,
+ * the slot is (sequence & mask). Only one writer may call the mutating
+ * methods at a time (callers serialize writers themselves); readers use
+ * load()/contains()/begin_index()/end_index() without any lock. A slot is
+ * published with a per-slot sequence stamp so that a reader racing with the
+ * writer either sees the element it asked for or nullptr, never a recycled one.
+ *
+ * The logical capacity (set_capacity) may change at runtime but is bounded by
+ * the physical slot count chosen at construction.
+ */
+template <class T>
+class spmc_ring {
+public:
+    using Ptr = std::shared_ptr<T>;
+    static constexpr uint32_t INVALID_SEQ = static_cast<uint32_t>(-1);
+
+    explicit spmc_ring(size_t maxCapacity) : slots_(RoundUpPowerOfTwo(maxCapacity))
+    {
+        mask_ = static_cast<uint32_t>(slots_.size() - 1);
+        capacity_ = slots_.size();
+    }
+
+    ~spmc_ring() = default;
+
+    spmc_ring(const spmc_ring &) = delete;
+    spmc_ring &operator=(const spmc_ring &) = delete;
+
+    class Iterator {
+    public:
+        Iterator(spmc_ring *ring, uint32_t seq) : ring_(ring), seq_(seq) {}
+
+        Ptr &operator*()
+        {
+            return ring_->slots_[seq_ & ring_->mask_].item;
+        }
+
+        Iterator &operator++()
+        {
+            ++seq_;
+            return *this;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return seq_ != other.seq_;
+        }
+
+    private:
+        spmc_ring *ring_ = nullptr;
+        uint32_t seq_ = 0;
+    };
+
+public:
+    // writer side
+    void push_back(Ptr item)
+    {
+        if (size() >= capacity()) {
+            pop_front();
+        }
+
+        uint32_t seq = tail_.load(std::memory_order_relaxed);
+        Slot &slot = slots_[seq & mask_];
+        slot.seq.store(INVALID_SEQ, std::memory_order_relaxed);
+        std::atomic_store_explicit(&slot.item, std::move(item), std::memory_order_release);
+        slot.seq.store(seq, std::memory_order_release);
+        tail_.store(seq + 1, std::memory_order_release);
+    }
+
+    void pop_front()
+    {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        Slot &slot = slots_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        slot.seq.store(INVALID_SEQ, std::memory_order_release);
+        std::atomic_store_explicit(&slot.item, Ptr(nullptr), std::memory_order_release);
+    }
+
+    // drops every element by advancing the read floor to the write head, sequences keep increasing so a
+    // reader still holding an old index sees it as evicted instead of as a future slot.
+    void clear()
+    {
+        while (!empty()) {
+            pop_front();
+        }
+    }
+
+    void set_capacity(size_t newCapacity)
+    {
+        capacity_ = newCapacity < slots_.size() ? newCapacity : slots_.size();
+    }
+
+    Ptr &at(size_t pos)
+    {
+        return slots_[(head_.load(std::memory_order_relaxed) + pos) & mask_].item;
+    }
+
+    Ptr &operator[](size_t pos)
+    {
+        return at(pos);
+    }
+
+    Ptr &front()
+    {
+        return at(0);
+    }
+
+    Ptr &back()
+    {
+        return slots_[(tail_.load(std::memory_order_relaxed) - 1) & mask_].item;
+    }
+
+    Iterator begin()
+    {
+        return Iterator(this, head_.load(std::memory_order_relaxed));
+    }
+
+    Iterator end()
+    {
+        return Iterator(this, tail_.load(std::memory_order_relaxed));
+    }
+
+public:
+    // reader side, lock free
+    Ptr load(uint32_t seq) const
+    {
+        if (!contains(seq)) {
+            return nullptr;
+        }
+
+        const Slot &slot = slots_[seq & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != seq) {
+            return nullptr;
+        }
+
+        Ptr item = std::atomic_load_explicit(&slot.item, std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_acquire) != seq) {
+            return nullptr;
+        }
+
+        return item;
+    }
+
+    bool contains(uint32_t seq) const
+    {
+        uint32_t head = head_.load(std::memory_order_acquire);
+        uint32_t tail = tail_.load(std::memory_order_acquire);
+        return seq - head < tail - head;
+    }
+
+    // sequence of the oldest element
+    uint32_t begin_index() const
+    {
+        return head_.load(std::memory_order_acquire);
+    }
+
+    // sequence the next element will get
+    uint32_t end_index() const
+    {
+        return tail_.load(std::memory_order_acquire);
+    }
+
+    // sequence of the newest element, INVALID_SEQ when empty
+    uint32_t back_index() const
+    {
+        return empty() ? INVALID_SEQ : end_index() - 1;
+    }
+
+    size_t size() const
+    {
+        uint32_t head = head_.load(std::memory_order_acquire);
+        uint32_t tail = tail_.load(std::memory_order_acquire);
+        // head is loaded first, so a concurrent push/pop never makes it pass tail.
+        return tail - head <= slots_.size() ? tail - head : 0;
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    size_t max_capacity() const
+    {
+        return slots_.size();
+    }
+
+    size_t reserve() const
+    {
+        return capacity() > size() ? capacity() - size() : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    bool full() const
+    {
+        return size() >= capacity();
+    }
+
+private:
+    static size_t RoundUpPowerOfTwo(size_t value)
+    {
+        size_t slots = 1;
+        while (slots < value) {
+            slots <<= 1;
+        }
+        return slots;
+    }
+
+    struct Slot {
+        std::atomic<uint32_t> seq{INVALID_SEQ};
+        Ptr item = nullptr;
+    };
+
+    std::vector<Slot> slots_;
+    uint32_t mask_ = 0;
+    std::atomic<size_t> capacity_ = 0;
+    std::atomic<uint32_t> head_ = 0;
+    std::atomic<uint32_t> tail_ = 0;
+};
+
+} // namespace Sharing
+} // namespace OHOS
+#endif
@@ -14,116 +14,40 @@
  */
 
 #include "timeout_timer.h"
-#include <chrono>
-#include <condition_variable>
-#include <cstdio>
-#include <cstring>
-#include <sys/time.h>
+#include <algorithm>
 #include "common/media_log.h"
+
 namespace OHOS {
 namespace Sharing {
+constexpr uint32_t MS_PER_SECOND = 1000;
 
-#define TIMER_TIMEOUT 2
-TimeoutTimer::TimeoutTimer(std::string info)
+TimeoutTimer::TimeoutTimer(std::string info) : name_(std::move(info))
 {
     SHARING_LOGD("trace.");
-    thread_ = std::make_unique<std::thread>(&TimeoutTimer::MainLoop, this);
-    pthread_setname_np(thread_->native_handle(), info.c_str());
 }
 
 TimeoutTimer::~TimeoutTimer()
 {
-    SHARING_LOGD("dtor in %{public}d.", state_);
-    {
-        std::unique_lock<std::mutex> taskLock(taskMutex_);
-        if (state_ == State::WAITING) {
-            state_ = State::EXITED;
-            taskSignal_.notify_all();
-        } else if (state_ == State::WORKING) {
-            state_ = State::EXITED;
-            cancelSignal_.notify_all();
-        } else {
-            state_ = State::EXITED;
-        }
-    }
-
-    SHARING_LOGD("thread join %{public}d.", state_);
-    if (thread_->joinable()) {
-        thread_->join();
-    }
-    SHARING_LOGD("dtor out %{public}d.", state_);
+    // timer_ stops itself and waits for a running callback, it may use the owner
+    SHARING_LOGD("dtor %{public}s.", name_.c_str());
 }
 
 void TimeoutTimer::StartTimer(int timeout, std::string info, std::function<void()> callback, bool reuse)
 {
-    SHARING_LOGD("add timeout timer (%{public}s).", info.c_str());
-    std::lock_guard<std::mutex> lock(taskMutex_);
-    reuse_ = reuse;
-    timeout_ = timeout;
-    if (state_ == State::WORKING) {
-        SHARING_LOGD("cancel timeout timer (%{public}s).", taskName_.c_str());
-        state_ = State::CANCELLED;
-        cancelSignal_.notify_all();
-
-        std::unique_lock<std::mutex> waitLock(waitMutex_);
-        waitSignal_.wait_for(waitLock, std::chrono::milliseconds(TIMER_TIMEOUT));
-    }
-    taskName_ = std::move(info);
-    if (callback) {
-        callback_ = std::move(callback);
-    }
-    taskSignal_.notify_all();
-    SHARING_LOGD("start timeout timer leave.");
+    SHARING_LOGI("start timeout timer(%{public}s) %{public}ds.", info.c_str(), timeout);
+    uint32_t timeoutMs = static_cast<uint32_t>(std::max(timeout, 0)) * MS_PER_SECOND;
+    TimerWheel::GetInstance().Start(timer_, timeoutMs, reuse ? timeoutMs : 0, std::move(callback));
 }
 
 void TimeoutTimer::StopTimer()
 {
-    SHARING_LOGD("cancel timeout timer (%{public}s).", taskName_.c_str());
-    std::lock_guard<std::mutex> lock(taskMutex_);
-
-    if (state_ == State::WORKING) {
-        state_ = State::CANCELLED;
-        cancelSignal_.notify_all();
-        std::unique_lock<std::mutex> waitLock(waitMutex_);
-        waitSignal_.wait_for(waitLock, std::chrono::milliseconds(TIMER_TIMEOUT));
-    }
-    SHARING_LOGD("cancel timeout timer (%{public}s) leave.", taskName_.c_str());
-}
-
-void TimeoutTimer::MainLoop()
-{
-    SHARING_LOGD("trace.");
-    while (state_ != State::EXITED) {
-        std::unique_lock<std::mutex> taskLock(taskMutex_);
-        if (state_ == State::EXITED) {
-            break;
-        }
-
-        state_ = State::WAITING;
-        waitSignal_.notify_all();
-        if (!reuse_) {
-            taskSignal_.wait(taskLock);
-        }
-    
-        if (state_ == State::EXITED) {
-            break;
-        }
-
-        state_ = State::WORKING;
-        SHARING_LOGI("start timeout timer(%{public}s).", taskName_.c_str());
-        cancelSignal_.wait_for(taskLock, std::chrono::seconds(timeout_));
-        if (state_ == State::WORKING && callback_) {
-            SHARING_LOGI("invoke timeout timer(%{public}s) callback.", taskName_.c_str());
-            callback_();
-        }
-        SHARING_LOGI("end timeout timer(%{public}s).", taskName_.c_str());
-    }
-    SHARING_LOGD("exit.");
+    SHARING_LOGD("cancel timeout timer(%{public}s).", name_.c_str());
+    TimerWheel::GetInstance().Stop(timer_);
 }
 
 void TimeoutTimer::SetTimeoutCallback(std::function<void()> callback)
 {
-    callback_ = std::move(callback);
+    TimerWheel::GetInstance().SetCallback(timer_, std::move(callback));
 }
 } // namespace Sharing
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS
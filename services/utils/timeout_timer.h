@@ -17,13 +17,14 @@
 #define OHOS_SHARING_TIMEOUT_TIMER_CPP
 
 #include <functional>
-#include <future>
 #include <memory>
-#include <thread>
+#include <string>
 #include <utility>
+#include "timer_wheel.h"
 
 namespace OHOS {
 namespace Sharing {
+// a one shot or repeating timeout in seconds, a timer of the shared TimerWheel
 class TimeoutTimer {
 public:
     explicit TimeoutTimer(std::string info = "TimeoutTimer");
@@ -31,31 +32,13 @@ public:
 
     void StopTimer();
     void SetTimeoutCallback(std::function<void()> callback);
+    // reuse: fires every timeout seconds until stopped
     void StartTimer(int timeout, std::string info = "none", std::function<void()> callback = nullptr,
         bool reuse = false);
 
 private:
-    void MainLoop();
-
-private:
-    enum State { INIT, WAITING, WORKING, CANCELLED, EXITED };
-
-    bool reuse_ = false;
-
-    int timeout_ = 0;
-
-    std::string taskName_;
-    std::mutex taskMutex_;
-    std::mutex waitMutex_;
-    std::mutex cancelMutex_;
-    std::mutex operateMutex_;
-    std::function<void()> callback_;
-    std::condition_variable taskSignal_;
-    std::condition_variable waitSignal_;
-    std::condition_variable cancelSignal_;
-    std::unique_ptr<std::thread> thread_;
-
-    State state_ = INIT;
+    std::string name_;
+    TimerWheel::Timer timer_;
 };
 } // namespace Sharing
 } // namespace OHOS
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "timer_wheel.h"
+#include <algorithm>
+#include <chrono>
+#include "common/media_log.h"
+
+namespace OHOS {
+namespace Sharing {
+constexpr uint64_t NO_WAKE_TICK = UINT64_MAX;
+
+TimerWheel::Timer::~Timer()
+{
+    TimerWheel::GetInstance().Stop(*this, false);
+}
+
+TimerWheel::TimerWheel()
+{
+    SHARING_LOGD("trace.");
+    currentTick_ = NowTick();
+    wakeTick_ = NO_WAKE_TICK;
+    thread_ = std::make_unique<std::thread>(&TimerWheel::MainLoop, this);
+    driverId_ = thread_->get_id();
+    pthread_setname_np(thread_->native_handle(), "timerwheel");
+}
+
+TimerWheel::~TimerWheel()
+{
+    SHARING_LOGD("trace.");
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        isRunning_ = false;
+        wakeup_.notify_all();
+    }
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+}
+
+uint64_t TimerWheel::NowMs()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::ceil<std::chrono::milliseconds>(now).count());
+}
+
+uint64_t TimerWheel::NowTick()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now).count()) / TICK_MS;
+}
+
+void TimerWheel::Link(Node &head, Timer &timer)
+{
+    timer.prev_ = head.prev_;
+    timer.next_ = &head;
+    head.prev_->next_ = &timer;
+    head.prev_ = &timer;
+}
+
+void TimerWheel::Unlink(Timer &timer)
+{
+    timer.prev_->next_ = timer.next_;
+    timer.next_->prev_ = timer.prev_;
+    timer.prev_ = nullptr;
+    timer.next_ = nullptr;
+}
+
+void TimerWheel::Start(Timer &timer, uint32_t delayMs, uint32_t periodMs, std::function<void()> callback)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (timer.next_ != nullptr) {
+        Unlink(timer);
+        --timerNum_;
+    }
+    if (callback) {
+        timer.callback_ = std::move(callback);
+    }
+
+    uint64_t nowMs = NowMs();
+    if (timerNum_ == 0) {
+        // every slot is empty, the driver may skip the ticks it slept through
+        currentTick_ = std::max(currentTick_, nowMs / TICK_MS);
+    }
+    // rounded up, a timer never fires early
+    timer.expire_ = (nowMs + delayMs + TICK_MS - 1) / TICK_MS;
+    timer.period_ = periodMs == 0 ? 0 : std::max<uint64_t>(1, (periodMs + TICK_MS - 1) / TICK_MS);
+    AddTimer(timer);
+    ++timerNum_;
+
+    if (timer.expire_ < wakeTick_) {
+        wakeup_.notify_one();
+    }
+}
+
+void TimerWheel::SetCallback(Timer &timer, std::function<void()> callback)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    timer.callback_ = std::move(callback);
+}
+
+void TimerWheel::Stop(Timer &timer)
+{
+    Stop(timer, true);
+}
+
+void TimerWheel::Stop(Timer &timer, bool bounded)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (timer.next_ != nullptr) {
+        Unlink(timer);
+        --timerNum_;
+    }
+    // from its own callback it would wait for itself
+    if (std::this_thread::get_id() == driverId_) {
+        return;
+    }
+    auto done = [this, &timer]() { return runningTimer_ != &timer; };
+    if (!bounded) {
+        callbackDone_.wait(lock, done);
+    } else if (!callbackDone_.wait_for(lock, std::chrono::milliseconds(STOP_WAIT_MS), done)) {
+        SHARING_LOGW("timer callback still running, stop without waiting for it.");
+    }
+}
+
+bool TimerWheel::IsActive(const Timer &timer)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return timer.next_ != nullptr;
+}
+
+void TimerWheel::AddTimer(Timer &timer)
+{
+    // mutex_ held
+    uint64_t expire = std::max(timer.expire_, currentTick_);
+    uint64_t delta = std::min(expire - currentTick_, MAX_TICKS);
+    expire = currentTick_ + delta;
+    timer.expire_ = expire;
+
+    if (delta < LEVEL0_SLOTS) {
+        Link(level0_[expire & (LEVEL0_SLOTS - 1)].head, timer);
+        return;
+    }
+
+    for (uint32_t level = 1; level < LEVELS; ++level) {
+        uint32_t shift = LEVEL0_BITS + (level - 1) * LEVELN_BITS;
+        if (delta < (1ULL << (shift + LEVELN_BITS)) || level == LEVELS - 1) {
+            Link(levelN_[level - 1][(expire >> shift) & (LEVELN_SLOTS - 1)].head, timer);
+            return;
+        }
+    }
+}
+
+void TimerWheel::Cascade(uint32_t level, uint32_t index)
+{
+    // the timers of this slot are due within the lap of the level below that starts now
+    Node &head = levelN_[level][index].head;
+    while (head.next_ != &head) {
+        Timer &timer = static_cast<Timer &>(*head.next_);
+        Unlink(timer);
+        AddTimer(timer);
+    }
+}
+
+void TimerWheel::RunTick(std::unique_lock<std::mutex> &lock)
+{
+    uint64_t tick = currentTick_;
+    uint32_t index = tick & (LEVEL0_SLOTS - 1);
+    if (index == 0) {
+        for (uint32_t level = 0; level < LEVELS - 1; ++level) {
+            uint32_t levelIndex = (tick >> (LEVEL0_BITS + level * LEVELN_BITS)) & (LEVELN_SLOTS - 1);
+            Cascade(level, levelIndex);
+            if (levelIndex != 0) {
+                break;
+            }
+        }
+    }
+    currentTick_ = tick + 1;
+
+    // moved out, so a periodic timer added back to this slot waits for the next lap
+    Node expired;
+    Node &head = level0_[index].head;
+    if (head.next_ == &head) {
+        return;
+    }
+    expired.next_ = head.next_;
+    expired.prev_ = head.prev_;
+    expired.next_->prev_ = &expired;
+    expired.prev_->next_ = &expired;
+    head.next_ = &head;
+    head.prev_ = &head;
+
+    while (expired.next_ != &expired) {
+        Timer &timer = static_cast<Timer &>(*expired.next_);
+        Unlink(timer);
+        --timerNum_;
+        if (timer.period_ > 0) {
+            timer.expire_ = tick + timer.period_;
+            AddTimer(timer);
+            ++timerNum_;
+        }
+        if (!timer.callback_) {
+            continue;
+        }
+
+        auto callback = timer.callback_;
+        runningTimer_ = &timer;
+        lock.unlock();
+        callback();
+        lock.lock();
+        runningTimer_ = nullptr;
+        callbackDone_.notify_all();
+    }
+}
+
+uint64_t TimerWheel::NextWakeTick() const
+{
+    if (timerNum_ == 0) {
+        return NO_WAKE_TICK;
+    }
+    for (uint64_t tick = currentTick_; tick < currentTick_ + LEVEL0_SLOTS; ++tick) {
+        uint32_t index = tick & (LEVEL0_SLOTS - 1);
+        // the upper levels cascade at the start of a lap
+        if (index == 0 && tick != currentTick_) {
+            return tick;
+        }
+        const Node &head = level0_[index].head;
+        if (head.next_ != &head) {
+            return tick;
+        }
+    }
+    return currentTick_ + LEVEL0_SLOTS;
+}
+
+void TimerWheel::MainLoop()
+{
+    SHARING_LOGD("trace.");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (isRunning_) {
+        uint64_t now = NowTick();
+        while (currentTick_ <= now && isRunning_) {
+            if (timerNum_ == 0) {
+                currentTick_ = now + 1;
+                break;
+            }
+            RunTick(lock);
+        }
+
+        wakeTick_ = NextWakeTick();
+        if (wakeTick_ == NO_WAKE_TICK) {
+            wakeup_.wait(lock);
+        } else if (wakeTick_ > NowTick()) {
+            auto wakeTime = std::chrono::steady_clock::time_point(std::chrono::milliseconds(wakeTick_ * TICK_MS));
+            wakeup_.wait_until(lock, wakeTime);
+        }
+        wakeTick_ = NO_WAKE_TICK;
+    }
+    SHARING_LOGD("exit.");
+}
+
+} // namespace Sharing
+} // namespace OHOS
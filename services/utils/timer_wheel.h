@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_SHARING_TIMER_WHEEL_H
+#define OHOS_SHARING_TIMER_WHEEL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "singleton.h"
+
+namespace OHOS {
+namespace Sharing {
+
+/**
+ * Hierarchical timer wheel shared by every timer of the process. One driver
+ * thread sleeps until the next slot that holds a timer and runs the expired
+ * callbacks, so a timer is a small node linked into a slot: starting and
+ * stopping it unlinks and links that node in constant time.
+ *
+ * Level 0 has one slot per TICK_MS, the upper levels one slot per lap of the
+ * level below; timers due later than the last level reaches are clamped.
+ * Callbacks of all timers run one after another on the driver thread without
+ * the wheel lock held and must not block. Stop waits a little for a callback
+ * of its timer that is running, ~Timer until it is done.
+ */
+class TimerWheel : public Singleton<TimerWheel> {
+    friend class Singleton<TimerWheel>;
+
+private:
+    // links of a circular slot list, unlinked: both nullptr
+    struct Node {
+        Node *prev_ = nullptr;
+        Node *next_ = nullptr;
+    };
+
+public:
+    static constexpr uint32_t TICK_MS = 10;
+
+    // owned by the caller, must be stopped before it goes, ~Timer does it
+    class Timer : private Node {
+    public:
+        Timer() = default;
+        ~Timer();
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+    private:
+        friend class TimerWheel;
+
+        uint64_t expire_ = 0; // tick
+        uint64_t period_ = 0; // ticks, 0: one shot
+        std::function<void()> callback_ = nullptr;
+    };
+
+    TimerWheel();
+    ~TimerWheel();
+
+    // restarts a running timer; callback nullptr keeps the one set before; periodMs 0: fires once
+    void Start(Timer &timer, uint32_t delayMs, uint32_t periodMs = 0, std::function<void()> callback = nullptr);
+    void SetCallback(Timer &timer, std::function<void()> callback);
+    // no effect on a timer that is not started; a running callback is waited for at most STOP_WAIT_MS, a caller
+    // holding a lock the callback takes must not hang on it
+    void Stop(Timer &timer);
+    bool IsActive(const Timer &timer);
+
+private:
+    static constexpr uint32_t LEVEL0_BITS = 8;
+    static constexpr uint32_t LEVELN_BITS = 6;
+    static constexpr uint32_t LEVELS = 4;
+    static constexpr uint32_t LEVEL0_SLOTS = 1 << LEVEL0_BITS;
+    static constexpr uint32_t LEVELN_SLOTS = 1 << LEVELN_BITS;
+    static constexpr uint64_t MAX_TICKS = (1ULL << (LEVEL0_BITS + (LEVELS - 1) * LEVELN_BITS)) - 1;
+    static constexpr uint32_t STOP_WAIT_MS = 2; // 2: what StopTimer waited for the thread of a TimeoutTimer
+
+    struct Slot {
+        Slot()
+        {
+            head.prev_ = &head;
+            head.next_ = &head;
+        }
+        Node head;
+    };
+
+    static uint64_t NowMs(); // rounded up
+    static uint64_t NowTick();
+    static void Link(Node &head, Timer &timer);
+    static void Unlink(Timer &timer);
+
+    // bounded: Stop, otherwise ~Timer, the node must not go while its callback runs
+    void Stop(Timer &timer, bool bounded);
+    void AddTimer(Timer &timer);
+    void Cascade(uint32_t level, uint32_t index);
+    void RunTick(std::unique_lock<std::mutex> &lock);
+    uint64_t NextWakeTick() const;
+    void MainLoop();
+
+private:
+    bool isRunning_ = true;
+    size_t timerNum_ = 0;
+    uint64_t currentTick_ = 0; // the next tick to run
+    uint64_t wakeTick_ = 0;    // the driver sleeps until this one
+    const Timer *runningTimer_ = nullptr;
+    std::thread::id driverId_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable callbackDone_;
+    std::unique_ptr<std::thread> thread_ = nullptr;
+
+    Slot level0_[LEVEL0_SLOTS];
+    Slot levelN_[LEVELS - 1][LEVELN_SLOTS];
+};
+
+} // namespace Sharing
+} // namespace OHOS
+#endif
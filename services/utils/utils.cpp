@@ -21,6 +21,7 @@
 #include <sstream>
 #include <sys/time.h>
 #include <thread>
+#include <time.h>
 #include "common/common_macro.h"
 #include "common/media_log.h"
 
@@ -192,6 +193,14 @@ uint64_t GetCurrentMillisecond()
     return tv.tv_sec * 1000 + tv.tv_usec / 1000; // 1000: time base conversion.
 }
 
+int64_t GetMonotonicMicrosecond()
+{
+    struct timespec ts {
+    };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000; // 1000000, 1000: time base conversion.
+}
+
 uint16_t SwapEndian16(uint16_t value)
 {
     return (value & 0xff00) >> 8 | (value & 0x00ff) << 8; // 8: swap endian
@@ -87,6 +87,8 @@ private:
 
 unsigned long long GetThreadId();
 uint64_t GetCurrentMillisecond();
+// CLOCK_MONOTONIC, for intervals and deadlines that must not follow wall clock changes
+int64_t GetMonotonicMicrosecond();
 
 std::string ChangeCase(const std::string &value, bool lowerCase);
 std::string Trim(std::string &&s, const std::string &chars = " \r\n\t");
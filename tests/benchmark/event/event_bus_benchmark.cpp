@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include "common/sharing_log.h"
+#include "event/event_manager.h"
+#include "event/taskpool.h"
+#include "magic_enum.hpp"
+
+namespace OHOS {
+namespace Sharing {
+namespace {
+constexpr int32_t POOL_THREADS = 30; // as EventManager::Init sets it
+
+// tells its producer the listener got it
+struct ProbeMsg : public EventMsg {
+    std::atomic<bool> delivered = false;
+};
+
+class ProbeListener : public EventListener {
+public:
+    int32_t OnEvent(SharingEvent &event) final
+    {
+        static_cast<ProbeMsg *>(event.eventMsg.get())->delivered.store(true, std::memory_order_release);
+        return 0;
+    }
+};
+
+// the event loop EventManager had before: one mutex for the queue and the listener map,
+// the event name formatted whether the log is on or not
+class LockedEventBus {
+public:
+    LockedEventBus()
+    {
+        pool_.Start(POOL_THREADS);
+        thread_ = std::thread(&LockedEventBus::ProcessEvent, this);
+    }
+
+    ~LockedEventBus()
+    {
+        {
+            std::unique_lock<std::mutex> locker(mutex_);
+            isRunning_ = false;
+            hasEvent_.notify_all();
+        }
+        thread_.join();
+        pool_.Stop();
+    }
+
+    void AddListener(std::shared_ptr<EventListener> listener)
+    {
+        std::unique_lock<std::mutex> locker(mutex_);
+        listeners_[listener->GetListenerClassType()].emplace_back(listener);
+    }
+
+    int32_t PushEvent(const SharingEvent &event)
+    {
+        SHARING_LOGI("push a async event, type: %{public}u %{public}s.", event.eventMsg->type,
+                     std::string(magic_enum::enum_name(event.eventMsg->type)).c_str());
+        std::unique_lock<std::mutex> locker(mutex_);
+        events_.emplace(event);
+        hasEvent_.notify_one();
+        return 0;
+    }
+
+private:
+    void ProcessEvent()
+    {
+        std::unique_lock<std::mutex> locker(mutex_);
+        while (isRunning_) {
+            if (events_.empty()) {
+                hasEvent_.wait(locker);
+                continue;
+            }
+            auto event = events_.front();
+            events_.pop();
+            auto it = listeners_.find(event.listenerType);
+            if (it == listeners_.end()) {
+                continue;
+            }
+            for (auto &listener : it->second) {
+                pool_.PushTask([listener, event]() mutable { listener->OnEvent(event); });
+            }
+        }
+    }
+
+private:
+    bool isRunning_ = true;
+    std::mutex mutex_;
+    std::condition_variable hasEvent_;
+    std::queue<SharingEvent> events_;
+    std::unordered_map<ClassType, std::list<std::shared_ptr<EventListener>>> listeners_;
+    std::thread thread_;
+    TaskPool pool_;
+};
+
+std::shared_ptr<EventListener> MakeListener()
+{
+    auto listener = std::make_shared<ProbeListener>();
+    listener->SetListenerClassType(CLASS_TYPE_SESSION);
+    return listener;
+}
+
+LockedEventBus &GetLockedBus()
+{
+    static LockedEventBus bus;
+    static bool added = (bus.AddListener(MakeListener()), true);
+    benchmark::DoNotOptimize(added);
+    return bus;
+}
+
+EventManager &GetEventManager()
+{
+    static bool started = []() {
+        EventManager::GetInstance().Init();
+        EventManager::GetInstance().StartEventLoop();
+        EventManager::GetInstance().AddListener(MakeListener());
+        return true;
+    }();
+    benchmark::DoNotOptimize(started);
+    return EventManager::GetInstance();
+}
+
+SharingEvent MakeProbe(std::shared_ptr<ProbeMsg> &msg)
+{
+    msg = std::make_shared<ProbeMsg>();
+    msg->type = EVENT_COMMON_BASE;
+    SharingEvent event;
+    event.eventMsg = msg;
+    event.emitterType = CLASS_TYPE_PRODUCER;
+    event.listenerType = CLASS_TYPE_SESSION;
+    return event;
+}
+
+void WaitDelivered(const ProbeMsg &msg)
+{
+    while (!msg.delivered.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+}
+
+// push to OnEvent latency, every benchmark thread is a producer with one event in flight
+template <typename Bus>
+void DispatchLatency(benchmark::State &state, Bus &bus)
+{
+    std::shared_ptr<ProbeMsg> msg;
+    SharingEvent event = MakeProbe(msg);
+    for (auto _ : state) {
+        msg->delivered.store(false, std::memory_order_relaxed);
+        while (bus.PushEvent(event) != 0) {
+            std::this_thread::yield();
+        }
+        WaitDelivered(*msg);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void LockedDispatch(benchmark::State &state)
+{
+    DispatchLatency(state, GetLockedBus());
+}
+
+void RingDispatch(benchmark::State &state)
+{
+    DispatchLatency(state, GetEventManager());
+}
+} // namespace
+
+BENCHMARK(LockedDispatch)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+BENCHMARK(RingDispatch)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+} // namespace Sharing
+} // namespace OHOS
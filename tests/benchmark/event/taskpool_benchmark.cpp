@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "event/taskpool.h"
+
+namespace OHOS {
+namespace Sharing {
+namespace {
+constexpr int32_t POOL_THREADS = 30; // as EventManager starts it
+constexpr int32_t STORM_TASKS = 256; // events of one producer, e.g. a session tearing down
+
+// the single queue pool TaskPool used before, kept as the baseline
+class LockedTaskPool {
+public:
+    explicit LockedTaskPool(int32_t threadsNum)
+    {
+        for (int32_t i = 0; i < threadsNum; ++i) {
+            threads_.emplace_back(&LockedTaskPool::Worker, this);
+        }
+    }
+
+    ~LockedTaskPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            isRunning_ = false;
+            hasTask_.notify_all();
+        }
+        for (auto &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void PushTask(std::packaged_task<int32_t()> &task)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        tasks_.emplace_back(std::move(task));
+        hasTask_.notify_one();
+    }
+
+private:
+    void Worker()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (isRunning_) {
+            if (tasks_.empty()) {
+                hasTask_.wait(lock);
+                continue;
+            }
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+private:
+    bool isRunning_ = true;
+    std::mutex mutex_;
+    std::condition_variable hasTask_;
+    std::vector<std::thread> threads_;
+    std::deque<std::packaged_task<int32_t()>> tasks_;
+};
+
+LockedTaskPool &GetLockedPool()
+{
+    static LockedTaskPool pool(POOL_THREADS);
+    return pool;
+}
+
+TaskPool &GetStealingPool()
+{
+    static TaskPool pool;
+    static bool started = pool.Start(POOL_THREADS) == 0;
+    benchmark::DoNotOptimize(started);
+    return pool;
+}
+
+void WaitDone(const std::atomic<int32_t> &remaining)
+{
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+// every benchmark thread is a producer pushing a burst of async events and waiting for them
+void LockedEventStorm(benchmark::State &state)
+{
+    auto &pool = GetLockedPool();
+    for (auto _ : state) {
+        std::atomic<int32_t> remaining = STORM_TASKS;
+        for (int32_t i = 0; i < STORM_TASKS; ++i) {
+            std::packaged_task<int32_t()> task([&remaining]() {
+                remaining.fetch_sub(1, std::memory_order_release);
+                return 0;
+            });
+            pool.PushTask(task);
+        }
+        WaitDone(remaining);
+    }
+    state.SetItemsProcessed(state.iterations() * STORM_TASKS);
+}
+
+void StealingEventStorm(benchmark::State &state)
+{
+    auto &pool = GetStealingPool();
+    for (auto _ : state) {
+        std::atomic<int32_t> remaining = STORM_TASKS;
+        for (int32_t i = 0; i < STORM_TASKS; ++i) {
+            pool.PushTask([&remaining]() { remaining.fetch_sub(1, std::memory_order_release); });
+        }
+        WaitDone(remaining);
+    }
+    state.SetItemsProcessed(state.iterations() * STORM_TASKS);
+}
+
+// one sync event at a time, answered through a future as PushSyncEvent did before
+void LockedSyncEvent(benchmark::State &state)
+{
+    auto &pool = GetLockedPool();
+    for (auto _ : state) {
+        std::packaged_task<int32_t()> task([]() { return 0; });
+        auto future = task.get_future();
+        pool.PushTask(task);
+        benchmark::DoNotOptimize(future.get());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// answered through a reused slot as PushSyncEvent does now
+void StealingSyncEvent(benchmark::State &state)
+{
+    auto &pool = GetStealingPool();
+    struct {
+        std::mutex mutex;
+        std::condition_variable done;
+        bool finished = false;
+    } call;
+    for (auto _ : state) {
+        call.finished = false;
+        pool.PushTask([&call]() {
+            std::unique_lock<std::mutex> lock(call.mutex);
+            call.finished = true;
+            call.done.notify_one();
+        });
+        std::unique_lock<std::mutex> lock(call.mutex);
+        call.done.wait(lock, [&call]() { return call.finished; });
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+} // namespace
+
+BENCHMARK(LockedEventStorm)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+BENCHMARK(StealingEventStorm)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+BENCHMARK(LockedSyncEvent)->Threads(1)->Threads(8)->UseRealTime();
+BENCHMARK(StealingSyncEvent)->Threads(1)->Threads(8)->UseRealTime();
+} // namespace Sharing
+} // namespace OHOS
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include "protocol/frame/h264_frame.h"
+
+namespace OHOS {
+namespace Sharing {
+namespace {
+// typical encoder output for one idr access unit
+constexpr size_t IDR_1080P_SIZE = 180 * 1024; // 180: KiB
+constexpr size_t IDR_4K_SIZE = 720 * 1024;    // 720: KiB
+constexpr size_t IDR_1080P_SLICES = 4;
+constexpr size_t IDR_4K_SLICES = 8;
+
+// random slice data with emulation prevention applied, as an encoder emits it
+void AppendNalu(std::string &au, uint8_t header, size_t size, std::mt19937 &rng)
+{
+    au.append("\x00\x00\x00\x01", 4); // 4: start code size
+    au.push_back(static_cast<char>(header));
+    size_t zeros = 0;
+    for (size_t i = 0; i < size; i++) {
+        // zero bytes are frequent in cabac output
+        uint8_t byte = (rng() % 8 == 0) ? 0 : static_cast<uint8_t>(rng()); // 8: one in eight
+        if (zeros >= 2 && byte <= 3) {                                     // 2, 3: emulation prevention
+            au.push_back(0x03);
+            zeros = 0;
+        }
+        zeros = byte == 0 ? zeros + 1 : 0;
+        au.push_back(static_cast<char>(byte));
+    }
+    if (zeros > 0) {
+        au.push_back(static_cast<char>(0x80)); // rbsp trailing bits
+    }
+}
+
+std::string MakeIdrAccessUnit(size_t size, size_t slices)
+{
+    std::mt19937 rng(static_cast<uint32_t>(size));
+    std::string au;
+    au.reserve(size + size / 64); // 64: room for emulation prevention bytes
+    AppendNalu(au, 0x09, 1, rng);   // 0x09: aud
+    AppendNalu(au, 0x67, 24, rng);  // 0x67: sps, 24: size
+    AppendNalu(au, 0x68, 4, rng);   // 0x68: pps, 4: size
+    AppendNalu(au, 0x06, 32, rng);  // 0x06: sei, 32: size
+    for (size_t i = 0; i < slices; i++) {
+        AppendNalu(au, 0x65, size / slices, rng); // 0x65: idr slice
+    }
+
+    return au;
+}
+
+// set SHARING_H264_IDR to an annex-b dump of a real idr frame to measure it as well
+std::string LoadIdrAccessUnit()
+{
+    const char *path = getenv("SHARING_H264_IDR");
+    if (path == nullptr) {
+        return {};
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// the byte-wise memcmp scan SplitH264 used before, kept as the baseline
+const char *MemcmpFindStartCode(const char *begin, const char *end)
+{
+    for (auto p = begin; p + 3 <= end; ++p) { // 3: start code size
+        if (memcmp(p, "\x00\x00\x01", 3) == 0) { // 3: start code size
+            return p;
+        }
+    }
+
+    return nullptr;
+}
+
+void RunSplit(benchmark::State &state, const std::string &au)
+{
+    if (au.empty()) {
+        state.SkipWithError("no access unit");
+        return;
+    }
+
+    for (auto _ : state) {
+        size_t count = 0;
+        SplitH264(au.data(), au.size(), 0, [&count](const char *, size_t, size_t) { count++; });
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * au.size()));
+}
+
+void RunMemcmpScan(benchmark::State &state, const std::string &au)
+{
+    for (auto _ : state) {
+        size_t count = 0;
+        auto end = au.data() + au.size();
+        for (auto p = MemcmpFindStartCode(au.data(), end); p != nullptr; p = MemcmpFindStartCode(p + 3, end)) {
+            count++;
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * au.size()));
+}
+
+void SplitH264Idr1080p(benchmark::State &state)
+{
+    static const std::string au = MakeIdrAccessUnit(IDR_1080P_SIZE, IDR_1080P_SLICES);
+    RunSplit(state, au);
+}
+
+void SplitH264Idr4k(benchmark::State &state)
+{
+    static const std::string au = MakeIdrAccessUnit(IDR_4K_SIZE, IDR_4K_SLICES);
+    RunSplit(state, au);
+}
+
+void SplitH264IdrFile(benchmark::State &state)
+{
+    static const std::string au = LoadIdrAccessUnit();
+    RunSplit(state, au);
+}
+
+void MemcmpScanIdr1080p(benchmark::State &state)
+{
+    static const std::string au = MakeIdrAccessUnit(IDR_1080P_SIZE, IDR_1080P_SLICES);
+    RunMemcmpScan(state, au);
+}
+
+void MemcmpScanIdr4k(benchmark::State &state)
+{
+    static const std::string au = MakeIdrAccessUnit(IDR_4K_SIZE, IDR_4K_SLICES);
+    RunMemcmpScan(state, au);
+}
+} // namespace
+
+BENCHMARK(SplitH264Idr1080p);
+BENCHMARK(SplitH264Idr4k);
+BENCHMARK(SplitH264IdrFile);
+BENCHMARK(MemcmpScanIdr1080p);
+BENCHMARK(MemcmpScanIdr4k);
+} // namespace Sharing
+} // namespace OHOS
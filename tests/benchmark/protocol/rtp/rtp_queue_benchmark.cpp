@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2026 Shenzhen Kaihong Digital Industry Development Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+#include "sink/protocol/rtp/include/rtp_queue.h"
+
+namespace OHOS {
+namespace Sharing {
+namespace {
+constexpr size_t TRACE_PACKETS = 4096;
+constexpr size_t SORT_CACHE_MAX = 1024;
+constexpr size_t SORT_CACHE_MIN = 64;
+
+// seq offsets as they arrive, reorderPercent of the packets swap with one up to depth later
+std::vector<uint16_t> MakeTrace(uint32_t lossPercent, uint32_t reorderPercent, uint32_t depth)
+{
+    std::mt19937 rng(lossPercent * 100 + reorderPercent); // 100: distinct seeds
+    std::vector<uint16_t> trace;
+    trace.reserve(TRACE_PACKETS);
+    for (size_t i = 0; i < TRACE_PACKETS; i++) {
+        if (rng() % 100 >= lossPercent) { // 100: percent
+            trace.push_back(static_cast<uint16_t>(i));
+        }
+    }
+    for (size_t i = 0; i + 1 < trace.size(); i++) {
+        if (rng() % 100 < reorderPercent) { // 100: percent
+            std::swap(trace[i], trace[std::min(trace.size() - 1, i + 1 + rng() % depth)]);
+        }
+    }
+
+    return trace;
+}
+
+// the std::map cache RtpPacketSortor used before, kept as the baseline
+class MapSortor {
+public:
+    void SortPacket(uint16_t seq, const RtpPacket::Ptr &packet)
+    {
+        cache_.emplace(seq, packet);
+        auto it = cache_.lower_bound(nextSeqOut_);
+        if (it == cache_.end() || it->first != nextSeqOut_) {
+            if (cache_.size() <= maxSortSize_) {
+                return;
+            }
+            if (it == cache_.end()) {
+                it = cache_.begin();
+            }
+            nextSeqOut_ = it->first;
+        }
+        while (it != cache_.end() && it->first == nextSeqOut_) {
+            benchmark::DoNotOptimize(it->second);
+            nextSeqOut_ = it->first + 1;
+            cache_.erase(it);
+            it = cache_.lower_bound(nextSeqOut_);
+        }
+        maxSortSize_ = std::min(SORT_CACHE_MIN + cache_.size(), SORT_CACHE_MAX);
+    }
+
+private:
+    uint16_t nextSeqOut_ = 0;
+    size_t maxSortSize_ = SORT_CACHE_MIN;
+    std::map<uint16_t, RtpPacket::Ptr> cache_;
+};
+
+void RunRingSortor(benchmark::State &state, const std::vector<uint16_t> &trace)
+{
+    auto packet = std::make_shared<RtpPacket>();
+    RtpPacketSortor sortor(90000, SORT_CACHE_MAX, SORT_CACHE_MIN); // 90000: video clock
+    size_t sorted = 0;
+    sortor.SetOnSort([&sorted](uint16_t, const RtpPacket::Ptr &) { sorted++; });
+    uint16_t base = 0;
+    for (auto _ : state) {
+        for (auto offset : trace) {
+            sortor.SortPacket(base + offset, packet);
+        }
+        base += TRACE_PACKETS;
+    }
+    benchmark::DoNotOptimize(sorted);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * trace.size()));
+}
+
+void RunMapSortor(benchmark::State &state, const std::vector<uint16_t> &trace)
+{
+    auto packet = std::make_shared<RtpPacket>();
+    MapSortor sortor;
+    uint16_t base = 0;
+    for (auto _ : state) {
+        for (auto offset : trace) {
+            sortor.SortPacket(base + offset, packet);
+        }
+        base += TRACE_PACKETS;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * trace.size()));
+}
+
+const std::vector<uint16_t> &InOrderTrace()
+{
+    static const std::vector<uint16_t> trace = MakeTrace(0, 0, 1);
+    return trace;
+}
+
+const std::vector<uint16_t> &ReorderedTrace()
+{
+    static const std::vector<uint16_t> trace = MakeTrace(0, 10, 16); // 10: percent, 16: depth
+    return trace;
+}
+
+const std::vector<uint16_t> &LossyTrace()
+{
+    static const std::vector<uint16_t> trace = MakeTrace(2, 10, 16); // 2, 10: percent, 16: depth
+    return trace;
+}
+
+void RingSortorInOrder(benchmark::State &state)
+{
+    RunRingSortor(state, InOrderTrace());
+}
+
+void RingSortorReordered(benchmark::State &state)
+{
+    RunRingSortor(state, ReorderedTrace());
+}
+
+void RingSortorLossy(benchmark::State &state)
+{
+    RunRingSortor(state, LossyTrace());
+}
+
+void MapSortorInOrder(benchmark::State &state)
+{
+    RunMapSortor(state, InOrderTrace());
+}
+
+void MapSortorReordered(benchmark::State &state)
+{
+    RunMapSortor(state, ReorderedTrace());
+}
+
+void MapSortorLossy(benchmark::State &state)
+{
+    RunMapSortor(state, LossyTrace());
+}
+} // namespace
+
+BENCHMARK(RingSortorInOrder);
+BENCHMARK(RingSortorReordered);
+BENCHMARK(RingSortorLossy);
+BENCHMARK(MapSortorInOrder);
+BENCHMARK(MapSortorReordered);
+BENCHMARK(MapSortorLossy);
+} // namespace Sharing
+} // namespace OHOS
@@ -18,6 +18,7 @@
 #include <thread>
 #include "common/sharing_log.h"
 #include "video_sink_decoder.h"
+#include "securec.h"
 
 using namespace OHOS::Sharing;
 
@@ -101,37 +102,22 @@ public:
 
     void ProcessVideoData(DataBuffer::Ptr data)
     {
-        int32_t bufferIndex = -1;
-        {
-            SHARING_LOGD("process video data");
-            std::unique_lock<std::mutex> lock(inMutex_);
-            SHARING_LOGD("process video data in");
-            if (inQueue_.empty()) {
-                while (!stop_) {
-                    inCond_.wait_for(lock, std::chrono::milliseconds(DECODE_WAIT_MILLISECONDS),
-                                     [this]() { return (!inQueue_.empty()); });
-                    if (inQueue_.empty()) {
-                        SHARING_LOGD("index queue empty");
-                        continue;
-                    }
-                    break;
-                }
+        SHARING_LOGD("process video data");
+        InputBuffer input;
+        while (!AcquireInputBuffer(input, DECODE_WAIT_MILLISECONDS)) {
+            if (stop_ || !isRunning_) {
+                SHARING_LOGD("stop no process video data");
+                return;
             }
-            SHARING_LOGD("process video data get buffer index");
-            bufferIndex = inQueue_.front();
-            inQueue_.pop();
+            SHARING_LOGD("input buffer queue empty");
         }
-        SHARING_LOGD("process video data bufferIndex: %{public}d.", bufferIndex);
-        if (stop_) {
-            SHARING_LOGD("stop return");
+        SHARING_LOGD("process video data bufferIndex: %{public}u.", input.index);
+        if (stop_ || input.memory == nullptr || data->Size() > input.memory->GetSize() ||
+            memcpy_s(input.memory->GetBase(), input.memory->GetSize(), data->Peek(), data->Size()) != EOK) {
+            RecycleInputBuffer(input);
             return;
         }
-
-        if (bufferIndex == -1) {
-            SHARING_LOGD("stop no process video data");
-        } else {
-            DecodeVideoData(data->Peek(), data->Size(), bufferIndex);
-        }
+        QueueInputBuffer(input, data->Size(), 0);
     }
 
     void StartPlayThread()
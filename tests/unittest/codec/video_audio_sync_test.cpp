@@ -15,15 +15,23 @@
  */
 
 #include <gtest/gtest.h>
+#include <cmath>
 #include <memory>
+#include <random>
+#include "media_clock.h"
+#include "utils/utils.h"
 #include "video_audio_sync.h"
 
 namespace OHOS {
 namespace Sharing {
+namespace {
+constexpr int64_t FRAME_US = 33333; // 30 fps
+constexpr int64_t WINDOW_FRAMES = 31; // one clock window at 30 fps
+} // namespace
 
 class MockAudioPlayController : public AudioPlayController {
 public:
-    MockAudioPlayController() = default;
+    MockAudioPlayController() : AudioPlayController(0) {}
     ~MockAudioPlayController() override = default;
 
     int64_t GetAudioDecoderTimestamp() override
@@ -62,6 +70,16 @@ protected:
 
     void TearDown() override {}
 
+    // frames 0..count-1 arrived one interval apart, the last one just now; returns the pts of now
+    int64_t LockClock(int64_t count = 2 * WINDOW_FRAMES)
+    {
+        int64_t nowUs = GetMonotonicMicrosecond();
+        for (int64_t i = 0; i < count; ++i) {
+            videoAudioSync_->OnVideoArrival(i * FRAME_US, nowUs - (count - 1 - i) * FRAME_US);
+        }
+        return (count - 1) * FRAME_US;
+    }
+
     std::shared_ptr<VideoAudioSync> videoAudioSync_;
     std::shared_ptr<MockAudioPlayController> audioPlayController_;
 };
@@ -72,74 +90,126 @@ TEST_F(VideoAudioSyncTest, CreateVideoAudioSync)
     ASSERT_NE(sync, nullptr);
 }
 
-TEST_F(VideoAudioSyncTest, IsNeedDrop_FirstFrame)
+TEST_F(VideoAudioSyncTest, MediaClock_LearnsDrift)
 {
-    bool result = videoAudioSync_->IsNeedDrop(1000);
-    EXPECT_EQ(result, false);
+    // 200 ppm fast source, exponential network delay of 5 ms mean, an hour at 30 fps
+    MediaClock clock;
+    std::mt19937 random(1);
+    std::exponential_distribution<double> delay(1.0 / 5000); // 5000: us
+    double maxErrorUs = 0;
+    for (int64_t i = 0; i < 30 * 3600; ++i) { // 30: fps, 3600: s
+        int64_t pts = i * FRAME_US;
+        double envelopeUs = 1e11 + pts * (1 + 200e-6); // 1e11: local start, 200e-6: drift
+        clock.OnSample(pts, std::llround(envelopeUs + delay(random)));
+        if (i > 30 * 120) { // 30: fps, 120: s to settle
+            maxErrorUs = std::max(maxErrorUs, std::fabs(clock.ToLocalUs(pts) - envelopeUs));
+        }
+    }
+    EXPECT_TRUE(clock.IsLocked());
+    EXPECT_NEAR(clock.GetDriftPpm(), 200, 20); // 200: ppm, 20: ppm
+    EXPECT_LT(maxErrorUs, 2000); // 2000: us, no creep after an hour
+    EXPECT_GT(clock.GetJitterUs(), 0);
 }
 
-TEST_F(VideoAudioSyncTest, IsNeedDrop_AudioTimestampZero)
+TEST_F(VideoAudioSyncTest, MediaClock_Discontinuity)
 {
-    audioPlayController_->SetAudioTimestamp(0);
-    bool result = videoAudioSync_->IsNeedDrop(1000);
-    EXPECT_EQ(result, false);
+    MediaClock clock;
+    for (int64_t i = 0; i < 2 * WINDOW_FRAMES; ++i) {
+        clock.OnSample(i * FRAME_US, i * FRAME_US);
+    }
+    ASSERT_TRUE(clock.IsLocked());
+    EXPECT_EQ(clock.ToLocalUs(100 * FRAME_US), 100 * FRAME_US);
+
+    // the source restarted its timestamps
+    clock.OnSample(0, 2 * WINDOW_FRAMES * FRAME_US);
+    EXPECT_FALSE(clock.IsLocked());
+    clock.Reset();
+    EXPECT_FALSE(clock.IsLocked());
 }
 
-TEST_F(VideoAudioSyncTest, IsNeedDrop_VideoTooLate)
+TEST_F(VideoAudioSyncTest, ScheduleVideoFrame_BeforeLock)
 {
-    videoAudioSync_->IsNeedDrop(1000);
-    audioPlayController_->SetAudioTimestamp(300000);
-    bool result = videoAudioSync_->IsNeedDrop(0);
-    EXPECT_EQ(result, false);
+    int64_t nowUs = GetMonotonicMicrosecond();
+    int64_t renderUs = 0;
+    EXPECT_TRUE(videoAudioSync_->ScheduleVideoFrame(1000, renderUs));
+    EXPECT_GE(renderUs, nowUs);
+    EXPECT_LT(renderUs - nowUs, 10 * 1000); // 10: ms, rendered right away
 }
 
-TEST_F(VideoAudioSyncTest, IsNeedDrop_VideoLate)
+TEST_F(VideoAudioSyncTest, ScheduleVideoFrame_HoldsEarlyFrame)
 {
-    videoAudioSync_->IsNeedDrop(1000);
-    audioPlayController_->SetAudioTimestamp(150000);
-    bool result = videoAudioSync_->IsNeedDrop(0);
-    EXPECT_EQ(result, true);
+    int64_t pts = LockClock();
+    int64_t renderUs = 0;
+    ASSERT_TRUE(videoAudioSync_->ScheduleVideoFrame(pts, renderUs));
+
+    // a frame 100 ms ahead of the clock waits for its time
+    int64_t nowUs = GetMonotonicMicrosecond();
+    ASSERT_TRUE(videoAudioSync_->ScheduleVideoFrame(pts + 100 * 1000, renderUs)); // 100: ms
+    EXPECT_GT(renderUs - nowUs, 80 * 1000); // 80: ms
+    EXPECT_LT(renderUs - nowUs, 120 * 1000); // 120: ms
 }
 
-TEST_F(VideoAudioSyncTest, IsNeedDrop_AudioLate)
+TEST_F(VideoAudioSyncTest, ScheduleVideoFrame_DropsLateFrameOnce)
 {
-    videoAudioSync_->IsNeedDrop(1000);
-    audioPlayController_->SetAudioTimestamp(0);
-    bool result = videoAudioSync_->IsNeedDrop(150000);
-    EXPECT_EQ(result, false);
+    int64_t pts = LockClock();
+    int64_t renderUs = 0;
+    ASSERT_TRUE(videoAudioSync_->ScheduleVideoFrame(pts, renderUs));
+
+    // 300 ms late: dropped, but never two in a row
+    EXPECT_FALSE(videoAudioSync_->ScheduleVideoFrame(pts - 300 * 1000, renderUs)); // 300: ms
+    EXPECT_TRUE(videoAudioSync_->ScheduleVideoFrame(pts - 300 * 1000, renderUs)); // 300: ms
+
+    uint32_t videoTooLateCount = 0;
+    uint32_t audioTooLateCount = 0;
+    uint32_t videoDropFrameCount = 0;
+    videoAudioSync_->GetAVSyncExceptionCount(videoTooLateCount, audioTooLateCount, videoDropFrameCount);
+    EXPECT_EQ(videoDropFrameCount, 1U);
+    videoAudioSync_->ResetAVSyncExceptionCount();
+    videoAudioSync_->GetAVSyncExceptionCount(videoTooLateCount, audioTooLateCount, videoDropFrameCount);
+    EXPECT_EQ(videoDropFrameCount, 0U);
 }
 
-TEST_F(VideoAudioSyncTest, IsNeedDrop_AudioTooLate)
+TEST_F(VideoAudioSyncTest, ScheduleVideoFrame_FollowsAudio)
 {
-    videoAudioSync_->IsNeedDrop(1000);
-    audioPlayController_->SetAudioTimestamp(0);
-    bool result = videoAudioSync_->IsNeedDrop(400000);
-    EXPECT_EQ(result, false);
+    int64_t pts = LockClock();
+
+    // the audio heard now arrived 80 ms ago, video waits as long
+    audioPlayController_->SetAudioTimestamp(pts - 80 * 1000); // 80: ms
+    int64_t nowUs = GetMonotonicMicrosecond();
+    int64_t renderUs = 0;
+    ASSERT_TRUE(videoAudioSync_->ScheduleVideoFrame(pts, renderUs));
+    EXPECT_GT(renderUs - nowUs, 60 * 1000); // 60: ms
+    EXPECT_LT(renderUs - nowUs, 100 * 1000); // 100: ms
+    EXPECT_EQ(audioPlayController_->GetDropFrameCount(), 0);
 }
 
-TEST_F(VideoAudioSyncTest, IsNeedDrop_Synced)
+TEST_F(VideoAudioSyncTest, ScheduleVideoFrame_TrimsAudioBacklog)
 {
-    videoAudioSync_->IsNeedDrop(1000);
-    audioPlayController_->SetAudioTimestamp(50000);
-    bool result = videoAudioSync_->IsNeedDrop(55000);
-    EXPECT_EQ(result, false);
+    int64_t pts = LockClock();
+    int64_t renderUs = 0;
+    audioPlayController_->SetAudioTimestamp(pts - 20 * 1000); // 20: ms, the baseline
+    videoAudioSync_->ScheduleVideoFrame(pts, renderUs);
+
+    // audio falls 150 ms behind: trimmed once, then taken as the new baseline since trimming did not help
+    audioPlayController_->SetAudioTimestamp(pts - 170 * 1000); // 170: ms
+    for (int32_t i = 0; i < 60; ++i) { // 60: frames
+        videoAudioSync_->ScheduleVideoFrame(pts, renderUs);
+    }
+    EXPECT_EQ(audioPlayController_->GetDropFrameCount(), 1);
+
+    uint32_t videoTooLateCount = 0;
+    uint32_t audioTooLateCount = 0;
+    uint32_t videoDropFrameCount = 0;
+    videoAudioSync_->GetAVSyncExceptionCount(videoTooLateCount, audioTooLateCount, videoDropFrameCount);
+    EXPECT_EQ(audioTooLateCount, 1U);
 }
 
 TEST_F(VideoAudioSyncTest, SetAudioPlayController_Null)
 {
     auto sync = std::make_shared<VideoAudioSync>();
     sync->SetAudioPlayController(nullptr);
-    bool result = sync->IsNeedDrop(1000);
-    EXPECT_EQ(result, false);
-}
-
-TEST_F(VideoAudioSyncTest, IsNeedDrop_ContinueDropCount)
-{
-    videoAudioSync_->IsNeedDrop(1000);
-    audioPlayController_->SetAudioTimestamp(150000);
-    videoAudioSync_->IsNeedDrop(0);
-    bool result = videoAudioSync_->IsNeedDrop(0);
-    EXPECT_EQ(result, false);
+    int64_t renderUs = 0;
+    EXPECT_TRUE(sync->ScheduleVideoFrame(1000, renderUs));
 }
 
 } // namespace Sharing
@@ -14,10 +14,17 @@
  */
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <iostream>
+#include <thread>
+#include <vector>
 #include "common/sharing_log.h"
 #include "event/event_manager.h"
 #include "event/taskpool.h"
+#include "utils/timeout_timer.h"
+#include "utils/timer_wheel.h"
 
 using namespace testing::ext;
 using namespace OHOS::Sharing;
@@ -34,6 +41,17 @@ public:
     }
 };
 
+class CountingListener : public EventListener {
+public:
+    int32_t OnEvent(SharingEvent &event) final
+    {
+        count_++;
+        return 0;
+    }
+
+    std::atomic<int32_t> count_ = 0;
+};
+
 class SharingEventUnitTest : public testing::Test {};
 
 namespace {
@@ -182,6 +200,52 @@ HWTEST_F(SharingEventUnitTest, Event_Manager_01, Function | SmallTest | Level2)
     EXPECT_EQ(ret, 0);
 }
 
+HWTEST_F(SharingEventUnitTest, Event_Manager_02, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("trace");
+    constexpr int32_t producers = 4;
+    constexpr int32_t eventsEach = 200;
+    EventManager::GetInstance().Init();
+    EventManager::GetInstance().StartEventLoop();
+    EventManager::GetInstance().DrainAllListeners();
+
+    auto listener = std::make_shared<CountingListener>();
+    auto listener1 = std::make_shared<CountingListener>();
+    listener->SetListenerClassType(CLASS_TYPE_SESSION);
+    listener1->SetListenerClassType(CLASS_TYPE_SESSION);
+    EXPECT_EQ(EventManager::GetInstance().AddListener(listener), 0);
+    EXPECT_EQ(EventManager::GetInstance().AddListener(listener1), 0);
+
+    auto invalid = std::make_shared<CountingListener>();
+    invalid->SetListenerClassType(static_cast<ClassType>(CLASS_TYPE_PRODUCER + 1));
+    EXPECT_NE(EventManager::GetInstance().AddListener(invalid), 0);
+
+    SharingEvent event;
+    event.eventMsg = std::make_shared<EventMsg>();
+    event.listenerType = CLASS_TYPE_SESSION;
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < producers; ++i) {
+        threads.emplace_back([&event]() {
+            for (int32_t j = 0; j < eventsEach; ++j) {
+                while (EventManager::GetInstance().PushEvent(event) != 0) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // every event reaches every listener of its type
+    for (int32_t i = 0; i < 200 && listener1->count_ < producers * eventsEach; ++i) { // 200: 2s
+        std::this_thread::sleep_for(std::chrono::milliseconds(10)); // 10: poll interval
+    }
+    EXPECT_EQ(listener->count_, producers * eventsEach);
+    EXPECT_EQ(listener1->count_, producers * eventsEach);
+    EventManager::GetInstance().DrainAllListeners();
+}
+
 HWTEST_F(SharingEventUnitTest, Event_Base_07, Function | SmallTest | Level2)
 {
     SHARING_LOGD("trace");
@@ -531,6 +595,243 @@ HWTEST_F(SharingEventUnitTest, Task_Pool_01, Function | SmallTest | Level2)
     EXPECT_EQ(ret, 1);
 }
 
+HWTEST_F(SharingEventUnitTest, Task_Pool_02, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("task_Pool_02");
+    auto taskPool = std::make_shared<TaskPool>();
+    EXPECT_EQ(taskPool->Start(8), 0); // 8: max threads
+    EXPECT_EQ(taskPool->GetThreadNum(), 1U);
+
+    // sessions tearing down at once, each pushing a burst of events
+    std::atomic<int32_t> done = 0;
+    std::vector<std::thread> producers;
+    for (int32_t i = 0; i < 8; ++i) { // 8: producers
+        producers.emplace_back([&taskPool, &done]() {
+            for (int32_t j = 0; j < 1000; ++j) { // 1000: tasks
+                taskPool->PushTask([&done]() { done++; });
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    for (int32_t i = 0; i < 2000 && done < 8000; ++i) { // 2000: ms, 8000: all tasks
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(done.load(), 8000); // 8000: all tasks
+    EXPECT_EQ(taskPool->GetTaskNum(), 0U);
+    EXPECT_LE(taskPool->GetThreadNum(), 8U); // 8: max threads
+    taskPool->Stop();
+}
+
+HWTEST_F(SharingEventUnitTest, Task_Pool_03, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("task_Pool_03");
+    auto taskPool = std::make_shared<TaskPool>();
+    EXPECT_EQ(taskPool->Start(2), 0); // 2: max threads
+
+    // a task waiting for one it pushed itself, another worker is started to run it
+    std::promise<int32_t> outer;
+    taskPool->PushTask([&taskPool, &outer]() {
+        std::promise<int32_t> inner;
+        auto future = inner.get_future();
+        taskPool->PushTask([&inner]() { inner.set_value(1); });
+        outer.set_value(future.get());
+    });
+    auto future = outer.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(2)), std::future_status::ready); // 2: timeout
+    EXPECT_EQ(future.get(), 1);
+    EXPECT_EQ(taskPool->GetThreadNum(), 2U); // 2: max threads
+    taskPool->Stop();
+}
+
+HWTEST_F(SharingEventUnitTest, Task_Pool_04, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("task_Pool_04");
+    auto count = std::make_shared<int32_t>(0);
+    {
+        TaskPool::SmallTask task([count]() { (*count)++; });
+        TaskPool::SmallTask moved;
+        moved = std::move(task);
+        EXPECT_FALSE(task);
+        moved();
+        EXPECT_EQ(count.use_count(), 2);
+    }
+    EXPECT_EQ(count.use_count(), 1);
+
+    // too large to be kept inline, still a task
+    struct Large {
+        char data[TaskPool::SmallTask::INLINE_SIZE + 1];
+        std::shared_ptr<int32_t> count;
+        void operator()()
+        {
+            (*count)++;
+        }
+    };
+    TaskPool::SmallTask large(Large{{0}, count});
+    TaskPool::SmallTask movedLarge(std::move(large));
+    movedLarge();
+    EXPECT_EQ(*count, 2); // 2: both tasks ran
+}
+
+
+HWTEST_F(SharingEventUnitTest, Task_Pool_05, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("task_Pool_05");
+    auto taskPool = std::make_shared<TaskPool>();
+    taskPool->SetMaxTaskNum(2); // 2: pending tasks kept
+
+    // nothing runs them before Start, the one past the limit is dropped instead of blocking
+    std::atomic<int32_t> done = 0;
+    for (int32_t i = 0; i < 3; ++i) { // 3: one more than the limit
+        taskPool->PushTask([&done]() { done++; });
+    }
+    EXPECT_EQ(taskPool->GetTaskNum(), 2U);
+
+    EXPECT_EQ(taskPool->Start(2), 0); // 2: max threads
+    for (int32_t i = 0; i < 1000 && done < 2; ++i) { // 1000: ms, 2: kept tasks
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(done.load(), 2);
+    taskPool->Stop();
+}
+
+HWTEST_F(SharingEventUnitTest, Task_Pool_06, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("task_Pool_06");
+    auto taskPool = std::make_shared<TaskPool>();
+    taskPool->SetMaxTaskNum(30); // 30: as EventManager sets it
+    EXPECT_EQ(taskPool->Start(4), 0); // 4: max threads
+
+    // workers take tasks as fast as they come in, the count must never go below zero and park the pushers
+    std::atomic<int32_t> done = 0;
+    std::atomic<int32_t> pushed = 0;
+    std::vector<std::thread> producers;
+    for (int32_t i = 0; i < 8; ++i) { // 8: producers
+        producers.emplace_back([&taskPool, &done, &pushed]() {
+            for (int32_t j = 0; j < 20000; ++j) { // 20000: tasks
+                taskPool->PushTask([&done]() { done++; });
+                pushed++;
+            }
+        });
+    }
+    // past the limit only by pushers that passed the check together, a wrapped count is far beyond
+    size_t maxSeen = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5); // 5: timeout
+    while (done < 160000 && std::chrono::steady_clock::now() < deadline) { // 160000: all tasks
+        maxSeen = std::max(maxSeen, taskPool->GetTaskNum());
+    }
+    EXPECT_LE(maxSeen, 30U + 8U); // 30: limit, 8: producers
+    EXPECT_EQ(pushed.load(), 160000); // 160000: all tasks
+    EXPECT_EQ(done.load(), 160000); // 160000: all tasks
+    EXPECT_EQ(taskPool->GetTaskNum(), 0U);
+
+    // drained, a push goes straight through
+    auto last = std::async(std::launch::async, [&taskPool, &done]() { taskPool->PushTask([&done]() { done++; }); });
+    EXPECT_EQ(last.wait_for(std::chrono::seconds(1)), std::future_status::ready); // 1: timeout
+    // wakes a pusher parked on a lost count, the test fails instead of hanging
+    taskPool->Stop();
+    for (auto &producer : producers) {
+        producer.join();
+    }
+}
+
+HWTEST_F(SharingEventUnitTest, Timer_Wheel_01, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("timer_Wheel_01");
+    constexpr uint32_t delayMs = 50;
+    std::promise<std::chrono::steady_clock::time_point> fired;
+    auto start = std::chrono::steady_clock::now();
+    TimerWheel::Timer timer;
+    TimerWheel::GetInstance().Start(timer, delayMs, 0,
+                                    [&fired]() { fired.set_value(std::chrono::steady_clock::now()); });
+    EXPECT_TRUE(TimerWheel::GetInstance().IsActive(timer));
+
+    auto future = fired.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(2)), std::future_status::ready); // 2: timeout
+    EXPECT_GE(future.get() - start, std::chrono::milliseconds(delayMs));
+    EXPECT_FALSE(TimerWheel::GetInstance().IsActive(timer));
+}
+
+HWTEST_F(SharingEventUnitTest, Timer_Wheel_02, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("timer_Wheel_02");
+    std::atomic<int32_t> count = 0;
+    TimerWheel::Timer stopped;
+    TimerWheel::Timer restarted;
+    TimerWheel::GetInstance().Start(stopped, 30, 0, [&count]() { count += 100; }); // 30: ms, 100: must not run
+    TimerWheel::GetInstance().Start(restarted, 30, 0, [&count]() { count++; });    // 30: ms
+    TimerWheel::GetInstance().Stop(stopped);
+    TimerWheel::GetInstance().Start(restarted, 60); // 60: ms, keeps its callback
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40)); // 40: the first deadline passed
+    EXPECT_EQ(count, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200)); // 200: the second one too
+    EXPECT_EQ(count, 1);
+}
+
+HWTEST_F(SharingEventUnitTest, Timer_Wheel_03, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("timer_Wheel_03");
+    std::atomic<int32_t> count = 0;
+    std::promise<void> done;
+    TimerWheel::Timer timer;
+    // repeats until its own callback stops it
+    TimerWheel::GetInstance().Start(timer, 10, 10, [&]() { // 10: ms
+        if (++count == 3) { // 3: runs
+            TimerWheel::GetInstance().Stop(timer);
+            done.set_value();
+        }
+    });
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready); // 2: timeout
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // 50: a few periods
+    EXPECT_EQ(count, 3);
+}
+
+HWTEST_F(SharingEventUnitTest, Timer_Wheel_04, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("timer_Wheel_04");
+    // longer than the first level, the timer cascades down before it fires
+    constexpr uint32_t delayMs = TimerWheel::TICK_MS * 256 + 100; // 256: level 0 slots, 100: past them
+    std::promise<std::chrono::steady_clock::time_point> fired;
+    auto start = std::chrono::steady_clock::now();
+    TimeoutTimer timer("Timer_Wheel_04");
+    TimerWheel::Timer wheelTimer;
+    TimerWheel::GetInstance().Start(wheelTimer, delayMs, 0,
+                                    [&fired]() { fired.set_value(std::chrono::steady_clock::now()); });
+    timer.StartTimer(1, "short", nullptr);
+    timer.StopTimer();
+
+    auto future = fired.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready); // 5: timeout
+    auto elapsed = future.get() - start;
+    EXPECT_GE(elapsed, std::chrono::milliseconds(delayMs));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(delayMs + 500)); // 500: scheduling slack
+}
+
+HWTEST_F(SharingEventUnitTest, Timer_Wheel_05, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("timer_Wheel_05");
+    // the callback waits for a lock the stopping thread holds, Stop must not wait for it in turn
+    std::mutex mutex;
+    std::promise<void> entered;
+    std::atomic<bool> finished = false;
+    {
+        TimerWheel::Timer timer;
+        std::unique_lock<std::mutex> lock(mutex);
+        TimerWheel::GetInstance().Start(timer, 10, 0, [&]() { // 10: ms
+            entered.set_value();
+            std::lock_guard<std::mutex> callbackLock(mutex);
+            finished = true;
+        });
+        ASSERT_EQ(entered.get_future().wait_for(std::chrono::seconds(2)), std::future_status::ready); // 2: timeout
+        TimerWheel::GetInstance().Stop(timer);
+        EXPECT_FALSE(finished);
+        lock.unlock();
+        // ~Timer waits for the callback, it still uses the timer's owner
+    }
+    EXPECT_TRUE(finished);
+}
 } // namespace
 } // namespace Sharing
 } // namespace OHOS
\ No newline at end of file
@@ -360,6 +360,27 @@ HWTEST_F(WfdMessageTest, WfdRtspM4RequestGetRtpPort_001, TestSize.Level1)
     EXPECT_EQ(ret, 1);
 }
 
+HWTEST_F(WfdMessageTest, WfdRtspM4RequestGetRtpDirect_001, TestSize.Level1)
+{
+    WfdRtspM4Request m4Request(1, "url");
+    m4Request.SetClientRtpPorts(1);
+    auto m4ReqStr = m4Request.Stringify();
+    WfdRtspM4Request request;
+    request.Parse(m4ReqStr);
+    uint8_t videoPt = 0;
+    uint8_t audioPt = 0;
+    EXPECT_FALSE(request.GetRtpDirect(videoPt, audioPt));
+
+    m4Request.SetRtpDirect(96, 97);
+    m4ReqStr = m4Request.Stringify();
+    WfdRtspM4Request directRequest;
+    directRequest.Parse(m4ReqStr);
+    EXPECT_TRUE(directRequest.GetRtpDirect(videoPt, audioPt));
+    EXPECT_EQ(videoPt, 96);
+    EXPECT_EQ(audioPt, 97);
+    EXPECT_EQ(directRequest.GetRtpPort(), 1);
+}
+
 HWTEST_F(WfdMessageTest, WfdRtspM5RequestSetTriggerMethod_001, TestSize.Level1)
 {
     WfdRtspM5Request request(1);
@@ -417,6 +438,28 @@ HWTEST_F(WfdMessageTest, WfdRtspM6ResponseStringifyEx_001, TestSize.Level1)
     EXPECT_EQ(ret.code, RtspErrorType::OK);
 }
 
+HWTEST_F(WfdMessageTest, WfdRtspM6ResponseGetDestination_001, TestSize.Level1)
+{
+    WfdRtspM6Response m6Response(1, 1, "sessionID", 30);
+    m6Response.SetClientPort(19000);
+    m6Response.SetServerPort(6700);
+    auto unicast = m6Response.StringifyEx();
+    WfdRtspM6Response response;
+    response.Parse(unicast);
+    EXPECT_EQ(response.GetDestination(), "");
+    EXPECT_EQ(response.GetMulticastPort(), 0);
+
+    m6Response.SetMulticast("239.255.43.21", 5004, 1);
+    auto multicast = m6Response.StringifyEx();
+    WfdRtspM6Response multicastResponse;
+    RtspError ret = multicastResponse.Parse(multicast);
+    EXPECT_EQ(ret.code, RtspErrorType::OK);
+    EXPECT_EQ(multicastResponse.GetDestination(), "239.255.43.21");
+    EXPECT_EQ(multicastResponse.GetMulticastPort(), 5004);
+    EXPECT_EQ(multicastResponse.GetClientPort(), 19000);
+    EXPECT_EQ(multicastResponse.GetServerPort(), 6700);
+}
+
 HWTEST_F(WfdMessageTest, WfdRtspM7ResponseStringifyEx_001, TestSize.Level1)
 {
     WfdRtspM6Response m7Response(1, 1, "sessionID", 30);
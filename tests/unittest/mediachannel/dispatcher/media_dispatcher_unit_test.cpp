@@ -2131,6 +2131,101 @@ HWTEST_F(MediaDispatcherUnitTest, BufferDispatcher_179, Function | SmallTest | L
     EXPECT_EQ(ret, 0);
 }
 
+HWTEST_F(MediaDispatcherUnitTest, BufferDispatcher_180, Function | SmallTest | Level2)
+{
+    spmc_ring<MediaData> ring(5); // 5: rounded up to 8 slots
+    EXPECT_EQ(ring.max_capacity(), 8);
+    ring.set_capacity(3); // 3: logical capacity
+    for (int32_t i = 0; i < 10; i++) { // 10: push more than capacity
+        auto mediaData = std::make_shared<MediaData>();
+        mediaData->pts = i;
+        ring.push_back(mediaData);
+    }
+
+    EXPECT_EQ(ring.size(), 3);
+    EXPECT_EQ(ring.begin_index(), 7);
+    EXPECT_EQ(ring.back_index(), 9);
+    EXPECT_EQ(ring.load(6), nullptr);
+    ASSERT_NE(ring.load(9), nullptr);
+    EXPECT_EQ(ring.load(9)->pts, 9);
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.back_index(), spmc_ring<MediaData>::INVALID_SEQ);
+    EXPECT_EQ(ring.load(9), nullptr);
+    ring.push_back(std::make_shared<MediaData>());
+    EXPECT_EQ(ring.begin_index(), 10); // 10: clear keeps the sequence increasing
+    EXPECT_EQ(ring.load(9), nullptr);
+}
+
+HWTEST_F(MediaDispatcherUnitTest, BufferDispatcher_181, Function | SmallTest | Level2)
+{
+    auto bufferDispatcher = std::make_shared<BufferDispatcher>(MAX_BUFFER_CAPACITY, BUFFER_CAPACITY_INCREMENT);
+    ASSERT_NE(bufferDispatcher, nullptr);
+    bufferDispatcher->SetBufferCapacity(4); // 4: small ring to force eviction
+    for (int32_t i = 0; i < 6; i++) { // 6: two frames evicted
+        auto dataSpec = std::make_shared<BufferDispatcher::DataSpec>();
+        dataSpec->mediaData = std::make_shared<MediaData>();
+        dataSpec->mediaData->mediaType = MEDIA_TYPE_AUDIO;
+        bufferDispatcher->circularBuffer_.push_back(dataSpec);
+    }
+
+    EXPECT_EQ(bufferDispatcher->GetBufferSize(), 4);
+    EXPECT_EQ(bufferDispatcher->GetOldestIndex(), 2);
+    EXPECT_EQ(bufferDispatcher->GetLatestIndex(), 5);
+    EXPECT_EQ(bufferDispatcher->ClampReadIndex(0), 2);
+    EXPECT_EQ(bufferDispatcher->ClampReadIndex(INVALID_INDEX), INVALID_INDEX);
+    EXPECT_EQ(bufferDispatcher->FindNextIndex(0, MEDIA_TYPE_AUDIO), 2);
+}
+
+HWTEST_F(MediaDispatcherUnitTest, BufferDispatcher_182, Function | SmallTest | Level2)
+{
+    auto bufferDispatcher = std::make_shared<BufferDispatcher>(MAX_BUFFER_CAPACITY, BUFFER_CAPACITY_INCREMENT);
+    ASSERT_NE(bufferDispatcher, nullptr);
+    // key video, audio, video, audio, key video
+    MediaType types[] = {MEDIA_TYPE_VIDEO, MEDIA_TYPE_AUDIO, MEDIA_TYPE_VIDEO, MEDIA_TYPE_AUDIO, MEDIA_TYPE_VIDEO};
+    bool keys[] = {true, false, false, false, true};
+    for (int32_t i = 0; i < 5; i++) { // 5: frames written
+        auto dataSpec = std::make_shared<BufferDispatcher::DataSpec>();
+        dataSpec->mediaData = std::make_shared<MediaData>();
+        dataSpec->mediaData->mediaType = types[i];
+        dataSpec->mediaData->keyFrame = keys[i];
+        dataSpec->mediaData->buff = std::make_shared<DataBuffer>();
+        bufferDispatcher->WriteDataIntoBuffer(dataSpec);
+    }
+
+    EXPECT_EQ(bufferDispatcher->FindNextIndex(0, MEDIA_TYPE_AUDIO), 1);
+    EXPECT_EQ(bufferDispatcher->FindNextIndex(1, MEDIA_TYPE_AUDIO), 3);
+    EXPECT_EQ(bufferDispatcher->FindNextIndex(3, MEDIA_TYPE_AUDIO), 3);
+    EXPECT_EQ(bufferDispatcher->FindNextIndex(0, MEDIA_TYPE_VIDEO), 2);
+    EXPECT_EQ(bufferDispatcher->FindNextIndex(1, MEDIA_TYPE_VIDEO), 2);
+    bufferDispatcher->EnableKeyMode(true);
+    EXPECT_EQ(bufferDispatcher->FindNextIndex(0, MEDIA_TYPE_VIDEO), 4);
+    bufferDispatcher->EnableKeyMode(false);
+    bufferDispatcher->circularBuffer_.pop_front();
+    EXPECT_EQ(bufferDispatcher->FindNextDeleteVideoIndex(), 1);
+}
+
+HWTEST_F(MediaDispatcherUnitTest, BufferDispatcher_183, Function | SmallTest | Level2)
+{
+    auto bufferDispatcher = std::make_shared<BufferDispatcher>(MAX_BUFFER_CAPACITY, BUFFER_CAPACITY_INCREMENT);
+    ASSERT_NE(bufferDispatcher, nullptr);
+    bufferDispatcher->idleVideoBuffer_.pop_front();
+    size_t idleSize = bufferDispatcher->idleVideoBuffer_.size();
+    auto dataSpec = std::make_shared<BufferDispatcher::DataSpec>();
+    dataSpec->mediaData = std::make_shared<MediaData>();
+    dataSpec->mediaData->mediaType = MEDIA_TYPE_VIDEO;
+    // a receiver still holds the frame, it must not be handed out again
+    MediaData::Ptr held = dataSpec->mediaData;
+    bufferDispatcher->ReturnIdleBuffer(dataSpec);
+    EXPECT_EQ(bufferDispatcher->idleVideoBuffer_.size(), idleSize);
+
+    dataSpec = std::make_shared<BufferDispatcher::DataSpec>();
+    dataSpec->mediaData = std::make_shared<MediaData>();
+    dataSpec->mediaData->mediaType = MEDIA_TYPE_VIDEO;
+    bufferDispatcher->ReturnIdleBuffer(dataSpec);
+    EXPECT_EQ(bufferDispatcher->idleVideoBuffer_.size(), idleSize + 1);
+}
+
 } // namespace
 } // namespace Sharing
 } // namespace OHOS
\ No newline at end of file
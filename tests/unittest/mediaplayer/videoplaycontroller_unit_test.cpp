@@ -22,6 +22,7 @@
 #include <fcntl.h>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 
 #include "common/sharing_log.h"
@@ -897,6 +898,59 @@ HWTEST_F(VideoPlayControllerUnitTest, Video_Play_Controller_Test_Release_02, Fun
     videoPlayController->Release();
 }
 
+
+class TestInputMemory : public MediaAVCodec::AVSharedMemory {
+public:
+    explicit TestInputMemory(int32_t size) : data_(size) {}
+    uint8_t *GetBase() const override
+    {
+        return const_cast<uint8_t *>(data_.data());
+    }
+    int32_t GetSize() const override
+    {
+        return static_cast<int32_t>(data_.size());
+    }
+    uint32_t GetFlags() const override
+    {
+        return 0;
+    }
+
+private:
+    std::vector<uint8_t> data_;
+};
+
+HWTEST_F(VideoPlayControllerUnitTest, Video_Play_Controller_Test_InputBuffer_01, Function | SmallTest | Level2)
+{
+    SHARING_LOGD("trace");
+    auto decoder = std::make_shared<VideoSinkDecoder>(g_testBase.GetId());
+    decoder->isRunning_ = true;
+    VideoSinkDecoder::InputBuffer input;
+    EXPECT_FALSE(decoder->AcquireInputBuffer(input, 10)); // 10: ms, the codec gave none yet
+
+    decoder->OnInputBufferAvailable(3, std::make_shared<TestInputMemory>(1024)); // 3: index, 1024: bytes
+    decoder->OnInputBufferAvailable(5, std::make_shared<TestInputMemory>(1024)); // 5: index, 1024: bytes
+    ASSERT_TRUE(decoder->AcquireInputBuffer(input, 10)); // 10: ms
+    EXPECT_EQ(input.index, 3U);
+
+    // a read that brought nothing hands the buffer back in front of the others
+    decoder->RecycleInputBuffer(input);
+    ASSERT_TRUE(decoder->AcquireInputBuffer(input, 10)); // 10: ms
+    EXPECT_EQ(input.index, 3U);
+
+    // stopping wakes a feeder waiting for a buffer and drops what the codec took back
+    std::thread stopper([&decoder]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20)); // 20: while the feeder waits
+        decoder->Stop();
+    });
+    ASSERT_TRUE(decoder->AcquireInputBuffer(input, 10)); // 10: ms
+    EXPECT_EQ(input.index, 5U);
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(decoder->AcquireInputBuffer(input, DECODE_WAIT_MILLISECONDS));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(DECODE_WAIT_MILLISECONDS));
+    stopper.join();
+    decoder->RecycleInputBuffer(input);
+    EXPECT_TRUE(decoder->inBuffers_.empty());
+}
 } // namespace
 } // namespace Sharing
 } // namespace OHOS
\ No newline at end of file
@@ -13,9 +13,13 @@
  * limitations under the License.
  */
 
+#include <arpa/inet.h>
 #include <gtest/gtest.h>
+#include <chrono>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <sys/socket.h>
 #include <unistd.h>
 #include "common/sharing_log.h"
 #include "network/interfaces/iclient_callback.h"
@@ -24,6 +28,7 @@
 #include "network/network_factory.h"
 #include "network/server/udp_server.h"
 #include "network/client/udp_client.h"
+#include "network/socket/socket_utils.h"
 
 using namespace std;
 using namespace OHOS::Sharing;
@@ -462,6 +467,161 @@ HWTEST_F(NetworkUdpUnitTest, NetworkUdpUnitTest_020, TestSize.Level0)
     ASSERT_TRUE(socketInfo == nullptr);
 }
 
+// 测试recvmmsg批量接收
+HWTEST_F(NetworkUdpUnitTest, NetworkUdpUnitTest_021, TestSize.Level0)
+{
+    int32_t fds[2] = {-1, -1};
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0, fds), 0);
+    auto udpServer = std::make_shared<UdpServer>();
+    ASSERT_TRUE(udpServer != nullptr);
+    EXPECT_EQ(udpServer->ReceiveBatch(fds[0]), -1);
+    EXPECT_EQ(errno, EAGAIN);
+
+    const std::string msgs[] = {"first", "second", "third"};
+    for (auto &msg : msgs) {
+        ASSERT_EQ(send(fds[1], msg.data(), msg.size(), 0), (ssize_t)msg.size());
+    }
+    ASSERT_EQ(udpServer->ReceiveBatch(fds[0]), 3); // 3: datagrams
+    for (size_t i = 0; i < 3; i++) {               // 3: datagrams
+        ASSERT_EQ(udpServer->readMsgs_[i].msg_len, msgs[i].size());
+        EXPECT_EQ(memcmp(udpServer->readBuffers_[i]->Data(), msgs[i].data(), msgs[i].size()), 0);
+    }
+    close(fds[0]);
+    close(fds[1]);
+}
+
+class BatchRecorder final : public IServerCallback {
+public:
+    void OnServerClose(int32_t fd) override {}
+    void OnServerWriteable(int32_t fd) override {}
+    void OnServerException(int32_t fd) override {}
+    void OnAccept(std::weak_ptr<INetworkSession> session) override {}
+    void OnServerReadData(int32_t fd, DataBuffer::Ptr buf, INetworkSession::Ptr session) override
+    {
+        received_.push_back(std::move(buf));
+    }
+
+    std::vector<DataBuffer::Ptr> received_;
+};
+
+// 测试OnServerReadBatch默认逐包转发给OnServerReadData
+HWTEST_F(NetworkUdpUnitTest, NetworkUdpUnitTest_022, TestSize.Level0)
+{
+    auto recorder = std::make_shared<BatchRecorder>();
+    ASSERT_TRUE(recorder != nullptr);
+    std::vector<DataBuffer::Ptr> batch;
+    for (int32_t i = 0; i < 3; i++) { // 3: datagrams
+        auto buf = std::make_shared<DataBuffer>();
+        buf->Append(static_cast<uint8_t>(i));
+        batch.push_back(buf);
+    }
+    recorder->OnServerReadBatch(0, batch);
+    ASSERT_EQ(recorder->received_.size(), 3U); // 3: datagrams
+    for (int32_t i = 0; i < 3; i++) {          // 3: datagrams
+        EXPECT_EQ(recorder->received_[i]->Data()[0], i);
+    }
+}
+
+// 测试SendBatch批量发送, 包括末尾较短的报文
+HWTEST_F(NetworkUdpUnitTest, NetworkUdpUnitTest_023, TestSize.Level0)
+{
+    int32_t rx = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(rx, 0);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(8890);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(bind(rx, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)), 0);
+    struct timeval timeout = {1, 0}; // 1: second
+    setsockopt(rx, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    auto clientPtr = std::make_shared<UdpClient>();
+    ASSERT_TRUE(clientPtr != nullptr);
+    ASSERT_TRUE(clientPtr->Connect("127.0.0.1", 8890, "127.0.0.1", 8891));
+    std::vector<DataBuffer::Ptr> bufs;
+    for (int32_t i = 0; i < 70; i++) {                  // 70: more than one batch
+        auto buf = std::make_shared<DataBuffer>(1328); // 1328: ts over rtp
+        buf->SetSize(i == 69 ? 100 : 1328);            // 69: last, 100: short tail, 1328: ts over rtp
+        memset(buf->Data(), i, buf->Size());
+        bufs.push_back(buf);
+    }
+    EXPECT_TRUE(clientPtr->SendBatch(bufs));
+
+    char recvBuf[2048] = {0};
+    for (int32_t i = 0; i < 70; i++) { // 70: sent datagrams
+        ASSERT_EQ(recv(rx, recvBuf, sizeof(recvBuf), 0), bufs[i]->Size());
+        EXPECT_EQ(recvBuf[0], static_cast<char>(i));
+    }
+    clientPtr->Disconnect();
+    close(rx);
+}
+
+class GroupRecorder final : public IServerCallback {
+public:
+    void OnServerClose(int32_t fd) override {}
+    void OnServerWriteable(int32_t fd) override {}
+    void OnServerException(int32_t fd) override {}
+    void OnAccept(std::weak_ptr<INetworkSession> session) override {}
+    void OnServerReadData(int32_t fd, DataBuffer::Ptr buf, INetworkSession::Ptr session) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        received_.emplace_back(buf->Peek(), buf->Size());
+    }
+
+    std::vector<std::string> Received()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return received_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::string> received_;
+};
+
+// 测试组播: 同一台机器上的两个接收端经回环接口收到同一份报文
+HWTEST_F(NetworkUdpUnitTest, NetworkUdpUnitTest_024, TestSize.Level0)
+{
+    EXPECT_TRUE(SocketUtils::IsMulticastIp("239.255.43.21"));
+    EXPECT_FALSE(SocketUtils::IsMulticastIp("127.0.0.1"));
+    EXPECT_FALSE(SocketUtils::IsMulticastIp("invalid"));
+
+    const std::string group = "239.255.43.21";
+    std::shared_ptr<GroupRecorder> recorders[2];
+    std::shared_ptr<UdpServer> servers[2];
+    for (int32_t i = 0; i < 2; i++) { // 2: sinks
+        recorders[i] = std::make_shared<GroupRecorder>();
+        servers[i] = std::make_shared<UdpServer>();
+        servers[i]->RegisterCallback(recorders[i]);
+        ASSERT_TRUE(servers[i]->Start(8892, ""));
+        EXPECT_FALSE(servers[i]->JoinMulticastGroup("127.0.0.1", "127.0.0.1"));
+        ASSERT_TRUE(servers[i]->JoinMulticastGroup(group, "127.0.0.1"));
+    }
+
+    auto unicastClient = std::make_shared<UdpClient>();
+    ASSERT_TRUE(unicastClient->Connect("127.0.0.1", 8893, "127.0.0.1", 0));
+    EXPECT_FALSE(unicastClient->SetMulticastOptions(1, true, "127.0.0.1"));
+    unicastClient->Disconnect();
+
+    auto clientPtr = std::make_shared<UdpClient>();
+    ASSERT_TRUE(clientPtr->Connect(group, 8892, "127.0.0.1", 0));
+    ASSERT_TRUE(clientPtr->SetMulticastOptions(1, true, "127.0.0.1"));
+    const std::string msg = "multicast";
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2); // 2: seconds
+    bool received = false;
+    while (!received && std::chrono::steady_clock::now() < deadline) {
+        EXPECT_TRUE(clientPtr->Send(msg.data(), msg.size()));
+        usleep(100 * 1000); // 100 * 1000: 100 ms
+        received = !recorders[0]->Received().empty() && !recorders[1]->Received().empty();
+    }
+    ASSERT_TRUE(received);
+    for (int32_t i = 0; i < 2; i++) { // 2: sinks
+        EXPECT_EQ(recorders[i]->Received().front(), msg);
+        EXPECT_TRUE(servers[i]->LeaveMulticastGroup(group, "127.0.0.1"));
+        servers[i]->Stop();
+    }
+    clientPtr->Disconnect();
+}
 
 } // namespace
 } // namespace Sharing
@@ -275,6 +275,58 @@ HWTEST_F(FrameUnitTest, H264Frame_007, Function | SmallTest | Level2)
     EXPECT_NE(ret, true);
 }
 
+HWTEST_F(FrameUnitTest, H264Frame_008, Function | SmallTest | Level2)
+{
+    // start codes at every offset of a buffer longer than one vector block
+    for (size_t pos = 0; pos + 3 <= 100; pos++) { // 100: buffer size, 3: start code size
+        std::string buf(100, '\x5a'); // 100: buffer size
+        buf[pos] = 0x00;
+        buf[pos + 1] = 0x00;
+        buf[pos + 2] = 0x01; // 2: byte offset
+        EXPECT_EQ(FindStartCode(buf.data(), buf.data() + buf.size()), buf.data() + pos);
+        buf[pos + 2] = 0x02; // 2: byte offset
+        EXPECT_EQ(FindStartCode(buf.data(), buf.data() + buf.size()), nullptr);
+    }
+    const char tail[] = {0x00, 0x00};
+    EXPECT_EQ(FindStartCode(tail, tail + sizeof(tail)), nullptr);
+    EXPECT_EQ(FindStartCode(nullptr, nullptr), nullptr);
+}
+
+HWTEST_F(FrameUnitTest, H264Frame_009, Function | SmallTest | Level2)
+{
+    std::string sps = std::string("\x00\x00\x00\x01\x67\x42", 6);                   // 6: sps size
+    std::string pps = std::string("\x00\x00\x01\x68\xce", 5);                        // 5: pps size
+    std::string idr = std::string("\x00\x00\x00\x01\x65", 5) + std::string(64, '\x11'); // 5, 64: idr size
+    std::string au = sps + pps + idr;
+    std::vector<std::pair<size_t, size_t>> nalus;
+    SplitH264(au.data(), au.size(), 0, [&](const char *ptr, size_t len, size_t prefix) {
+        nalus.emplace_back(ptr - au.data(), len);
+        EXPECT_EQ(PrefixSize(ptr, len), prefix);
+    });
+    ASSERT_EQ(nalus.size(), 3U); // 3: sps, pps, idr
+    EXPECT_EQ(nalus[0], std::make_pair(size_t(0), sps.size()));
+    EXPECT_EQ(nalus[1], std::make_pair(sps.size(), pps.size()));
+    EXPECT_EQ(nalus[2], std::make_pair(sps.size() + pps.size(), idr.size())); // 2: third nalu
+}
+
+HWTEST_F(FrameUnitTest, SharedFrame_001, Function | SmallTest | Level2)
+{
+    uint8_t idr[] = {0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84};
+    auto buffer = std::make_shared<DataBuffer>();
+    buffer->Assign(reinterpret_cast<char *>(idr), sizeof(idr));
+    auto frame = std::make_shared<SharedFrame<H264Frame>>(buffer);
+    ASSERT_NE(frame, nullptr);
+    frame->prefixSize_ = PrefixSize(reinterpret_cast<char *>(frame->Data()), frame->Size());
+    EXPECT_EQ(frame->Data(), buffer->Data());
+    EXPECT_EQ(frame->Size(), buffer->Size());
+    EXPECT_EQ(frame->PrefixSize(), 4); // 4: start code size
+    EXPECT_TRUE(frame->KeyFrame());
+    EXPECT_EQ(buffer.use_count(), 2); // 2: owner and frame
+    frame = nullptr;
+    EXPECT_EQ(buffer.use_count(), 1);
+    EXPECT_EQ(buffer->Size(), sizeof(idr));
+}
+
 } // namespace
 } // namespace Sharing
 } // namespace OHOS
\ No newline at end of file
@@ -15,6 +15,7 @@
 
 #include "rtcp_unit_test.h"
 #include <iostream>
+#include <netinet/in.h>
 #include "common/sharing_log.h"
 #include "protocol/rtcp/include/rtcp_context.h"
 
@@ -422,6 +423,130 @@ HWTEST_F(RtcpUnitTest, RtcpXRDLRR_048, Function | SmallTest | Level2)
     auto ret = RtcpXRDLRR::Create(0);
     EXPECT_NE(ret, nullptr);
 }
+
+HWTEST_F(RtcpUnitTest, RtcpFB_049, Function | SmallTest | Level2)
+{
+    // 65535 and 0..15 share one item across the wrap, 100 starts a new one
+    std::vector<uint16_t> seqs = {65535, 0, 3, 15, 100};
+    auto nack = RtcpFB::CreateNack(0x3000, 0x2000, seqs); // 0x3000, 0x2000: ssrc
+    ASSERT_NE(nack, nullptr);
+    EXPECT_EQ(nack->version_, 2);
+    EXPECT_EQ(nack->pt_, static_cast<uint8_t>(RtcpType::RTCP_RTPFB));
+    EXPECT_EQ(nack->reportCount_, static_cast<uint8_t>(RtpfbType::RTCP_RTPFB_NACK));
+    EXPECT_EQ(nack->GetFciSize(), 8); // 8: two items
+    EXPECT_EQ(ntohl(nack->ssrcMedia_), 0x2000U);
+    EXPECT_EQ(nack->GetNackSeqs(), seqs);
+
+    // the first byte on the wire carries the version
+    EXPECT_EQ(reinterpret_cast<uint8_t *>(nack.get())[0], 0x81); // 0x81: v=2, fmt=1
+    EXPECT_EQ(reinterpret_cast<uint8_t *>(nack.get())[1], 205);  // 205: rtpfb
+
+    EXPECT_EQ(RtcpFB::CreateNack(0x3000, 0x2000, {}), nullptr); // 0x3000, 0x2000: ssrc
+    auto pli = RtcpFB::Create(PsfbType::RTCP_PSFB_PLI);
+    ASSERT_NE(pli, nullptr);
+    EXPECT_TRUE(pli->GetNackSeqs().empty());
+}
+
+HWTEST_F(RtcpUnitTest, RtcpFB_050, Function | SmallTest | Level2)
+{
+    auto sr = RtcpSR::Create(0);
+    auto nack = RtcpFB::CreateNack(0x3000, 0x2000, {1, 2}); // 0x3000, 0x2000: ssrc
+    ASSERT_NE(sr, nullptr);
+    ASSERT_NE(nack, nullptr);
+    std::string compound(reinterpret_cast<char *>(sr.get()), sr->GetSize());
+    compound.append(reinterpret_cast<char *>(nack.get()), nack->GetSize());
+
+    auto list = RtcpHeader::LoadFromBytes(reinterpret_cast<uint8_t *>(compound.data()), compound.size());
+    ASSERT_EQ(list.size(), 2U);
+    EXPECT_EQ(list[0]->pt_, static_cast<uint8_t>(RtcpType::RTCP_SR));
+    EXPECT_EQ(reinterpret_cast<RtcpFB *>(list[1])->GetNackSeqs(), std::vector<uint16_t>({1, 2}));
+
+    // a truncated packet invalidates the whole compound
+    list = RtcpHeader::LoadFromBytes(reinterpret_cast<uint8_t *>(compound.data()), compound.size() - 4);
+    EXPECT_TRUE(list.empty());
+    EXPECT_TRUE(RtcpHeader::LoadFromBytes(nullptr, 0).empty());
+}
+
+HWTEST_F(RtcpUnitTest, RtcpFB_051, Function | SmallTest | Level2)
+{
+    auto pli = RtcpFB::CreatePli(0x3000, 0x2000); // 0x3000, 0x2000: ssrc
+    ASSERT_NE(pli, nullptr);
+    EXPECT_EQ(pli->GetSize(), 12);                              // 12: header and two ssrc
+    EXPECT_EQ(reinterpret_cast<uint8_t *>(pli.get())[1], 206); // 206: psfb
+    EXPECT_TRUE(pli->IsKeyFrameRequest(0x2000));
+    EXPECT_FALSE(pli->IsKeyFrameRequest(0x2001));
+
+    // a fir names the media source in its fci
+    RtcpFirItem item = {htonl(0x2000), 1, {0}};
+    auto fir = RtcpFB::Create(PsfbType::RTCP_PSFB_FIR, &item, sizeof(item));
+    ASSERT_NE(fir, nullptr);
+    fir->ssrcMedia_ = 0;
+    EXPECT_TRUE(fir->IsKeyFrameRequest(0x2000));
+    EXPECT_FALSE(fir->IsKeyFrameRequest(0x2001));
+
+    auto nack = RtcpFB::CreateNack(0x3000, 0x2000, {1}); // 0x3000, 0x2000: ssrc
+    ASSERT_NE(nack, nullptr);
+    EXPECT_FALSE(nack->IsKeyFrameRequest(0x2000));
+}
+
+HWTEST_F(RtcpUnitTest, RtcpSenderContext_052, Function | SmallTest | Level2)
+{
+    auto sender = std::make_shared<RtcpSenderContext>();
+    auto receiver = std::make_shared<RtcpReceiverContext>();
+    auto sr = sender->CreateRtcpSR(0x2000); // 0x2000: ssrc
+    ASSERT_NE(sr, nullptr);
+    receiver->OnRtcp(reinterpret_cast<RtcpHeader *>(sr->Data()));
+
+    auto rr = receiver->CreateRtcpRR(0x3000, 0x2000); // 0x3000, 0x2000: ssrc
+    ASSERT_NE(rr, nullptr);
+    sender->OnRtcp(reinterpret_cast<RtcpHeader *>(rr->Data()));
+    // the round trip is answered for the media ssrc the report block names
+    ASSERT_EQ(sender->rtt_.size(), 1U);
+    EXPECT_EQ(sender->rtt_.begin()->first, 0x2000U);
+    EXPECT_LT(sender->GetRtt(0x2000), 1000U); // 1000: ms, both ends are local
+}
+
+HWTEST_F(RtcpUnitTest, RtcpReceiverContext_053, Function | SmallTest | Level2)
+{
+    auto sender = std::make_shared<RtcpSenderContext>();
+    auto receiver = std::make_shared<RtcpReceiverContext>();
+    // 100..109 with 103 and 104 lost and 105 duplicated
+    for (uint16_t seq : {100, 101, 102, 105, 105, 106, 107, 108, 109}) {
+        receiver->OnRtp(seq, seq * 3000, 0, 90000, 1000); // 3000: stamp step, 90000: clock, 1000: bytes
+    }
+    auto rr = receiver->CreateRtcpRR(0x3000, 0x2000); // 0x3000, 0x2000: ssrc
+    ASSERT_NE(rr, nullptr);
+    auto data = reinterpret_cast<const uint8_t *>(rr->Data());
+    ASSERT_EQ(rr->Size(), 32); // 32: header, ssrc and one report block
+    EXPECT_EQ(data[1], static_cast<uint8_t>(RtcpType::RTCP_RR));
+    EXPECT_EQ((data[8] << 24) | (data[9] << 16) | (data[10] << 8) | data[11], 0x2000);
+    // one in ten lost once the duplicate is counted: 256 / 10
+    EXPECT_EQ(data[12], 25); // 25: fraction lost
+    EXPECT_EQ((data[13] << 16) | (data[14] << 8) | data[15], 1);
+    EXPECT_EQ((data[18] << 8) | data[19], 109); // 109: highest seq
+
+    // more duplicates than losses report nothing lost rather than wrapping
+    receiver->OnRtp(109, 109 * 3000, 0, 90000, 1000); // 109: seq, 3000: stamp step, 90000: clock, 1000: bytes
+    receiver->OnRtp(109, 109 * 3000, 0, 90000, 1000); // 109: seq, 3000: stamp step, 90000: clock, 1000: bytes
+    EXPECT_EQ(receiver->GetLost(), 0U);
+    EXPECT_EQ(receiver->GetLostInterval(), 0U);
+
+    // no dlrr before an rrtr arrived, then the receiver learns the round trip
+    EXPECT_EQ(sender->CreateRtcpXRDLRR(0x2000, 0x3000), nullptr); // 0x2000, 0x3000: ssrc
+    auto rrtr = receiver->CreateRtcpXRRRTR(0x3000);                // 0x3000: ssrc
+    ASSERT_NE(rrtr, nullptr);
+    sender->OnRtcp(reinterpret_cast<RtcpHeader *>(rrtr->Data()));
+    auto dlrr = sender->CreateRtcpXRDLRR(0x2000, 0x3000); // 0x2000, 0x3000: ssrc
+    ASSERT_NE(dlrr, nullptr);
+    auto list = RtcpHeader::LoadFromBytes(reinterpret_cast<uint8_t *>(dlrr->Data()), dlrr->Size());
+    ASSERT_EQ(list.size(), 1U);
+    auto items = reinterpret_cast<RtcpXRDLRR *>(list[0])->GetItemList();
+    ASSERT_EQ(items.size(), 1U);
+    EXPECT_EQ(ntohl(items[0]->ssrc_), 0x3000U);
+    receiver->rtt_ = UINT32_MAX;
+    receiver->OnRtcp(list[0]);
+    EXPECT_LT(receiver->GetRtt(), 1000U); // 1000: ms, both ends are local
+}
 } // namespace
 } // namespace Sharing
 } // namespace OHOS
\ No newline at end of file
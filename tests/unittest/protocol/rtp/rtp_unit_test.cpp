@@ -15,7 +15,13 @@
 
 #include "rtp_unit_test.h"
 #include <gtest/gtest.h>
+#include <chrono>
 #include <iostream>
+#include <thread>
+#include <securec.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include "common/sharing_log.h"
 #include "sink/protocol/rtp/include/adts.h"
 #include "sink/protocol/rtp/include/rtp_decoder_aac.h"
@@ -25,13 +31,23 @@
 #include "sink/protocol/rtp/include/rtp_decoder_h264.h"
 #include "source/protocol/rtp/include/rtp_encoder_h264.h"
 #include "sink/protocol/rtp/include/rtp_decoder_ts.h"
+#include "sink/protocol/rtp/include/rtp_fec_decoder.h"
 #include "source/protocol/rtp/include/rtp_encoder_ts.h"
+#include "source/protocol/rtp/include/rtp_fanout.h"
 #include "sink/protocol/rtp/include/rtp_sink_factory.h"
 #include "source/protocol/rtp/include/rtp_source_factory.h"
+#include "source/protocol/rtp/include/rtp_fec_encoder.h"
 #include "source/protocol/rtp/include/rtp_maker.h"
+#include "source/protocol/rtp/include/rtp_pacer.h"
+#include "source/protocol/rtp/include/rtp_packet_history.h"
+#include "source/protocol/rtp/include/rtp_rate_controller.h"
 #include "source/protocol/rtp/include/rtp_pack.h"
 #include "source/protocol/rtp/include/rtp_pack_impl.h"
+#include "protocol/frame/aac_frame.h"
+#include "protocol/frame/h264_frame.h"
 #include "protocol/rtp/include/rtp_packet.h"
+#include "protocol/rtp/include/ts_def.h"
+#include "utils/packet_pool.h"
 #include "sink/protocol/rtp/include/rtp_queue.h"
 #include "sink/protocol/rtp/include/rtp_unpack_impl.h"
 
@@ -632,35 +648,52 @@ HWTEST_F(RtpUnitTest, RtpUnitTest_049, Function | SmallTest | Level2)
 {
     auto decoder = std::make_shared<RtpDecoderTs>();
     EXPECT_NE(decoder, nullptr);
-    const auto rtp = std::make_shared<RtpPacket>();
-    EXPECT_NE(rtp, nullptr);
-    rtp->Resize(sizeof(RtpHeader));
-    RtpHeader *head = rtp->GetHeader();
-    EXPECT_NE(head, nullptr);
-    head->version_ = 1;
-    head->padding_ = 0;
-    head->ext_ = 1;
-    head->csrc_ = 2;
-    head->mark_ = 1;
-    head->pt_ = 1;
-    head->seq_ = 12;
-    head->stamp_ = 1212;
-    head->ssrc_ = 33;
-    head->payload_ = 24;
-    decoder->dataQueue_.emplace(rtp);
-    int bufSize = sizeof(RtpHeader);
-    auto buf = std::make_shared<uint8_t>(bufSize);
-    auto ret = decoder->ReadPacket(buf.get(), bufSize);
-    EXPECT_EQ(ret, 0);
+    std::vector<Frame::Ptr> frames;
+    decoder->SetOnFrame([&frames](const Frame::Ptr &frame) { frames.push_back(frame); });
+    auto encoder = std::make_shared<RtpEncoderTs>(1, 1400, 90000, 33); // 1400: mtu, 90000: clock, 33: MP2T
+    EXPECT_NE(encoder, nullptr);
+    encoder->SetOnRtpPack([&decoder](const RtpPacket::Ptr &rtp) { decoder->InputRtp(rtp); });
+
+    uint8_t sps[] = {0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x1f};
+    uint8_t idr[2000] = {0x00, 0x00, 0x00, 0x01, 0x65, 0x88};
+    uint8_t next[] = {0x00, 0x00, 0x00, 0x01, 0x41, 0x9a};
+    uint8_t aac[300] = {0xff, 0xf1};
+    encoder->InputFrame(std::make_shared<H264Frame>(sps, sizeof(sps), 40, 40, 4)); // 40: pts, 4: prefix
+    encoder->InputFrame(std::make_shared<H264Frame>(idr, sizeof(idr), 40, 40, 4)); // 40: pts, 4: prefix
+    encoder->InputFrame(std::make_shared<AACFrame>(aac, sizeof(aac), 50, 50));     // 50: pts
+    // the video pes is unbounded, it completes when the next one starts
+    encoder->InputFrame(std::make_shared<H264Frame>(next, sizeof(next), 80, 80, 4)); // 80: pts, 4: prefix
+
+    ASSERT_EQ(frames.size(), 3U); // 3: aac, sps, idr
+    EXPECT_EQ(frames[0]->GetTrackType(), TRACK_AUDIO);
+    EXPECT_EQ(frames[0]->Size(), (int32_t)sizeof(aac));
+    EXPECT_EQ(memcmp(frames[0]->Peek(), aac, sizeof(aac)), 0);
+    EXPECT_EQ(frames[1]->Size(), (int32_t)sizeof(sps));
+    EXPECT_EQ(memcmp(frames[1]->Data(), sps, sizeof(sps)), 0);
+    EXPECT_EQ(frames[2]->Size(), (int32_t)sizeof(idr));
+    EXPECT_TRUE(frames[2]->KeyFrame());
+    EXPECT_EQ(frames[2]->Pts() - frames[1]->Pts(), 0U);
+    EXPECT_EQ(frames[0]->Pts() - frames[2]->Pts(), 10000U); // 10000: 10ms in us
 }
 
 HWTEST_F(RtpUnitTest, RtpUnitTest_050, Function | SmallTest | Level2)
 {
-    void *opaque = nullptr;
-    uint8_t *buf = nullptr;
-    int bufSize = 0;
-    auto ret = RtpDecoderTs::StaticReadPacket(opaque, buf, bufSize);
-    EXPECT_EQ(ret, 0);
+    auto decoder = std::make_shared<RtpDecoderTs>();
+    EXPECT_NE(decoder, nullptr);
+    size_t count = 0;
+    decoder->SetOnFrame([&count](const Frame::Ptr &) { count++; });
+    auto rtp = std::make_shared<RtpPacket>();
+    rtp->SetCapacity(RtpPacket::RTP_HEADER_SIZE + TS_PACKET_SIZE * 2); // 2: packets
+    rtp->SetSize(RtpPacket::RTP_HEADER_SIZE + TS_PACKET_SIZE * 2);     // 2: packets
+    (void)memset_s(rtp->Data(), rtp->Capacity(), 0, rtp->Capacity());
+    rtp->GetHeader()->version_ = RtpPacket::RTP_VERSION;
+    uint8_t *ts = rtp->GetPayload();
+    ts[TS_PACKET_SIZE] = TS_SYNC_BYTE; // a pes on an unknown pid before any pmt
+    ts[TS_PACKET_SIZE + 1] = 0x50;     // 1: unit start, pid 0x1011
+    ts[TS_PACKET_SIZE + 2] = 0x11;     // 2: pid low
+    ts[TS_PACKET_SIZE + 3] = 0x10;     // 3: payload only
+    decoder->InputRtp(rtp);
+    EXPECT_EQ(count, 0U);
 }
 
 HWTEST_F(RtpUnitTest, RtpUnitTest_051, Function | SmallTest | Level2)
@@ -1123,8 +1156,9 @@ HWTEST_F(RtpUnitTest, RtpUnitTest_093, Function | SmallTest | Level2)
     auto rtpPacket = std::make_shared<RtpPacket>();
     EXPECT_NE(rtpPacket, nullptr);
     rtpPacket->Resize(sizeof(RtpHeader));
-    rtpSortor->pktSortCacheMap_.emplace(seq, std::move(rtpPacket));
+    rtpSortor->StoreSlot(seq, std::move(rtpPacket));
     rtpSortor->TryPopPacket();
+    EXPECT_EQ(rtpSortor->GetJitterSize(), 0U);
 }
 
 HWTEST_F(RtpUnitTest, RtpUnitTest_094, Function | SmallTest | Level2)
@@ -1169,11 +1203,11 @@ HWTEST_F(RtpUnitTest, RtpUnitTest_096, Function | SmallTest | Level2)
         (void)packet;
     };
     rtpSortor->SetOnSort(f);
-    std::map<uint16_t, RtpPacket::Ptr> rtpMap;
     auto rtp = std::make_shared<RtpPacket>();
     EXPECT_NE(rtp, nullptr);
-    rtpMap[0] = rtp;
-    rtpSortor->PopIterator(rtpMap.begin());
+    rtpSortor->StoreSlot(0, std::move(rtp));
+    rtpSortor->PopSlot(0);
+    EXPECT_EQ(rtpSortor->GetJitterSize(), 0U);
 }
 
 HWTEST_F(RtpUnitTest, RtpUnitTest_097, Function | SmallTest | Level2)
@@ -1283,6 +1317,744 @@ HWTEST_F(RtpUnitTest, RtpUnitTest_105, Function | SmallTest | Level2)
     rtpUnpack->CreateRtpDecoder(rpp);
 }
 
+HWTEST_F(RtpUnitTest, RtpUnitTest_106, Function | SmallTest | Level2)
+{
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(TsCrc32(check, sizeof(check)), 0x0376E6E7U);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_107, Function | SmallTest | Level2)
+{
+    auto encoder = std::make_shared<RtpEncoderTs>(1, 1400, 90000, 33); // 1400: mtu, 90000: clock, 33: MP2T
+    ASSERT_NE(encoder, nullptr);
+    std::vector<RtpPacket::Ptr> rtps;
+    encoder->SetOnRtpPack([&rtps](const RtpPacket::Ptr &rtp) { rtps.push_back(rtp); });
+
+    uint8_t sps[] = {0x00, 0x00, 0x00, 0x01, 0x67, 0x42, 0x00, 0x1f};
+    uint8_t idr[1000] = {0x00, 0x00, 0x00, 0x01, 0x65, 0x88};
+    encoder->InputFrame(std::make_shared<H264Frame>(sps, sizeof(sps), 40, 40, 4)); // 40: pts, 4: prefix
+    EXPECT_TRUE(rtps.empty());
+    encoder->InputFrame(std::make_shared<H264Frame>(idr, sizeof(idr), 40, 40, 4)); // 40: pts, 4: prefix
+    ASSERT_FALSE(rtps.empty());
+
+    size_t tsCount = 0;
+    for (auto &rtp : rtps) {
+        EXPECT_EQ(rtp->GetPayloadSize() % TS_PACKET_SIZE, 0U);
+        EXPECT_LE(rtp->GetPayloadSize(), TS_PACKETS_PER_RTP * TS_PACKET_SIZE);
+        EXPECT_TRUE(rtp->GetHeader()->mark_);
+        for (size_t offset = 0; offset < rtp->GetPayloadSize(); offset += TS_PACKET_SIZE) {
+            EXPECT_EQ(rtp->GetPayload()[offset], TS_SYNC_BYTE);
+            tsCount++;
+        }
+    }
+    // pat, pmt, pcr, then 14 + 6 + 8 + 1000 bytes of pes (header, aud, sps, idr) in 6 packets
+    EXPECT_EQ(tsCount, 9U);
+    uint8_t *first = rtps.front()->GetPayload();
+    EXPECT_EQ(first[1] & 0x1F, 0);                                  // 1: pat pid high
+    EXPECT_EQ(first[TS_PACKET_SIZE + 2], TS_PID_PMT & 0xFF);        // 2: pmt pid low
+    EXPECT_EQ(first[TS_PACKET_SIZE * 2 + 5] & 0x10, 0x10);          // 5: pcr flag
+    uint8_t *pes = first + TS_PACKET_SIZE * 3;                      // 3: pat, pmt, pcr
+    EXPECT_EQ(pes[1] & 0x40, 0x40);                                 // 1: payload_unit_start_indicator
+    EXPECT_EQ(pes[5] & 0x40, 0x40);                                 // 5: random_access_indicator
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_108, Function | SmallTest | Level2)
+{
+    auto encoder = std::make_shared<RtpEncoderTs>(1, 1400, 90000, 33); // 1400: mtu, 90000: clock, 33: MP2T
+    ASSERT_NE(encoder, nullptr);
+    size_t count = 0;
+    encoder->SetOnRtpPack([&count](const RtpPacket::Ptr &rtp) { count++; });
+    encoder->Release();
+    uint8_t idr[] = {0x00, 0x00, 0x00, 0x01, 0x65, 0x88};
+    encoder->InputFrame(std::make_shared<H264Frame>(idr, sizeof(idr), 0, 0, 4)); // 4: prefix
+    EXPECT_EQ(count, 0U);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_109, Function | SmallTest | Level2)
+{
+    auto rtp = RtpPacket::Create(1400); // 1400: mtu
+    ASSERT_NE(rtp, nullptr);
+    ASSERT_NE(rtp->Data(), nullptr);
+    EXPECT_EQ(rtp->Capacity(), 1400); // 1400: mtu
+    uint8_t *storage = rtp->Data();
+    rtp = nullptr;
+
+    // the thread cache hands the block just released out again
+    auto before = PacketPool::GetStats();
+    rtp = RtpPacket::Create(1400); // 1400: mtu
+    ASSERT_NE(rtp, nullptr);
+    EXPECT_EQ(rtp->Data(), storage);
+    auto after = PacketPool::GetStats();
+    EXPECT_EQ(after.hits, before.hits + 1);
+    EXPECT_EQ(after.misses, before.misses);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_110, Function | SmallTest | Level2)
+{
+    // larger than a pool block, served by the heap
+    auto before = PacketPool::GetStats();
+    auto buffer = DataBuffer::CreatePooled(PacketPool::BlockSize() * 2); // 2: blocks
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_EQ(buffer->Capacity(), (int32_t)PacketPool::BlockSize() * 2); // 2: blocks
+    EXPECT_EQ(PacketPool::GetStats().hits + PacketPool::GetStats().misses, before.hits + before.misses);
+
+    // a pooled buffer keeps its block across moves and regrows onto the heap
+    auto small = DataBuffer::CreatePooled(100); // 100: bytes
+    ASSERT_NE(small, nullptr);
+    uint8_t *storage = small->Data();
+    DataBuffer moved(std::move(*small));
+    EXPECT_EQ(moved.Data(), storage);
+    std::string payload(PacketPool::BlockSize() + 1, 'a');
+    moved.Assign(payload.data(), payload.size());
+    EXPECT_EQ(moved.Size(), (int32_t)payload.size());
+    EXPECT_EQ(memcmp(moved.Data(), payload.data(), payload.size()), 0);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_111, Function | SmallTest | Level2)
+{
+    RtpPacer::Config config;
+    config.bitrate = 0;
+    config.spreadPercent = 50; // 50: half the interval
+    config.burstPackets = 4;   // 4: packets
+    auto pacer = std::make_shared<RtpPacer>(config);
+    std::mutex mutex;
+    std::vector<uint8_t> order;
+    pacer->SetOnSend([&](const std::vector<DataBuffer::Ptr> &packets) {
+        std::lock_guard<std::mutex> lock(mutex);
+        EXPECT_LE(packets.size(), 4U); // 4: burst
+        for (auto &packet : packets) {
+            order.push_back(packet->Data()[0]);
+        }
+    });
+    ASSERT_TRUE(pacer->Start());
+
+    std::vector<DataBuffer::Ptr> frame;
+    for (uint8_t i = 0; i < 40; i++) {  // 40: packets
+        auto packet = std::make_shared<DataBuffer>(1000); // 1000: bytes
+        packet->SetSize(1000);                             // 1000: bytes
+        packet->Data()[0] = i;
+        frame.push_back(packet);
+    }
+
+    // 40000 bytes within 50ms, the nine bursts after the first one take 45ms
+    auto start = std::chrono::steady_clock::now();
+    pacer->InputFrame(std::move(frame), 100); // 100: ms interval
+    for (int32_t i = 0; i < 100 && pacer->TakeStats().frames == 0; i++) { // 100: 1s at most
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));     // 10: ms
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    pacer->Stop();
+
+    EXPECT_GE(elapsed, std::chrono::milliseconds(40)); // 40: ms
+    ASSERT_EQ(order.size(), 40U);                        // 40: packets
+    for (uint8_t i = 0; i < 40; i++) {                   // 40: packets
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_112, Function | SmallTest | Level2)
+{
+    RtpPacer::Config config;
+    config.bitrate = 8000;   // 8000: 1000 bytes per second
+    config.headroomPercent = 100;
+    config.burstPackets = 1;
+    config.maxQueueFrames = 2;
+    auto pacer = std::make_shared<RtpPacer>(config);
+    size_t sent = 0;
+    pacer->SetOnSend([&sent](const std::vector<DataBuffer::Ptr> &packets) { sent += packets.size(); });
+
+    auto makeFrame = []() {
+        std::vector<DataBuffer::Ptr> frame;
+        for (int32_t i = 0; i < 10; i++) {                   // 10: packets
+            auto packet = std::make_shared<DataBuffer>(1000); // 1000: bytes
+            packet->SetSize(1000);                             // 1000: bytes
+            frame.push_back(packet);
+        }
+        return frame;
+    };
+
+    // dropped while stopped
+    pacer->InputFrame(makeFrame(), 0);
+    EXPECT_EQ(pacer->TakeStats().maxQueueDepth, 0U);
+
+    ASSERT_TRUE(pacer->Start());
+    for (int32_t i = 0; i < 4; i++) { // 4: frames, ten seconds each at the configured rate
+        pacer->InputFrame(makeFrame(), 0);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50)); // 50: ms
+    auto stats = pacer->TakeStats();
+    EXPECT_GE(stats.maxQueueDepth, 3U); // 3: first frame taken right away at the earliest
+
+    // stop interrupts the pacing wait instead of sending the rest
+    auto start = std::chrono::steady_clock::now();
+    pacer->Stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+    EXPECT_LT(sent, 40U); // 40: all packets
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_113, Function | SmallTest | Level2)
+{
+    auto rtpSortor = std::make_shared<RtpPacketSortor>(90000, 1024, 4); // 90000: clock, 1024, 4: cache
+    std::vector<uint16_t> sorted;
+    std::vector<uint16_t> lost;
+    rtpSortor->SetOnSort([&sorted](uint16_t seq, const RtpPacket::Ptr &) { sorted.push_back(seq); });
+    rtpSortor->SetOnLost([&lost](const std::vector<uint16_t> &seqs) {
+        lost.insert(lost.end(), seqs.begin(), seqs.end());
+    });
+
+    // 2 and 3 go missing, 2 is retransmitted after the nack, 3 never comes
+    for (uint16_t seq : {0, 1, 4, 5, 6, 2, 7, 8, 9, 10, 11}) {
+        rtpSortor->SortPacket(seq, std::make_shared<RtpPacket>());
+    }
+    EXPECT_EQ(lost, std::vector<uint16_t>({2, 3}));
+    EXPECT_EQ(sorted, std::vector<uint16_t>({0, 1, 2, 4, 5, 6, 7, 8, 9, 10, 11}));
+
+    auto stats = rtpSortor->GetLossStats();
+    EXPECT_EQ(stats.nacked, 2U);      // 2: 2, 3
+    EXPECT_EQ(stats.recovered, 1U);   // 1: 2
+    EXPECT_EQ(stats.unrecovered, 1U); // 1: 3
+
+    // a jump beyond the cache is a restart rather than a loss
+    lost.clear();
+    rtpSortor->SortPacket(2000, std::make_shared<RtpPacket>()); // 2000: more than the cache
+    EXPECT_TRUE(lost.empty());
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_114, Function | SmallTest | Level2)
+{
+    auto history = std::make_shared<RtpPacketHistory>(3); // 3: rounded up to 4
+    auto maker = std::make_shared<RtpMaker>(0x2000, 1400, 33, 90000); // 0x2000: ssrc, 1400: mtu, 33: MP2T
+    uint8_t payload[188] = {0x47};                                      // 188: ts packet
+    for (int32_t i = 0; i < 6; i++) {                                  // 6: seq 0 to 5
+        history->Insert(maker->MakeRtp(payload, sizeof(payload), false, 0));
+    }
+
+    // 0 and 1 have been overwritten by 4 and 5
+    auto packets = history->Lookup({0, 1, 4, 5}, 1000); // 1000: ms
+    ASSERT_EQ(packets.size(), 2U);
+    EXPECT_EQ(std::static_pointer_cast<RtpPacket>(packets[0])->GetSeq(), 4);
+    EXPECT_EQ(std::static_pointer_cast<RtpPacket>(packets[1])->GetSeq(), 5);
+
+    // a second nack within the interval is not answered again
+    EXPECT_TRUE(history->Lookup({5}, 1000).empty()); // 1000: ms
+    EXPECT_EQ(history->Lookup({5}, 0).size(), 1U);
+
+    auto stats = history->GetStats();
+    EXPECT_EQ(stats.requested, 6U);     // 6: 4 + 1 + 1
+    EXPECT_EQ(stats.retransmitted, 3U); // 3: 4, 5, 5
+    EXPECT_EQ(stats.missing, 2U);       // 2: 0, 1
+    EXPECT_EQ(stats.throttled, 1U);
+
+    history->Clear();
+    EXPECT_TRUE(history->Lookup({4, 5}, 0).empty());
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_115, Function | SmallTest | Level2)
+{
+    auto h264 = std::make_shared<RtpDecoderH264>();
+    auto maker = std::make_shared<RtpMaker>(0x2000, 1400, 96, 90000, 100); // 0x2000: ssrc, 1400: mtu, 96: pt, 100: seq
+    std::vector<uint16_t> frames;
+    int32_t needed = 0;
+    h264->SetOnFrame([&frames](const Frame::Ptr &frame) { frames.push_back(frame->Data()[4]); }); // 4: start code
+    h264->SetOnKeyFrameNeeded([&needed]() { needed++; });
+
+    // idr, p, p lost, p, p, idr: the frames after the gap wait for the next idr and ask for it
+    uint8_t nals[] = {0x65, 0x41, 0x41, 0x41, 0x41, 0x65};
+    for (size_t i = 0; i < sizeof(nals); i++) {
+        uint8_t payload[] = {nals[i], 0x80}; // 0x80: first slice of the picture
+        auto rtp = maker->MakeRtp(payload, sizeof(payload), true, 0);
+        if (i != 2) { // 2: the lost one
+            h264->InputRtp(rtp);
+        }
+    }
+
+    EXPECT_EQ(frames, std::vector<uint16_t>({0x65, 0x41, 0x41, 0x65}));
+    EXPECT_EQ(needed, 1);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_116, Function | SmallTest | Level2)
+{
+    auto rtpSortor = std::make_shared<RtpPacketSortor>(90000, 16, 4); // 90000: clock, 16, 4: cache
+    std::vector<uint16_t> sorted;
+    rtpSortor->SetOnSort([&sorted](uint16_t seq, const RtpPacket::Ptr &) { sorted.push_back(seq); });
+
+    // reordered across the wrap, as for a stream that started at 65533
+    rtpSortor->nextSeqOut_ = 65533; // 65533: first seq
+    for (uint16_t seq : {65533, 65535, 0, 65534, 1, 1}) {
+        rtpSortor->SortPacket(seq, std::make_shared<RtpPacket>());
+    }
+    EXPECT_EQ(sorted, std::vector<uint16_t>({65533, 65534, 65535, 0, 1}));
+
+    // 2 never comes, a duplicate of a cached packet is dropped
+    sorted.clear();
+    for (uint16_t seq : {3, 3, 4, 5, 6}) {
+        rtpSortor->SortPacket(seq, std::make_shared<RtpPacket>());
+    }
+    EXPECT_TRUE(sorted.empty());
+    EXPECT_EQ(rtpSortor->GetJitterSize(), 4U); // 4: 3 to 6
+    rtpSortor->SortPacket(7, std::make_shared<RtpPacket>()); // 7: one more than the cache waits for
+    EXPECT_EQ(sorted, std::vector<uint16_t>({3, 4, 5, 6, 7}));
+    EXPECT_EQ(rtpSortor->GetJitterSize(), 0U);
+
+    // a jump beyond the ring flushes what waits in it
+    sorted.clear();
+    rtpSortor->SortPacket(9, std::make_shared<RtpPacket>());   // 9: 8 is missing
+    rtpSortor->SortPacket(200, std::make_shared<RtpPacket>()); // 200: more than the ring
+    EXPECT_EQ(sorted, std::vector<uint16_t>({9, 200}));
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_117, Function | SmallTest | Level2)
+{
+    auto rtpSortor = std::make_shared<RtpPacketSortor>(90000, 1024, 4); // 90000: clock, 1024, 4: cache
+    auto maker = std::make_shared<RtpMaker>(0x2000, 1400, 96, 90000, 0); // 0x2000: ssrc, 1400: mtu, 96: pt
+    std::vector<uint16_t> sorted;
+    rtpSortor->SetOnSort([&sorted](uint16_t seq, const RtpPacket::Ptr &) { sorted.push_back(seq); });
+    rtpSortor->SetPlayoutDelay(20, 200); // 20, 200: delay bounds in ms
+    uint8_t payload[] = {0x00};
+    // one packet every 10 ms, arrival and stamp in ms
+    auto input = [&](uint16_t seq, int64_t arrival) {
+        rtpSortor->SortPacket(seq, maker->MakeRtp(payload, sizeof(payload), false, seq * 10), arrival); // 10: ms
+    };
+
+    // on a clean link a gap is waited for the minimum delay, not for a packet count
+    for (uint16_t seq : {0, 1, 3, 4}) {
+        input(seq, seq * 10); // 10: ms
+    }
+    EXPECT_EQ(sorted, std::vector<uint16_t>({0, 1}));
+    EXPECT_EQ(rtpSortor->GetTargetDelay(), 20U); // 20: min delay
+    input(5, 50);                                 // 50: 3 has waited 20 ms
+    EXPECT_EQ(sorted, std::vector<uint16_t>({0, 1, 3, 4, 5}));
+
+    // 2 comes too late and raises the delay
+    input(2, 55); // 55: ms
+    input(6, 60); // 60: ms
+    input(7, 70); // 70: ms
+    auto stats = rtpSortor->GetPlayoutStats();
+    EXPECT_EQ(stats.lateDrops, 1U);
+    EXPECT_GT(stats.targetDelayMs, 20U); // 20: min delay
+
+    // bursty arrivals raise it further, bounded by the max
+    uint16_t seq = 8;
+    for (int32_t i = 0; i < 200; i++, seq++) {     // 200: packets
+        input(seq, seq * 10 + (i % 2 ? 40 : 0)); // 10, 40: ms
+    }
+    uint32_t bursty = rtpSortor->GetTargetDelay();
+    EXPECT_GT(bursty, 60U);   // 60: well above the clean link
+    EXPECT_LE(bursty, 200U);  // 200: max delay
+
+    // and it comes back down once the link calms
+    for (int32_t i = 0; i < 2000; i++, seq++) { // 2000: packets
+        input(seq, seq * 10);                   // 10: ms
+    }
+    EXPECT_LT(rtpSortor->GetTargetDelay(), 25U); // 25: close to the min delay
+    EXPECT_EQ(rtpSortor->GetPlayoutStats().lateDrops, 1U);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_118, Function | SmallTest | Level2)
+{
+    auto maker = std::make_shared<RtpMaker>(0x2000, 1400, 96, 90000, 0); // 0x2000: ssrc, 1400: mtu, 96: pt
+    auto encoder = std::make_shared<RtpFecEncoder>(127, 4, 4);             // 127: fec pt, 4: group packets
+    auto decoder = std::make_shared<RtpFecDecoder>(127);                   // 127: fec pt
+    std::vector<std::string> recovered;
+    decoder->SetOnRecovered([&recovered](const char *data, size_t len) { recovered.emplace_back(data, len); });
+
+    std::vector<RtpPacket::Ptr> media;
+    std::vector<RtpPacket::Ptr> parity;
+    for (uint32_t i = 0; i < 8; i++) { // 8: two groups
+        std::vector<uint8_t> payload(100 + i * 37, static_cast<uint8_t>(i * 11)); // 100, 37, 11: varied packets
+        auto rtp = maker->MakeRtp(payload.data(), payload.size(), i % 4 == 3, i * 3000); // 3: last of group, 3000
+        media.push_back(rtp);
+        auto fec = encoder->AddPacket(rtp);
+        if (fec != nullptr) {
+            EXPECT_EQ(fec->GetHeader()->pt_, 127); // 127: fec pt
+            parity.push_back(fec);
+        }
+    }
+    ASSERT_EQ(parity.size(), 2U);
+    EXPECT_EQ(encoder->Flush(), nullptr);
+
+    // one loss in the first group is rebuilt bit exact, marker and stamp included
+    for (uint32_t i = 0; i < 4; i++) { // 4: group packets
+        if (i != 2) {                  // 2: lost
+            decoder->InputMedia(reinterpret_cast<const char *>(media[i]->Data()), media[i]->Size());
+        }
+    }
+    decoder->InputFec(reinterpret_cast<const char *>(parity[0]->Data()), parity[0]->Size());
+    ASSERT_EQ(recovered.size(), 1U);
+    EXPECT_EQ(recovered[0], std::string(reinterpret_cast<const char *>(media[2]->Data()), media[2]->Size()));
+
+    // two losses are beyond a single parity
+    decoder->InputMedia(reinterpret_cast<const char *>(media[4]->Data()), media[4]->Size());
+    decoder->InputMedia(reinterpret_cast<const char *>(media[7]->Data()), media[7]->Size());
+    decoder->InputFec(reinterpret_cast<const char *>(parity[1]->Data()), parity[1]->Size());
+    EXPECT_EQ(recovered.size(), 1U);
+    auto stats = decoder->GetStats();
+    EXPECT_EQ(stats.parity, 2U);
+    EXPECT_EQ(stats.recovered, 1U);
+    EXPECT_EQ(stats.unrecoverable, 1U);
+
+    // the group shrinks with the loss rate, within the configured bounds
+    auto adaptive = std::make_shared<RtpFecEncoder>(127, 2, 16); // 127: fec pt, 2, 16: group bounds
+    EXPECT_EQ(adaptive->GetStats().groupPackets, 16U);          // 16: clean link
+    adaptive->OnLossRate(0.1);                                   // 0.1: 10% loss
+    EXPECT_EQ(adaptive->GetStats().groupPackets, 5U);           // 5: half a loss per group
+    adaptive->OnLossRate(0.9);                                   // 0.9: 90% loss
+    EXPECT_EQ(adaptive->GetStats().groupPackets, 2U);           // 2: min group
+    adaptive->OnLossRate(0.1);                                   // 0.1: 10% loss
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < 5; i++) { // 5: group packets
+        std::vector<uint8_t> payload(10, 0);  // 10: bytes
+        count += adaptive->AddPacket(maker->MakeRtp(payload.data(), payload.size(), false, 0)) != nullptr ? 1 : 0;
+    }
+    EXPECT_EQ(count, 1U);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_119, Function | SmallTest | Level2)
+{
+    RtpRateController::Config config;
+    config.startBitrate = 2000000; // 2000000: bit/s
+    config.minBitrate = 500000;    // 500000: bit/s
+    config.maxBitrate = 4000000;   // 4000000: bit/s
+    config.lowBitrate = 1000000;   // 1000000: bit/s
+    config.maxFrameRate = 30;      // 30: fps
+    config.minFrameRate = 15;      // 15: fps
+    auto controller = std::make_shared<RtpRateController>(config);
+    int64_t now = 0;
+    // one report a second, the encoder sends what it is asked for
+    auto report = [&](double loss, uint32_t rtt) {
+        controller->OnSent(controller->GetTargetBitrate() / 8); // 8: bits per byte
+        now += 1000;                                             // 1000: ms
+        RtpRateController::Report item;
+        item.lossRate = loss;
+        item.rttMs = rtt;
+        item.jitterMs = 1;
+        return controller->OnReport(item, now);
+    };
+
+    // a clean link ramps up by about 8% a second, up to the max
+    EXPECT_FALSE(report(0, 10)); // 10: rtt ms
+    EXPECT_TRUE(report(0, 10));  // 10: rtt ms
+    EXPECT_NEAR(controller->GetTargetBitrate(), 2160000U, 1000U); // 2160000: 8% up
+    for (int32_t i = 0; i < 20; i++) { // 20: seconds
+        report(0, 10);                  // 10: rtt ms
+    }
+    EXPECT_EQ(controller->GetTargetBitrate(), 4000000U); // 4000000: max
+    EXPECT_EQ(controller->GetFrameRate(), 30U);          // 30: fps
+
+    // a growing queue backs off before anything is lost
+    EXPECT_TRUE(report(0, 110)); // 110: 100 ms queued
+    auto stats = controller->GetStats();
+    EXPECT_EQ(stats.usage, RtpRateController::Usage::OVERUSE);
+    EXPECT_EQ(stats.decreases, 1U);
+    EXPECT_NEAR(stats.targetBitrate, 3400000U, 1000U); // 3400000: 85% of the send rate
+    // draining, the rate holds
+    EXPECT_FALSE(report(0, 40)); // 40: rtt ms
+    EXPECT_EQ(controller->GetStats().usage, RtpRateController::Usage::UNDERUSE);
+    EXPECT_NEAR(controller->GetTargetBitrate(), 3400000U, 1000U); // 3400000: unchanged
+    // back to normal it grows again, by a packet per round trip once close to the congested rate
+    report(0, 10); // 10: rtt ms
+    EXPECT_EQ(controller->GetStats().state, RtpRateController::RateState::INCREASE);
+    EXPECT_NEAR(controller->GetTargetBitrate(), 3672000U, 1000U); // 3672000: 8% up
+    report(0, 10);                                                // 10: rtt ms
+    EXPECT_NEAR(controller->GetTargetBitrate(), 3672000U + 1200 * 8 * 1000 / 110, 1000U); // 1200, 110: packet, rtt
+
+    // heavy loss halves the loss rate every report, the frame rate follows at low rates
+    for (int32_t i = 0; i < 10; i++) { // 10: seconds
+        report(0.5, 10);                // 0.5: loss, 10: rtt ms
+    }
+    EXPECT_EQ(controller->GetTargetBitrate(), 500000U); // 500000: min
+    EXPECT_EQ(controller->GetFrameRate(), 15U);         // 15: min fps
+    // moderate loss holds the rate
+    EXPECT_FALSE(report(0.05, 10)); // 0.05: loss, 10: rtt ms
+    EXPECT_EQ(controller->GetTargetBitrate(), 500000U); // 500000: min
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_120, Function | SmallTest | Level2)
+{
+    // two loopback sinks and one sending socket
+    int32_t fds[2] = {-1, -1};
+    uint16_t ports[2] = {0, 0};
+    for (int32_t i = 0; i < 2; i++) { // 2: sinks
+        fds[i] = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_GE(fds[i], 0);
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        ASSERT_EQ(bind(fds[i], reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+        ASSERT_EQ(getsockname(fds[i], reinterpret_cast<sockaddr *>(&addr), &len), 0);
+        ports[i] = ntohs(addr.sin_port);
+        timeval timeout = {1, 0}; // 1: s
+        setsockopt(fds[i], SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+    int32_t sendFd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    ASSERT_GE(sendFd, 0);
+
+    RtpFanout::Config config;
+    config.maxSinks = 2;           // 2: sinks
+    config.payloadType = 33;       // 33: ts pt
+    auto fanout = std::make_shared<RtpFanout>(config);
+    fanout->SetSocket(sendFd);
+    ASSERT_TRUE(fanout->AddSink(1, "127.0.0.1", ports[0], 0x2001)); // 0x2001: ssrc
+    ASSERT_TRUE(fanout->AddSink(2, "127.0.0.1", ports[1], 0x2002)); // 2: id, 0x2002: ssrc
+    EXPECT_FALSE(fanout->AddSink(3, "127.0.0.1", ports[1], 0x2003)); // 3: id, 0x2003: ssrc, over maxSinks
+
+    auto maker = std::make_shared<RtpMaker>(0x2000, 1400, 33, 90000, 65534); // 0x2000: ssrc, 33: pt, 65534: seq
+    auto fecMaker = std::make_shared<RtpMaker>(0x2000, 1400, 127, 90000, 0); // 127: fec pt
+    std::vector<DataBuffer::Ptr> packets;
+    for (uint32_t i = 0; i < 3; i++) { // 3: packets, across the seq wrap
+        std::vector<uint8_t> payload(188, static_cast<uint8_t>(i)); // 188: ts packet
+        packets.push_back(maker->MakeRtp(payload.data(), payload.size(), false, 3000)); // 3000: stamp
+    }
+    std::vector<uint8_t> parity(188, 0); // 188: ts packet
+    packets.push_back(fecMaker->MakeRtp(parity.data(), parity.size(), false, 3000)); // 3000: stamp
+    fanout->Send(packets);
+
+    for (int32_t i = 0; i < 2; i++) { // 2: sinks
+        uint16_t base = 0;
+        for (uint32_t j = 0; j < 3; j++) { // 3: packets, the parity is not forwarded
+            uint8_t buf[1500] = {0};      // 1500: mtu
+            ASSERT_EQ(recv(fds[i], buf, sizeof(buf), 0), 200); // 200: header and ts packet
+            uint16_t seq = static_cast<uint16_t>((buf[2] << 8) | buf[3]);
+            uint32_t ssrc = (static_cast<uint32_t>(buf[8]) << 24) | (buf[9] << 16) | (buf[10] << 8) | buf[11];
+            EXPECT_EQ(ssrc, 0x2001U + i);     // 0x2001: ssrc of the first sink
+            EXPECT_EQ(buf[12], j);            // 12: payload, in order
+            EXPECT_EQ(buf[1] & 0x7F, 33);     // 33: pt untouched
+            base = j == 0 ? seq : base;
+            EXPECT_EQ(seq, static_cast<uint16_t>(base + j));
+        }
+        uint8_t buf[1500] = {0};
+        EXPECT_LT(recv(fds[i], buf, sizeof(buf), MSG_DONTWAIT), 0);
+
+        // a nack in the sink's numbering maps back to the source stream
+        auto seqs = fanout->ToSourceSeqs(1 + i, {static_cast<uint16_t>(base + 2)}); // 2: third packet
+        ASSERT_EQ(seqs.size(), 1U);
+        EXPECT_EQ(seqs[0], 0U); // 0: 65534 + 2 wrapped
+
+        auto stats = fanout->GetStats(1 + i);
+        EXPECT_EQ(stats.packets, 3U);
+        EXPECT_EQ(stats.queued, 0U);
+        EXPECT_NE(fanout->CreateSenderReport(1 + i), nullptr);
+    }
+
+    // a resend reaches only the sink that asked
+    fanout->SendTo(2, {packets[1]}); // 2: id
+    uint8_t buf[1500] = {0};         // 1500: mtu
+    EXPECT_EQ(recv(fds[1], buf, sizeof(buf), 0), 200); // 200: header and ts packet
+    EXPECT_LT(recv(fds[0], buf, sizeof(buf), MSG_DONTWAIT), 0);
+
+    fanout->RemoveSink(1);
+    EXPECT_EQ(fanout->GetSinkCount(), 1U);
+    close(sendFd);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_121, Function | SmallTest | Level2)
+{
+    // 96, 97: direct video and audio pt
+    auto videoPacker = RtpSourceFactory::CreateRtpPack(0x3000, 1400, 90000, 96, RtpPayloadStream::H264, 0);
+    auto audioPacker = RtpSourceFactory::CreateRtpPack(0x3001, 1400, 48000, 97, RtpPayloadStream::MPEG4_GENERIC, 2);
+    ASSERT_NE(videoPacker, nullptr);
+    ASSERT_NE(audioPacker, nullptr);
+    std::vector<RtpPacket::Ptr> packets;
+    videoPacker->SetOnRtpPack([&](const RtpPacket::Ptr &rtp) { packets.push_back(rtp); });
+    audioPacker->SetOnRtpPack([&](const RtpPacket::Ptr &rtp) { packets.push_back(rtp); });
+
+    // an access unit of sps, pps and an idr larger than the mtu
+    const uint8_t sps[] = {0, 0, 0, 1, 0x67, 0x42, 0xC0, 0x1F};
+    const uint8_t pps[] = {0, 0, 0, 1, 0x68, 0xCE, 0x3C, 0x80};
+    std::vector<uint8_t> idr(3000, 0xA5); // 3000: fu-a, 0xA5: first_mb_in_slice 0
+    const uint8_t idrHeader[] = {0, 0, 0, 1, 0x65};
+    ASSERT_EQ(memcpy_s(idr.data(), idr.size(), idrHeader, sizeof(idrHeader)), EOK);
+    uint32_t pts = 40; // 40: ms
+    videoPacker->InputFrame(std::make_shared<H264Frame>(const_cast<uint8_t *>(sps), sizeof(sps), pts, pts, 4));
+    videoPacker->InputFrame(std::make_shared<H264Frame>(const_cast<uint8_t *>(pps), sizeof(pps), pts, pts, 4));
+    videoPacker->InputFrame(std::make_shared<H264Frame>(idr.data(), idr.size(), pts, pts, 4));
+    // the idr waits for the next frame to know it ends the access unit, the parameter sets go with it
+    EXPECT_TRUE(packets.empty());
+    videoPacker->Flush();
+    ASSERT_GT(packets.size(), 3U); // 3: sps, pps and fu-a fragments
+    for (size_t i = 0; i < packets.size(); i++) {
+        EXPECT_EQ(packets[i]->GetHeader()->mark_, i + 1 == packets.size() ? 1U : 0U);
+    }
+    for (auto &rtp : packets) {
+        EXPECT_EQ(rtp->GetHeader()->pt_, 96); // 96: video pt
+        EXPECT_EQ(rtp->GetStamp(), pts * 90); // 90: 90 kHz
+    }
+    size_t videoPackets = packets.size();
+
+    // the adts header is not sent, the au header carries the size
+    std::vector<uint8_t> adts(7 + 100, 0x11); // 7: adts header, 100: raw frame
+    const uint8_t header[] = {0xFF, 0xF1, 0x4C, 0x80, 0x0D, 0x7F, 0xFC}; // 48000, 2 channels, 107 bytes
+    ASSERT_EQ(memcpy_s(adts.data(), adts.size(), header, sizeof(header)), EOK);
+    ASSERT_EQ(AdtsHeaderSize(adts.data(), adts.size()), 7U); // 7: without crc
+    auto aac = std::make_shared<FrameImpl>();
+    aac->Assign(reinterpret_cast<char *>(adts.data()), adts.size());
+    aac->codecId_ = CODEC_AAC;
+    aac->dts_ = aac->pts_ = pts;
+    aac->prefixSize_ = AdtsHeaderSize(adts.data(), adts.size());
+    audioPacker->InputFrame(aac);
+    ASSERT_EQ(packets.size(), videoPackets + 1);
+    EXPECT_EQ(packets.back()->GetHeader()->pt_, 97);      // 97: audio pt
+    EXPECT_EQ(packets.back()->GetPayloadSize(), 4U + 100); // 4: au headers, 100: raw frame
+
+    auto unpack = std::make_shared<RtpUnpackImpl>();
+    unpack->AddPayload(RtpPlaylodParam{96, 90000, RtpPayloadStream::H264}); // 96: pt, 90000: clock
+    auto extra = std::make_shared<AACExtra>();
+    extra->aacConfig_ = "1190"; // aac-lc, 48000, 2 channels
+    unpack->AddPayload(RtpPlaylodParam{97, 48000, RtpPayloadStream::MPEG4_GENERIC, extra}); // 97: pt
+    std::vector<Frame::Ptr> frames;
+    unpack->SetOnRtpUnpack([&](uint32_t, const Frame::Ptr &frame) { frames.push_back(frame); });
+    for (auto &rtp : packets) {
+        unpack->ParseRtp(reinterpret_cast<const char *>(rtp->Data()), rtp->Size());
+    }
+
+    ASSERT_EQ(frames.size(), 4U); // 4: sps, pps, idr, aac
+    EXPECT_EQ(frames[0]->Size(), static_cast<int32_t>(sizeof(sps)));
+    EXPECT_EQ(memcmp(frames[1]->Data(), pps, sizeof(pps)), 0);
+    ASSERT_EQ(frames[2]->Size(), static_cast<int32_t>(idr.size()));
+    EXPECT_EQ(memcmp(frames[2]->Data(), idr.data(), idr.size()), 0);
+    EXPECT_EQ(frames[2]->Pts(), pts * 1000); // 1000: the unpacker hands out us like the ts demuxer
+    EXPECT_EQ(frames[3]->Pts(), pts * 1000); // 1000: ms to us
+    // rebuilt from the config, the same header the encoder had
+    ASSERT_EQ(frames[3]->Size(), static_cast<int32_t>(adts.size()));
+    EXPECT_EQ(memcmp(frames[3]->Data(), adts.data(), adts.size()), 0);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_122, Function | SmallTest | Level2)
+{
+    auto decoder = std::make_shared<RtpDecoderTs>();
+    ASSERT_NE(decoder, nullptr);
+    std::vector<Frame::Ptr> frames;
+    decoder->SetOnFrame([&frames](const Frame::Ptr &frame) { frames.push_back(frame); });
+    auto encoder = std::make_shared<RtpEncoderTs>(1, 1400, 90000, 33); // 1400: mtu, 90000: clock, 33: MP2T
+    ASSERT_NE(encoder, nullptr);
+    encoder->SetOnRtpPack([&decoder](const RtpPacket::Ptr &rtp) { decoder->InputRtp(rtp); });
+
+    // the 33 bits 90 kHz clock wraps after 95443717 ms, the second frame is stamped past it
+    uint8_t idr[] = {0x00, 0x00, 0x00, 0x01, 0x65, 0x88};
+    uint8_t next[] = {0x00, 0x00, 0x00, 0x01, 0x41, 0x9a};
+    uint32_t pts = 95443580; // 95443580: 100 ms mux delay keeps it just below the wrap
+    encoder->InputFrame(std::make_shared<H264Frame>(idr, sizeof(idr), pts, pts, 4));           // 4: prefix
+    encoder->InputFrame(std::make_shared<H264Frame>(next, sizeof(next), pts + 40, pts + 40, 4)); // 40: ms, 4: prefix
+    encoder->InputFrame(std::make_shared<H264Frame>(next, sizeof(next), pts + 80, pts + 80, 4)); // 80: ms, 4: prefix
+
+    ASSERT_EQ(frames.size(), 2U); // 2: the last pes is still open
+    EXPECT_GT(frames[1]->Pts(), frames[0]->Pts());
+    EXPECT_EQ(frames[1]->Pts() - frames[0]->Pts(), 40000U); // 40000: 40 ms in us
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_123, Function | SmallTest | Level2)
+{
+    auto rtpSortor = std::make_shared<RtpPacketSortor>(90000, 1024, 16); // 90000: clock, 1024, 16: cache
+    std::vector<uint16_t> sorted;
+    std::vector<uint16_t> lost;
+    rtpSortor->SetOnSort([&sorted](uint16_t seq, const RtpPacket::Ptr &) { sorted.push_back(seq); });
+    rtpSortor->SetOnLost([&lost](const std::vector<uint16_t> &seqs) {
+        lost.insert(lost.end(), seqs.begin(), seqs.end());
+    });
+
+    // overtaken by one or two packets is reordering, not loss
+    for (uint16_t seq : {0, 2, 1, 3, 6, 4, 5, 7, 8, 9}) {
+        rtpSortor->SortPacket(seq, std::make_shared<RtpPacket>());
+    }
+    EXPECT_TRUE(lost.empty());
+    EXPECT_EQ(sorted, std::vector<uint16_t>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    // 10 is nacked once three later packets are in, and not again
+    for (uint16_t seq : {11, 12}) {
+        rtpSortor->SortPacket(seq, std::make_shared<RtpPacket>());
+    }
+    EXPECT_TRUE(lost.empty());
+    for (uint16_t seq : {13, 14, 15}) {
+        rtpSortor->SortPacket(seq, std::make_shared<RtpPacket>());
+    }
+    EXPECT_EQ(lost, std::vector<uint16_t>({10}));
+    EXPECT_EQ(rtpSortor->GetLossStats().nacked, 1U);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_124, Function | SmallTest | Level2)
+{
+    auto rtpSortor = std::make_shared<RtpPacketSortor>(90000); // 90000: clock
+    std::vector<uint16_t> sorted;
+    rtpSortor->SetOnSort([&sorted](uint16_t seq, const RtpPacket::Ptr &) { sorted.push_back(seq); });
+    rtpSortor->SetPlayoutDelay(10, 10); // 10: ms
+
+    // 1 is lost and the stream stalls after 3, the reader's poll plays out what waited long enough
+    for (uint16_t seq : {0, 2, 3}) {
+        rtpSortor->SortPacket(seq, std::make_shared<RtpPacket>());
+    }
+    EXPECT_EQ(sorted, std::vector<uint16_t>({0}));
+    rtpSortor->Poll();
+    EXPECT_EQ(sorted, std::vector<uint16_t>({0}));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); // 20: past the delay
+    rtpSortor->Poll();
+    EXPECT_EQ(sorted, std::vector<uint16_t>({0, 2, 3}));
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_125, Function | SmallTest | Level2)
+{
+    auto rtpSortor = std::make_shared<RtpPacketSortor>(90000, 1024, 64); // 90000: clock, 1024, 64: cache
+    std::vector<uint16_t> sorted;
+    rtpSortor->SetOnSort([&sorted](uint16_t seq, const RtpPacket::Ptr &) { sorted.push_back(seq); });
+
+    // a burst loss longer than the ring, what was cached before it is played out, not dropped
+    for (uint16_t seq : {0, 2, 3, 5000, 5001}) { // 5000: beyond the 2048 slots
+        rtpSortor->SortPacket(seq, std::make_shared<RtpPacket>());
+    }
+    EXPECT_EQ(sorted, std::vector<uint16_t>({0, 2, 3, 5000, 5001}));
+    // the seqs given up are late now
+    rtpSortor->SortPacket(1, std::make_shared<RtpPacket>());
+    EXPECT_EQ(sorted.size(), 5U); // 5: unchanged
+    EXPECT_EQ(rtpSortor->GetPlayoutStats().lateDrops, 1U);
+}
+
+HWTEST_F(RtpUnitTest, RtpUnitTest_126, Function | SmallTest | Level2)
+{
+    // direct rtp: video protected by fec, audio on the next ssrc with the same seq numbers and no parity
+    auto video = std::make_shared<RtpMaker>(0x2000, 1400, 96, 90000, 0); // 0x2000: ssrc, 1400: mtu, 96: pt
+    auto audio = std::make_shared<RtpMaker>(0x2001, 1400, 97, 48000, 0); // 0x2001: ssrc, 1400: mtu, 97: pt
+    auto encoder = std::make_shared<RtpFecEncoder>(127, 4, 4);           // 127: fec pt, 4: group packets
+    auto decoder = std::make_shared<RtpFecDecoder>(127);                 // 127: fec pt
+    std::vector<std::string> recovered;
+    decoder->SetOnRecovered([&recovered](const char *data, size_t len) { recovered.emplace_back(data, len); });
+
+    std::vector<RtpPacket::Ptr> media;
+    std::vector<RtpPacket::Ptr> parity;
+    for (uint32_t i = 0; i < 8; i++) { // 8: two groups
+        std::vector<uint8_t> payload(100 + i * 37, static_cast<uint8_t>(i * 11)); // 100, 37, 11: varied packets
+        media.push_back(video->MakeRtp(payload.data(), payload.size(), i % 4 == 3, i * 3000)); // 3: last, 3000
+        auto fec = encoder->AddPacket(media.back());
+        if (fec != nullptr) {
+            parity.push_back(fec);
+        }
+    }
+    ASSERT_EQ(parity.size(), 2U);
+    // one video packet of each group is lost, every audio packet arrives right after its video one
+    auto input = [&](uint32_t first) {
+        for (uint32_t i = first; i < first + 4; i++) { // 4: group packets
+            if (i % 4 != 2) {                          // 2: lost
+                decoder->InputMedia(reinterpret_cast<const char *>(media[i]->Data()), media[i]->Size());
+            }
+            std::vector<uint8_t> payload(160, 0x55); // 160: g711 20 ms, 0x55: silence
+            auto rtp = audio->MakeRtp(payload.data(), payload.size(), false, i * 960); // 960: 20 ms
+            decoder->InputMedia(reinterpret_cast<const char *>(rtp->Data()), rtp->Size());
+        }
+    };
+
+    // before the first parity the audio has taken the slots, nothing is rebuilt from it
+    input(0);
+    decoder->InputFec(reinterpret_cast<const char *>(parity[0]->Data()), parity[0]->Size());
+    EXPECT_TRUE(recovered.empty());
+    EXPECT_EQ(decoder->GetStats().unrecoverable, 1U);
+
+    // the parity told the protected ssrc, audio stays out of the ring
+    input(4); // 4: second group
+    decoder->InputFec(reinterpret_cast<const char *>(parity[1]->Data()), parity[1]->Size());
+    ASSERT_EQ(recovered.size(), 1U);
+    EXPECT_EQ(recovered[0], std::string(reinterpret_cast<const char *>(media[6]->Data()), media[6]->Size()));
+}
 } // namespace
 } // namespace Sharing
-} // namespace OHOS
\ No newline at end of file
+} // namespace OHOS